@@ -75,6 +75,7 @@ LOCAL_SRC_FILES := \
 	src/codec/SkBmpRLECodec.cpp \
 	src/codec/SkBmpStandardCodec.cpp \
 	src/codec/SkCodec.cpp \
+	src/codec/SkCodecPool.cpp \
 	src/codec/SkGifCodec.cpp \
 	src/codec/SkIcoCodec.cpp \
 	src/codec/SkJpegCodec.cpp \
@@ -83,6 +84,7 @@ LOCAL_SRC_FILES := \
 	src/codec/SkMaskSwizzler.cpp \
 	src/codec/SkMasks.cpp \
 	src/codec/SkPngCodec.cpp \
+	src/codec/SkPngRowReader.cpp \
 	src/codec/SkSampler.cpp \
 	src/codec/SkSampledCodec.cpp \
 	src/codec/SkSwizzler.cpp \
@@ -90,6 +92,7 @@ LOCAL_SRC_FILES := \
 	src/codec/SkWebpAdapterCodec.cpp \
 	src/codec/SkWebpCodec.cpp \
 	src/codec/SkCodecImageGenerator.cpp \
+	src/codec/SkCompressedImageGenerator.cpp \
 	src/ports/SkImageGenerator_skia.cpp \
 	src/android/SkBitmapRegionCanvas.cpp \
 	src/android/SkBitmapRegionCodec.cpp \
@@ -118,6 +121,7 @@ LOCAL_SRC_FILES := \
 	src/core/SkBlitter.cpp \
 	src/core/SkBlitter_A8.cpp \
 	src/core/SkBlitter_ARGB32.cpp \
+	src/core/SkBlitter_Fused.cpp \
 	src/core/SkBlitter_PM4f.cpp \
 	src/core/SkBlitter_RGB16.cpp \
 	src/core/SkBlitter_Sprite.cpp \
@@ -132,6 +136,7 @@ LOCAL_SRC_FILES := \
 	src/core/SkColorFilterShader.cpp \
 	src/core/SkColorMatrixFilterRowMajor255.cpp \
 	src/core/SkColorSpace.cpp \
+	src/core/SkColorSpaceXform.cpp \
 	src/core/SkColorTable.cpp \
 	src/core/SkComposeShader.cpp \
 	src/core/SkConfig8888.cpp \
@@ -155,6 +160,7 @@ LOCAL_SRC_FILES := \
 	src/core/SkEdgeClipper.cpp \
 	src/core/SkEdge.cpp \
 	src/core/SkError.cpp \
+	src/core/SkFillPathCache.cpp \
 	src/core/SkFilterProc.cpp \
 	src/core/SkFlattenable.cpp \
 	src/core/SkFlattenableSerialization.cpp \
@@ -215,7 +221,9 @@ LOCAL_SRC_FILES := \
 	src/core/SkPoint3.cpp \
 	src/core/SkPtrRecorder.cpp \
 	src/core/SkQuadClipper.cpp \
+	src/core/SkQuadPathCache.cpp \
 	src/core/SkRasterClip.cpp \
+	src/core/SkRasterClipCache.cpp \
 	src/core/SkRasterizer.cpp \
 	src/core/SkReadBuffer.cpp \
 	src/core/SkRecord.cpp \
@@ -299,6 +307,7 @@ LOCAL_SRC_FILES := \
 	src/pathops/SkOpSpan.cpp \
 	src/pathops/SkPathOpsCommon.cpp \
 	src/pathops/SkPathOpsConic.cpp \
+	src/pathops/SkPathOpsContext.cpp \
 	src/pathops/SkPathOpsCubic.cpp \
 	src/pathops/SkPathOpsCurve.cpp \
 	src/pathops/SkPathOpsDebug.cpp \
@@ -580,6 +589,7 @@ LOCAL_SRC_FILES := \
 	src/images/SkMovie_gif.cpp \
 	src/images/SkPageFlipper.cpp \
 	src/images/SkScaledBitmapSampler.cpp \
+	src/images/SkStripEncoder.cpp \
 	src/doc/SkDocument_PDF.cpp \
 	src/pdf/SkDeflate.cpp \
 	src/pdf/SkJpegInfo.cpp \
@@ -653,6 +663,7 @@ LOCAL_SRC_FILES := \
 	src/utils/SkTextureCompressor_LATC.cpp \
 	src/utils/SkThreadUtils_pthread.cpp \
 	src/utils/SkWhitelistTypefaces.cpp \
+	src/utils/SkYUVToRGBA.cpp \
 	src/fonts/SkGScalerContext.cpp \
 	src/fonts/SkRandomScalerContext.cpp \
 	src/fonts/SkTestScalerContext.cpp \
@@ -769,27 +780,27 @@ LOCAL_CFLAGS_x86 += \
 	-mfpmath=sse
 
 LOCAL_SRC_FILES_x86 += \
-	src/opts/SkBitmapFilter_opts_SSE2.cpp \
 	src/opts/SkBitmapProcState_opts_SSE2.cpp \
 	src/opts/SkBlitRow_opts_SSE2.cpp \
 	src/opts/opts_check_x86.cpp \
 	src/opts/SkBitmapProcState_opts_SSSE3.cpp \
 	src/opts/SkOpts_ssse3.cpp \
 	src/opts/SkBlitRow_opts_SSE4.cpp \
-	src/opts/SkOpts_sse41.cpp
+	src/opts/SkOpts_sse41.cpp \
+	src/opts/SkOpts_avx2.cpp
 
 LOCAL_CFLAGS_x86 += \
 	-DqDNGBigEndian=0
 
 LOCAL_SRC_FILES_x86_64 += \
-	src/opts/SkBitmapFilter_opts_SSE2.cpp \
 	src/opts/SkBitmapProcState_opts_SSE2.cpp \
 	src/opts/SkBlitRow_opts_SSE2.cpp \
 	src/opts/opts_check_x86.cpp \
 	src/opts/SkBitmapProcState_opts_SSSE3.cpp \
 	src/opts/SkOpts_ssse3.cpp \
 	src/opts/SkBlitRow_opts_SSE4.cpp \
-	src/opts/SkOpts_sse41.cpp
+	src/opts/SkOpts_sse41.cpp \
+	src/opts/SkOpts_avx2.cpp
 
 LOCAL_CFLAGS_mips += \
 	-EL
@@ -9,6 +9,7 @@
 #include "SkAAClip.h"
 #include "SkCanvas.h"
 #include "SkPath.h"
+#include "SkRRect.h"
 #include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkString.h"
@@ -170,6 +171,61 @@ private:
     typedef Benchmark INHERITED;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// Nests rounded rect clips the way pages do (a list in a card in a dialog), and draws a row
+// inside each. Each loop either draws the same page again, or scrolls it by a pixel so that
+// none of the clips repeat.
+class NestedRRectClipBench : public Benchmark {
+    SkString fName;
+    bool     fScroll;
+
+    static const int kNestingDepth = 6;
+    static const int kRowCount = 8;
+
+public:
+    NestedRRectClipBench(bool scroll) : fScroll(scroll) {
+        fName.printf("nested_rrect_clip_%s", scroll ? "scroll" : "redraw");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+
+        for (int i = 0; i < loops; ++i) {
+            canvas->save();
+            if (fScroll) {
+                canvas->translate(0, -SkIntToScalar(i % 100));
+            }
+            SkRect bounds = SkRect::MakeLTRB(0.5f, 0.5f, 400.5f, 600.5f);
+            for (int depth = 0; depth < kNestingDepth; ++depth) {
+                canvas->save();
+                canvas->clipRRect(SkRRect::MakeRectXY(bounds, 8, 8), SkRegion::kIntersect_Op,
+                                  true);
+                for (int row = 0; row < kRowCount; ++row) {
+                    const SkRect r = SkRect::MakeXYWH(bounds.fLeft + 4, bounds.fTop + row * 12,
+                                                      bounds.width() - 8, 10);
+                    canvas->save();
+                    canvas->clipRRect(SkRRect::MakeRectXY(r, 3, 3), SkRegion::kIntersect_Op,
+                                      true);
+                    canvas->drawRect(r, paint);
+                    canvas->restore();
+                }
+                bounds.inset(20, 30);
+            }
+            for (int depth = 0; depth < kNestingDepth; ++depth) {
+                canvas->restore();
+            }
+            canvas->restore();
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 class AAClipBuilderBench : public Benchmark {
     SkString fName;
@@ -255,3 +311,5 @@ DEF_BENCH(return new AAClipBench(true, false);)
 DEF_BENCH(return new AAClipBench(true, true);)
 DEF_BENCH(return new NestedAAClipBench(false);)
 DEF_BENCH(return new NestedAAClipBench(true);)
+DEF_BENCH(return new NestedRRectClipBench(false);)
+DEF_BENCH(return new NestedRRectClipBench(true);)
@@ -43,13 +43,16 @@ LOCAL_SRC_FILES := \
 	ChromeBench.cpp \
 	CmapBench.cpp \
 	CodecBench.cpp \
+	CodecPoolBench.cpp \
 	ColorCubeBench.cpp \
 	ColorFilterBench.cpp \
 	ColorPrivBench.cpp \
+	CompressedAtlasBench.cpp \
 	ControlBench.cpp \
 	CoverageBench.cpp \
 	DashBench.cpp \
 	DisplacementBench.cpp \
+	DrawAtlasBench.cpp \
 	DrawBitmapAABench.cpp \
 	FSRectBench.cpp \
 	FontCacheBench.cpp \
@@ -60,7 +63,9 @@ LOCAL_SRC_FILES := \
 	GLVertexAttributesBench.cpp \
 	GMBench.cpp \
 	GameBench.cpp \
+	GammaCorrectBench.cpp \
 	GeometryBench.cpp \
+	GifFrameBench.cpp \
 	GrMemoryPoolBench.cpp \
 	GrResourceCacheBench.cpp \
 	GradientBench.cpp \
@@ -89,11 +94,15 @@ LOCAL_SRC_FILES := \
 	PatchGridBench.cpp \
 	PathBench.cpp \
 	PathIterBench.cpp \
+	PathMeasureBench.cpp \
+	PathOpsBuilderBench.cpp \
+	PathOpsSmallBench.cpp \
 	PerlinNoiseBench.cpp \
 	PictureNestingBench.cpp \
 	PictureOverheadBench.cpp \
 	PicturePlaybackBench.cpp \
 	PremulAndUnpremulAlphaOpsBench.cpp \
+	QuadPathBench.cpp \
 	RTreeBench.cpp \
 	ReadPixBench.cpp \
 	RecordingBench.cpp \
@@ -115,6 +124,7 @@ LOCAL_SRC_FILES := \
 	SkLinearBitmapPipelineBench.cpp \
 	SkipZeroesBench.cpp \
 	SortBench.cpp \
+	StripEncoderBench.cpp \
 	StrokeBench.cpp \
 	SwizzleBench.cpp \
 	TableBench.cpp \
@@ -444,6 +454,7 @@ LOCAL_C_INCLUDES := \
 	$(LOCAL_PATH)/../src/sfnt \
 	$(LOCAL_PATH)/../include/utils \
 	$(LOCAL_PATH)/../src/utils \
+	$(LOCAL_PATH)/../src/codec \
 	$(LOCAL_PATH)/../include/gpu \
 	$(LOCAL_PATH)/../include/private \
 	$(LOCAL_PATH)/../src/gpu \
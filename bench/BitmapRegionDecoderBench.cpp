@@ -8,13 +8,17 @@
 #include "BitmapRegionDecoderBench.h"
 #include "CodecBenchPriv.h"
 #include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkImageEncoder.h"
 #include "SkOSFile.h"
+#include "SkRandom.h"
 
 BitmapRegionDecoderBench::BitmapRegionDecoderBench(const char* baseName, SkData* encoded,
         SkBitmapRegionDecoder::Strategy strategy, SkColorType colorType,
         uint32_t sampleSize, const SkIRect& subset)
     : fBRD(nullptr)
-    , fData(SkRef(encoded))
+    , fData(SkSafeRef(encoded))
     , fStrategy(strategy)
     , fColorType(colorType)
     , fSampleSize(sampleSize)
@@ -62,3 +66,82 @@ void BitmapRegionDecoderBench::onDraw(int n, SkCanvas* canvas) {
         SkAssertResult(fBRD->decodeRegion(&bm, nullptr, fSubset, fSampleSize, fColorType, false));
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ *  Decodes 512x512 tiles of a large, generated PNG, like a tile server cropping a huge scan.
+ *
+ *  PNG rows can only be reached by inflating everything before them, so the cost of a tile
+ *  depends on how far down the image it is.  With a fresh decoder for each tile, that is
+ *  what we measure.  Otherwise the decoder keeps an index of places to resume inflating
+ *  from, and tiles near the bottom should cost about the same as those near the top.
+ */
+class PngRegionDecoderBench : public BitmapRegionDecoderBench {
+public:
+    PngRegionDecoderBench(const char* baseName, const SkIRect& subset, bool fresh)
+        : INHERITED(baseName, nullptr, SkBitmapRegionDecoder::kAndroidCodec_Strategy,
+                    kN32_SkColorType, 1, subset)
+        , fFresh(fresh)
+    {
+        if (fresh) {
+            fName.append("_fresh");
+        }
+    }
+
+protected:
+    enum {
+        kSize = 4096,
+    };
+
+    void onDelayedSetup() override {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kSize, kSize);
+        SkCanvas canvas(bitmap);
+        const SkPoint pts[] = { { 0, 0 }, { SkIntToScalar(kSize), SkIntToScalar(kSize) } };
+        const SkColor colors[] = { SK_ColorBLUE, SK_ColorYELLOW, SK_ColorRED };
+        SkPaint paint;
+        paint.setShader(SkGradientShader::CreateLinear(pts, colors, nullptr, 3,
+                                                       SkShader::kClamp_TileMode))->unref();
+        canvas.drawPaint(paint);
+
+        SkRandom rand;
+        paint.setShader(nullptr);
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 1000; i++) {
+            paint.setColor(rand.nextU() & 0x80FFFFFF);
+            canvas.drawCircle(rand.nextRangeScalar(0, kSize), rand.nextRangeScalar(0, kSize),
+                              rand.nextRangeScalar(8, 128), paint);
+        }
+
+        fData.reset(SkImageEncoder::EncodeData(bitmap, SkImageEncoder::kPNG_Type, 100));
+        INHERITED::onDelayedSetup();
+    }
+
+    void onDraw(int n, SkCanvas* canvas) override {
+        if (!fFresh) {
+            INHERITED::onDraw(n, canvas);
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            fBRD.reset(SkBitmapRegionDecoder::Create(fData,
+                    SkBitmapRegionDecoder::kAndroidCodec_Strategy));
+            INHERITED::onDraw(1, canvas);
+        }
+    }
+
+private:
+    const bool fFresh;
+
+    typedef BitmapRegionDecoderBench INHERITED;
+};
+
+#define PNG_REGION_BENCHES(name, x, y)                                                      \
+    DEF_BENCH(return new PngRegionDecoderBench("png4096_" name,                            \
+                                               SkIRect::MakeXYWH(x, y, 512, 512), false);) \
+    DEF_BENCH(return new PngRegionDecoderBench("png4096_" name,                            \
+                                               SkIRect::MakeXYWH(x, y, 512, 512), true);)
+
+PNG_REGION_BENCHES("TopLeft", 0, 0)
+PNG_REGION_BENCHES("Middle", 1792, 1792)
+PNG_REGION_BENCHES("BottomRight", 3584, 3584)
@@ -25,7 +25,8 @@
  */
 class BitmapRegionDecoderBench : public Benchmark {
 public:
-    // Calls encoded->ref()
+    // Calls encoded->ref().  encoded may be nullptr if a subclass sets fData in
+    // onDelayedSetup().
     BitmapRegionDecoderBench(const char* basename, SkData* encoded,
             SkBitmapRegionDecoder::Strategy strategy, SkColorType colorType,
             uint32_t sampleSize, const SkIRect& subset);
@@ -36,10 +37,11 @@ protected:
     void onDraw(int n, SkCanvas* canvas) override;
     void onDelayedSetup() override;
 
-private:
     SkString                                       fName;
     SkAutoTDelete<SkBitmapRegionDecoder>           fBRD;
     SkAutoTUnref<SkData>                           fData;
+
+private:
     const SkBitmapRegionDecoder::Strategy          fStrategy;
     const SkColorType                              fColorType;
     const uint32_t                                 fSampleSize;
@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkBlurMask.h"
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkShader.h"
@@ -115,14 +116,25 @@ DEF_BENCH(return new BitmapFilterScaleBench(64, 256);)
 
 #include "SkBitmapScaler.h"
 
+// Each loop writes about a megapixel of output however big the destination is, so one loop's
+// time in microseconds is the inverse of the filter's throughput in megapixels per second.
 class PixmapScalerBench: public Benchmark {
     SkBitmapScaler::ResizeMethod    fMethod;
+    SkISize                         fSrcSize, fDstSize;
+    int                             fRepeats;
     SkString                        fName;
     SkBitmap                        fSrc, fDst;
 
 public:
-    PixmapScalerBench(SkBitmapScaler::ResizeMethod method, const char suffix[]) : fMethod(method) {
-        fName.printf("pixmapscaler_%s", suffix);
+    PixmapScalerBench(SkBitmapScaler::ResizeMethod method, const char suffix[],
+                      SkISize srcSize = SkISize::Make(640, 480),
+                      SkISize dstSize = SkISize::Make(300, 250))
+        : fMethod(method)
+        , fSrcSize(srcSize)
+        , fDstSize(dstSize)
+        , fRepeats(SkTMax(1, (1 << 20) / (dstSize.width() * dstSize.height()))) {
+        fName.printf("pixmapscaler_%s_%dx%d_%dx%d", suffix, srcSize.width(), srcSize.height(),
+                     dstSize.width(), dstSize.height());
     }
 
 protected:
@@ -137,16 +149,21 @@ protected:
     }
 
     void onDelayedSetup() override {
-        fSrc.allocN32Pixels(640, 480);
-        fSrc.eraseColor(SK_ColorWHITE);
-        fDst.allocN32Pixels(300, 250);
+        // A gradient, so the vertical pass can't skip work for rows that all match.
+        fSrc.allocN32Pixels(fSrcSize.width(), fSrcSize.height());
+        for (int y = 0; y < fSrcSize.height(); ++y) {
+            for (int x = 0; x < fSrcSize.width(); ++x) {
+                *fSrc.getAddr32(x, y) = SkPackARGB32(0xFF, x & 0xFF, y & 0xFF, (x ^ y) & 0xFF);
+            }
+        }
+        fDst.allocN32Pixels(fDstSize.width(), fDstSize.height());
     }
 
     void onDraw(int loops, SkCanvas*) override {
         SkPixmap src, dst;
         fSrc.peekPixels(&src);
         fDst.peekPixels(&dst);
-        for (int i = 0; i < loops * 16; i++) {
+        for (int i = 0; i < loops * fRepeats; i++) {
             SkBitmapScaler::Resize(dst, src, fMethod);
         }
     }
@@ -159,3 +176,13 @@ DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_MITCHELL, "mitche
 DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_HAMMING,  "hamming");  )
 DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_TRIANGLE, "triangle"); )
 DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_BOX,      "box");      )
+
+// Upscales, and outputs big enough to be split across threads.
+DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_LANCZOS3, "lanczos",
+                                        SkISize::Make(300, 250), SkISize::Make(640, 480)); )
+DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_MITCHELL, "mitchell",
+                                        SkISize::Make(300, 250), SkISize::Make(640, 480)); )
+DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_LANCZOS3, "lanczos",
+                                        SkISize::Make(1024, 768), SkISize::Make(2048, 1536)); )
+DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_MITCHELL, "mitchell",
+                                        SkISize::Make(4096, 3072), SkISize::Make(1600, 1200)); )
@@ -9,6 +9,7 @@
 #define CodecBench_DEFINED
 
 #include "Benchmark.h"
+#include "SkColorSpace.h"
 #include "SkData.h"
 #include "SkImageInfo.h"
 #include "SkRefCnt.h"
@@ -19,8 +20,10 @@
  */
 class CodecBench : public Benchmark {
 public:
-    // Calls encoded->ref()
-    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType);
+    // Calls encoded->ref().  If dstColorSpace is not null, it is ref'd too, and the decodes
+    // convert to it.
+    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType,
+               SkColorSpace* dstColorSpace = nullptr);
 
 protected:
     const char* onGetName() override;
@@ -33,6 +36,7 @@ private:
     const SkColorType       fColorType;
     const SkAlphaType       fAlphaType;
     SkAutoTUnref<SkData>    fData;
+    SkAutoTUnref<SkColorSpace> fDstColorSpace;
     SkImageInfo             fInfo;          // Set in onDelayedSetup.
     SkAutoMalloc            fPixelStorage;
     typedef Benchmark INHERITED;
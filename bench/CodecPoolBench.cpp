@@ -0,0 +1,121 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkCodec.h"
+#include "SkCodecPool.h"
+#include "SkData.h"
+#include "SkImageEncoder.h"
+#include "SkStream.h"
+
+static SkData* make_image_data(SkImageEncoder::Type type, int size) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(size, size, true);
+    SkCanvas canvas(bitmap);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas.clear(SK_ColorWHITE);
+    paint.setColor(SK_ColorBLUE);
+    canvas.drawCircle(size * 0.5f, size * 0.5f, size * 0.4f, paint);
+    paint.setColor(SK_ColorRED);
+    canvas.drawRect(SkRect::MakeWH(size * 0.5f, size * 0.25f), paint);
+    return SkImageEncoder::EncodeData(bitmap, type, 90);
+}
+
+static bool decode(SkData* data, bool pooled, const SkBitmap& bitmap) {
+    SkStream* stream = new SkMemoryStream(data);
+    SkAutoTDelete<SkCodec> codec(pooled ? SkCodec::NewFromStreamPooled(stream)
+                                        : SkCodec::NewFromStream(stream));
+    return codec && SkCodec::kSuccess == codec->getPixels(bitmap.info(), bitmap.getPixels(),
+                                                         bitmap.rowBytes());
+}
+
+/**
+ *  Decodes a tiny image over and over, as a page full of icons or thumbnails would, with a
+ *  new codec for every decode.  Pooled codecs reuse their decoder state from the last one.
+ *
+ *  Pooled bench names end with how many of a warm decode's requests to the pool still had
+ *  to allocate, e.g. _pooled_0of7allocs.  Fresh codecs allocate for every one of them.
+ */
+class CodecPoolBench : public Benchmark {
+public:
+    CodecPoolBench(SkImageEncoder::Type type, int size, bool pooled)
+        : fType(type)
+        , fSize(size)
+        , fPooled(pooled)
+    {
+        fName.printf("CodecPool_%s_%dx%d_%s", SkImageEncoder::kJPEG_Type == type ? "jpg" : "png",
+                     size, size, pooled ? "pooled" : "fresh");
+        if (pooled) {
+            this->appendPoolStats();
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fData.reset(make_image_data(fType, fSize));
+        fBitmap.allocN32Pixels(fSize, fSize);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+        for (int i = 0; i < loops; i++) {
+            if (!decode(fData, fPooled, fBitmap)) {
+                return;
+            }
+        }
+    }
+
+private:
+    // The counts are the same every time, and these images are tiny, so we can afford to
+    // decode one here, where the name is still ours to choose.
+    void appendPoolStats() {
+        SkAutoTUnref<SkData> data(make_image_data(fType, fSize));
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(fSize, fSize);
+        if (!data || !decode(data, true, bitmap)) {
+            return;
+        }
+        const SkCodecPool::Stats before = SkCodecPool::GetStats();
+        decode(data, true, bitmap);
+        const SkCodecPool::Stats after = SkCodecPool::GetStats();
+        fName.appendf("_%dof%dallocs", after.fHeapAllocs - before.fHeapAllocs,
+                      after.fAllocs - before.fAllocs);
+        // Free what those decodes cached, rather than hold it for the rest of the run.
+        SkCodecPool::Purge();
+    }
+
+    const SkImageEncoder::Type  fType;
+    const int                   fSize;
+    const bool                  fPooled;
+    SkString                    fName;
+    SkAutoTUnref<SkData>        fData;
+    SkBitmap                    fBitmap;
+
+    typedef Benchmark INHERITED;
+};
+
+#define CODEC_POOL_BENCHES(type, size)                                     \
+    DEF_BENCH(return new CodecPoolBench(SkImageEncoder::type, size, false);) \
+    DEF_BENCH(return new CodecPoolBench(SkImageEncoder::type, size, true);)
+
+CODEC_POOL_BENCHES(kJPEG_Type, 16)
+CODEC_POOL_BENCHES(kJPEG_Type, 64)
+CODEC_POOL_BENCHES(kPNG_Type, 16)
+CODEC_POOL_BENCHES(kPNG_Type, 64)
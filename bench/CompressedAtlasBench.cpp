@@ -0,0 +1,92 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkEndian.h"
+#include "SkImage.h"
+#include "SkString.h"
+#include "SkTemplates.h"
+#include "SkTextureCompressor.h"
+
+// Draws a few sprites out of a 12x12 ASTC texture atlas, decoding it afresh each loop, either
+// as an SkImage of the whole atlas drawn with src rects, or as SkImages of just the sprites,
+// which only decompress the blocks under each sprite.  nanobench reports the resident set size
+// beside each.
+class CompressedAtlasBench : public Benchmark {
+public:
+    CompressedAtlasBench(bool subsets) : fSubsets(subsets) {
+        fName.printf("compressed_atlas_%s", subsets ? "subsets" : "full");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkAutoPixmapStorage pixmap;
+        pixmap.alloc(SkImageInfo::MakeA8(kAtlasSize, kAtlasSize));
+        for (int y = 0; y < kAtlasSize; ++y) {
+            for (int x = 0; x < kAtlasSize; ++x) {
+                *pixmap.writable_addr8(x, y) = (x * 7 + y * 3) & 0xFF;
+            }
+        }
+        SkAutoDataUnref blocks(SkTextureCompressor::CompressBitmapToFormat(
+                pixmap, SkTextureCompressor::kASTC_12x12_Format));
+
+        // Wrap the blocks in an .astc file header.
+        SkAutoTMalloc<uint8_t> file(16 + blocks->size());
+        const uint32_t magic = SkEndian_SwapLE32(0x5CA1AB13);
+        memcpy(file.get(), &magic, 4);
+        const uint8_t header[] = {
+            12, 12, 1,
+            kAtlasSize & 0xFF, kAtlasSize >> 8, 0,
+            kAtlasSize & 0xFF, kAtlasSize >> 8, 0,
+            1, 0, 0,
+        };
+        memcpy(file.get() + 4, header, sizeof(header));
+        memcpy(file.get() + 16, blocks->data(), blocks->size());
+        fFile.reset(SkData::NewWithCopy(file.get(), 16 + blocks->size()));
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            SkAutoTUnref<SkImage> atlas;
+            if (!fSubsets) {
+                atlas.reset(SkImage::NewFromEncoded(fFile));
+            }
+            for (int j = 0; j < kSprites; ++j) {
+                const SkIRect src = SkIRect::MakeXYWH(j * 5 * kSpriteSize % kAtlasSize,
+                                                      j * 3 * kSpriteSize % kAtlasSize,
+                                                      kSpriteSize, kSpriteSize);
+                const SkRect dst = SkRect::MakeXYWH(SkIntToScalar(j % 4 * kSpriteSize),
+                                                    SkIntToScalar(j / 4 * kSpriteSize),
+                                                    kSpriteSize, kSpriteSize);
+                if (fSubsets) {
+                    SkAutoTUnref<SkImage> sprite(SkImage::NewFromEncoded(fFile, &src));
+                    canvas->drawImageRect(sprite, dst, nullptr);
+                } else {
+                    canvas->drawImageRect(atlas, src, dst, nullptr);
+                }
+            }
+        }
+    }
+
+private:
+    static const int kAtlasSize  = 1200;
+    static const int kSpriteSize = 60;
+    static const int kSprites    = 8;
+
+    bool                 fSubsets;
+    SkString             fName;
+    SkAutoTUnref<SkData> fFile;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new CompressedAtlasBench(false); )
+DEF_BENCH( return new CompressedAtlasBench(true); )
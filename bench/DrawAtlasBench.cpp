@@ -0,0 +1,81 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkPaint.h"
+#include "SkRandom.h"
+#include "SkRSXform.h"
+#include "SkString.h"
+#include "SkSurface.h"
+
+// Draws a particle-system-like batch of small sprites from a 4x4 atlas, either all upright
+// or each rotated, with or without per-sprite colors.
+class DrawAtlasBench : public Benchmark {
+public:
+    DrawAtlasBench(bool rotate, bool colors) : fRotate(rotate), fUseColors(colors) {
+        fName.printf("drawatlas_%s%s", rotate ? "rotated" : "upright", colors ? "_colors" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterN32Premul(4 * kCell, 4 * kCell));
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->clear(SK_ColorTRANSPARENT);
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 16; ++i) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas->drawCircle((i % 4 + 0.5f) * kCell, (i / 4 + 0.5f) * kCell, kCell / 2, paint);
+        }
+        fAtlas.reset(surface->newImageSnapshot());
+
+        for (int i = 0; i < kCount; ++i) {
+            const int cell = rand.nextULessThan(16);
+            fTex[i] = SkRect::MakeXYWH(SkIntToScalar(cell % 4 * kCell),
+                                       SkIntToScalar(cell / 4 * kCell), kCell, kCell);
+            const SkScalar radians = fRotate ? rand.nextRangeF(0, 2 * SK_ScalarPI) : 0;
+            fXform[i] = SkRSXform::Make(SkScalarCos(radians), SkScalarSin(radians),
+                                        rand.nextRangeF(0, 640 - kCell),
+                                        rand.nextRangeF(0, 480 - kCell));
+            fColors[i] = rand.nextU() | 0xFF000000;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setFilterQuality(kLow_SkFilterQuality);
+        const SkColor* colors = fUseColors ? fColors : nullptr;
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawAtlas(fAtlas, fXform, fTex, colors, kCount, SkXfermode::kModulate_Mode,
+                              nullptr, &paint);
+        }
+    }
+
+private:
+    static const int kCell  = 16;
+    static const int kCount = 1000;
+
+    bool                  fRotate;
+    bool                  fUseColors;
+    SkString              fName;
+    SkAutoTUnref<SkImage> fAtlas;
+    SkRSXform             fXform[kCount];
+    SkRect                fTex[kCount];
+    SkColor               fColors[kCount];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new DrawAtlasBench(false, false); )
+DEF_BENCH( return new DrawAtlasBench(true,  false); )
+DEF_BENCH( return new DrawAtlasBench(false, true); )
+DEF_BENCH( return new DrawAtlasBench(true,  true); )
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBlurMaskFilter.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkPaint.h"
+#include "SkString.h"
+#include "SkSurface.h"
+
+// Draws the soft content that bands in 8888 -- a translucent radial gradient and blurred
+// circles -- to a raster N32 surface, blending as usual, or in linear light with
+// SkSurfaceProps::kGammaCorrect_Flag, with or without dither.
+class GammaCorrectBench : public Benchmark {
+public:
+    enum Content { kGradient_Content, kBlur_Content };
+    enum Blend   { kLegacy_Blend, kGammaCorrect_Blend, kGammaCorrectDither_Blend };
+
+    GammaCorrectBench(Content content, Blend blend) : fContent(content), fBlend(blend) {
+        static const char* kContentNames[] = { "gradient", "blur" };
+        static const char* kBlendNames[]   = { "legacy", "gammacorrect", "gammacorrect_dither" };
+        fName.printf("gammacorrect_%s_%s", kContentNames[content], kBlendNames[blend]);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        const uint32_t flags = kLegacy_Blend == fBlend ? 0 : SkSurfaceProps::kGammaCorrect_Flag;
+        const SkSurfaceProps props(flags, kUnknown_SkPixelGeometry);
+        fSurface.reset(SkSurface::NewRaster(SkImageInfo::MakeN32Premul(kSize, kSize), &props));
+
+        fPaint.setAntiAlias(true);
+        fPaint.setDither(kGammaCorrectDither_Blend == fBlend);
+        if (kGradient_Content == fContent) {
+            const SkColor colors[] = { 0xC0204080, 0x00204080 };
+            fPaint.setShader(SkGradientShader::CreateRadial(SkPoint::Make(kSize/2, kSize/2),
+                                                            kSize/2, colors, nullptr, 2,
+                                                            SkShader::kClamp_TileMode))->unref();
+        } else {
+            fPaint.setColor(0xC0204080);
+            fPaint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, 8))->unref();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+        for (int i = 0; i < loops; ++i) {
+            canvas->clear(SK_ColorWHITE);
+            if (kGradient_Content == fContent) {
+                canvas->drawPaint(fPaint);
+            } else {
+                for (int j = 0; j < 4; ++j) {
+                    canvas->drawCircle(kSize/4 + (j & 1) * kSize/2, kSize/4 + (j >> 1) * kSize/2,
+                                       kSize/5, fPaint);
+                }
+            }
+        }
+    }
+
+private:
+    static const int kSize = 256;
+
+    Content                 fContent;
+    Blend                   fBlend;
+    SkString                fName;
+    SkPaint                 fPaint;
+    SkAutoTUnref<SkSurface> fSurface;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new GammaCorrectBench(GammaCorrectBench::kGradient_Content,
+                                        GammaCorrectBench::kLegacy_Blend); )
+DEF_BENCH( return new GammaCorrectBench(GammaCorrectBench::kGradient_Content,
+                                        GammaCorrectBench::kGammaCorrect_Blend); )
+DEF_BENCH( return new GammaCorrectBench(GammaCorrectBench::kGradient_Content,
+                                        GammaCorrectBench::kGammaCorrectDither_Blend); )
+DEF_BENCH( return new GammaCorrectBench(GammaCorrectBench::kBlur_Content,
+                                        GammaCorrectBench::kLegacy_Blend); )
+DEF_BENCH( return new GammaCorrectBench(GammaCorrectBench::kBlur_Content,
+                                        GammaCorrectBench::kGammaCorrect_Blend); )
+DEF_BENCH( return new GammaCorrectBench(GammaCorrectBench::kBlur_Content,
+                                        GammaCorrectBench::kGammaCorrectDither_Blend); )
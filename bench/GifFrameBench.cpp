@@ -0,0 +1,113 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkData.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+
+/**
+ *  Decodes the frames of an animated GIF:
+ *    play:   each frame in order, drawn on top of the last, as an animation would.
+ *    seek:   random frames with one codec, so that keyframe snapshots can be reused.
+ *    replay: random frames with a new codec each time, replaying from the first frame.
+ */
+class GifFrameBench : public Benchmark {
+public:
+    enum Mode {
+        kPlay_Mode,
+        kSeek_Mode,
+        kReplay_Mode,
+    };
+
+    GifFrameBench(const char* resource, Mode mode)
+        : fResource(resource)
+        , fMode(mode)
+    {
+        static const char* kModeNames[] = { "play", "seek", "replay" };
+        fName.printf("GifFrame_%s_%s", resource, kModeNames[mode]);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkAutoTDelete<SkStreamAsset> stream(GetResourceAsStream(fResource));
+        if (!stream) {
+            return;
+        }
+        fData.reset(SkData::NewFromStream(stream, stream->getLength()));
+        fCodec.reset(SkCodec::NewFromData(fData));
+        if (!fCodec) {
+            return;
+        }
+        fFrameCount = fCodec->getFrameCount();
+        fBitmap.allocPixels(fCodec->getInfo().makeColorType(kN32_SkColorType));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fCodec) {
+            return;
+        }
+        SkRandom rand;
+        SkCodec::Options options;
+        for (int i = 0; i < loops; i++) {
+            switch (fMode) {
+                case kPlay_Mode:
+                    for (int frame = 0; frame < fFrameCount; frame++) {
+                        options.fFrameIndex = frame;
+                        options.fPriorFrame = frame - 1;
+                        this->decode(fCodec, options);
+                    }
+                    break;
+                case kSeek_Mode:
+                    options.fFrameIndex = rand.nextULessThan(fFrameCount);
+                    this->decode(fCodec, options);
+                    break;
+                case kReplay_Mode: {
+                    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fData));
+                    options.fFrameIndex = rand.nextULessThan(fFrameCount);
+                    this->decode(codec, options);
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    void decode(SkCodec* codec, const SkCodec::Options& options) {
+#ifdef SK_DEBUG
+        const SkCodec::Result result =
+#endif
+        codec->getPixels(fBitmap.info(), fBitmap.getPixels(), fBitmap.rowBytes(), &options,
+                         nullptr, nullptr);
+        SkASSERT(SkCodec::kSuccess == result || SkCodec::kIncompleteInput == result);
+    }
+
+    const char*             fResource;
+    const Mode              fMode;
+    SkString                fName;
+    SkAutoTUnref<SkData>    fData;
+    SkAutoTDelete<SkCodec>  fCodec;
+    int                     fFrameCount;
+    SkBitmap                fBitmap;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new GifFrameBench("test640x479.gif", GifFrameBench::kPlay_Mode);)
+DEF_BENCH(return new GifFrameBench("test640x479.gif", GifFrameBench::kSeek_Mode);)
+DEF_BENCH(return new GifFrameBench("test640x479.gif", GifFrameBench::kReplay_Mode);)
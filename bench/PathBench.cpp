@@ -214,6 +214,37 @@ private:
     typedef PathBench INHERITED;
 };
 
+// A star of a few thousand spikes, whose fill is dominated by building, sorting and walking
+// its edges rather than by blitting.
+class StarPathBench : public PathBench {
+public:
+    StarPathBench(Flags flags) : INHERITED(flags) {}
+
+    void appendName(SkString* name) override {
+        name->append("star");
+    }
+    void makePath(SkPath* path) override {
+        const int kSpikes = 2000;
+        const SkScalar cx = SkIntToScalar(320);
+        const SkScalar cy = SkIntToScalar(240);
+        for (int i = 0; i < 2 * kSpikes; i++) {
+            const SkScalar radius = SkIntToScalar(i & 1 ? 60 : 230);
+            const SkScalar radians = SK_ScalarPI * i / kSpikes;
+            const SkPoint pt = SkPoint::Make(cx + radius * SkScalarCos(radians),
+                                             cy + radius * SkScalarSin(radians));
+            if (0 == i) {
+                path->moveTo(pt);
+            } else {
+                path->lineTo(pt);
+            }
+        }
+        path->close();
+    }
+    int complexity() override { return 2; }
+private:
+    typedef PathBench INHERITED;
+};
+
 class RandomPathBench : public Benchmark {
 public:
     bool isSuitableFor(Backend backend) override {
@@ -1020,6 +1051,7 @@ DEF_BENCH( return new LongCurvedPathBench(FLAGS00); )
 DEF_BENCH( return new LongCurvedPathBench(FLAGS01); )
 DEF_BENCH( return new LongLinePathBench(FLAGS00); )
 DEF_BENCH( return new LongLinePathBench(FLAGS01); )
+DEF_BENCH( return new StarPathBench(FLAGS00); )
 
 DEF_BENCH( return new PathCreateBench(); )
 DEF_BENCH( return new PathCopyBench(); )
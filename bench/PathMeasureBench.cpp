@@ -0,0 +1,68 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkPath.h"
+#include "SkPathMeasure.h"
+#include "SkString.h"
+
+// Lays a line of glyphs out along a wavy path each frame, as drawTextOnPath does, with a new
+// SkPathMeasure each time. A volatile path is measured afresh every frame; others find their
+// contours in the resource cache. The glyphs are placed with getPosTans(), or one getPosTan()
+// each.
+class PathMeasureBench : public Benchmark {
+public:
+    PathMeasureBench(bool isVolatile, bool batch) : fBatch(batch) {
+        fName.printf("path_measure_text_layout_%s_%s", isVolatile ? "volatile" : "cached",
+                     batch ? "batch" : "single");
+        fPath.moveTo(0, 0);
+        for (int i = 0; i < 64; ++i) {
+            fPath.cubicTo(SkIntToScalar(20 * i + 5), 30, SkIntToScalar(20 * i + 15), -30,
+                          SkIntToScalar(20 * i + 20), 0);
+        }
+        fPath.setIsVolatile(isVolatile);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkScalar distances[kGlyphs];
+        SkPoint positions[kGlyphs];
+        SkVector tangents[kGlyphs];
+        for (int i = 0; i < loops; ++i) {
+            SkPathMeasure meas(fPath, false);
+            const SkScalar advance = meas.getLength() / kGlyphs;
+            for (int j = 0; j < kGlyphs; ++j) {
+                distances[j] = j * advance;
+            }
+            if (fBatch) {
+                (void) meas.getPosTans(distances, kGlyphs, positions, tangents);
+            } else {
+                for (int j = 0; j < kGlyphs; ++j) {
+                    (void) meas.getPosTan(distances[j], &positions[j], &tangents[j]);
+                }
+            }
+        }
+    }
+
+private:
+    static const int kGlyphs = 200;
+
+    bool     fBatch;
+    SkString fName;
+    SkPath   fPath;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathMeasureBench(true, false); )
+DEF_BENCH( return new PathMeasureBench(true, true); )
+DEF_BENCH( return new PathMeasureBench(false, false); )
+DEF_BENCH( return new PathMeasureBench(false, true); )
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// Unions a map-like scatter of small polygons, some overlapping their neighbors and some not,
+// either with SkOpBuilder or by calling Op() once per polygon.
+class PathOpsBuilderBench : public Benchmark {
+public:
+    PathOpsBuilderBench(int count, bool builder) : fCount(count), fBuilder(builder) {
+        fName.printf("pathops_union_%d_%s", count, builder ? "builder" : "op");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        const int columns = SkScalarCeilToInt(SkScalarSqrt(SkIntToScalar(fCount)));
+        for (int i = 0; i < fCount; ++i) {
+            const SkScalar x = SkIntToScalar(i % columns * 30) + rand.nextRangeF(0, 20);
+            const SkScalar y = SkIntToScalar(i / columns * 30) + rand.nextRangeF(0, 20);
+            SkPath& path = fPaths.push_back();
+            path.moveTo(x, y);
+            const int sides = 3 + rand.nextULessThan(5);
+            for (int side = 1; side < sides; ++side) {
+                const SkScalar radians = 2 * SK_ScalarPI * side / sides;
+                const SkScalar radius = rand.nextRangeF(10, 25);
+                path.lineTo(x + radius * SkScalarCos(radians), y + radius * SkScalarSin(radians));
+            }
+            path.close();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkPath result;
+            if (fBuilder) {
+                SkOpBuilder builder;
+                for (int index = 0; index < fPaths.count(); ++index) {
+                    builder.add(fPaths[index], kUnion_SkPathOp);
+                }
+                builder.resolve(&result);
+            } else {
+                for (int index = 0; index < fPaths.count(); ++index) {
+                    Op(result, fPaths[index], kUnion_SkPathOp, &result);
+                }
+            }
+        }
+    }
+
+private:
+    int              fCount;
+    bool             fBuilder;
+    SkString         fName;
+    SkTArray<SkPath> fPaths;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathOpsBuilderBench(100, true); )
+DEF_BENCH( return new PathOpsBuilderBench(100, false); )
+DEF_BENCH( return new PathOpsBuilderBench(1000, true); )
+DEF_BENCH( return new PathOpsBuilderBench(1000, false); )
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// A stream of small ops, like hit-testing a handful of shapes against a clip, made either with
+// Op() and Simplify(), or through one SkPathOpsContext that keeps its memory between calls.
+class PathOpsSmallBench : public Benchmark {
+public:
+    PathOpsSmallBench(bool context) : fUseContext(context) {
+        fName.printf("pathops_small_%s", context ? "context" : "op");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < kCount; ++i) {
+            const SkScalar x = rand.nextRangeF(0, 80);
+            const SkScalar y = rand.nextRangeF(0, 80);
+            fShapes[i].moveTo(x, y);
+            fShapes[i].lineTo(x + rand.nextRangeF(10, 40), y + rand.nextRangeF(-10, 10));
+            fShapes[i].lineTo(x + rand.nextRangeF(-10, 10), y + rand.nextRangeF(10, 40));
+            fShapes[i].close();
+            fShapes[i].addCircle(x, y, rand.nextRangeF(5, 15));
+        }
+        fClip.addRoundRect(SkRect::MakeLTRB(20, 20, 90, 90), 10, 10);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPathOpsContext context;
+        SkPath result;
+        for (int i = 0; i < loops; ++i) {
+            for (int j = 0; j < kCount; ++j) {
+                if (fUseContext) {
+                    context.simplify(fShapes[j], &result);
+                    context.op(fShapes[j], fClip, kIntersect_SkPathOp, &result);
+                } else {
+                    Simplify(fShapes[j], &result);
+                    Op(fShapes[j], fClip, kIntersect_SkPathOp, &result);
+                }
+            }
+        }
+    }
+
+private:
+    static const int kCount = 16;
+
+    bool     fUseContext;
+    SkString fName;
+    SkPath   fShapes[kCount];
+    SkPath   fClip;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathOpsSmallBench(false); )
+DEF_BENCH( return new PathOpsSmallBench(true); )
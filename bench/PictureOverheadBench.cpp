@@ -9,8 +9,11 @@
 // We record an empty picture and a picture with one draw op to force memory allocation.
 
 #include "Benchmark.h"
+#include "SkBBHFactory.h"
 #include "SkCanvas.h"
 #include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkString.h"
 
 template <bool kDraw>
 struct PictureOverheadBench : public Benchmark {
@@ -33,3 +36,48 @@ struct PictureOverheadBench : public Benchmark {
 
 DEF_BENCH(return (new PictureOverheadBench<false>);)
 DEF_BENCH(return (new PictureOverheadBench< true>);)
+
+// The per-op overhead of playing back a picture of many tiny draws, through an R-tree, into a
+// canvas that sees only a corner of it, either scaled or rotated.
+struct PicturePlaybackOverheadBench : public Benchmark {
+    PicturePlaybackOverheadBench(bool rotate) : fRotate(rotate) {
+        fName.printf("picture_overhead_playback_%s", rotate ? "rotate" : "scale");
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkRTreeFactory factory;
+        SkPictureRecorder rec;
+        SkCanvas* canvas = rec.beginRecording(SkRect::MakeWH(2000, 2000), &factory);
+        SkRandom rand;
+        SkPaint paint;
+        for (int i = 0; i < 20000; i++) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas->drawRect(SkRect::MakeXYWH(rand.nextRangeF(0, 2000), rand.nextRangeF(0, 2000),
+                                              4, 4), paint);
+        }
+        fPicture.reset(rec.endRecordingAsPicture());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas canvas(256, 256);
+        canvas.scale(0.5f, 0.5f);
+        if (fRotate) {
+            canvas.translate(256, 256);
+            canvas.rotate(45);
+            canvas.translate(-256, -256);
+        }
+        for (int i = 0; i < loops; i++) {
+            canvas.drawPicture(fPicture);
+        }
+    }
+
+    bool                    fRotate;
+    SkString                fName;
+    SkAutoTUnref<SkPicture> fPicture;
+};
+
+DEF_BENCH(return (new PicturePlaybackOverheadBench(false));)
+DEF_BENCH(return (new PicturePlaybackOverheadBench( true));)
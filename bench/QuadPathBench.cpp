@@ -0,0 +1,81 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkRRect.h"
+#include "SkString.h"
+#include "SkSurfaceProps.h"
+
+// A map-like scene of rounded blocks with circular plazas and curvy parks, filled again each
+// loop at a slightly larger zoom, into a raster canvas that either cuts each path's conics into
+// quads as it draws it or reuses quads cut for a nearby scale from the resource cache.
+class QuadPathBench : public Benchmark {
+public:
+    QuadPathBench(bool cache) : fCache(cache) {
+        fName.printf("quad_path_zoom_%s", cache ? "cache" : "nocache");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < kCount; ++i) {
+            const SkScalar cx = SkIntToScalar(i % 8 * 64 + 32);
+            const SkScalar cy = SkIntToScalar(i / 8 * 64 + 32);
+            SkPath& path = fPaths[i];
+            path.addRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(cx - 28, cy - 24, cx + 28, cy + 24),
+                                              rand.nextRangeF(4, 12), rand.nextRangeF(4, 12)));
+            path.addCircle(cx + rand.nextRangeF(-8, 8), cy + rand.nextRangeF(-8, 8),
+                           rand.nextRangeF(4, 10), SkPath::kCCW_Direction);
+            path.moveTo(cx - 20, cy + 16);
+            path.cubicTo(cx - 10, cy - 20, cx + 10, cy + 20, cx + 20, cy - 16);
+            path.quadTo(cx, cy + 30, cx - 20, cy + 16);
+            path.close();
+        }
+
+        fBitmap.allocN32Pixels(kSize, kSize);
+        const uint32_t flags = fCache ? SkSurfaceProps::kCacheConicQuads_Flag : 0;
+        fCanvas.reset(new SkCanvas(fBitmap, SkSurfaceProps(flags, kUnknown_SkPixelGeometry)));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < loops; ++i) {
+            // Zoom in by 1% a frame, from 1x to 4x, then start over.
+            const SkScalar zoom = SkScalarPow(1.01f, SkIntToScalar(i % 140));
+            fCanvas->save();
+            fCanvas->scale(zoom, zoom);
+            for (int j = 0; j < kCount; ++j) {
+                paint.setColor(0xFF000000 | (j * 0x3F2D1B));
+                fCanvas->drawPath(fPaths[j], paint);
+            }
+            fCanvas->restore();
+        }
+    }
+
+private:
+    static const int kCount = 64;
+    static const int kSize  = 512;
+
+    bool                    fCache;
+    SkString                fName;
+    SkPath                  fPaths[kCount];
+    SkBitmap                fBitmap;
+    SkAutoTDelete<SkCanvas> fCanvas;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new QuadPathBench(false); )
+DEF_BENCH( return new QuadPathBench(true); )
@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkRandom.h"
+#include "SkString.h"
 
 class QuickRejectBench : public Benchmark {
     enum { N = 1000000 };
@@ -38,6 +39,55 @@ class QuickRejectBench : public Benchmark {
 };
 DEF_BENCH( return new QuickRejectBench; )
 
+// Many small rects, tested one at a time or all at once, under a scale or a rotation.
+class QuickRejectArrayBench : public Benchmark {
+    enum { N = 100000 };
+    SkRect   fRects[N];
+    bool     fRejected[N];
+    bool     fArray;
+    bool     fRotate;
+    SkString fName;
+
+public:
+    QuickRejectArrayBench(bool array, bool rotate) : fArray(array), fRotate(rotate) {
+        fName.printf("quick_reject_%s_%s", rotate ? "rotate" : "scale", array ? "array" : "each");
+    }
+
+private:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend != kNonRendering_Backend; }
+
+    void onDelayedSetup() override  {
+        SkRandom rand;
+        for (int i = 0; i < N; ++i) {
+            fRects[i] = SkRect::MakeXYWH(rand.nextRangeF(-300, 600), rand.nextRangeF(-300, 600),
+                                         rand.nextRangeF(1, 10), rand.nextRangeF(1, 10));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        canvas->save();
+        canvas->scale(1.5f, 1.5f);
+        if (fRotate) {
+            canvas->rotate(30);
+        }
+        while (loops --> 0) {
+            if (fArray) {
+                canvas->quickReject(fRects, N, fRejected);
+            } else {
+                for (int i = 0; i < N; i++) {
+                    fRejected[i] = canvas->quickReject(fRects[i]);
+                }
+            }
+        }
+        canvas->restore();
+    }
+};
+DEF_BENCH( return new QuickRejectArrayBench(false, false); )
+DEF_BENCH( return new QuickRejectArrayBench(true, false); )
+DEF_BENCH( return new QuickRejectArrayBench(false, true); )
+DEF_BENCH( return new QuickRejectArrayBench(true, true); )
+
 class ConcatBench : public Benchmark {
     SkMatrix fMatrix;
 
@@ -9,6 +9,7 @@
 #include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 
 static bool union_proc(SkRegion& a, SkRegion& b) {
     SkRegion result;
@@ -130,3 +131,53 @@ DEF_BENCH(return new RegionBench(SMALL, containsrect_proc, "containsrect");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrgn_proc, "intersectsrgn");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrect_proc, "intersectsrect");)
 DEF_BENCH(return new RegionBench(SMALL, containsxy_proc, "containsxy");)
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Damage tracking: gather many small invalidated rects into one region, either
+// with setRects() or by growing a region in place one op() at a time.
+class RegionRectsBench : public Benchmark {
+public:
+    RegionRectsBench(int count, bool setRects) : fSetRects(setRects) {
+        fName.printf("region_%s_%d", setRects ? "setrects" : "unionrects", count);
+
+        SkRandom rand;
+        for (int i = 0; i < count; i++) {
+            const int x = rand.nextULessThan(2048);
+            const int y = rand.nextULessThan(2048);
+            fRects.append()->setXYWH(x, y, 1 + rand.nextULessThan(32),
+                                           1 + rand.nextULessThan(32));
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkRegion rgn;
+            if (fSetRects) {
+                rgn.setRects(fRects.begin(), fRects.count());
+            } else {
+                for (int j = 0; j < fRects.count(); j++) {
+                    rgn.op(fRects[j], SkRegion::kUnion_Op);
+                }
+            }
+        }
+    }
+
+private:
+    bool               fSetRects;
+    SkString           fName;
+    SkTDArray<SkIRect> fRects;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new RegionRectsBench(1000, true);)
+DEF_BENCH(return new RegionRectsBench(1000, false);)
+DEF_BENCH(return new RegionRectsBench(10000, true);)
@@ -15,6 +15,14 @@ static bool sect_proc(SkRegion& a, SkRegion& b) {
     return result.op(a, b, SkRegion::kIntersect_Op);
 }
 
+// Clip a rect out of the middle of a, then put it back, in place.
+static bool diffunion_proc(SkRegion& a, SkRegion& b) {
+    SkIRect r = b.getBounds();
+    r.inset(r.width()/4, r.height()/4);
+    a.op(r, SkRegion::kDifference_Op);
+    return a.op(r, SkRegion::kUnion_Op);
+}
+
 class RegionContainBench : public Benchmark {
 public:
     typedef bool (*Proc)(SkRegion& a, SkRegion& b);
@@ -22,23 +30,28 @@ public:
     Proc     fProc;
     SkString fName;
 
+    int fCount;
+
     enum {
         W = 200,
         H = 200,
-        COUNT = 10,
     };
 
     SkIRect randrect(SkRandom& rand, int i) {
         int w = rand.nextU() % W;
-        return SkIRect::MakeXYWH(0, i*H/COUNT, w, H/COUNT);
+        return SkIRect::MakeXYWH(0, i*H/fCount, w, H/fCount);
     }
 
-    RegionContainBench(Proc proc, const char name[])  {
+    RegionContainBench(Proc proc, const char name[], int count = 10)  {
         fProc = proc;
+        fCount = count;
         fName.printf("region_contains_%s", name);
+        if (count != 10) {
+            fName.appendf("_%d", count);
+        }
 
         SkRandom rand;
-        for (int i = 0; i < COUNT; i++) {
+        for (int i = 0; i < fCount; i++) {
             fA.op(randrect(rand, i), SkRegion::kXOR_Op);
         }
 
@@ -65,3 +78,5 @@ private:
 };
 
 DEF_BENCH(return new RegionContainBench(sect_proc, "sect");)
+DEF_BENCH(return new RegionContainBench(diffunion_proc, "diffunion");)
+DEF_BENCH(return new RegionContainBench(diffunion_proc, "diffunion", 200);)
@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkColorShader.h"
+#include "SkGradientShader.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkString.h"
@@ -36,19 +37,32 @@ class ShaderMaskBench : public Benchmark {
     SkString    fText;
     SkString    fName;
     FontQuality fFQ;
+    bool        fGradient;
 public:
-    ShaderMaskBench(bool isOpaque, FontQuality fq)  {
+    ShaderMaskBench(bool isOpaque, FontQuality fq, bool gradient = false)  {
         fFQ = fq;
+        fGradient = gradient;
         fText.set(STR);
 
         fPaint.setAntiAlias(kBW != fq);
         fPaint.setLCDRenderText(kLCD == fq);
-        fPaint.setShader(new SkColorShader(isOpaque ? 0xFFFFFFFF : 0x80808080))->unref();
+        if (gradient) {
+            const SkPoint pts[] = { { 0, 0 }, { 640, 0 } };
+            const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+            fPaint.setShader(SkGradientShader::CreateLinear(pts, colors, nullptr, 2,
+                                                            SkShader::kClamp_TileMode))->unref();
+            fPaint.setAlpha(isOpaque ? 0xFF : 0x80);
+        } else {
+            fPaint.setShader(new SkColorShader(isOpaque ? 0xFFFFFFFF : 0x80808080))->unref();
+        }
     }
 
 protected:
     virtual const char* onGetName() {
         fName.printf("shadermask");
+        if (fGradient) {
+            fName.append("_gradient");
+        }
         fName.appendf("_%s", fontQualityName(fPaint));
         fName.appendf("_%02X", fPaint.getAlpha());
         return fName.c_str();
@@ -95,3 +109,7 @@ DEF_BENCH( return new ShaderMaskBench(true,  kAA); )
 DEF_BENCH( return new ShaderMaskBench(false, kAA); )
 DEF_BENCH( return new ShaderMaskBench(true,  kLCD); )
 DEF_BENCH( return new ShaderMaskBench(false, kLCD); )
+DEF_BENCH( return new ShaderMaskBench(true,  kBW,  true); )
+DEF_BENCH( return new ShaderMaskBench(false, kBW,  true); )
+DEF_BENCH( return new ShaderMaskBench(true,  kAA,  true); )
+DEF_BENCH( return new ShaderMaskBench(false, kAA,  true); )
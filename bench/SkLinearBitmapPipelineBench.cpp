@@ -145,7 +145,7 @@ struct SkBitmapFPGeneral final : public CommonBitmapFPBenchmark {
         SkPixmap srcPixmap{fInfo, fBitmap.get(), static_cast<size_t>(4 * width)};
 
         SkLinearBitmapPipeline pipeline{
-            fInvert, filterQuality, fXTile, fYTile, srcPixmap};
+            fInvert, filterQuality, fXTile, fYTile, SK_ColorBLACK, srcPixmap};
 
         int count = 100;
 
@@ -213,6 +213,43 @@ struct SkBitmapFPOrigShader : public CommonBitmapFPBenchmark {
     SkAutoTUnref<SkImage> fImage;
 };
 
+// The bitmap shader as SkPM4f clients see it, which is the pipeline behind a shader context.
+struct SkBitmapFPShader4f final : public SkBitmapFPOrigShader {
+    SkBitmapFPShader4f(
+        SkISize srcSize,
+        SkColorProfileType colorProfile,
+        SkMatrix m,
+        bool useBilerp,
+        SkShader::TileMode xTile,
+        SkShader::TileMode yTile)
+            : SkBitmapFPOrigShader(srcSize, colorProfile, m, useBilerp, xTile, yTile) { }
+
+    SkString BaseName() override {
+        SkString name{"Shader4f"};
+        return name;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        int width = fSrcSize.fWidth;
+        int height = fSrcSize.fHeight;
+
+        SkAutoTMalloc<SkPM4f> FPbuffer(width*height);
+
+        const SkShader::ContextRec rec(fPaint, fM, nullptr,
+                                       SkShader::ContextRec::kPM4f_DstType);
+        SkAutoMalloc storage(fPaint.getShader()->contextSize(rec));
+        SkShader::Context* ctx = fPaint.getShader()->createContext(rec, storage.get());
+
+        int count = 100;
+
+        for (int n = 0; n < 1000*loops; n++) {
+            ctx->shadeSpan4f(3, 6, FPbuffer, count);
+        }
+
+        ctx->~Context();
+    }
+};
+
 static SkISize srcSize = SkISize::Make(120, 100);
 static SkMatrix mI = SkMatrix::I();
 DEF_BENCH(return new SkBitmapFPGeneral(
@@ -227,6 +264,10 @@ DEF_BENCH(return new SkBitmapFPOrigShader(
     srcSize, kLinear_SkColorProfileType, mI, false,
     SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
 
+DEF_BENCH(return new SkBitmapFPShader4f(
+    srcSize, kLinear_SkColorProfileType, mI, false,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
+
 DEF_BENCH(return new SkBitmapFPGeneral(
     srcSize, kSRGB_SkColorProfileType, mI, true,
     SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
@@ -239,6 +280,10 @@ DEF_BENCH(return new SkBitmapFPOrigShader(
     srcSize, kLinear_SkColorProfileType, mI, true,
     SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
 
+DEF_BENCH(return new SkBitmapFPShader4f(
+    srcSize, kLinear_SkColorProfileType, mI, true,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
+
 static SkMatrix mS = SkMatrix::MakeScale(2.7f, 2.7f);
 DEF_BENCH(return new SkBitmapFPGeneral(
     srcSize, kSRGB_SkColorProfileType, mS, false,
@@ -252,6 +297,10 @@ DEF_BENCH(return new SkBitmapFPOrigShader(
     srcSize, kLinear_SkColorProfileType, mS, false,
     SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
 
+DEF_BENCH(return new SkBitmapFPShader4f(
+    srcSize, kLinear_SkColorProfileType, mS, false,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
+
 DEF_BENCH(return new SkBitmapFPGeneral(
     srcSize, kSRGB_SkColorProfileType, mS, true,
     SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
@@ -264,6 +313,10 @@ DEF_BENCH(return new SkBitmapFPOrigShader(
     srcSize, kLinear_SkColorProfileType, mS, true,
     SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
 
+DEF_BENCH(return new SkBitmapFPShader4f(
+    srcSize, kLinear_SkColorProfileType, mS, true,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
+
 static SkMatrix rotate(SkScalar r) {
     SkMatrix m;
     m.setRotate(30);
@@ -283,6 +336,10 @@ DEF_BENCH(return new SkBitmapFPOrigShader(
     srcSize, kLinear_SkColorProfileType, mR, false,
     SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
 
+DEF_BENCH(return new SkBitmapFPShader4f(
+    srcSize, kLinear_SkColorProfileType, mR, false,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
+
 DEF_BENCH(return new SkBitmapFPGeneral(
     srcSize, kSRGB_SkColorProfileType, mR, true,
     SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
@@ -295,3 +352,32 @@ DEF_BENCH(return new SkBitmapFPOrigShader(
     srcSize, kLinear_SkColorProfileType, mR, true,
     SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
 
+DEF_BENCH(return new SkBitmapFPShader4f(
+    srcSize, kLinear_SkColorProfileType, mR, true,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
+
+
+static SkMatrix mT = SkMatrix::MakeTrans(-37.5f, 11.25f);
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, kLinear_SkColorProfileType, mT, false,
+    SkShader::kRepeat_TileMode, SkShader::kRepeat_TileMode);)
+
+DEF_BENCH(return new SkBitmapFPOrigShader(
+    srcSize, kLinear_SkColorProfileType, mT, false,
+    SkShader::kRepeat_TileMode, SkShader::kRepeat_TileMode);)
+
+DEF_BENCH(return new SkBitmapFPShader4f(
+    srcSize, kLinear_SkColorProfileType, mT, false,
+    SkShader::kRepeat_TileMode, SkShader::kRepeat_TileMode);)
+
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, kLinear_SkColorProfileType, mS, true,
+    SkShader::kMirror_TileMode, SkShader::kRepeat_TileMode);)
+
+DEF_BENCH(return new SkBitmapFPOrigShader(
+    srcSize, kLinear_SkColorProfileType, mS, true,
+    SkShader::kMirror_TileMode, SkShader::kRepeat_TileMode);)
+
+DEF_BENCH(return new SkBitmapFPShader4f(
+    srcSize, kLinear_SkColorProfileType, mS, true,
+    SkShader::kMirror_TileMode, SkShader::kRepeat_TileMode);)
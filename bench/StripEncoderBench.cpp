@@ -0,0 +1,117 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkImageEncoder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+
+/**
+ *  Compares SkImageEncoder::EncodeData() against the strip encoders at each preset.
+ *
+ *  Each loop encodes the number of MB of pixels in the name, so MB/s is (1000 * MB / ms).
+ *  Encoding takes too long to do for every bench we construct, so the encoded size is only
+ *  known once the bench is set up.  From then on the unique name ends with it in KB, e.g.
+ *  StripEncoder_png_fast_16MB_to_1065KB, so match on the name without it.
+ */
+class StripEncoderBench : public Benchmark {
+public:
+    // A negative preset means the plain, non-strip encoder.
+    StripEncoderBench(SkImageEncoder::Type type, int preset)
+        : fType(type)
+        , fPreset(preset)
+    {
+        static const char* kPresetNames[] = { "fast", "default", "small" };
+        fName.printf("StripEncoder_%s_%s_%dMB", SkImageEncoder::kPNG_Type == type ? "png" : "jpeg",
+                     preset < 0 ? "serial" : kPresetNames[preset],
+                     kSize * kSize * 4 / (1024 * 1024));
+        fUniqueName = fName;
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+protected:
+    enum {
+        kSize = 2048,
+    };
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    const char* onGetUniqueName() override {
+        return fUniqueName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        // Something photo-like: a smooth gradient under a scattering of soft shapes.
+        fBitmap.allocN32Pixels(kSize, kSize, true);
+        SkCanvas canvas(fBitmap);
+        const SkPoint pts[] = { { 0, 0 }, { SkIntToScalar(kSize), SkIntToScalar(kSize) } };
+        const SkColor colors[] = { SK_ColorBLUE, SK_ColorYELLOW, SK_ColorRED };
+        SkPaint paint;
+        paint.setShader(SkGradientShader::CreateLinear(pts, colors, nullptr, 3,
+                                                       SkShader::kClamp_TileMode))->unref();
+        canvas.drawPaint(paint);
+
+        SkRandom rand;
+        paint.setShader(nullptr);
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 500; i++) {
+            paint.setColor(rand.nextU() & 0x80FFFFFF);
+            canvas.drawCircle(rand.nextRangeScalar(0, kSize), rand.nextRangeScalar(0, kSize),
+                              rand.nextRangeScalar(8, 128), paint);
+        }
+
+        SkDynamicMemoryWStream stream;
+        this->encode(&stream);
+        fUniqueName.printf("%s_to_%dKB", fName.c_str(), (int) (stream.bytesWritten() / 1024));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkDynamicMemoryWStream stream;
+            this->encode(&stream);
+        }
+    }
+
+private:
+    void encode(SkWStream* stream) {
+        if (fPreset < 0) {
+            SkAssertResult(SkImageEncoder::EncodeStream(stream, fBitmap, fType, 90));
+            return;
+        }
+        SkAutoLockPixels alp(fBitmap);
+        SkPixmap pixmap;
+        SkAssertResult(fBitmap.peekPixels(&pixmap));
+        SkImageEncoder::StripOptions options;
+        options.fPreset = (SkImageEncoder::Preset)fPreset;
+        SkAssertResult(SkImageEncoder::EncodeStrips(stream, pixmap, fType, 90, options));
+    }
+
+    SkImageEncoder::Type    fType;
+    int                     fPreset;
+    SkString                fName;
+    SkString                fUniqueName;
+    SkBitmap                fBitmap;
+
+    typedef Benchmark INHERITED;
+};
+
+#define ENCODER_BENCHES(type)                                                          \
+    DEF_BENCH(return new StripEncoderBench(type, -1);)                                 \
+    DEF_BENCH(return new StripEncoderBench(type, SkImageEncoder::kFast_Preset);)       \
+    DEF_BENCH(return new StripEncoderBench(type, SkImageEncoder::kDefault_Preset);)    \
+    DEF_BENCH(return new StripEncoderBench(type, SkImageEncoder::kSmall_Preset);)
+
+ENCODER_BENCHES(SkImageEncoder::kPNG_Type)
+ENCODER_BENCHES(SkImageEncoder::kJPEG_Type)
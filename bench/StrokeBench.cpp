@@ -6,6 +6,8 @@
  */
 
 #include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkDashPathEffect.h"
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkRandom.h"
@@ -94,11 +96,24 @@ static SkPath cubic_path_maker() {
     return path;
 }
 
-static SkPaint paint_maker() {
+// A long GPS trace-like random walk.
+static SkPath polyline_path_maker() {
+    SkPath path;
+    SkRandom rand;
+    SkPoint pt = SkPoint::Make(0, 0);
+    path.moveTo(pt);
+    for (int i = 0; i < 100000; ++i) {
+        pt.offset(rand.nextRangeF(-1, 3), rand.nextRangeF(-2, 2));
+        path.lineTo(pt);
+    }
+    return path;
+}
+
+static SkPaint paint_maker(SkPaint::Join join = SkPaint::kMiter_Join) {
     SkPaint paint;
     paint.setStyle(SkPaint::kStroke_Style);
     paint.setStrokeWidth(X / 10);
-    paint.setStrokeJoin(SkPaint::kMiter_Join);
+    paint.setStrokeJoin(join);
     paint.setStrokeCap(SkPaint::kSquare_Cap);
     return paint;
 }
@@ -117,3 +132,53 @@ DEF_BENCH(return new StrokeBench(line_path_maker(), paint_maker(), "line_.25", .
 DEF_BENCH(return new StrokeBench(quad_path_maker(), paint_maker(), "quad_.25", .25f);)
 DEF_BENCH(return new StrokeBench(conic_path_maker(), paint_maker(), "conic_.25", .25f);)
 DEF_BENCH(return new StrokeBench(cubic_path_maker(), paint_maker(), "cubic_.25", .25f);)
+
+DEF_BENCH(return new StrokeBench(polyline_path_maker(), paint_maker(), "polyline_100k", 1);)
+DEF_BENCH(return new StrokeBench(polyline_path_maker(), paint_maker(SkPaint::kRound_Join),
+                                 "polyline_100k", 1);)
+DEF_BENCH(return new StrokeBench(polyline_path_maker(), paint_maker(SkPaint::kBevel_Join),
+                                 "polyline_100k", 1);)
+
+// Draws the same stroked (and maybe dashed) path frame after frame, as charts and maps do.
+// Unless the path is volatile, every frame after the first finds its fill path in the cache.
+class DrawStrokeBench : public Benchmark {
+public:
+    DrawStrokeBench(const SkPath& path, const char pathType[], bool dashed, bool isVolatile)
+        : fPath(path), fPaint(paint_maker())
+    {
+        fPath.setIsVolatile(isVolatile);
+        fPaint.setStrokeWidth(2);
+        if (dashed) {
+            const SkScalar intervals[] = { 6, 3 };
+            fPaint.setPathEffect(SkDashPathEffect::Create(intervals, 2, 0))->unref();
+        }
+        fName.printf("draw_stroke_%s%s%s", pathType, dashed ? "_dashed" : "",
+                     isVolatile ? "_volatile" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint(fPaint);
+        this->setupPaint(&paint);
+
+        canvas->translate(X, Y);
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    SkPath      fPath;
+    SkPaint     fPaint;
+    SkString    fName;
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new DrawStrokeBench(line_path_maker(), "line", false, false);)
+DEF_BENCH(return new DrawStrokeBench(line_path_maker(), "line", false, true);)
+DEF_BENCH(return new DrawStrokeBench(line_path_maker(), "line", true, false);)
+DEF_BENCH(return new DrawStrokeBench(line_path_maker(), "line", true, true);)
+DEF_BENCH(return new DrawStrokeBench(cubic_path_maker(), "cubic", false, false);)
+DEF_BENCH(return new DrawStrokeBench(cubic_path_maker(), "cubic", false, true);)
@@ -6,6 +6,7 @@
  */
 
 #include "Benchmark.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
@@ -13,8 +14,8 @@
 #include "SkString.h"
 
 enum VertFlags {
-    kColors_VertFlag,
-    kTexture_VertFlag,
+    kColors_VertFlag  = 1 << 0,
+    kTexture_VertFlag = 1 << 1,
 };
 
 class VertBench : public Benchmark {
@@ -31,6 +32,8 @@ class VertBench : public Benchmark {
     SkPoint fPts[PTS];
     SkColor fColors[PTS];
     uint16_t fIdx[IDX];
+    unsigned fFlags;
+    SkAutoTUnref<SkShader> fShader;
 
     static void load_2_tris(uint16_t idx[], int x, int y, int rb) {
         int n = y * rb + x;
@@ -39,7 +42,7 @@ class VertBench : public Benchmark {
     }
 
 public:
-    VertBench() {
+    VertBench(unsigned flags) : fFlags(flags) {
         const SkScalar dx = SkIntToScalar(W) / COL;
         const SkScalar dy = SkIntToScalar(H) / COL;
 
@@ -73,17 +76,42 @@ public:
         }
 
         fName.set("verts");
+        if (fFlags & kTexture_VertFlag) {
+            fName.append("_texture");
+            if (fFlags & kColors_VertFlag) {
+                fName.append("_colors");
+            }
+        }
     }
 
 protected:
     virtual const char* onGetName() { return fName.c_str(); }
+    void onDelayedSetup() override {
+        if (fFlags & kTexture_VertFlag) {
+            SkBitmap bm;
+            bm.allocN32Pixels(64, 64);
+            SkRandom rand;
+            for (int y = 0; y < bm.height(); ++y) {
+                for (int x = 0; x < bm.width(); ++x) {
+                    *bm.getAddr32(x, y) = rand.nextU() | (0xFF << 24);
+                }
+            }
+            fShader.reset(SkShader::CreateBitmapShader(bm, SkShader::kRepeat_TileMode,
+                                                       SkShader::kRepeat_TileMode));
+        }
+    }
     virtual void onDraw(int loops, SkCanvas* canvas) {
         SkPaint paint;
         this->setupPaint(&paint);
+        paint.setShader(fShader);
+
+        // Texture the mesh with its own positions.
+        const SkPoint* texs = (fFlags & kTexture_VertFlag) ? fPts : nullptr;
+        const SkColor* colors = (!texs || (fFlags & kColors_VertFlag)) ? fColors : nullptr;
 
         for (int i = 0; i < loops; i++) {
             canvas->drawVertices(SkCanvas::kTriangles_VertexMode, PTS,
-                                 fPts, nullptr, fColors, nullptr, fIdx, IDX, paint);
+                                 fPts, texs, colors, nullptr, fIdx, IDX, paint);
         }
     }
 private:
@@ -92,4 +120,6 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH(return new VertBench();)
+DEF_BENCH(return new VertBench(kColors_VertFlag);)
+DEF_BENCH(return new VertBench(kTexture_VertFlag);)
+DEF_BENCH(return new VertBench(kColors_VertFlag | kTexture_VertFlag);)
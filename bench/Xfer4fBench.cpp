@@ -103,3 +103,22 @@ DEF_BENCH( return new XferD32Bench(SkXfermode::kSrcOver_Mode, "srcover", true,
 DEF_BENCH( return new XferD32Bench(SkXfermode::kSrcOver_Mode, "srcover", true,  F00 | USE_AA); )
 DEF_BENCH( return new XferD32Bench(SkXfermode::kSrcOver_Mode, "srcover", true,  F11 | USE_AA); )
 DEF_BENCH( return new XferD32Bench(SkXfermode::kSrcOver_Mode, "srcover", true,  F01 | USE_AA); )
+
+// The other modes go through inlined per-mode procs; the non-separable ones blend 4 at a time.
+#define MODE_BENCH(mode, name)                                                  \
+    DEF_BENCH( return new XferD32Bench(mode, name, false, F00); )               \
+    DEF_BENCH( return new XferD32Bench(mode, name, true,  F00); )               \
+    DEF_BENCH( return new XferD32Bench(mode, name, false, F00 | USE_AA); )      \
+    DEF_BENCH( return new XferD32Bench(mode, name, true,  F10 | USE_AA); )
+
+MODE_BENCH(SkXfermode::kSrcATop_Mode,    "srcatop")
+MODE_BENCH(SkXfermode::kScreen_Mode,     "screen")
+MODE_BENCH(SkXfermode::kMultiply_Mode,   "multiply")
+MODE_BENCH(SkXfermode::kColorDodge_Mode, "colordodge")
+MODE_BENCH(SkXfermode::kSoftLight_Mode,  "softlight")
+MODE_BENCH(SkXfermode::kHue_Mode,        "hue")
+MODE_BENCH(SkXfermode::kSaturation_Mode, "saturation")
+MODE_BENCH(SkXfermode::kColor_Mode,      "color")
+MODE_BENCH(SkXfermode::kLuminosity_Mode, "luminosity")
+
+#undef MODE_BENCH
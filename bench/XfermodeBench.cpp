@@ -8,6 +8,7 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkGradientShader.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkString.h"
@@ -16,23 +17,54 @@
 // Benchmark that draws non-AA rects or AA text with an SkXfermode::Mode.
 class XfermodeBench : public Benchmark {
 public:
-    XfermodeBench(SkXfermode::Mode mode, bool aa) {
+    // What to shade with, besides the paint color.  The shaders exercise the fused blitters.
+    enum Source {
+        kColor_Source,
+        kBitmap_Source,
+        kGradient_Source,
+    };
+
+    XfermodeBench(SkXfermode::Mode mode, bool aa, Source source = kColor_Source) {
         fXfermode.reset(SkXfermode::Create(mode));
         fAA = aa;
+        fSource = source;
         SkASSERT(fXfermode.get() || SkXfermode::kSrcOver_Mode == mode);
-        fName.printf("Xfermode_%s%s", SkXfermode::ModeName(mode), aa ? "_aa" : "");
+        static const char* kSourceNames[] = { "", "_bitmap", "_gradient" };
+        fName.printf("Xfermode_%s%s%s", SkXfermode::ModeName(mode), kSourceNames[source],
+                     aa ? "_aa" : "");
     }
 
     XfermodeBench(SkXfermode* xferMode, const char* name, bool aa) {
         SkASSERT(xferMode);
         fXfermode.reset(xferMode);
         fAA = aa;
+        fSource = kColor_Source;
         fName.printf("Xfermode_%s%s", name, aa ? "_aa" : "");
     }
 
 protected:
     const char* onGetName() override { return fName.c_str(); }
 
+    void onDelayedSetup() override {
+        if (kBitmap_Source == fSource) {
+            SkBitmap bm;
+            bm.allocN32Pixels(64, 64);
+            SkRandom random;
+            for (int y = 0; y < bm.height(); ++y) {
+                for (int x = 0; x < bm.width(); ++x) {
+                    *bm.getAddr32(x, y) = SkPreMultiplyColor(random.nextU());
+                }
+            }
+            fShader.reset(SkShader::CreateBitmapShader(bm, SkShader::kClamp_TileMode,
+                                                       SkShader::kClamp_TileMode));
+        } else if (kGradient_Source == fSource) {
+            const SkPoint pts[] = { { 0, 0 }, { 100, 100 } };
+            const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+            fShader.reset(SkGradientShader::CreateLinear(pts, colors, nullptr, 2,
+                                                         SkShader::kClamp_TileMode));
+        }
+    }
+
     void onDraw(int loops, SkCanvas* canvas) override {
         const char* text = "Hamburgefons";
         size_t len = strlen(text);
@@ -42,6 +74,11 @@ protected:
             SkPaint paint;
             paint.setXfermode(fXfermode.get());
             paint.setColor(random.nextU());
+            if (fShader) {
+                // Shaders are modulated by the paint's alpha; keep that out of the way.
+                paint.setShader(fShader.get());
+                paint.setAlpha(0xFF);
+            }
             if (fAA) {
                 // Draw text to exercise AA code paths.
                 paint.setAntiAlias(true);
@@ -70,8 +107,55 @@ protected:
 
 private:
     SkAutoTUnref<SkXfermode> fXfermode;
+    SkAutoTUnref<SkShader> fShader;
     SkString fName;
     bool fAA;
+    Source fSource;
+
+    typedef Benchmark INHERITED;
+};
+
+// Benchmark that calls SkXfermode::xfer32() directly on a span, with or without coverage.
+class Xfer32Bench : public Benchmark {
+public:
+    Xfer32Bench(SkXfermode::Mode mode, bool aa) : fAA(aa) {
+        fXfermode.reset(SkXfermode::Create(mode));
+        SkASSERT(fXfermode.get());
+        fName.printf("xfer32_%s%s", SkXfermode::ModeName(mode), aa ? "_aa" : "");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom random;
+        for (int i = 0; i < N; ++i) {
+            fSrc[i] = SkPreMultiplyColor(random.nextU());
+            fDst[i] = SkPreMultiplyColor(random.nextU());
+            fCoverage[i] = random.nextU() & 0xFF;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops * 100; ++i) {
+            fXfermode->xfer32(fDst, fSrc, N, fAA ? fCoverage : nullptr);
+        }
+    }
+
+private:
+    enum {
+        N = 1000,
+    };
+    SkAutoTUnref<SkXfermode> fXfermode;
+    SkString  fName;
+    bool      fAA;
+    SkPMColor fSrc[N];
+    SkPMColor fDst[N];
+    SkAlpha   fCoverage[N];
 
     typedef Benchmark INHERITED;
 };
@@ -137,4 +221,28 @@ BENCH(SkXfermode::kSaturation_Mode)
 BENCH(SkXfermode::kColor_Mode)
 BENCH(SkXfermode::kLuminosity_Mode)
 
+#define SHADER_BENCH(mode)                                                                   \
+    DEF_BENCH( return new XfermodeBench(mode, true,  XfermodeBench::kBitmap_Source); )       \
+    DEF_BENCH( return new XfermodeBench(mode, false, XfermodeBench::kBitmap_Source); )       \
+    DEF_BENCH( return new XfermodeBench(mode, true,  XfermodeBench::kGradient_Source); )     \
+    DEF_BENCH( return new XfermodeBench(mode, false, XfermodeBench::kGradient_Source); )
+
+SHADER_BENCH(SkXfermode::kSrcOver_Mode)
+SHADER_BENCH(SkXfermode::kSrc_Mode)
+SHADER_BENCH(SkXfermode::kMultiply_Mode)
+
+#define XFER32_BENCH(mode)                             \
+    DEF_BENCH( return new Xfer32Bench(mode, true); )   \
+    DEF_BENCH( return new Xfer32Bench(mode, false); )
+
+XFER32_BENCH(SkXfermode::kSrcATop_Mode)
+XFER32_BENCH(SkXfermode::kMultiply_Mode)
+XFER32_BENCH(SkXfermode::kHardLight_Mode)
+XFER32_BENCH(SkXfermode::kColorDodge_Mode)
+XFER32_BENCH(SkXfermode::kSoftLight_Mode)
+XFER32_BENCH(SkXfermode::kHue_Mode)
+XFER32_BENCH(SkXfermode::kSaturation_Mode)
+XFER32_BENCH(SkXfermode::kColor_Mode)
+XFER32_BENCH(SkXfermode::kLuminosity_Mode)
+
 DEF_BENCH(return new XferCreateBench;)
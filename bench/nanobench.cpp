@@ -441,6 +441,7 @@ static void create_config(const SkCommandLineConfig* config, SkTArray<Config>* c
         CPU_CONFIG(nonrendering, kNonRendering_Backend, kUnknown_SkColorType, kUnpremul_SkAlphaType)
         CPU_CONFIG(8888, kRaster_Backend, kN32_SkColorType, kPremul_SkAlphaType)
         CPU_CONFIG(565, kRaster_Backend, kRGB_565_SkColorType, kOpaque_SkAlphaType)
+        CPU_CONFIG(f16, kRaster_Backend, kRGBA_F16_SkColorType, kPremul_SkAlphaType)
     }
 
     #undef CPU_CONFIG
@@ -548,6 +549,7 @@ public:
                       , fCurrentSKP(0)
                       , fCurrentUseMPD(0)
                       , fCurrentCodec(0)
+                      , fCurrentCodecXform(0)
                       , fCurrentAndroidCodec(0)
                       , fCurrentBRDImage(0)
                       , fCurrentColorType(0)
@@ -800,6 +802,41 @@ public:
             fCurrentColorType = 0;
         }
 
+        // Run CodecBenches that convert to Display P3 as they decode, to compare against the
+        // plain N32 decodes above.
+        for (; fCurrentCodecXform < fImages.count(); fCurrentCodecXform++) {
+            fSourceType = "image";
+            fBenchType = "skcodec";
+            const SkString& path = fImages[fCurrentCodecXform];
+            if (SkCommandLineFlags::ShouldSkip(FLAGS_match, path.c_str())) {
+                continue;
+            }
+            SkAutoTUnref<SkData> encoded(SkData::NewFromFileName(path.c_str()));
+            SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(encoded));
+            if (!codec) {
+                continue;
+            }
+
+            const SkAlphaType alphaType = kOpaque_SkAlphaType == codec->getInfo().alphaType() ?
+                    kOpaque_SkAlphaType : kPremul_SkAlphaType;
+            const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                                     .makeAlphaType(alphaType);
+            const size_t rowBytes = info.minRowBytes();
+            SkAutoMalloc storage(info.getSafeSize(rowBytes));
+            SkAutoTUnref<SkColorSpace> p3(
+                    SkColorSpace::NewNamed(SkColorSpace::kDisplayP3_Named));
+            SkCodec::Options options;
+            options.fDstColorSpace = p3;
+
+            const SkCodec::Result result = codec->getPixels(info, storage.get(), rowBytes,
+                                                            &options, nullptr, nullptr);
+            if (SkCodec::kSuccess == result || SkCodec::kIncompleteInput == result) {
+                fCurrentCodecXform++;
+                return new CodecBench(SkOSPath::Basename(path.c_str()), encoded,
+                                      kN32_SkColorType, alphaType, p3);
+            }
+        }
+
         // Run AndroidCodecBenches
         const int sampleSizes[] = { 2, 4, 8 };
         for (; fCurrentAndroidCodec < fImages.count(); fCurrentAndroidCodec++) {
@@ -986,6 +1023,7 @@ private:
     int fCurrentSKP;
     int fCurrentUseMPD;
     int fCurrentCodec;
+    int fCurrentCodecXform;
     int fCurrentAndroidCodec;
     int fCurrentBRDImage;
     int fCurrentColorType;
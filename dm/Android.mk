@@ -37,6 +37,7 @@ LOCAL_SRC_FILES := \
 	../tests/PathOpsBuildUseTest.cpp \
 	../tests/PathOpsConicIntersectionTest.cpp \
 	../tests/PathOpsConicLineIntersectionTest.cpp \
+	../tests/PathOpsContextTest.cpp \
 	../tests/PathOpsCubicConicIntersectionTest.cpp \
 	../tests/PathOpsCubicIntersectionTest.cpp \
 	../tests/PathOpsCubicIntersectionTestData.cpp \
@@ -110,7 +111,9 @@ LOCAL_SRC_FILES := \
 	../tests/ColorFilterTest.cpp \
 	../tests/ColorMatrixTest.cpp \
 	../tests/ColorPrivTest.cpp \
+	../tests/ColorSpaceXformTest.cpp \
 	../tests/ColorTest.cpp \
+	../tests/ConvolverTest.cpp \
 	../tests/CopySurfaceTest.cpp \
 	../tests/DashPathEffectTest.cpp \
 	../tests/DataRefTest.cpp \
@@ -118,6 +121,7 @@ LOCAL_SRC_FILES := \
 	../tests/DeviceLooperTest.cpp \
 	../tests/DiscardableMemoryPoolTest.cpp \
 	../tests/DiscardableMemoryTest.cpp \
+	../tests/DrawAtlasTest.cpp \
 	../tests/DrawBitmapRectTest.cpp \
 	../tests/DrawFilterTest.cpp \
 	../tests/DrawPathTest.cpp \
@@ -126,6 +130,7 @@ LOCAL_SRC_FILES := \
 	../tests/EGLImageTest.cpp \
 	../tests/EmptyPathTest.cpp \
 	../tests/ErrorTest.cpp \
+	../tests/FillPathCacheTest.cpp \
 	../tests/FillPathTest.cpp \
 	../tests/FitsInTest.cpp \
 	../tests/FlattenableFactoryToName.cpp \
@@ -138,6 +143,7 @@ LOCAL_SRC_FILES := \
 	../tests/FontNamesTest.cpp \
 	../tests/FontObjTest.cpp \
 	../tests/FrontBufferedStreamTest.cpp \
+	../tests/FusedBlitterTest.cpp \
 	../tests/GLProgramsTest.cpp \
 	../tests/GeometryTest.cpp \
 	../tests/GifTest.cpp \
@@ -211,11 +217,13 @@ LOCAL_SRC_FILES := \
 	../tests/Point3Test.cpp \
 	../tests/PointTest.cpp \
 	../tests/PremulAlphaRoundTripTest.cpp \
+	../tests/QuadPathCacheTest.cpp \
 	../tests/QuickRejectTest.cpp \
 	../tests/RRectInPathTest.cpp \
 	../tests/RTConfRegistryTest.cpp \
 	../tests/RTreeTest.cpp \
 	../tests/RandomTest.cpp \
+	../tests/RasterClipCacheTest.cpp \
 	../tests/ReadPixelsTest.cpp \
 	../tests/ReadWriteAlphaTest.cpp \
 	../tests/Reader32Test.cpp \
@@ -255,6 +263,7 @@ LOCAL_SRC_FILES := \
 	../tests/SrcOverTest.cpp \
 	../tests/StreamTest.cpp \
 	../tests/StringTest.cpp \
+	../tests/StripEncoderTest.cpp \
 	../tests/StrokeTest.cpp \
 	../tests/StrokerTest.cpp \
 	../tests/SurfaceTest.cpp \
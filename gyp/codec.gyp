@@ -17,10 +17,13 @@
       'standalone_static_library': 1,
       'dependencies': [
         'core.gyp:*',
+        'etc1.gyp:libetc1',
         'giflib.gyp:giflib',
+        'ktx.gyp:libSkKTX',
         'libjpeg-turbo-selector.gyp:libjpeg-turbo-selector',
         'libpng.gyp:libpng',
         'libwebp.gyp:libwebp',
+        'utils.gyp:utils',
       ],
       'cflags':[   
         # FIXME: This gets around a warning: "Argument might be clobbered by longjmp". 
@@ -40,6 +43,7 @@
         '../src/codec/SkBmpRLECodec.cpp',
         '../src/codec/SkBmpStandardCodec.cpp',
         '../src/codec/SkCodec.cpp',
+        '../src/codec/SkCodecPool.cpp',
         '../src/codec/SkGifCodec.cpp',
         '../src/codec/SkIcoCodec.cpp',
         '../src/codec/SkJpegCodec.cpp',
@@ -48,6 +52,7 @@
         '../src/codec/SkMaskSwizzler.cpp',
         '../src/codec/SkMasks.cpp',
         '../src/codec/SkPngCodec.cpp',
+        '../src/codec/SkPngRowReader.cpp',
         '../src/codec/SkSampler.cpp',
         '../src/codec/SkSampledCodec.cpp',
         '../src/codec/SkSwizzler.cpp',
@@ -56,6 +61,7 @@
         '../src/codec/SkWebpCodec.cpp',
 
         '../src/codec/SkCodecImageGenerator.cpp',
+        '../src/codec/SkCompressedImageGenerator.cpp',
         '../src/ports/SkImageGenerator_skia.cpp',
       ],
       'direct_dependent_settings': {
@@ -12,10 +12,13 @@
 #include "SkColor.h"
 #include "SkEncodedFormat.h"
 #include "SkImageInfo.h"
+#include "SkRefCnt.h"
 #include "SkSize.h"
 #include "SkStream.h"
 #include "SkTypes.h"
 
+class SkColorSpace;
+class SkColorSpaceXform;
 class SkData;
 class SkPngChunkReader;
 class SkSampler;
@@ -91,6 +94,14 @@ public:
      */
     static SkCodec* NewFromData(SkData*, SkPngChunkReader* = NULL);
 
+    /**
+     *  Like NewFromStream(), but for decoding many small images, where setting up the decoder
+     *  can cost as much as the decode itself.  JPEG decompress structs, and the memory libpng
+     *  and zlib allocate, come from a per-thread pool, and go back to it when the codec is
+     *  deleted.  Other formats are created as usual.
+     */
+    static SkCodec* NewFromStreamPooled(SkStream*, SkPngChunkReader* = NULL);
+
     virtual ~SkCodec();
 
     /**
@@ -98,6 +109,12 @@ public:
      */
     const SkImageInfo& getInfo() const { return fSrcInfo; }
 
+    /**
+     *  Return the color space the encoded image is tagged with, or NULL if it is not tagged.
+     *  Untagged images are treated as sRGB when converting to another space.
+     */
+    SkColorSpace* getColorSpace() const { return fColorSpace; }
+
     /**
      *  Return a size that approximately supports the desired scale factor.
      *  The codec may not be able to scale efficiently to the exact scale
@@ -206,6 +223,63 @@ public:
         kNo_ZeroInitialized,
     };
 
+    /**
+     *  Used by the frame APIs below to mean "no frame".
+     */
+    static const int kNone = -1;
+
+    /**
+     *  Return the number of frames in the image.
+     *
+     *  This is one for everything but animated formats. For those, it may require reading
+     *  through the entire stream the first time it is called.
+     */
+    int getFrameCount() { return this->onGetFrameCount(); }
+
+    /**
+     *  How a frame is to be removed before the next frame is drawn.
+     */
+    enum DisposalMethod {
+        /**
+         *  Leave the frame in place; the next frame is drawn on top of it.
+         */
+        kKeep_DisposalMethod,
+        /**
+         *  Clear the frame's rectangle to the background before drawing the next frame.
+         */
+        kRestoreBGColor_DisposalMethod,
+        /**
+         *  Return to the state before this frame was drawn.
+         */
+        kRestorePrevious_DisposalMethod,
+    };
+
+    struct FrameInfo {
+        /**
+         *  The frame that must be fully composed (and then disposed) before this one can
+         *  be drawn on top of it, or kNone if this frame can be decoded on its own.
+         */
+        int             fRequiredFrame;
+
+        /**
+         *  Number of milliseconds to show this frame.
+         */
+        int             fDuration;
+
+        DisposalMethod  fDisposalMethod;
+
+        /**
+         *  The part of the image this frame draws to. May extend past getInfo()'s bounds.
+         */
+        SkIRect         fFrameRect;
+    };
+
+    /**
+     *  Return information about the frame at 'index', which must be less than
+     *  getFrameCount(). Returns false, and leaves info unchanged, on a bad index.
+     */
+    bool getFrameInfo(int index, FrameInfo* info);
+
     /**
      *  Additional options to pass to getPixels.
      */
@@ -213,6 +287,9 @@ public:
         Options()
             : fZeroInitialized(kNo_ZeroInitialized)
             , fSubset(NULL)
+            , fFrameIndex(0)
+            , fPriorFrame(kNone)
+            , fDstColorSpace(NULL)
         {}
 
         ZeroInitialized fZeroInitialized;
@@ -234,6 +311,30 @@ public:
          *  to getScanlines().
          */
         SkIRect*        fSubset;
+
+        /**
+         *  The frame to decode, in [0, getFrameCount()). The result is the frame as it is
+         *  meant to be displayed, i.e. composed on top of the frames it depends on.
+         *
+         *  Only getPixels() supports frames other than the first.
+         */
+        int             fFrameIndex;
+
+        /**
+         *  If not kNone, the destination already holds this frame, as decoded by a previous
+         *  call to getPixels() with the same info. If fFrameIndex (transitively) depends on
+         *  it, the codec will draw on top of it instead of redecoding it. Otherwise this is
+         *  ignored. Must be less than fFrameIndex.
+         */
+        int             fPriorFrame;
+
+        /**
+         *  If not NULL, the pixels are converted from the image's color space (see
+         *  getColorSpace()) to this one as they are decoded.  Conversion requires a
+         *  kRGBA_8888 or kBGRA_8888 destination; other color types fail with
+         *  kInvalidConversion unless the two spaces already match.  Not owned.
+         */
+        SkColorSpace*   fDstColorSpace;
     };
 
     /**
@@ -502,7 +603,11 @@ public:
     int outputScanline(int inputScanline) const;
 
 protected:
-    SkCodec(const SkImageInfo&, SkStream*);
+    /**
+     *  Takes ownership of the stream, and of the ref to colorSpace, which is the color space
+     *  the image is tagged with, if any.
+     */
+    SkCodec(const SkImageInfo&, SkStream*, SkColorSpace* colorSpace = NULL);
 
     virtual SkISize onGetScaledDimensions(float /*desiredScale*/) const {
         // By default, scaling is not supported.
@@ -544,6 +649,22 @@ protected:
         return false;
     }
 
+    /**
+     *  Animated formats should override these two. The default describes a single frame
+     *  that covers the whole image.
+     */
+    virtual int onGetFrameCount() {
+        return 1;
+    }
+
+    virtual bool onGetFrameInfo(int /*index*/, FrameInfo* info) {
+        info->fRequiredFrame = kNone;
+        info->fDuration = 0;
+        info->fDisposalMethod = kKeep_DisposalMethod;
+        info->fFrameRect = SkIRect::MakeSize(this->getInfo().dimensions());
+        return true;
+    }
+
     /**
      *  If the stream was previously read, attempt to rewind.
      *
@@ -619,6 +740,19 @@ protected:
 
     const SkCodec::Options& options() const { return fOptions; }
 
+    /**
+     *  The conversion to Options::fDstColorSpace for the current decode, or NULL if there
+     *  is none.  Only valid from the time onGetPixels() or onStartScanlineDecode() is
+     *  called until the decode finishes.
+     */
+    const SkColorSpaceXform* colorXform() const { return fColorXform; }
+
+    /**
+     *  Subclasses that apply colorXform() to each row as they produce it should override
+     *  this to return true.  Otherwise SkCodec converts the rows once they are decoded.
+     */
+    virtual bool onAppliesColorXform() const { return false; }
+
     /**
      *  Returns the number of scanlines that have been decoded so far.
      *  This is unaffected by the SkScanlineOrder.
@@ -637,6 +771,19 @@ private:
     SkImageInfo             fDstInfo;
     SkCodec::Options        fOptions;
     int                     fCurrScanline;
+    SkAutoTUnref<SkColorSpace>      fColorSpace;
+    SkAutoTUnref<SkColorSpaceXform> fColorXform;
+
+    /**
+     *  Looks up the conversion to options.fDstColorSpace, if any, for decoding to dstInfo.
+     */
+    Result setUpColorXform(const SkImageInfo& dstInfo, const Options& options);
+
+    /**
+     *  Applies fColorXform to count rows of width pixels, if the subclass did not.
+     */
+    void applyColorXform(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int width,
+                         int count) const;
 
     /**
      *  Return whether these dimensions are supported as a scale.
@@ -503,6 +503,17 @@ public:
     */
     bool quickReject(const SkRect& rect) const;
 
+    /** Set rejected[i] to quickReject(rects[i]) for each of the count rects,
+        and return how many were rejected. This looks at the matrix and clip
+        once for the whole array, so it is faster than calling quickReject()
+        on each rect, e.g. to cull many small draws before making them.
+        @param rects    the rects to compare with the current clip
+        @param count    the number of rects
+        @param rejected receives, for each rect, whether it can be skipped
+        @return the number of rects that were rejected
+    */
+    int quickReject(const SkRect rects[], int count, bool rejected[]) const;
+
     /** Return true if the specified path, after being transformed by the
         current matrix, would lie completely outside of the current clip. Call
         this to check if an area you intend to draw into is clipped out (and
@@ -48,7 +48,7 @@ public:
 
     size_t totalCapacity() const { return fTotalCapacity; }
     size_t totalUsed() const { return fTotalUsed; }
-    SkDEBUGCODE(int blockCount() const { return fBlockCount; })
+    int blockCount() const { return fBlockCount; }
     SkDEBUGCODE(size_t totalLost() const { return fTotalLost; })
 
     /**
@@ -66,7 +66,7 @@ private:
     size_t  fChunkSize;
     size_t  fTotalCapacity;
     size_t  fTotalUsed;     // will be <= fTotalCapacity
-    SkDEBUGCODE(int     fBlockCount;)
+    int     fBlockCount;
     SkDEBUGCODE(size_t  fTotalLost;)     // will be <= fTotalCapacity
 
     Block* newBlock(size_t bytes, AllocFailType ftype);
@@ -74,6 +74,14 @@ public:
                          const uint16_t indices[], int ptCount,
                          const SkPaint& paint) const;
 
+    /**
+     *  Draws all of the sprites with one blitter, resetting its shader context per sprite.
+     *  The paint must be a plain fill: no mask filter, path effect, or rasterizer.
+     */
+    void    drawAtlas(const SkImage* atlas, const SkRSXform xform[], const SkRect tex[],
+                      const SkColor colors[], int count, SkXfermode::Mode mode,
+                      const SkPaint& paint) const;
+
     /**
      *  Overwrite the target with the path's coverage (i.e. its mask).
      *  Will overwrite the entire device, so it need not be zero'd first.
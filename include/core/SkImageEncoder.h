@@ -62,6 +62,72 @@ public:
      */
     bool encodeStream(SkWStream* stream, const SkBitmap& bm, int quality);
 
+    /**
+     *  Speed/size tradeoff used by the strip encoders.
+     */
+    enum Preset {
+        kFast_Preset,       //!< fastest compression, larger output
+        kDefault_Preset,    //!< roughly what encodeStream() produces
+        kSmall_Preset,      //!< slowest compression, smallest output
+    };
+
+    /**
+     *  Supplies rows to encodeStrips(). getRows() is only called on the thread that called
+     *  encodeStrips(), with y increasing from one call to the next.
+     */
+    class RowSource {
+    public:
+        virtual ~RowSource() {}
+
+        /**
+         *  Write 'count' rows, starting at row 'y', into 'dst' (each row 'rowBytes' apart),
+         *  in the SkImageInfo that was passed to encodeStrips(). Return false to abort.
+         */
+        virtual bool getRows(int y, int count, void* dst, size_t rowBytes) = 0;
+
+        /**
+         *  If every row already lives in memory, return the address of the first one and set
+         *  'rowBytes', so the encoder can skip copying rows. Otherwise return nullptr.
+         */
+        virtual const void* peekPixels(size_t* rowBytes) { return nullptr; }
+    };
+
+    struct StripOptions {
+        StripOptions()
+            : fPreset(kDefault_Preset)
+            , fStripHeight(0)
+            , fMaxConcurrentStrips(0) {}
+
+        Preset  fPreset;
+
+        /**
+         *  Rows per strip. 0 lets the encoder choose. Encoders may round this up to suit the
+         *  format (e.g. to a multiple of the JPEG MCU height).
+         */
+        int     fStripHeight;
+
+        /**
+         *  Upper bound on the number of strips held in memory and compressed at once, using
+         *  SkTaskGroup. 0 means sk_num_cores(). 1 encodes one strip at a time on the calling
+         *  thread.
+         */
+        int     fMaxConcurrentStrips;
+    };
+
+    /**
+     *  Encode an image of the given info, pulling its rows from 'src' in strips. PNG and
+     *  JPEG compress the strips in parallel; other formats gather every row and then
+     *  encode them as encodeStream() would. kIndex_8 is not supported, since the
+     *  SkImageInfo carries no color table. Returns false on failure.
+     */
+    bool encodeStrips(SkWStream*, const SkImageInfo&, RowSource* src, int quality,
+                      const StripOptions& = StripOptions());
+
+    static bool EncodeStrips(SkWStream*, const SkImageInfo&, RowSource*, Type, int quality,
+                             const StripOptions& = StripOptions());
+    static bool EncodeStrips(SkWStream*, const SkPixmap&, Type, int quality,
+                             const StripOptions& = StripOptions());
+
     static SkData* EncodeData(const SkImageInfo&, const void* pixels, size_t rowBytes,
                               Type, int quality);
     static SkData* EncodeData(const SkBitmap&, Type, int quality);
@@ -86,6 +152,15 @@ protected:
      * This must be overridden by each SkImageEncoder implementation.
      */
     virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) = 0;
+
+    /**
+     *  Encode rows pulled from 'src' in strips. 'info' has already been validated, and
+     *  'quality' clamped to 0-100.
+     *
+     *  The default implementation reads every row into a bitmap and calls onEncode().
+     */
+    virtual bool onEncodeStrips(SkWStream*, const SkImageInfo& info, RowSource* src,
+                                int quality, const StripOptions&);
 };
 
 // This macro declares a global (i.e., non-class owned) creation entry point
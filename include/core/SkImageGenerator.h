@@ -209,6 +209,12 @@ public:
                                           SkIPoint::Make(0, 0), scaledPixels);
     }
 
+    /**
+     *  Returns true if this generator implements generateScaledPixels(). If this returns false,
+     *  generateScaledPixels() always fails, so callers need not allocate pixels to try it.
+     */
+    bool canGenerateScaledPixels() const { return this->onCanGenerateScaledPixels(); }
+
     /**
      *  If the default image decoder system can interpret the specified (encoded) data, then
      *  this returns a new ImageGenerator for it. Otherwise this returns NULL. Either way
@@ -262,6 +268,9 @@ protected:
     virtual bool onGenerateScaledPixels(const SkISize&, const SkIPoint&, const SkPixmap&) {
         return false;
     }
+    virtual bool onCanGenerateScaledPixels() const {
+        return false;
+    }
 
     bool tryGenerateBitmap(SkBitmap* bm, const SkImageInfo* optionalInfo, SkBitmap::Allocator*);
 
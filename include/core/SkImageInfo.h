@@ -252,6 +252,10 @@ public:
         return SkImageInfo::Make(fWidth, fHeight, newColorType, fAlphaType, fProfileType);
     }
 
+    SkImageInfo makeProfileType(SkColorProfileType newProfileType) const {
+        return SkImageInfo::Make(fWidth, fHeight, fColorType, fAlphaType, newProfileType);
+    }
+
     int bytesPerPixel() const {
         return SkColorTypeBytesPerPixel(fColorType);
     }
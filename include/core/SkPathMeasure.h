@@ -47,6 +47,16 @@ public:
     bool SK_WARN_UNUSED_RESULT getPosTan(SkScalar distance, SkPoint* position,
                                          SkVector* tangent);
 
+    /** Same as calling getPosTan() for each of the count distances, storing the results in
+        positions[] and tangents[] (either of which may be null), but faster when there are
+        many: distances in increasing order, like the advances of glyphs laid out along the
+        path, are found in one sweep of the contour rather than by a search each.
+        Returns false if there is no path, or a zero-length path was specified, in which case
+        positions and tangents are unchanged.
+    */
+    bool SK_WARN_UNUSED_RESULT getPosTans(const SkScalar distances[], int count,
+                                          SkPoint positions[], SkVector tangents[]);
+
     enum MatrixFlags {
         kGetPosition_MatrixFlag     = 0x01,
         kGetTangent_MatrixFlag      = 0x02,
@@ -88,8 +98,10 @@ private:
     SkScalar        fTolerance;
     SkScalar        fLength;            // relative to the current contour
     int             fFirstPtIndex;      // relative to the current contour
+    int             fContourIndex;      // of the current contour
     bool            fIsClosed;          // relative to the current contour
     bool            fForceClosed;
+    bool            fCacheable;         // whether the path's contours are worth caching
 
     struct Segment {
         SkScalar    fDistance;  // total distance up to this point
@@ -102,9 +114,13 @@ private:
     SkTDArray<Segment>  fSegments;
     SkTDArray<SkPoint>  fPts; // Points used to define the segments
 
+    struct ContourRec;
+
     static const Segment* NextSegment(const Segment*);
 
     void     buildSegments();
+    bool     findCachedContour();
+    void     addCachedContour(int ptCount);
     SkScalar compute_quad_segs(const SkPoint pts[3], SkScalar distance,
                                 int mint, int maxt, int ptIndex);
     SkScalar compute_conic_segs(const SkConic&, SkScalar distance,
@@ -113,6 +129,7 @@ private:
     SkScalar compute_cubic_segs(const SkPoint pts[3], SkScalar distance,
                                 int mint, int maxt, int ptIndex);
     const Segment* distanceToSegment(SkScalar distance, SkScalar* t);
+    const Segment* interpolateSegment(int index, SkScalar distance, SkScalar* t);
     bool quad_too_curvy(const SkPoint pts[3]);
     bool conic_too_curvy(const SkPoint& firstPt, const SkPoint& midTPt,const SkPoint& lastPt);
     bool cheap_dist_exceeds_limit(const SkPoint& pt, SkScalar x, SkScalar y);
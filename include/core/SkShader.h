@@ -167,6 +167,12 @@ public:
         // Notification from blitter::blitMask in case we need to see the non-alpha channels
         virtual void set3DMask(const SkMask*) {}
 
+        /**
+         *  The matrix from device space to the shader's own space, including its local matrix.
+         *  Blitters that sample the shader's source themselves use this.
+         */
+        const SkMatrix& getTotalInverse() const { return fTotalInverse; }
+
     protected:
         // Reference to shader, so we don't have to dupe information.
         const SkShader& fShader;
@@ -180,7 +186,6 @@ public:
         static MatrixClass ComputeMatrixClass(const SkMatrix&);
 
         uint8_t         getPaintAlpha() const { return fPaintAlpha; }
-        const SkMatrix& getTotalInverse() const { return fTotalInverse; }
         MatrixClass     getInverseClass() const { return (MatrixClass)fTotalInverseClass; }
         const SkMatrix& getCTM() const { return fCTM; }
     private:
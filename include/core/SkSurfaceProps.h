@@ -54,6 +54,19 @@ public:
         kDisallowAntiAlias_Flag         = 1 << 0,
         kDisallowDither_Flag            = 1 << 1,
         kUseDeviceIndependentFonts_Flag = 1 << 2,
+        /**
+         *  Raster N32 surfaces blend in linear light, treating their pixels as sRGB-encoded,
+         *  as if their SkImageInfo had kSRGB_SkColorProfileType. Dithered paints also dither
+         *  when they store to them.
+         */
+        kGammaCorrect_Flag              = 1 << 3,
+        /**
+         *  Raster surfaces fill paths with conics (circles, ovals, rounded rects) from copies
+         *  with the conics cut into quads, kept in the resource cache and shared by draws of
+         *  the same path at similar scales (e.g. while panning and zooming). Conics may come
+         *  out very slightly differently than when cut up for each draw.
+         */
+        kCacheConicQuads_Flag           = 1 << 4,
     };
     /** Deprecated alias used by Chromium. Will be removed. */
     static const Flags kUseDistanceFieldFonts_Flag = kUseDeviceIndependentFonts_Flag;
@@ -75,6 +88,8 @@ public:
     bool isUseDeviceIndependentFonts() const {
         return SkToBool(fFlags & kUseDeviceIndependentFonts_Flag);
     }
+    bool isGammaCorrect() const { return SkToBool(fFlags & kGammaCorrect_Flag); }
+    bool isCacheConicQuads() const { return SkToBool(fFlags & kCacheConicQuads_Flag); }
 
 private:
     SkSurfaceProps();
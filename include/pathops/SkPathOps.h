@@ -67,6 +67,35 @@ bool SK_API Simplify(const SkPath& path, SkPath* result);
   */
 bool SK_API TightBounds(const SkPath& path, SkRect* result);
 
+class SkOpWorkingSet;
+
+/** Keeps the memory that path operations work in from one call to the next. A caller making
+    many path operations, such as a stream of small ones, can make them through one context
+    rather than call Op() and Simplify(), so that they reuse the memory earlier calls grew
+    instead of each allocating and freeing its own.
+
+    A context must only be used by one thread at a time.
+  */
+class SK_API SkPathOpsContext : SkNoncopyable {
+public:
+    SkPathOpsContext();
+    ~SkPathOpsContext();
+
+    /** Same as Op(), but works in this context's memory. */
+    bool op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result);
+
+    /** Same as Simplify(), but works in this context's memory. */
+    bool simplify(const SkPath& path, SkPath* result);
+
+    /** Returns how many blocks of memory the last call to op() or simplify() had to allocate.
+        Once the context has grown to fit the operations it is given, this is usually zero.
+      */
+    int lastAllocationCount() const;
+
+private:
+    SkOpWorkingSet* fWorkingSet;
+};
+
 /** Perform a series of path operations, optimized for unioning many paths together.
   */
 class SK_API SkOpBuilder {
@@ -8,6 +8,7 @@
 #include "SkBmpCodec.h"
 #include "SkCodec.h"
 #include "SkCodecPriv.h"
+#include "SkColorSpaceXform.h"
 #include "SkData.h"
 #include "SkGifCodec.h"
 #include "SkIcoCodec.h"
@@ -46,8 +47,7 @@ size_t SkCodec::MinBufferedBytesNeeded() {
     return WEBP_VP8_HEADER_SIZE;
 }
 
-SkCodec* SkCodec::NewFromStream(SkStream* stream,
-                                SkPngChunkReader* chunkReader) {
+static SkCodec* new_from_stream(SkStream* stream, SkPngChunkReader* chunkReader, bool pooled) {
     if (!stream) {
         return nullptr;
     }
@@ -56,7 +56,7 @@ SkCodec* SkCodec::NewFromStream(SkStream* stream,
 
     // 14 is enough to read all of the supported types.
     const size_t bytesToRead = 14;
-    SkASSERT(bytesToRead <= MinBufferedBytesNeeded());
+    SkASSERT(bytesToRead <= SkCodec::MinBufferedBytesNeeded());
 
     char buffer[bytesToRead];
     size_t bytesRead = stream->peek(buffer, bytesToRead);
@@ -87,7 +87,12 @@ SkCodec* SkCodec::NewFromStream(SkStream* stream,
     // But this code follows the same pattern as the loop.
 #ifdef SK_CODEC_DECODES_PNG
     if (SkPngCodec::IsPng(buffer, bytesRead)) {
-        return SkPngCodec::NewFromStream(streamDeleter.detach(), chunkReader);
+        return SkPngCodec::NewFromStream(streamDeleter.detach(), chunkReader, pooled);
+    } else
+#endif
+#ifdef SK_CODEC_DECODES_JPEG
+    if (pooled && SkJpegCodec::IsJpeg(buffer, bytesRead)) {
+        return SkJpegCodec::NewFromStreamPooled(streamDeleter.detach());
     } else
 #endif
     {
@@ -106,6 +111,14 @@ SkCodec* SkCodec::NewFromStream(SkStream* stream,
     return nullptr;
 }
 
+SkCodec* SkCodec::NewFromStream(SkStream* stream, SkPngChunkReader* chunkReader) {
+    return new_from_stream(stream, chunkReader, false);
+}
+
+SkCodec* SkCodec::NewFromStreamPooled(SkStream* stream, SkPngChunkReader* chunkReader) {
+    return new_from_stream(stream, chunkReader, true);
+}
+
 SkCodec* SkCodec::NewFromData(SkData* data, SkPngChunkReader* reader) {
     if (!data) {
         return nullptr;
@@ -113,13 +126,14 @@ SkCodec* SkCodec::NewFromData(SkData* data, SkPngChunkReader* reader) {
     return NewFromStream(new SkMemoryStream(data), reader);
 }
 
-SkCodec::SkCodec(const SkImageInfo& info, SkStream* stream)
+SkCodec::SkCodec(const SkImageInfo& info, SkStream* stream, SkColorSpace* colorSpace)
     : fSrcInfo(info)
     , fStream(stream)
     , fNeedsRewind(false)
     , fDstInfo()
     , fOptions()
     , fCurrScanline(-1)
+    , fColorSpace(colorSpace)
 {}
 
 SkCodec::~SkCodec() {}
@@ -149,6 +163,45 @@ bool SkCodec::rewindIfNeeded() {
     return this->onRewind();
 }
 
+SkCodec::Result SkCodec::setUpColorXform(const SkImageInfo& dstInfo, const Options& options) {
+    fColorXform.reset(nullptr);
+    if (!options.fDstColorSpace) {
+        return kSuccess;
+    }
+
+    SkAutoTUnref<SkColorSpace> srgb;
+    const SkColorSpace* src = fColorSpace;
+    if (!src) {
+        srgb.reset(SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named));
+        src = srgb;
+    }
+    fColorXform.reset(SkColorSpaceXform::New(src, options.fDstColorSpace));
+    if (fColorXform && kRGBA_8888_SkColorType != dstInfo.colorType() &&
+            kBGRA_8888_SkColorType != dstInfo.colorType()) {
+        fColorXform.reset(nullptr);
+        return kInvalidConversion;
+    }
+    return kSuccess;
+}
+
+void SkCodec::applyColorXform(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int width,
+                              int count) const {
+    if (!fColorXform || this->onAppliesColorXform()) {
+        return;
+    }
+    for (int y = 0; y < count; y++) {
+        uint32_t* row = SkTAddOffset<uint32_t>(dst, y * rowBytes);
+        fColorXform->apply(row, row, width, dstInfo.colorType(), dstInfo.alphaType());
+    }
+}
+
+bool SkCodec::getFrameInfo(int index, FrameInfo* info) {
+    if (index < 0 || index >= this->getFrameCount() || nullptr == info) {
+        return false;
+    }
+    return this->onGetFrameInfo(index, info);
+}
+
 SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
                                    const Options* options, SkPMColor ctable[], int* ctableCount) {
     if (kUnknown_SkColorType == info.colorType()) {
@@ -196,6 +249,18 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
         return kInvalidScale;
     }
 
+    if (0 != options->fFrameIndex) {
+        if (options->fFrameIndex < 0 || options->fFrameIndex >= this->getFrameCount() ||
+                options->fPriorFrame >= options->fFrameIndex) {
+            return kInvalidParameters;
+        }
+    }
+
+    const Result xformResult = this->setUpColorXform(info, *options);
+    if (kSuccess != xformResult) {
+        return xformResult;
+    }
+
     // On an incomplete decode, the subclass will specify the number of scanlines that it decoded
     // successfully.
     int rowsDecoded = 0;
@@ -216,6 +281,11 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
                 rowsDecoded);
     }
 
+    if (kIncompleteInput == result || kSuccess == result) {
+        this->applyColorXform(info, pixels, rowBytes, info.width(), info.height());
+    }
+    fColorXform.reset(nullptr);
+
     return result;
 }
 
@@ -261,13 +331,24 @@ SkCodec::Result SkCodec::startScanlineDecode(const SkImageInfo& dstInfo,
         }
     }
 
+    // Only the first frame supports scanline decoding.
+    if (0 != options->fFrameIndex) {
+        return kUnimplemented;
+    }
+
     // FIXME: Support subsets somehow?
     if (!this->dimensionsSupported(dstInfo.dimensions())) {
         return kInvalidScale;
     }
 
+    const Result xformResult = this->setUpColorXform(dstInfo, *options);
+    if (kSuccess != xformResult) {
+        return xformResult;
+    }
+
     const Result result = this->onStartScanlineDecode(dstInfo, *options, ctable, ctableCount);
     if (result != SkCodec::kSuccess) {
+        fColorXform.reset(nullptr);
         return result;
     }
 
@@ -296,6 +377,8 @@ int SkCodec::getScanlines(void* dst, int countLines, size_t rowBytes) {
         this->fillIncompleteImage(this->dstInfo(), dst, rowBytes, this->options().fZeroInitialized,
                 countLines, linesDecoded);
     }
+    const int width = fOptions.fSubset ? fOptions.fSubset->width() : fDstInfo.width();
+    this->applyColorXform(fDstInfo, dst, rowBytes, width, countLines);
     fCurrScanline += countLines;
     return linesDecoded;
 }
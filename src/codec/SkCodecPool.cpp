@@ -0,0 +1,148 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodecPool.h"
+#include "SkJpegDecoderMgr.h"
+#include "SkMath.h"
+#include "SkTLS.h"
+
+// Each block starts with its size class, padded to keep the rest of the block aligned as
+// malloc() would.
+static const size_t kHeaderSize = 16;
+static_assert(sizeof(size_t) <= kHeaderSize, "block header too small");
+
+// Blocks of 64 bytes up to 256K are kept.  Anything larger goes straight to the heap.
+static const int kMinClass = 6;
+static const int kMaxClass = 18;
+static const int kLargeClass = kMaxClass + 1;
+
+// Limits on what one thread keeps.
+static const size_t kMaxCachedBytes = 2 * 1024 * 1024;
+static const int kMaxJpegs = 4;
+
+struct FreeBlock {
+    FreeBlock* fNext;
+};
+
+struct ThreadPool {
+    ThreadPool() {
+        sk_bzero(this, sizeof(*this));
+    }
+
+    ~ThreadPool() {
+        this->purge();
+    }
+
+    void purge() {
+        for (int i = kMinClass; i <= kMaxClass; i++) {
+            while (FreeBlock* block = fFree[i]) {
+                fFree[i] = block->fNext;
+                sk_free(SkTAddOffset<void>(block, -(intptr_t) kHeaderSize));
+            }
+        }
+        fCachedBytes = 0;
+        for (int i = 0; i < fJpegCount; i++) {
+            delete fJpegs[i];
+        }
+        fJpegCount = 0;
+    }
+
+    FreeBlock*          fFree[kMaxClass + 1];
+    size_t              fCachedBytes;
+    JpegDecoderMgr*     fJpegs[kMaxJpegs];
+    int                 fJpegCount;
+    SkCodecPool::Stats  fStats;
+};
+
+static void* create_pool() { return new ThreadPool; }
+static void delete_pool(void* pool) { delete static_cast<ThreadPool*>(pool); }
+
+static ThreadPool* get_pool() {
+    return static_cast<ThreadPool*>(SkTLS::Get(create_pool, delete_pool));
+}
+
+static int size_class(size_t size) {
+    if (size > ((size_t) 1 << kMaxClass) - kHeaderSize) {
+        return kLargeClass;
+    }
+    return SkTMax(kMinClass, SkNextLog2(SkToU32(size + kHeaderSize)));
+}
+
+void* SkCodecPool::Alloc(size_t size) {
+    ThreadPool* pool = get_pool();
+    pool->fStats.fAllocs++;
+
+    const int cls = size_class(size);
+    void* block;
+    if (cls != kLargeClass && pool->fFree[cls]) {
+        FreeBlock* free = pool->fFree[cls];
+        pool->fFree[cls] = free->fNext;
+        pool->fCachedBytes -= (size_t) 1 << cls;
+        block = SkTAddOffset<void>(free, -(intptr_t) kHeaderSize);
+    } else {
+        block = sk_malloc_flags(cls == kLargeClass ? size + kHeaderSize : (size_t) 1 << cls, 0);
+        if (!block) {
+            return nullptr;
+        }
+        pool->fStats.fHeapAllocs++;
+    }
+    *static_cast<size_t*>(block) = cls;
+    return SkTAddOffset<void>(block, kHeaderSize);
+}
+
+void SkCodecPool::Free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    void* block = SkTAddOffset<void>(ptr, -(intptr_t) kHeaderSize);
+    const int cls = (int) *static_cast<size_t*>(block);
+    ThreadPool* pool = get_pool();
+    if (cls == kLargeClass || pool->fCachedBytes + ((size_t) 1 << cls) > kMaxCachedBytes) {
+        sk_free(block);
+        return;
+    }
+    FreeBlock* free = static_cast<FreeBlock*>(ptr);
+    free->fNext = pool->fFree[cls];
+    pool->fFree[cls] = free;
+    pool->fCachedBytes += (size_t) 1 << cls;
+}
+
+JpegDecoderMgr* SkCodecPool::AcquireJpeg(SkStream* stream) {
+    ThreadPool* pool = get_pool();
+    pool->fStats.fAllocs++;
+    if (pool->fJpegCount > 0) {
+        JpegDecoderMgr* decoderMgr = pool->fJpegs[--pool->fJpegCount];
+        decoderMgr->reset(stream);
+        return decoderMgr;
+    }
+    pool->fStats.fHeapAllocs++;
+    return new JpegDecoderMgr(stream);
+}
+
+void SkCodecPool::Release(JpegDecoderMgr* decoderMgr) {
+    if (!decoderMgr) {
+        return;
+    }
+    ThreadPool* pool = get_pool();
+    if (pool->fJpegCount == kMaxJpegs) {
+        delete decoderMgr;
+        return;
+    }
+    // Drop the image-lifetime memory and the stream now, rather than when it is next used.
+    decoderMgr->reset(nullptr);
+    pool->fJpegs[pool->fJpegCount++] = decoderMgr;
+}
+
+SkCodecPool::Stats SkCodecPool::GetStats() {
+    return get_pool()->fStats;
+}
+
+void SkCodecPool::Purge() {
+    if (ThreadPool* pool = static_cast<ThreadPool*>(SkTLS::Find(create_pool))) {
+        pool->purge();
+    }
+}
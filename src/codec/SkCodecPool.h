@@ -0,0 +1,54 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodecPool_DEFINED
+#define SkCodecPool_DEFINED
+
+#include "SkTypes.h"
+
+class JpegDecoderMgr;
+class SkStream;
+
+/**
+ *  Per-thread caches of decoder state for the codecs made by SkCodec::NewFromStreamPooled(),
+ *  so that decoding many small images does not spend most of its time setting up decoders.
+ *
+ *  Anything may be handed back on a different thread than the one it came from.  It then
+ *  joins the pool of the thread that handed it back.
+ */
+namespace SkCodecPool {
+    /**
+     *  Memory for libraries that let us replace their allocator (libpng, and zlib through it).
+     *  Freed blocks are kept by size class, up to a limit per thread.
+     */
+    void* Alloc(size_t);
+    void Free(void*);
+
+    /**
+     *  A libjpeg decompress context, already created, reading from stream.  Release() aborts
+     *  whatever it was doing.
+     */
+    JpegDecoderMgr* AcquireJpeg(SkStream*);
+    void Release(JpegDecoderMgr*);
+
+    struct Stats {
+        int fAllocs;        // calls to Alloc() and AcquireJpeg()
+        int fHeapAllocs;    // those that had to allocate
+    };
+
+    /**
+     *  Counts for the calling thread since it first used the pool.
+     */
+    Stats GetStats();
+
+    /**
+     *  Frees everything cached for the calling thread.
+     */
+    void Purge();
+}
+
+#endif // SkCodecPool_DEFINED
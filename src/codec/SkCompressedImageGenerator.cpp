@@ -0,0 +1,256 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkCompressedImageGenerator.h"
+#include "SkEndian.h"
+#include "SkOpts.h"
+#include "SkTemplates.h"
+
+#include "etc1.h"
+#include "ktx.h"
+
+static const uint32_t kASTCMagicNumber = 0x5CA1AB13;
+static const size_t   kASTCHeaderSize  = 16;
+static const size_t   kKTXIdentifierSize = 12;
+
+static inline int read_24bit(const uint8_t* buf) {
+    // Assume everything is little endian...
+    return
+        static_cast<int>(buf[0]) |
+        (static_cast<int>(buf[1]) << 8) |
+        (static_cast<int>(buf[2]) << 16);
+}
+
+static bool astc_format(int blockDimX, int blockDimY, SkTextureCompressor::Format* format) {
+    for (int i = SkTextureCompressor::kASTC_4x4_Format;
+         i <= SkTextureCompressor::kASTC_12x12_Format; ++i) {
+        const SkTextureCompressor::Format fmt = static_cast<SkTextureCompressor::Format>(i);
+        int dimX, dimY;
+        SkTextureCompressor::GetBlockDimensions(fmt, &dimX, &dimY, true);
+        if (dimX == blockDimX && dimY == blockDimY) {
+            *format = fmt;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool is_alpha_format(SkTextureCompressor::Format format) {
+    return SkTextureCompressor::kLATC_Format == format ||
+           SkTextureCompressor::kR11_EAC_Format == format;
+}
+
+static SkImageInfo make_info(int width, int height, SkTextureCompressor::Format format) {
+    if (is_alpha_format(format)) {
+        return SkImageInfo::MakeA8(width, height);
+    }
+    if (SkTextureCompressor::kETC1_Format == format) {
+        return SkImageInfo::MakeN32(width, height, kOpaque_SkAlphaType);
+    }
+    return SkImageInfo::MakeN32Premul(width, height);
+}
+
+// Bytes per pixel of SkTextureCompressor's decompressed output.
+static int decompressed_bytes_per_pixel(SkTextureCompressor::Format format) {
+    if (is_alpha_format(format)) {
+        return 1;   // A8
+    }
+    if (SkTextureCompressor::kETC1_Format == format) {
+        return 3;   // RGB
+    }
+    return 4;       // SkColor
+}
+
+// ETC1 decompresses to RGB bytes.
+static void etc1_row_to_n32(uint32_t* dst, const uint8_t* src, int count) {
+#if SK_PMCOLOR_BYTE_ORDER(B,G,R,A)
+    SkOpts::RGB_to_BGR1(dst, src, count);
+#else
+    SkOpts::RGB_to_RGB1(dst, src, count);
+#endif
+}
+
+// ASTC decompresses to unpremultiplied SkColors, unless the KTX file says it holds premul data.
+static void astc_row_to_n32(uint32_t* dst, const SkColor* src, int count, bool isPremul) {
+#if defined(SK_CPU_LENDIAN) && SK_PMCOLOR_BYTE_ORDER(B,G,R,A)
+    // Little endian SkColors are already BGRA in memory.
+    if (isPremul) {
+        memcpy(dst, src, count * sizeof(uint32_t));
+    } else {
+        SkOpts::RGBA_to_rgbA(dst, src, count);
+    }
+#elif defined(SK_CPU_LENDIAN) && SK_PMCOLOR_BYTE_ORDER(R,G,B,A)
+    if (isPremul) {
+        SkOpts::RGBA_to_BGRA(dst, src, count);
+    } else {
+        SkOpts::RGBA_to_bgrA(dst, src, count);
+    }
+#else
+    for (int i = 0; i < count; ++i) {
+        const SkColor c = src[i];
+        dst[i] = isPremul ? SkPackARGB32NoCheck(SkColorGetA(c), SkColorGetR(c),
+                                                SkColorGetG(c), SkColorGetB(c))
+                          : SkPreMultiplyColor(c);
+    }
+#endif
+}
+
+SkImageGenerator* SkCompressedImageGenerator::NewFromEncodedCompressed(SkData* data) {
+    if (nullptr == data) {
+        return nullptr;
+    }
+
+    const uint8_t* bytes = data->bytes();
+    const size_t size = data->size();
+
+    SkTextureCompressor::Format format;
+    const uint8_t* blocks;
+    int width, height;
+    bool isPremul = false;
+
+    if (size >= ETC_PKM_HEADER_SIZE && etc1_pkm_is_valid(bytes)) {
+        format = SkTextureCompressor::kETC1_Format;
+        width = etc1_pkm_get_width(bytes);
+        height = etc1_pkm_get_height(bytes);
+        blocks = bytes + ETC_PKM_HEADER_SIZE;
+    } else if (size >= kASTCHeaderSize &&
+               kASTCMagicNumber == SkEndian_SwapLE32(*reinterpret_cast<const uint32_t*>(bytes))) {
+        // We don't support decoding 3D.
+        if (1 != bytes[6] || 1 != read_24bit(bytes + 13) ||
+            !astc_format(bytes[4], bytes[5], &format)) {
+            return nullptr;
+        }
+        width = read_24bit(bytes + 7);
+        height = read_24bit(bytes + 10);
+        blocks = bytes + kASTCHeaderSize;
+    } else if (size >= kKTXIdentifierSize && SkKTXFile::is_ktx(bytes)) {
+        SkKTXFile ktx(data);
+        if (!ktx.valid()) {
+            return nullptr;
+        }
+        int i = 0;
+        for (; i < SkTextureCompressor::kFormatCnt; ++i) {
+            if (ktx.isCompressedFormat(static_cast<SkTextureCompressor::Format>(i))) {
+                break;
+            }
+        }
+        if (SkTextureCompressor::kFormatCnt == i) {
+            // Uncompressed KTX files are left to the image decoders.
+            return nullptr;
+        }
+        format = static_cast<SkTextureCompressor::Format>(i);
+        width = ktx.width();
+        height = ktx.height();
+        blocks = ktx.pixelData();
+        isPremul = ktx.getValueForKey(SkString("KTXPremultipliedAlpha")) == SkString("True");
+    } else {
+        return nullptr;
+    }
+
+#ifdef SK_IGNORE_ETC1_SUPPORT
+    if (SkTextureCompressor::kETC1_Format == format) {
+        return nullptr;
+    }
+#endif
+    if (width <= 0 || height <= 0) {
+        return nullptr;
+    }
+    // We only handle whole blocks, as SkTextureCompressor does.
+    const int dataSize = SkTextureCompressor::GetCompressedDataSize(format, width, height);
+    if (dataSize < 0 || blocks + dataSize > bytes + size) {
+        return nullptr;
+    }
+
+    return new SkCompressedImageGenerator(make_info(width, height, format), data, blocks, format,
+                                          isPremul);
+}
+
+SkCompressedImageGenerator::SkCompressedImageGenerator(const SkImageInfo& info, SkData* data,
+                                                       const uint8_t* blocks,
+                                                       SkTextureCompressor::Format format,
+                                                       bool isPremul)
+    : INHERITED(info)
+    , fData(SkRef(data))
+    , fBlocks(blocks)
+    , fFormat(format)
+    , fIsPremul(isPremul)
+{}
+
+SkData* SkCompressedImageGenerator::onRefEncodedData(SK_REFENCODEDDATA_CTXPARAM) {
+    return SkRef(fData.get());
+}
+
+bool SkCompressedImageGenerator::onGetPixels(const SkImageInfo& info, void* pixels,
+                                             size_t rowBytes, SkPMColor ctable[],
+                                             int* ctableCount) {
+    if (info.dimensions() != this->getInfo().dimensions()) {
+        return false;
+    }
+    return this->decompress(SkIPoint::Make(0, 0), SkPixmap(info, pixels, rowBytes));
+}
+
+bool SkCompressedImageGenerator::onGenerateScaledPixels(const SkISize& scaledSize,
+                                                        const SkIPoint& subsetOrigin,
+                                                        const SkPixmap& subsetPixels) {
+    if (scaledSize != this->getInfo().dimensions()) {
+        return false;
+    }
+    return this->decompress(subsetOrigin, subsetPixels);
+}
+
+bool SkCompressedImageGenerator::decompress(const SkIPoint& origin, const SkPixmap& dst) {
+    const SkImageInfo& info = this->getInfo();
+    if (dst.colorType() != info.colorType() || dst.alphaType() != info.alphaType()) {
+        return false;
+    }
+
+    int dimX, dimY;
+    SkTextureCompressor::GetBlockDimensions(fFormat, &dimX, &dimY, true);
+
+    const SkIRect subset = SkIRect::MakeXYWH(origin.x(), origin.y(), dst.width(), dst.height());
+    const SkIRect blocks = SkIRect::MakeLTRB(subset.fLeft / dimX, subset.fTop / dimY,
+                                             (subset.fRight + dimX - 1) / dimX,
+                                             (subset.fBottom + dimY - 1) / dimY);
+
+    // Decompress one row of blocks at a time into a small buffer, then convert each of the
+    // pixel rows it covers straight into dst.
+    const int bpp = decompressed_bytes_per_pixel(fFormat);
+    const size_t blockRowBytes = blocks.width() * dimX * bpp;
+    SkAutoSMalloc<4096> storage(blockRowBytes * dimY);
+    uint8_t* blockRow = reinterpret_cast<uint8_t*>(storage.get());
+
+    for (int by = blocks.fTop; by < blocks.fBottom; ++by) {
+        if (!SkTextureCompressor::DecompressBlocksFromFormat(
+                blockRow, SkToInt(blockRowBytes), fBlocks, info.width(), info.height(), fFormat,
+                SkIRect::MakeLTRB(blocks.fLeft, by, blocks.fRight, by + 1))) {
+            return false;
+        }
+
+        const int top = SkTMax(subset.fTop, by * dimY);
+        const int bottom = SkTMin(subset.fBottom, (by + 1) * dimY);
+        for (int y = top; y < bottom; ++y) {
+            const uint8_t* src = blockRow + (y - by * dimY) * blockRowBytes
+                                          + (subset.fLeft - blocks.fLeft * dimX) * bpp;
+            const int dstY = y - subset.fTop;
+            switch (bpp) {
+                case 1:
+                    memcpy(dst.writable_addr8(0, dstY), src, dst.width());
+                    break;
+                case 3:
+                    etc1_row_to_n32(dst.writable_addr32(0, dstY), src, dst.width());
+                    break;
+                default:
+                    astc_row_to_n32(dst.writable_addr32(0, dstY),
+                                    reinterpret_cast<const SkColor*>(src), dst.width(),
+                                    fIsPremul);
+                    break;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkData.h"
+#include "SkImageGenerator.h"
+#include "SkTextureCompressor.h"
+
+/*
+ * Generates pixels from block compressed textures (KTX and PKM files, and ASTC files) without
+ * expanding the whole texture: only the compressed data is kept, and each request decompresses
+ * just the blocks that cover it, one row of blocks at a time.  That includes subsets, so
+ * SkImages made from a subset of an atlas only ever decompress their own blocks.
+ *
+ * The raster pipeline never samples the blocks directly.  Drawing one of these images still
+ * decompresses the (subset) image into an N32 or A8 bitmap, which lives in the purgeable
+ * SkResourceCache like any other decoded image.
+ */
+class SkCompressedImageGenerator : public SkImageGenerator {
+public:
+    /*
+     * If this data holds a KTX, PKM or ASTC file in a compressed format that we know how
+     * to decompress, return an SkCompressedImageGenerator.  Otherwise return nullptr.
+     *
+     * Refs the data if an image generator can be returned.  Otherwise does
+     * not affect the data.
+     */
+    static SkImageGenerator* NewFromEncodedCompressed(SkData* data);
+
+protected:
+    SkData* onRefEncodedData(SK_REFENCODEDDATA_CTXPARAM) override;
+
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes, SkPMColor ctable[],
+            int* ctableCount) override;
+
+    // Only supports a scaledSize matching our dimensions, i.e. just subsetting.
+    bool onGenerateScaledPixels(const SkISize& scaledSize, const SkIPoint& subsetOrigin,
+                                const SkPixmap& subsetPixels) override;
+    bool onCanGenerateScaledPixels() const override { return true; }
+
+private:
+    /*
+     * Refs the data
+     */
+    SkCompressedImageGenerator(const SkImageInfo& info, SkData* data, const uint8_t* blocks,
+                               SkTextureCompressor::Format format, bool isPremul);
+
+    bool decompress(const SkIPoint& origin, const SkPixmap& dst);
+
+    SkAutoTUnref<SkData>        fData;
+    const uint8_t*              fBlocks;    // points into fData
+    SkTextureCompressor::Format fFormat;
+    bool                        fIsPremul;  // ASTC data that is already premultiplied
+
+    typedef SkImageGenerator INHERITED;
+};
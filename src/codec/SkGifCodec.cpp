@@ -5,12 +5,17 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
+#include "SkColorSpaceXform.h"
 #include "SkColorTable.h"
 #include "SkGifCodec.h"
+#include "SkNextID.h"
+#include "SkResourceCache.h"
 #include "SkStream.h"
 #include "SkSwizzler.h"
+#include "SkTDArray.h"
 #include "SkUtils.h"
 
 #include "gif_lib.h"
@@ -93,6 +98,53 @@ static uint32_t find_trans_index(const SavedImage& image) {
     return SK_MaxU32;
 }
 
+/*
+ * Sets the frame's duration and disposal method from its graphics control extension
+ */
+static void find_frame_control(const SavedImage& image, int* duration,
+                               SkCodec::DisposalMethod* disposalMethod) {
+    *duration = 0;
+    *disposalMethod = SkCodec::kKeep_DisposalMethod;
+    for (int32_t i = image.ExtensionBlockCount - 1; i >= 0; i--) {
+        const ExtensionBlock& extBlock = image.ExtensionBlocks[i];
+        if (GRAPHICS_EXT_FUNC_CODE == extBlock.Function && extBlock.ByteCount >= 4) {
+            // The delay is in hundredths of a second, stored little endian in the second
+            // and third bytes.  The disposal method is in bits 2-4 of the first byte, and
+            // values other than 2 and 3 mean the frame stays in place.
+            const uint8_t* bytes = (const uint8_t*) extBlock.Bytes;
+            *duration = 10 * (bytes[1] | (bytes[2] << 8));
+            switch ((bytes[0] >> 2) & 7) {
+                case 2:
+                    *disposalMethod = SkCodec::kRestoreBGColor_DisposalMethod;
+                    break;
+                case 3:
+                    *disposalMethod = SkCodec::kRestorePrevious_DisposalMethod;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+    }
+}
+
+/*
+ * Reads past the image data of the current frame, without decoding it
+ */
+static bool skip_image_data(GifFileType* gif) {
+    int codeSize;
+    GifByteType* codeBlock;
+    if (GIF_ERROR == DGifGetCode(gif, &codeSize, &codeBlock)) {
+        return false;
+    }
+    while (nullptr != codeBlock) {
+        if (GIF_ERROR == DGifGetCodeNext(gif, &codeBlock)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 inline uint32_t ceil_div(uint32_t a, uint32_t b) {
     return (a + b - 1) / b;
 }
@@ -239,6 +291,11 @@ SkCodec* SkGifCodec::NewFromStream(SkStream* stream) {
     return nullptr;
 }
 
+static uint64_t make_resource_cache_shared_id(uint32_t codecID) {
+    uint64_t sharedID = SkSetFourByteTag('g', 'i', 'f', 'f');
+    return (sharedID << 32) | codecID;
+}
+
 SkGifCodec::SkGifCodec(const SkImageInfo& srcInfo, SkStream* stream, GifFileType* gif,
         uint32_t transIndex, const SkIRect& frameRect, bool frameIsSubset)
     : INHERITED(srcInfo, stream)
@@ -255,9 +312,34 @@ SkGifCodec::SkGifCodec(const SkImageInfo& srcInfo, SkStream* stream, GifFileType
     , fFrameIsSubset(frameIsSubset)
     , fSwizzler(NULL)
     , fColorTable(NULL)
+    , fFramesParsed(false)
+    , fHasFrameOffsets(false)
+    , fNextFrame(kNone)
+    , fNextFrameOffset(0)
+    , fSnapshotInterval(1)
+    , fUniqueID(SkNextID::ImageID())
 {}
 
+SkGifCodec::~SkGifCodec() {
+    if (fFrames.count() > 1) {
+        SkResourceCache::PostPurgeSharedID(make_resource_cache_shared_id(fUniqueID));
+    }
+}
+
 bool SkGifCodec::onRewind() {
+    // Decoding the frame after the last one drawn carries on from where fGif is, so put the
+    // stream back there.  Decodes of the first frame start over in prepareToDecode().
+    if (kNone != fNextFrame && this->stream()->hasPosition() &&
+            this->stream()->seek(fNextFrameOffset)) {
+        return true;
+    }
+    return this->resetToFirstImage();
+}
+
+bool SkGifCodec::resetToFirstImage() {
+    if (!this->stream()->rewind()) {
+        return false;
+    }
     GifFileType* gifOut = nullptr;
     if (!ReadHeader(this->stream(), nullptr, &gifOut)) {
         return false;
@@ -265,10 +347,13 @@ bool SkGifCodec::onRewind() {
 
     SkASSERT(nullptr != gifOut);
     fGif.reset(gifOut);
+    // fGif has read into the first frame.
+    fNextFrame = kNone;
     return true;
 }
 
-SkCodec::Result SkGifCodec::ReadUpToFirstImage(GifFileType* gif, uint32_t* transIndex) {
+SkCodec::Result SkGifCodec::ReadUpToFirstImage(GifFileType* gif, uint32_t* transIndex,
+        Frame* frame) {
     // Use this as a container to hold information about any gif extension
     // blocks.  This generally stores transparency and animation instructions.
     SavedImage saveExt;
@@ -290,6 +375,9 @@ SkCodec::Result SkGifCodec::ReadUpToFirstImage(GifFileType* gif, uint32_t* trans
         switch (recordType) {
             case IMAGE_DESC_RECORD_TYPE: {
                 *transIndex = find_trans_index(saveExt);
+                if (nullptr != frame) {
+                    find_frame_control(saveExt, &frame->fDuration, &frame->fDisposalMethod);
+                }
 
                 // FIXME: Gif files may have multiple images stored in a single
                 //        file.  This is most commonly used to enable
@@ -444,6 +532,11 @@ void SkGifCodec::initializeColorTable(const SkImageInfo& dstInfo, SkPMColor* inp
         sk_memset32(colorPtr, 0xFF000000, maxColors);
     }
 
+    // Converting the colors once here converts every pixel we draw, and the fill value.
+    if (const SkColorSpaceXform* xform = this->colorXform()) {
+        xform->apply(colorPtr, colorPtr, maxColors, kN32_SkColorType, kPremul_SkAlphaType);
+    }
+
     fColorTable.reset(new SkColorTable(colorPtr, maxColors));
     copy_color_table(dstInfo, this->fColorTable, inputColorPtr, inputColorCount);
 }
@@ -456,6 +549,11 @@ SkCodec::Result SkGifCodec::prepareToDecode(const SkImageInfo& dstInfo, SkPMColo
                 kInvalidConversion);
     }
 
+    // The first frame is read from where ReadHeader() left fGif.
+    if (kNone != fNextFrame && !this->resetToFirstImage()) {
+        return kCouldNotRewind;
+    }
+
     // Initialize color table and copy to the client if necessary
     this->initializeColorTable(dstInfo, inputColorPtr, inputColorCount);
 
@@ -484,6 +582,13 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                                         SkPMColor* inputColorPtr,
                                         int* inputColorCount,
                                         int* rowsDecoded) {
+    if (0 != opts.fFrameIndex) {
+        // decodeFrame() leaves whatever it could not decode as it was in the frames
+        // underneath, so there is nothing for the caller to fill.
+        *rowsDecoded = dstInfo.height();
+        return this->decodeFrame(dstInfo, dst, dstRowBytes, opts);
+    }
+
     Result result = this->prepareToDecode(dstInfo, inputColorPtr, inputColorCount, opts);
     if (kSuccess != result) {
         return result;
@@ -606,3 +711,403 @@ int SkGifCodec::onOutputScanline(int inputScanline) const {
     }
     return inputScanline;
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Animation
+
+namespace {
+static unsigned gGifFrameKeyNamespaceLabel;
+
+struct GifFrameKey : public SkResourceCache::Key {
+public:
+    GifFrameKey(uint32_t codecID, int index, const SkImageInfo& info)
+        : fIndex(index)
+        , fColorType(info.colorType())
+        , fAlphaType(info.alphaType())
+    {
+        this->init(&gGifFrameKeyNamespaceLabel, make_resource_cache_shared_id(codecID),
+                   sizeof(fIndex) + sizeof(fColorType) + sizeof(fAlphaType));
+    }
+
+    const int32_t   fIndex;
+    const int32_t   fColorType;
+    const int32_t   fAlphaType;
+};
+
+struct GifFrameRec : public SkResourceCache::Rec {
+    GifFrameRec(const GifFrameKey& key, const SkBitmap& bitmap)
+        : fKey(key)
+        , fBitmap(bitmap)
+    {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(fKey) + fBitmap.getSize(); }
+    const char* getCategory() const override { return "gif-frame"; }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextPixmap) {
+        const GifFrameRec& rec = static_cast<const GifFrameRec&>(baseRec);
+        const SkPixmap* dst = static_cast<const SkPixmap*>(contextPixmap);
+        // Our copy of the bitmap does not hold a lock on its pixels.
+        SkAutoLockPixels alp(rec.fBitmap);
+        if (!rec.fBitmap.getPixels()) {
+            return false;
+        }
+        const size_t rowBytes = dst->info().minRowBytes();
+        for (int y = 0; y < dst->height(); y++) {
+            memcpy(SkTAddOffset<void>(dst->writable_addr(), y * dst->rowBytes()),
+                   rec.fBitmap.getAddr(0, y), rowBytes);
+        }
+        return true;
+    }
+
+    GifFrameKey fKey;
+    SkBitmap    fBitmap;
+};
+} // namespace
+
+/*
+ * The value to clear with, where a frame starts from nothing or restores to the background
+ */
+static uint32_t get_clear_value(const GifFileType* gif, const SkImageInfo& dstInfo,
+                                const SkColorSpaceXform* xform) {
+    SkPMColor color = SK_ColorTRANSPARENT;
+    if (kOpaque_SkAlphaType == dstInfo.alphaType()) {
+        // We cannot clear to transparent, so use the background color.
+        color = SkPackARGB32(0xFF, 0, 0, 0);
+        const ColorMapObject* colorMap = gif->SColorMap;
+        if (nullptr != colorMap && gif->SBackGroundColor < colorMap->ColorCount) {
+            const GifColorType& bg = colorMap->Colors[gif->SBackGroundColor];
+            color = SkPackARGB32(0xFF, bg.Red, bg.Green, bg.Blue);
+        }
+        if (xform) {
+            xform->apply(&color, &color, 1, kN32_SkColorType, kPremul_SkAlphaType);
+        }
+    }
+    return kRGB_565_SkColorType == dstInfo.colorType() ? SkPixel32ToPixel16(color) : color;
+}
+
+template <typename T>
+static void blit_frame_row(T* SK_RESTRICT dst, const uint8_t* SK_RESTRICT src, int width,
+                           const uint32_t colors[256], const bool opaque[256]) {
+    for (int x = 0; x < width; x++) {
+        if (opaque[src[x]]) {
+            dst[x] = (T) colors[src[x]];
+        }
+    }
+}
+
+int SkGifCodec::onGetFrameCount() {
+    this->parseFrames();
+    return fFrames.count();
+}
+
+bool SkGifCodec::onGetFrameInfo(int index, FrameInfo* info) {
+    this->parseFrames();
+    const Frame& frame = fFrames[index];
+    info->fRequiredFrame = frame.fRequiredFrame;
+    info->fDuration = frame.fDuration;
+    info->fDisposalMethod = frame.fDisposalMethod;
+    info->fFrameRect = frame.fRect;
+    return true;
+}
+
+void SkGifCodec::parseFrames() {
+    if (fFramesParsed) {
+        return;
+    }
+    fFramesParsed = true;
+
+    // Prefer to read a duplicate of the stream, which leaves fGif alone.
+    SkAutoTDelete<SkStream> duplicate(this->stream()->duplicate());
+    SkStream* stream = duplicate.get();
+    if (nullptr == stream && this->stream()->rewind()) {
+        stream = this->stream();
+    }
+
+    if (nullptr != stream) {
+        SkAutoTCallVProc<GifFileType, CloseGif> gif(open_gif(stream));
+        fHasFrameOffsets = stream->hasPosition();
+        while (nullptr != gif) {
+            Frame frame;
+            frame.fOffset = stream->getPosition();
+            // This fails at the trailer, once there are no more images.
+            if (kSuccess != ReadUpToFirstImage(gif, &frame.fTransIndex, &frame) ||
+                    GIF_ERROR == DGifGetImageDesc(gif)) {
+                break;
+            }
+            const GifImageDesc& desc = gif->Image;
+            frame.fRect.setXYWH(desc.Left, desc.Top, desc.Width, desc.Height);
+            fFrames.push_back(frame);
+
+            // A truncated frame is still a frame; we will decode as much of it as we can.
+            if (!skip_image_data(gif)) {
+                break;
+            }
+        }
+
+        if (stream == this->stream()) {
+            // Put fGif back where it was when this codec was created.
+            if (!this->resetToFirstImage()) {
+                fFrames.reset();
+            }
+        }
+    }
+
+    if (fFrames.empty()) {
+        // Fall back to the first frame, as we found it in ReadHeader().
+        Frame& frame = fFrames.push_back();
+        frame.fOffset = 0;
+        frame.fRect = fFrameRect;
+        frame.fTransIndex = fTransIndex;
+        frame.fDuration = 0;
+        frame.fDisposalMethod = kKeep_DisposalMethod;
+        fHasFrameOffsets = false;
+    }
+
+    // Work out which frame each frame must be drawn on top of.  A frame that covers
+    // the whole image, and has no transparent pixels, needs nothing underneath it.
+    // Otherwise we need the previous frame, unless that frame is disposed by
+    // restoring what was under it (so we need what it needed), or by clearing the
+    // whole image.
+    const SkIRect bounds = SkIRect::MakeSize(this->getInfo().dimensions());
+    for (int i = 0; i < fFrames.count(); i++) {
+        Frame& frame = fFrames[i];
+        frame.fRequiredFrame = kNone;
+        if (0 == i || (frame.fTransIndex >= 256 && frame.fRect.contains(bounds))) {
+            continue;
+        }
+
+        const Frame& prev = fFrames[i - 1];
+        switch (prev.fDisposalMethod) {
+            case kKeep_DisposalMethod:
+                frame.fRequiredFrame = i - 1;
+                break;
+            case kRestorePrevious_DisposalMethod:
+                frame.fRequiredFrame = prev.fRequiredFrame;
+                break;
+            case kRestoreBGColor_DisposalMethod:
+                // An independent frame started from a clear image, so clearing it leaves
+                // nothing behind.
+                if (kNone != prev.fRequiredFrame && !prev.fRect.contains(bounds)) {
+                    frame.fRequiredFrame = i - 1;
+                }
+                break;
+        }
+    }
+
+    // Space the snapshots so that one of each frame would use no more than a quarter
+    // of the cache.
+    const uint64_t frameBytes = SkTMax<uint64_t>(1,
+            (uint64_t) this->getInfo().width() * this->getInfo().height() * sizeof(SkPMColor));
+    const uint64_t maxSnapshots = SkTMax<uint64_t>(1,
+            SkResourceCache::GetTotalByteLimit() / 4 / frameBytes);
+    fSnapshotInterval = (int) SkTMax<uint64_t>(1,
+            (fFrames.count() + maxSnapshots - 1) / maxSnapshots);
+}
+
+SkCodec::Result SkGifCodec::seekToFrame(int index) {
+    SkASSERT(index >= 0 && index < fFrames.count());
+
+    if (kNone == fNextFrame || index < fNextFrame) {
+        // Start again from just after the header, skipping ahead if we can.
+        fNextFrame = kNone;
+        if (!this->stream()->rewind()) {
+            return kCouldNotRewind;
+        }
+        GifFileType* gif = open_gif(this->stream());
+        if (nullptr == gif) {
+            return gif_error("DGifOpen failed.\n");
+        }
+        fGif.reset(gif);
+        fNextFrame = 0;
+
+        if (fHasFrameOffsets && index > 0) {
+            if (!this->stream()->seek(fFrames[index].fOffset)) {
+                // We no longer know where we are, so start again without the offsets.
+                fHasFrameOffsets = false;
+                fNextFrame = kNone;
+                return this->seekToFrame(index);
+            }
+            fNextFrame = index;
+        }
+    }
+
+    // fNextFrame is only valid again once the frame has been read to the end.
+    const int nextFrame = fNextFrame;
+    fNextFrame = kNone;
+
+    uint32_t transIndex;
+    for (int i = nextFrame; i < index; i++) {
+        if (kSuccess != ReadUpToFirstImage(fGif, &transIndex) ||
+                GIF_ERROR == DGifGetImageDesc(fGif) || !skip_image_data(fGif)) {
+            return gif_error("Could not skip frame.\n", kIncompleteInput);
+        }
+    }
+    if (kSuccess != ReadUpToFirstImage(fGif, &transIndex) || GIF_ERROR == DGifGetImageDesc(fGif)) {
+        return gif_error("Could not read frame.\n", kIncompleteInput);
+    }
+    return kSuccess;
+}
+
+SkCodec::Result SkGifCodec::drawFrame(int index, const SkImageInfo& dstInfo, void* dst,
+        size_t dstRowBytes) {
+    const Result result = this->seekToFrame(index);
+    if (kSuccess != result) {
+        return result;
+    }
+
+    // Pixels are drawn only if their index is in the color table, and is not the
+    // transparent index.  Anything else leaves what is underneath.
+    uint32_t colors[256];
+    bool opaque[256];
+    sk_bzero(opaque, sizeof(opaque));
+    const ColorMapObject* colorMap = fGif->Image.ColorMap ? fGif->Image.ColorMap : fGif->SColorMap;
+    const int colorCount = colorMap ? SkTMin(colorMap->ColorCount, 256) : 0;
+    for (int i = 0; i < colorCount; i++) {
+        const GifColorType& c = colorMap->Colors[i];
+        const SkPMColor color = SkPackARGB32(0xFF, c.Red, c.Green, c.Blue);
+        colors[i] = kRGB_565_SkColorType == dstInfo.colorType() ? SkPixel32ToPixel16(color)
+                                                                : color;
+        opaque[i] = (uint32_t) i != fFrames[index].fTransIndex;
+    }
+    if (const SkColorSpaceXform* xform = this->colorXform()) {
+        // Only 8888 destinations have a transform, so colors are still SkPMColors.
+        xform->apply(colors, colors, colorCount, kN32_SkColorType, kPremul_SkAlphaType);
+    }
+
+    const SkIRect& frameRect = fFrames[index].fRect;
+    SkIRect clip = frameRect;
+    if (!clip.intersect(SkIRect::MakeSize(dstInfo.dimensions()))) {
+        return kSuccess;
+    }
+
+    const bool interlaced = fGif->Image.Interlace;
+    SkAutoTMalloc<uint8_t> row(frameRect.width());
+    for (int y = 0; y < frameRect.height(); y++) {
+        if (GIF_ERROR == DGifGetLine(fGif, row.get(), frameRect.width())) {
+            return gif_error("Could not decode line.\n", kIncompleteInput);
+        }
+        const int dstY = frameRect.top() +
+                (interlaced ? get_output_row_interlaced(y, frameRect.height()) : y);
+        if (dstY < clip.top() || dstY >= clip.bottom()) {
+            continue;
+        }
+
+        const uint8_t* src = row.get() + clip.left() - frameRect.left();
+        void* dstRow = SkTAddOffset<void>(dst, dstY * dstRowBytes);
+        if (kRGB_565_SkColorType == dstInfo.colorType()) {
+            blit_frame_row((uint16_t*) dstRow + clip.left(), src, clip.width(), colors, opaque);
+        } else {
+            blit_frame_row((uint32_t*) dstRow + clip.left(), src, clip.width(), colors, opaque);
+        }
+    }
+
+    fNextFrame = index + 1;
+    fNextFrameOffset = this->stream()->getPosition();
+    return kSuccess;
+}
+
+void SkGifCodec::disposeFrame(int index, const SkImageInfo& dstInfo, void* dst,
+        size_t dstRowBytes, uint32_t clearValue) {
+    // kRestorePrevious frames are never required, so never need to be disposed.
+    if (kRestoreBGColor_DisposalMethod != fFrames[index].fDisposalMethod) {
+        return;
+    }
+
+    SkIRect clip = fFrames[index].fRect;
+    if (!clip.intersect(SkIRect::MakeSize(dstInfo.dimensions()))) {
+        return;
+    }
+
+    // Fill one row at a time, since Fill() writes through to the end of the row bytes.
+    const SkImageInfo rowInfo = dstInfo.makeWH(clip.width(), 1);
+    const size_t offset = clip.left() * dstInfo.bytesPerPixel();
+    for (int y = clip.top(); y < clip.bottom(); y++) {
+        SkSampler::Fill(rowInfo, SkTAddOffset<void>(dst, y * dstRowBytes + offset), dstRowBytes,
+                clearValue, kNo_ZeroInitialized);
+    }
+}
+
+bool SkGifCodec::findSnapshot(int index, const SkImageInfo& dstInfo, void* dst,
+        size_t dstRowBytes) {
+    SkPixmap pixmap(dstInfo, dst, dstRowBytes);
+    return SkResourceCache::Find(GifFrameKey(fUniqueID, index, dstInfo), GifFrameRec::Finder,
+                                 &pixmap);
+}
+
+void SkGifCodec::addSnapshot(int index, const SkImageInfo& dstInfo, const void* src,
+        size_t srcRowBytes) {
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocPixels(dstInfo)) {
+        return;
+    }
+    for (int y = 0; y < dstInfo.height(); y++) {
+        memcpy(bitmap.getAddr(0, y), SkTAddOffset<const void>(src, y * srcRowBytes),
+               dstInfo.minRowBytes());
+    }
+    bitmap.setImmutable();
+    SkResourceCache::Add(new GifFrameRec(GifFrameKey(fUniqueID, index, dstInfo), bitmap));
+}
+
+SkCodec::Result SkGifCodec::decodeFrame(const SkImageInfo& dstInfo, void* dst,
+        size_t dstRowBytes, const Options& opts) {
+    if (!conversion_possible(dstInfo, this->getInfo())) {
+        return gif_error("Cannot convert input type to output type.\n", kInvalidConversion);
+    }
+    // Index8 would need a color table shared by every frame.
+    if (kN32_SkColorType != dstInfo.colorType() && kRGB_565_SkColorType != dstInfo.colorType()) {
+        return gif_error("Frames after the first only support kN32 and k565.\n",
+                kInvalidConversion);
+    }
+    if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+        return gif_error("Scaling not supported.\n", kInvalidScale);
+    }
+
+    // Snapshots are keyed by color type, not color space, so only share unconverted frames.
+    const bool useSnapshots = fFrames.count() > 1 && !this->colorXform();
+
+    // Walk back through the frames this one is drawn on top of, until we find one that
+    // is already in dst or in the cache, or one that starts from nothing.
+    SkTDArray<int> toDraw;
+    int base = kNone;
+    for (int index = opts.fFrameIndex; ; index = fFrames[index].fRequiredFrame) {
+        *toDraw.append() = index;
+        const int required = fFrames[index].fRequiredFrame;
+        if (kNone == required) {
+            break;
+        }
+        if (required == opts.fPriorFrame ||
+                (useSnapshots && this->findSnapshot(required, dstInfo, dst, dstRowBytes))) {
+            base = required;
+            break;
+        }
+    }
+
+    const uint32_t clearValue = get_clear_value(fGif, dstInfo, this->colorXform());
+    if (kNone == base) {
+        SkSampler::Fill(dstInfo, dst, dstRowBytes, clearValue, opts.fZeroInitialized);
+    } else {
+        this->disposeFrame(base, dstInfo, dst, dstRowBytes, clearValue);
+    }
+
+    // Snapshot the first frame we draw in each run of fSnapshotInterval frames.
+    int prevRun = kNone == base ? -1 : base / fSnapshotInterval;
+    for (int i = toDraw.count() - 1; i >= 0; i--) {
+        const int index = toDraw[i];
+        const Result result = this->drawFrame(index, dstInfo, dst, dstRowBytes);
+        if (kSuccess != result) {
+            return result;
+        }
+
+        const int run = index / fSnapshotInterval;
+        if (run != prevRun && useSnapshots) {
+            this->addSnapshot(index, dstInfo, dst, dstRowBytes);
+        }
+        prevRun = run;
+
+        if (i > 0) {
+            this->disposeFrame(index, dstInfo, dst, dstRowBytes, clearValue);
+        }
+    }
+    return kSuccess;
+}
@@ -9,6 +9,7 @@
 #include "SkColorTable.h"
 #include "SkImageInfo.h"
 #include "SkSwizzler.h"
+#include "SkTArray.h"
 
 struct GifFileType;
 struct SavedImage;
@@ -29,6 +30,8 @@ public:
      */
     static SkCodec* NewFromStream(SkStream*);
 
+    ~SkGifCodec() override;
+
 protected:
 
     /*
@@ -67,10 +70,71 @@ protected:
 
     uint32_t onGetFillValue(SkColorType) const override;
 
+    // We convert the color table, so frames drawn over a prior frame leave its pixels as they are.
+    bool onAppliesColorXform() const override { return true; }
+
     int onOutputScanline(int inputScanline) const override;
 
+    int onGetFrameCount() override;
+
+    bool onGetFrameInfo(int index, FrameInfo*) override;
+
 private:
 
+    /*
+     * What we know about a frame without decoding it.
+     */
+    struct Frame {
+        size_t          fOffset;        // stream position of the frame's first record
+        SkIRect         fRect;
+        uint32_t        fTransIndex;
+        int             fDuration;
+        DisposalMethod  fDisposalMethod;
+        int             fRequiredFrame;
+    };
+
+    /*
+     * Reads through the whole stream, once, to fill fFrames.
+     */
+    void parseFrames();
+
+    /*
+     * Rewinds the stream and reads it into the first image, as ReadHeader() left it.
+     */
+    bool resetToFirstImage();
+
+    /*
+     * Positions fGif at the start of the image data of frame 'index', with its
+     * image descriptor read.
+     */
+    Result seekToFrame(int index);
+
+    /*
+     * Decodes a frame other than the first, composing it on top of the frames it
+     * depends on.  Only kN32 and k565 are supported.
+     */
+    Result decodeFrame(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+            const Options& opts);
+
+    /*
+     * Draws the opaque pixels of a single frame onto dst, which must already hold
+     * the frame's starting state.
+     */
+    Result drawFrame(int index, const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes);
+
+    /*
+     * Applies the disposal method of frame 'index'.  dst holds that frame, composed.
+     */
+    void disposeFrame(int index, const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+            uint32_t clearValue);
+
+    /*
+     * Keyframes of composed frames are kept in the SkResourceCache, so that any frame
+     * can be reached by drawing at most fSnapshotInterval frames.
+     */
+    bool findSnapshot(int index, const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes);
+    void addSnapshot(int index, const SkImageInfo& dstInfo, const void* src, size_t srcRowBytes);
+
     /*
      * A gif can contain multiple image frames.  We will only decode the first
      * frame.  This function reads up to the first image frame, processing
@@ -80,8 +144,11 @@ private:
      * @param gif        Pointer to the library type that manages the gif decode
      * @param transIndex This call will set the transparent index based on the
      *                   extension data.
+     * @param frame      If not nullptr, this call will set its duration and
+     *                   disposal method based on the extension data.
      */
-     static Result ReadUpToFirstImage(GifFileType* gif, uint32_t* transIndex);
+     static Result ReadUpToFirstImage(GifFileType* gif, uint32_t* transIndex,
+             Frame* frame = nullptr);
 
      /*
       * A gif may contain many image frames, all of different sizes.
@@ -200,5 +267,17 @@ private:
     SkAutoTDelete<SkSwizzler>               fSwizzler;
     SkAutoTUnref<SkColorTable>              fColorTable;
 
+    // Filled in by parseFrames(), which is deferred until the client asks about frames.
+    SkTArray<Frame, true>                   fFrames;
+    bool                                    fFramesParsed;
+    bool                                    fHasFrameOffsets;
+    // The frame whose records fGif will read next, or kNone if we must start over.  Once a
+    // frame has been drawn, fGif is past the first image, and fNextFrameOffset is the stream
+    // position of the next frame's records, which survives a rewind of a seekable stream.
+    int                                     fNextFrame;
+    size_t                                  fNextFrameOffset;
+    int                                     fSnapshotInterval;
+    const uint32_t                          fUniqueID;
+
     typedef SkCodec INHERITED;
 };
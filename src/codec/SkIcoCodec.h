@@ -45,6 +45,9 @@ protected:
 
     SkScanlineOrder onGetScanlineOrder() const override;
 
+    // The embedded codecs are given the same options, so they convert to the color space.
+    bool onAppliesColorXform() const override { return true; }
+
 private:
 
     Result onStartScanlineDecode(const SkImageInfo& dstInfo, const SkCodec::Options& options,
@@ -6,6 +6,7 @@
  */
 
 #include "SkCodec.h"
+#include "SkCodecPool.h"
 #include "SkMSAN.h"
 #include "SkJpegCodec.h"
 #include "SkJpegDecoderMgr.h"
@@ -30,10 +31,11 @@ bool SkJpegCodec::IsJpeg(const void* buffer, size_t bytesRead) {
 }
 
 bool SkJpegCodec::ReadHeader(SkStream* stream, SkCodec** codecOut,
-        JpegDecoderMgr** decoderMgrOut) {
+        JpegDecoderMgr** decoderMgrOut, bool pooled) {
 
     // Create a JpegDecoderMgr to own all of the decompress information
-    SkAutoTDelete<JpegDecoderMgr> decoderMgr(new JpegDecoderMgr(stream));
+    SkAutoTDelete<JpegDecoderMgr> decoderMgr(pooled ? SkCodecPool::AcquireJpeg(stream)
+                                                    : new JpegDecoderMgr(stream));
 
     // libjpeg errors will be caught and reported here
     if (setjmp(decoderMgr->getJmpBuf())) {
@@ -55,7 +57,7 @@ bool SkJpegCodec::ReadHeader(SkStream* stream, SkCodec** codecOut,
         // Create image info object and the codec
         const SkImageInfo& imageInfo = SkImageInfo::Make(decoderMgr->dinfo()->image_width,
                 decoderMgr->dinfo()->image_height, colorType, kOpaque_SkAlphaType);
-        *codecOut = new SkJpegCodec(imageInfo, stream, decoderMgr.detach());
+        *codecOut = new SkJpegCodec(imageInfo, stream, decoderMgr.detach(), pooled);
     } else {
         SkASSERT(nullptr != decoderMgrOut);
         *decoderMgrOut = decoderMgr.detach();
@@ -63,10 +65,10 @@ bool SkJpegCodec::ReadHeader(SkStream* stream, SkCodec** codecOut,
     return true;
 }
 
-SkCodec* SkJpegCodec::NewFromStream(SkStream* stream) {
+SkCodec* SkJpegCodec::NewFromStream(SkStream* stream, bool pooled) {
     SkAutoTDelete<SkStream> streamDeleter(stream);
     SkCodec* codec = nullptr;
-    if (ReadHeader(stream,  &codec, nullptr)) {
+    if (ReadHeader(stream,  &codec, nullptr, pooled)) {
         // Codec has taken ownership of the stream, we do not need to delete it
         SkASSERT(codec);
         streamDeleter.detach();
@@ -75,15 +77,30 @@ SkCodec* SkJpegCodec::NewFromStream(SkStream* stream) {
     return nullptr;
 }
 
+SkCodec* SkJpegCodec::NewFromStream(SkStream* stream) {
+    return NewFromStream(stream, false);
+}
+
+SkCodec* SkJpegCodec::NewFromStreamPooled(SkStream* stream) {
+    return NewFromStream(stream, true);
+}
+
 SkJpegCodec::SkJpegCodec(const SkImageInfo& srcInfo, SkStream* stream,
-        JpegDecoderMgr* decoderMgr)
+        JpegDecoderMgr* decoderMgr, bool pooled)
     : INHERITED(srcInfo, stream)
     , fDecoderMgr(decoderMgr)
+    , fPooled(pooled)
     , fReadyState(decoderMgr->dinfo()->global_state)
     , fSrcRow(nullptr)
     , fSwizzlerSubset(SkIRect::MakeEmpty())
 {}
 
+SkJpegCodec::~SkJpegCodec() {
+    if (fPooled) {
+        SkCodecPool::Release(fDecoderMgr.detach());
+    }
+}
+
 /*
  * Return the row bytes of a particular image type and width
  */
@@ -151,10 +168,13 @@ SkISize SkJpegCodec::onGetScaledDimensions(float desiredScale) const {
 
 bool SkJpegCodec::onRewind() {
     JpegDecoderMgr* decoderMgr = nullptr;
-    if (!ReadHeader(this->stream(), nullptr, &decoderMgr)) {
+    if (!ReadHeader(this->stream(), nullptr, &decoderMgr, fPooled)) {
         return fDecoderMgr->returnFalse("could not rewind");
     }
     SkASSERT(nullptr != decoderMgr);
+    if (fPooled) {
+        SkCodecPool::Release(fDecoderMgr.detach());
+    }
     fDecoderMgr.reset(decoderMgr);
 
     fSwizzler.reset(nullptr);
@@ -32,6 +32,13 @@ public:
      */
     static SkCodec* NewFromStream(SkStream*);
 
+    /*
+     * As above, but the decompress struct comes from, and goes back to, SkCodecPool
+     */
+    static SkCodec* NewFromStreamPooled(SkStream*);
+
+    ~SkJpegCodec() override;
+
 protected:
 
     /*
@@ -77,9 +84,14 @@ private:
      * codecOut will take ownership of it in the case where we created a codec.
      * Ownership is unchanged when we set decoderMgrOut.
      *
+     * @param pooled
+     * Take the JpegDecoderMgr from SkCodecPool rather than creating one.
+     *
      */
     static bool ReadHeader(SkStream* stream, SkCodec** codecOut,
-            JpegDecoderMgr** decoderMgrOut);
+            JpegDecoderMgr** decoderMgrOut, bool pooled);
+
+    static SkCodec* NewFromStream(SkStream*, bool pooled);
 
     /*
      * Creates an instance of the decoder
@@ -89,8 +101,10 @@ private:
      * @param stream the encoded image data
      * @param decoderMgr holds decompress struct, src manager, and error manager
      *                   takes ownership
+     * @param pooled whether decoderMgr goes back to SkCodecPool when we are done with it
      */
-    SkJpegCodec(const SkImageInfo& srcInfo, SkStream* stream, JpegDecoderMgr* decoderMgr);
+    SkJpegCodec(const SkImageInfo& srcInfo, SkStream* stream, JpegDecoderMgr* decoderMgr,
+            bool pooled);
 
     /*
      * Checks if the conversion between the input image and the requested output
@@ -108,6 +122,7 @@ private:
     bool onSkipScanlines(int count) override;
 
     SkAutoTDelete<JpegDecoderMgr> fDecoderMgr;
+    const bool                    fPooled;
     // We will save the state of the decompress struct after reading the header.
     // This allows us to safely call onGetScaledDimensions() at any time.
     const int                     fReadyState;
@@ -53,12 +53,23 @@ JpegDecoderMgr::JpegDecoderMgr(SkStream* stream)
 }
 
 void JpegDecoderMgr::init() {
-    jpeg_create_decompress(&fDInfo);
-    fInit = true;
+    if (!fInit) {
+        jpeg_create_decompress(&fDInfo);
+        fInit = true;
+    }
     fDInfo.src = &fSrcMgr;
     fDInfo.err->output_message = &output_message;
 }
 
+void JpegDecoderMgr::reset(SkStream* stream) {
+    if (fInit) {
+        // This frees everything allocated for the last image, but keeps the struct itself,
+        // ready for jpeg_read_header().
+        jpeg_abort_decompress(&fDInfo);
+    }
+    fSrcMgr.fStream = stream;
+}
+
 JpegDecoderMgr::~JpegDecoderMgr() {
     if (fInit) {
         jpeg_destroy_decompress(&fDInfo);
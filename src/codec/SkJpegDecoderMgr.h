@@ -39,11 +39,17 @@ public:
     JpegDecoderMgr(SkStream* stream);
 
     /*
-     * Initialize decompress struct
+     * Initialize decompress struct, if it has not been already
      * Initialize the source manager
      */
     void  init();
 
+    /*
+     * Abort any decode in progress, keeping the decompress struct for reuse, and read from
+     * stream from now on.  Does not take ownership of stream.
+     */
+    void reset(SkStream* stream);
+
     /*
      * Recommend a color type based on the encoded format
      */
@@ -7,11 +7,14 @@
 
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
+#include "SkColorSpace.h"
+#include "SkCodecPool.h"
 #include "SkColorTable.h"
 #include "SkBitmap.h"
 #include "SkMath.h"
 #include "SkOpts.h"
 #include "SkPngCodec.h"
+#include "SkPngRowReader.h"
 #include "SkSize.h"
 #include "SkStream.h"
 #include "SkSwizzler.h"
@@ -43,6 +46,16 @@ static void sk_read_fn(png_structp png_ptr, png_bytep data,
     }
 }
 
+#ifdef PNG_USER_MEM_SUPPORTED
+static png_voidp sk_pool_malloc_fn(png_structp, png_alloc_size_t size) {
+    return SkCodecPool::Alloc(size);
+}
+
+static void sk_pool_free_fn(png_structp, png_voidp ptr) {
+    SkCodecPool::Free(ptr);
+}
+#endif
+
 #ifdef PNG_READ_UNKNOWN_CHUNKS_SUPPORTED
 static int sk_read_user_chunk(png_structp png_ptr, png_unknown_chunkp chunk) {
     SkPngChunkReader* chunkReader = (SkPngChunkReader*)png_get_user_chunk_ptr(png_ptr);
@@ -187,10 +200,18 @@ bool SkPngCodec::IsPng(const char* buf, size_t bytesRead) {
 //      If it returns false, the passed in fields (except stream) are unchanged.
 static bool read_header(SkStream* stream, SkPngChunkReader* chunkReader,
                         png_structp* png_ptrp, png_infop* info_ptrp,
-                        SkImageInfo* imageInfo, int* bitDepthPtr, int* numberPassesPtr) {
+                        SkImageInfo* imageInfo, int* bitDepthPtr, int* numberPassesPtr,
+                        bool pooled) {
     // The image is known to be a PNG. Decode enough to know the SkImageInfo.
+#ifdef PNG_USER_MEM_SUPPORTED
+    png_structp png_ptr = pooled
+            ? png_create_read_struct_2(PNG_LIBPNG_VER_STRING, nullptr, sk_error_fn,
+                                       sk_warning_fn, nullptr, sk_pool_malloc_fn, sk_pool_free_fn)
+            : png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, sk_error_fn, sk_warning_fn);
+#else
     png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr,
                                                  sk_error_fn, sk_warning_fn);
+#endif
     if (!png_ptr) {
         return false;
     }
@@ -329,15 +350,40 @@ static bool read_header(SkStream* stream, SkPngChunkReader* chunkReader,
     return true;
 }
 
+// Returns the color space the image is tagged with, from its sRGB or iCCP chunk, or nullptr
+// if it has neither (or has an ICC profile SkColorSpace does not understand).
+static SkColorSpace* read_color_space(png_structp png_ptr, png_infop info_ptr) {
+    if (png_get_valid(png_ptr, info_ptr, PNG_INFO_sRGB)) {
+        return SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named);
+    }
+
+#ifdef PNG_READ_iCCP_SUPPORTED
+    png_charp name;
+    int compression;
+#if PNG_LIBPNG_VER < 10500
+    png_charp profile;
+#else
+    png_bytep profile;
+#endif
+    png_uint_32 length;
+    if (png_get_iCCP(png_ptr, info_ptr, &name, &compression, &profile, &length)) {
+        return SkColorSpace::NewICC(profile, length);
+    }
+#endif
+    return nullptr;
+}
+
 SkPngCodec::SkPngCodec(const SkImageInfo& info, SkStream* stream, SkPngChunkReader* chunkReader,
-                       png_structp png_ptr, png_infop info_ptr, int bitDepth, int numberPasses)
-    : INHERITED(info, stream)
+                       png_structp png_ptr, png_infop info_ptr, int bitDepth, int numberPasses,
+                       bool pooled, SkColorSpace* colorSpace)
+    : INHERITED(info, stream, colorSpace)
     , fPngChunkReader(SkSafeRef(chunkReader))
     , fPng_ptr(png_ptr)
     , fInfo_ptr(info_ptr)
     , fSrcConfig(SkSwizzler::kUnknown)
     , fNumberPasses(numberPasses)
     , fBitDepth(bitDepth)
+    , fPooled(pooled)
 {}
 
 SkPngCodec::~SkPngCodec() {
@@ -416,7 +462,8 @@ SkCodec::Result SkPngCodec::initializeSwizzler(const SkImageInfo& requestedInfo,
 
     // Create the swizzler.  SkPngCodec retains ownership of the color table.
     const SkPMColor* colors = get_color_ptr(fColorTable.get());
-    fSwizzler.reset(SkSwizzler::CreateSwizzler(fSrcConfig, colors, requestedInfo, options));
+    fSwizzler.reset(SkSwizzler::CreateSwizzler(fSrcConfig, colors, requestedInfo, options,
+                                               nullptr, this->colorXform()));
     SkASSERT(fSwizzler);
 
     return kSuccess;
@@ -434,7 +481,7 @@ bool SkPngCodec::onRewind() {
     png_structp png_ptr;
     png_infop info_ptr;
     if (!read_header(this->stream(), fPngChunkReader.get(), &png_ptr, &info_ptr,
-                     nullptr, nullptr, nullptr)) {
+                     nullptr, nullptr, nullptr, fPooled)) {
         return false;
     }
 
@@ -538,12 +585,44 @@ uint32_t SkPngCodec::onGetFillValue(SkColorType colorType) const {
 }
 
 // Subclass of SkPngCodec which supports scanline decoding
+/*
+ * Returns the bytes per pixel of the rows as they are stored in the image data, if they are
+ * exactly what the swizzler expects, so that they can be read without libpng.  Otherwise
+ * returns 0.
+ *
+ * This must be called before png_read_update_info(), which replaces the color type and tRNS
+ * flag from the IHDR with those of the transformed rows (e.g. RGB with tRNS becomes RGBA).
+ */
+static int raw_row_bytes_per_pixel(png_structp png_ptr, png_infop info_ptr, int bitDepth) {
+    if (8 != bitDepth) {
+        return 0;
+    }
+    const bool hasTrns = png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
+    switch (png_get_color_type(png_ptr, info_ptr)) {
+        case PNG_COLOR_TYPE_PALETTE:
+            return 1;
+        case PNG_COLOR_TYPE_GRAY:
+            return hasTrns ? 0 : 1;
+        case PNG_COLOR_TYPE_GRAY_ALPHA:
+            return 2;
+        case PNG_COLOR_TYPE_RGB:
+            return hasTrns ? 0 : 3;
+        case PNG_COLOR_TYPE_RGBA:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
 class SkPngScanlineDecoder : public SkPngCodec {
 public:
     SkPngScanlineDecoder(const SkImageInfo& srcInfo, SkStream* stream,
-            SkPngChunkReader* chunkReader, png_structp png_ptr, png_infop info_ptr, int bitDepth)
-        : INHERITED(srcInfo, stream, chunkReader, png_ptr, info_ptr, bitDepth, 1)
+            SkPngChunkReader* chunkReader, png_structp png_ptr, png_infop info_ptr, int bitDepth,
+            bool pooled, SkColorSpace* colorSpace)
+        : INHERITED(srcInfo, stream, chunkReader, png_ptr, info_ptr, bitDepth, 1, pooled,
+                    colorSpace)
         , fSrcRow(nullptr)
+        , fRawBytesPerPixel(raw_row_bytes_per_pixel(png_ptr, info_ptr, bitDepth))
     {}
 
     Result onStartScanlineDecode(const SkImageInfo& dstInfo, const Options& options,
@@ -561,10 +640,41 @@ public:
         fStorage.reset(this->getInfo().width() * SkSwizzler::BytesPerPixel(this->srcConfig()));
         fSrcRow = fStorage.get();
 
+        // When the rows need no libpng transforms, inflate and unfilter them ourselves, so
+        // that skipping rows can jump ahead using the seek index.  The index is built as we
+        // go, and kept for later decodes, so that decoding a region near the bottom of a
+        // large image does not need to inflate everything above it each time.
+        fRowReader.reset(nullptr);
+        const int bpp = fRawBytesPerPixel;
+        if (bpp && this->getInfo().height() > 1) {
+            const size_t srcRowBytes = this->getInfo().width() * bpp;
+            if (!fSeekIndex) {
+                fSeekIndex.reset(new SkPngSeekIndex(srcRowBytes, this->getInfo().height()));
+            }
+            fRowReader.reset(new SkPngRowReader(this->stream(), srcRowBytes, bpp,
+                                                this->getInfo().height(), fSeekIndex));
+            if (!fRowReader->isValid()) {
+                fRowReader.reset(nullptr);
+            }
+        }
+
         return kSuccess;
     }
 
     int onGetScanlines(void* dst, int count, size_t rowBytes) override {
+        if (fRowReader) {
+            void* dstRow = dst;
+            for (int row = 0; row < count; row++) {
+                const uint8_t* srcRow = fRowReader->readRow();
+                if (!srcRow) {
+                    return row;
+                }
+                this->swizzler()->swizzle(dstRow, srcRow);
+                dstRow = SkTAddOffset<void>(dstRow, rowBytes);
+            }
+            return count;
+        }
+
         // Assume that an error in libpng indicates an incomplete input.
         int row = 0;
         if (setjmp(png_jmpbuf(this->png_ptr()))) {
@@ -583,6 +693,10 @@ public:
     }
 
     bool onSkipScanlines(int count) override {
+        if (fRowReader) {
+            return fRowReader->skipRows(count);
+        }
+
         // Assume that an error in libpng indicates an incomplete input.
         if (setjmp(png_jmpbuf(this->png_ptr()))) {
             SkCodecPrintf("setjmp long jump!\n");
@@ -595,9 +709,19 @@ public:
         return true;
     }
 
+    bool onRewind() override {
+        // The reader holds the stream position and inflate state of the last decode.
+        fRowReader.reset(nullptr);
+        return INHERITED::onRewind();
+    }
+
 private:
-    SkAutoTMalloc<uint8_t>      fStorage;
-    uint8_t*                    fSrcRow;
+    SkAutoTMalloc<uint8_t>          fStorage;
+    uint8_t*                        fSrcRow;
+    // Computed from the IHDR, before libpng transforms the rows; see raw_row_bytes_per_pixel().
+    const int                       fRawBytesPerPixel;
+    SkAutoTDelete<SkPngSeekIndex>   fSeekIndex;
+    SkAutoTDelete<SkPngRowReader>   fRowReader;
 
     typedef SkPngCodec INHERITED;
 };
@@ -607,8 +731,9 @@ class SkPngInterlacedScanlineDecoder : public SkPngCodec {
 public:
     SkPngInterlacedScanlineDecoder(const SkImageInfo& srcInfo, SkStream* stream,
             SkPngChunkReader* chunkReader, png_structp png_ptr, png_infop info_ptr,
-            int bitDepth, int numberPasses)
-        : INHERITED(srcInfo, stream, chunkReader, png_ptr, info_ptr, bitDepth, numberPasses)
+            int bitDepth, int numberPasses, bool pooled, SkColorSpace* colorSpace)
+        : INHERITED(srcInfo, stream, chunkReader, png_ptr, info_ptr, bitDepth, numberPasses,
+                    pooled, colorSpace)
         , fHeight(-1)
         , fCanSkipRewind(false)
     {
@@ -726,7 +851,8 @@ private:
     typedef SkPngCodec INHERITED;
 };
 
-SkCodec* SkPngCodec::NewFromStream(SkStream* stream, SkPngChunkReader* chunkReader) {
+SkCodec* SkPngCodec::NewFromStream(SkStream* stream, SkPngChunkReader* chunkReader,
+                                   bool pooled) {
     SkAutoTDelete<SkStream> streamDeleter(stream);
     png_structp png_ptr;
     png_infop info_ptr;
@@ -735,15 +861,17 @@ SkCodec* SkPngCodec::NewFromStream(SkStream* stream, SkPngChunkReader* chunkRead
     int numberPasses;
 
     if (!read_header(stream, chunkReader, &png_ptr, &info_ptr, &imageInfo, &bitDepth,
-                     &numberPasses)) {
+                     &numberPasses, pooled)) {
         return nullptr;
     }
 
+    SkColorSpace* colorSpace = read_color_space(png_ptr, info_ptr);
     if (1 == numberPasses) {
         return new SkPngScanlineDecoder(imageInfo, streamDeleter.detach(), chunkReader,
-                                        png_ptr, info_ptr, bitDepth);
+                                        png_ptr, info_ptr, bitDepth, pooled, colorSpace);
     }
 
     return new SkPngInterlacedScanlineDecoder(imageInfo, streamDeleter.detach(), chunkReader,
-                                              png_ptr, info_ptr, bitDepth, numberPasses);
+                                              png_ptr, info_ptr, bitDepth, numberPasses, pooled,
+                                              colorSpace);
 }
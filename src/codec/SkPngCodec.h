@@ -22,7 +22,8 @@ public:
     static bool IsPng(const char*, size_t);
 
     // Assume IsPng was called and returned true.
-    static SkCodec* NewFromStream(SkStream*, SkPngChunkReader* = NULL);
+    // If pooled, libpng and zlib allocate from SkCodecPool.
+    static SkCodec* NewFromStream(SkStream*, SkPngChunkReader* = NULL, bool pooled = false);
 
     virtual ~SkPngCodec();
 
@@ -32,6 +33,7 @@ protected:
     SkEncodedFormat onGetEncodedFormat() const override { return kPNG_SkEncodedFormat; }
     bool onRewind() override;
     uint32_t onGetFillValue(SkColorType) const override;
+    bool onAppliesColorXform() const override { return true; }
 
     // Helper to set up swizzler and color table. Also calls png_read_update_info.
     Result initializeSwizzler(const SkImageInfo& requestedInfo, const Options&,
@@ -41,9 +43,12 @@ protected:
         return fSwizzler;
     }
 
-    SkPngCodec(const SkImageInfo&, SkStream*, SkPngChunkReader*, png_structp, png_infop, int, int);
+    SkPngCodec(const SkImageInfo&, SkStream*, SkPngChunkReader*, png_structp, png_infop, int, int,
+               bool, SkColorSpace*);
 
     png_structp png_ptr() { return fPng_ptr; }
+    png_infop info_ptr() { return fInfo_ptr; }
+    int bitDepth() const { return fBitDepth; }
     SkSwizzler* swizzler() { return fSwizzler; }
     SkSwizzler::SrcConfig srcConfig() const { return fSrcConfig; }
     int numberPasses() const { return fNumberPasses; }
@@ -60,6 +65,7 @@ private:
     SkSwizzler::SrcConfig           fSrcConfig;
     const int                       fNumberPasses;
     int                             fBitDepth;
+    const bool                      fPooled;
 
     bool decodePalette(bool premultiply, int* ctableCount);
     void destroyReadStruct();
@@ -0,0 +1,324 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodecPriv.h"
+#include "SkPngRowReader.h"
+#include "SkStream.h"
+
+// The most inflate can refer back to, and so the most a checkpoint has to keep.
+static const uInt kWindowSize = 32768;
+
+// How much compressed data we read at a time.  We never read past the end of an IDAT,
+// so this is also an upper bound.
+static const size_t kInputSize = 32768;
+
+static uint32_t read_be32(const uint8_t* bytes) {
+    return (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+}
+
+static bool is_idat(const uint8_t* type) {
+    return 'I' == type[0] && 'D' == type[1] && 'A' == type[2] && 'T' == type[3];
+}
+
+static uint8_t paeth_predictor(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = SkTAbs(p - a);
+    const int pb = SkTAbs(p - b);
+    const int pc = SkTAbs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+/*
+ * Undoes the filter on 'row', whose first byte is the filter type, given the previous
+ * row, already unfiltered.
+ */
+static bool unfilter_row(uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp) {
+    const uint8_t filter = row[0];
+    row++;
+    prev++;
+    switch (filter) {
+        case 0:
+            break;
+        case 1:
+            for (size_t i = bpp; i < rowBytes; i++) {
+                row[i] += row[i - bpp];
+            }
+            break;
+        case 2:
+            for (size_t i = 0; i < rowBytes; i++) {
+                row[i] += prev[i];
+            }
+            break;
+        case 3:
+            for (size_t i = 0; i < (size_t) bpp; i++) {
+                row[i] += prev[i] >> 1;
+            }
+            for (size_t i = bpp; i < rowBytes; i++) {
+                row[i] += (row[i - bpp] + prev[i]) >> 1;
+            }
+            break;
+        case 4:
+            for (size_t i = 0; i < (size_t) bpp; i++) {
+                row[i] += prev[i];
+            }
+            for (size_t i = bpp; i < rowBytes; i++) {
+                row[i] += paeth_predictor(row[i - bpp], prev[i], prev[i - bpp]);
+            }
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkPngSeekIndex::SkPngSeekIndex(size_t rowBytes, int height)
+    : fRowBytes(rowBytes)
+    // One checkpoint per megabyte of rows, but no more than 64 in all.  Each costs up to
+    // 32K plus two rows.
+    , fSpan(SkTMax<size_t>(1 << 20, (rowBytes + 1) * height / 64))
+{}
+
+SkPngSeekIndex::~SkPngSeekIndex() {
+    for (int i = 0; i < fCheckpoints.count(); i++) {
+        sk_free(fCheckpoints[i].fData);
+    }
+}
+
+const SkPngSeekIndex::Checkpoint* SkPngSeekIndex::find(size_t output) const {
+    // Checkpoints are in order of output, so find the last one at or before output.
+    const Checkpoint* found = nullptr;
+    for (int i = 0; i < fCheckpoints.count() && fCheckpoints[i].fOutput <= output; i++) {
+        found = &fCheckpoints[i];
+    }
+    return found;
+}
+
+void SkPngSeekIndex::add(const z_stream& zstream, size_t output, size_t inputPosition,
+                         size_t inputLeft, const uint8_t* prevRow, const uint8_t* partialRow,
+                         size_t partialBytes) {
+    const size_t lastOutput = fCheckpoints.isEmpty() ? 0 : fCheckpoints.top().fOutput;
+    if (output < lastOutput + fSpan) {
+        return;
+    }
+
+    const int bits = zstream.data_type & 7;
+    if (bits && zstream.next_in == nullptr) {
+        return;
+    }
+
+    uint8_t* data = (uint8_t*) sk_malloc_flags(kWindowSize + fRowBytes + partialBytes, 0);
+    if (!data) {
+        return;
+    }
+    uInt windowSize = kWindowSize;
+    if (Z_OK != inflateGetDictionary(const_cast<z_stream*>(&zstream), data, &windowSize)) {
+        sk_free(data);
+        return;
+    }
+    memcpy(data + windowSize, prevRow, fRowBytes);
+    memcpy(data + windowSize + fRowBytes, partialRow, partialBytes);
+
+    Checkpoint* checkpoint = fCheckpoints.append();
+    checkpoint->fOutput = output;
+    checkpoint->fInputPosition = inputPosition;
+    checkpoint->fInputLeft = inputLeft;
+    checkpoint->fBits = bits;
+    checkpoint->fBitsByte = bits ? zstream.next_in[-1] : 0;
+    checkpoint->fWindowSize = windowSize;
+    checkpoint->fData = data;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkPngRowReader::SkPngRowReader(SkStream* stream, size_t rowBytes, int bpp, int height,
+                               SkPngSeekIndex* index)
+    : fStream(stream)
+    , fIndex(index)
+    , fRowBytes(rowBytes)
+    , fStride(rowBytes + 1)
+    , fBpp(bpp)
+    , fHeight(height)
+    , fValid(false)
+    , fInflating(false)
+    , fInput(kInputSize)
+    , fInputPosition(0)
+    , fChunkLeft(0)
+    , fRowStorage(2 * (rowBytes + 1))
+    , fPrev(fRowStorage.get())
+    , fCurr(fRowStorage.get() + rowBytes + 1)
+    , fRow(0)
+    , fFilled(0)
+{
+    SkASSERT(!index || index->fRowBytes == rowBytes);
+    sk_bzero(&fZStream, sizeof(fZStream));
+    sk_bzero(fPrev, fStride);
+
+    // libpng stops reading just after the header of the first IDAT.  Make sure that is
+    // where we are, and that we will be able to come back.
+    if (!fStream->hasPosition()) {
+        return;
+    }
+    const size_t start = fStream->getPosition();
+    uint8_t header[8];
+    if (start < sizeof(header) || !fStream->seek(start - sizeof(header))) {
+        return;
+    }
+    if (fStream->read(header, sizeof(header)) != sizeof(header) || !is_idat(header + 4)) {
+        fStream->seek(start);
+        return;
+    }
+
+    if (Z_OK != inflateInit(&fZStream)) {
+        return;
+    }
+    fInflating = true;
+    fInputPosition = start;
+    fChunkLeft = read_be32(header);
+    fValid = true;
+}
+
+SkPngRowReader::~SkPngRowReader() {
+    if (fInflating) {
+        inflateEnd(&fZStream);
+    }
+}
+
+bool SkPngRowReader::fillInput() {
+    SkASSERT(0 == fZStream.avail_in);
+    while (0 == fChunkLeft) {
+        // Skip the CRC of this IDAT, and read the header of the next.
+        uint8_t header[12];
+        if (fStream->read(header, sizeof(header)) != sizeof(header) || !is_idat(header + 8)) {
+            return false;
+        }
+        fInputPosition += sizeof(header);
+        fChunkLeft = read_be32(header + 4);
+    }
+
+    const size_t bytesRead = fStream->read(fInput.get(), SkTMin(kInputSize, fChunkLeft));
+    if (0 == bytesRead) {
+        return false;
+    }
+    fInputPosition += bytesRead;
+    fChunkLeft -= bytesRead;
+    fZStream.next_in = fInput.get();
+    fZStream.avail_in = (uInt) bytesRead;
+    return true;
+}
+
+bool SkPngRowReader::inflateRow() {
+    fZStream.next_out = fCurr + fFilled;
+    fZStream.avail_out = (uInt) (fStride - fFilled);
+    while (fZStream.avail_out > 0) {
+        if (0 == fZStream.avail_in && !this->fillInput()) {
+            return false;
+        }
+
+        // Z_BLOCK stops at the end of each deflate block, which are the only places we
+        // can resume from.
+        const int ret = inflate(&fZStream, Z_BLOCK);
+        if (Z_STREAM_END == ret) {
+            if (fZStream.avail_out > 0) {
+                return false;
+            }
+            break;
+        }
+        if (Z_OK != ret) {
+            return false;
+        }
+
+        fFilled = fStride - fZStream.avail_out;
+        // A checkpoint at the very end of a row would need that row unfiltered, which it
+        // is not yet, so leave those for the next block.
+        const bool endOfBlock = (fZStream.data_type & 128) && !(fZStream.data_type & 64);
+        if (fIndex && endOfBlock && fZStream.avail_out > 0) {
+            const size_t unread = fZStream.avail_in;
+            fIndex->add(fZStream, fRow * fStride + fFilled, fInputPosition - unread,
+                        fChunkLeft + unread, fPrev + 1, fCurr, fFilled);
+        }
+    }
+    fFilled = 0;
+    return true;
+}
+
+const uint8_t* SkPngRowReader::readRow() {
+    if (!fValid || fRow >= fHeight || !this->inflateRow()) {
+        return nullptr;
+    }
+    if (!unfilter_row(fCurr, fPrev, fRowBytes, fBpp)) {
+        SkCodecPrintf("Unknown png filter type.\n");
+        return nullptr;
+    }
+    SkTSwap(fPrev, fCurr);
+    fRow++;
+    return fPrev + 1;
+}
+
+bool SkPngRowReader::restore(const SkPngSeekIndex::Checkpoint& checkpoint) {
+    if (!fStream->seek(checkpoint.fInputPosition)) {
+        return false;
+    }
+    fInputPosition = checkpoint.fInputPosition;
+    fChunkLeft = checkpoint.fInputLeft;
+
+    // We are in the middle of the deflate stream now, past the zlib header.
+    inflateEnd(&fZStream);
+    sk_bzero(&fZStream, sizeof(fZStream));
+    fInflating = false;
+    if (Z_OK != inflateInit2(&fZStream, -MAX_WBITS)) {
+        return false;
+    }
+    fInflating = true;
+    if (checkpoint.fBits) {
+        inflatePrime(&fZStream, checkpoint.fBits,
+                     checkpoint.fBitsByte >> (8 - checkpoint.fBits));
+    }
+    if (Z_OK != inflateSetDictionary(&fZStream, checkpoint.fData, checkpoint.fWindowSize)) {
+        return false;
+    }
+
+    fRow = (int) (checkpoint.fOutput / fStride);
+    fFilled = checkpoint.fOutput % fStride;
+    const uint8_t* prevRow = checkpoint.fData + checkpoint.fWindowSize;
+    fPrev[0] = 0;
+    memcpy(fPrev + 1, prevRow, fRowBytes);
+    memcpy(fCurr, prevRow + fRowBytes, fFilled);
+    return true;
+}
+
+bool SkPngRowReader::skipRows(int count) {
+    if (!fValid) {
+        return false;
+    }
+    const int target = fRow + count;
+    if (target > fHeight) {
+        return false;
+    }
+
+    // Jump to the last checkpoint before the start of the target row, if it is ahead of us.
+    if (fIndex) {
+        const SkPngSeekIndex::Checkpoint* checkpoint = fIndex->find(target * fStride);
+        if (checkpoint && checkpoint->fOutput > fRow * fStride + fFilled) {
+            if (!this->restore(*checkpoint)) {
+                fValid = false;
+                return false;
+            }
+        }
+    }
+
+    while (fRow < target) {
+        if (!this->readRow()) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngRowReader_DEFINED
+#define SkPngRowReader_DEFINED
+
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+#include "SkTypes.h"
+
+#include "zlib.h"
+
+class SkStream;
+
+/**
+ *  Places in the image data of a non-interlaced PNG where SkPngRowReader can pick up
+ *  inflating, so that rows far down the image can be reached without inflating and
+ *  unfiltering all of the rows above them.
+ *
+ *  The index is filled in as a side effect of reading rows, and is meant to be kept for
+ *  later decodes of the same stream.
+ */
+class SkPngSeekIndex : SkNoncopyable {
+public:
+    /**
+     *  @param rowBytes Bytes in an unfiltered row.
+     */
+    SkPngSeekIndex(size_t rowBytes, int height);
+    ~SkPngSeekIndex();
+
+    int count() const { return fCheckpoints.count(); }
+
+private:
+    struct Checkpoint {
+        size_t      fOutput;        // bytes of filtered rows (filter bytes included) before here
+        size_t      fInputPosition; // stream position of the next compressed byte
+        size_t      fInputLeft;     // bytes of the IDAT chunk left at fInputPosition
+        int         fBits;          // bits of the byte before fInputPosition still to be read
+        uint8_t     fBitsByte;
+        uInt        fWindowSize;
+        // The inflate window, then the unfiltered row before the current one, then the
+        // filtered bytes we have of the current row.
+        uint8_t*    fData;
+    };
+
+    const Checkpoint* find(size_t output) const;
+    void add(const z_stream&, size_t output, size_t inputPosition, size_t inputLeft,
+             const uint8_t* prevRow, const uint8_t* partialRow, size_t partialBytes);
+
+    const size_t                    fRowBytes;
+    const size_t                    fSpan;
+    SkTDArray<Checkpoint>           fCheckpoints;
+
+    friend class SkPngRowReader;
+};
+
+/**
+ *  Inflates and unfilters the rows of a non-interlaced PNG itself, rather than through
+ *  libpng, so that it can skip ahead using an SkPngSeekIndex.  It only produces the raw
+ *  unfiltered rows, so it is only useful for images that need no libpng transforms.
+ */
+class SkPngRowReader : SkNoncopyable {
+public:
+    /**
+     *  @param stream Positioned at the start of the data of the first IDAT chunk.  Must
+     *                support getPosition() and seek().  Not owned.
+     *  @param bpp    Bytes per pixel, for unfiltering.
+     *  @param index  May be nullptr.  Not owned.
+     */
+    SkPngRowReader(SkStream* stream, size_t rowBytes, int bpp, int height, SkPngSeekIndex* index);
+    ~SkPngRowReader();
+
+    /**
+     *  False if the stream is not where we expect it to be, or does not support seeking.
+     *  In that case the stream has not been moved.
+     */
+    bool isValid() const { return fValid; }
+
+    /**
+     *  Returns the next unfiltered row, valid until the next call, or nullptr on failure.
+     */
+    const uint8_t* readRow();
+
+    /**
+     *  Moves past the next 'count' rows, jumping ahead to a checkpoint where there is one.
+     */
+    bool skipRows(int count);
+
+private:
+    bool fillInput();
+    bool inflateRow();
+    bool restore(const SkPngSeekIndex::Checkpoint&);
+
+    SkStream*               fStream;
+    SkPngSeekIndex*         fIndex;
+    const size_t            fRowBytes;
+    const size_t            fStride;        // fRowBytes plus the filter byte
+    const int               fBpp;
+    const int               fHeight;
+    bool                    fValid;
+    bool                    fInflating;
+
+    z_stream                fZStream;
+    SkAutoTMalloc<uint8_t>  fInput;
+    size_t                  fInputPosition; // stream position after the last byte in fInput
+    size_t                  fChunkLeft;     // bytes of the current IDAT not yet in fInput
+
+    SkAutoTMalloc<uint8_t>  fRowStorage;
+    uint8_t*                fPrev;          // the previous row, unfiltered, with its filter byte
+    uint8_t*                fCurr;          // the current row, filtered
+    int                     fRow;           // the row in fCurr
+    size_t                  fFilled;        // bytes of fCurr inflated so far
+};
+
+#endif // SkPngRowReader_DEFINED
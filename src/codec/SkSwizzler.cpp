@@ -7,6 +7,7 @@
 
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
+#include "SkColorSpaceXform.h"
 #include "SkOpts.h"
 #include "SkSwizzler.h"
 #include "SkTemplates.h"
@@ -665,10 +666,14 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
                                        const SkPMColor* ctable,
                                        const SkImageInfo& dstInfo,
                                        const SkCodec::Options& options,
-                                       const SkIRect* frame) {
+                                       const SkIRect* frame,
+                                       const SkColorSpaceXform* colorXform) {
     if (dstInfo.colorType() == kUnknown_SkColorType || kUnknown == sc) {
         return nullptr;
     }
+    if (colorXform && 4 != dstInfo.bytesPerPixel()) {
+        return nullptr;
+    }
     if ((kIndex == sc || kIndex4 == sc || kIndex2 == sc || kIndex1 == sc)
             && nullptr == ctable) {
         return nullptr;
@@ -906,15 +911,19 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
     }
 
     return new SkSwizzler(fastProc, proc, ctable, srcOffset, srcWidth, dstOffset, dstWidth,
-            srcBPP, dstBPP);
+            srcBPP, dstBPP, colorXform, dstInfo);
 }
 
 SkSwizzler::SkSwizzler(RowProc fastProc, RowProc proc, const SkPMColor* ctable, int srcOffset,
-        int srcWidth, int dstOffset, int dstWidth, int srcBPP, int dstBPP)
+        int srcWidth, int dstOffset, int dstWidth, int srcBPP, int dstBPP,
+        const SkColorSpaceXform* colorXform, const SkImageInfo& dstInfo)
     : fFastProc(fastProc)
     , fSlowProc(proc)
     , fActualProc(fFastProc ? fFastProc : fSlowProc)
     , fColorTable(ctable)
+    , fColorXform(colorXform)
+    , fDstColorType(dstInfo.colorType())
+    , fDstAlphaType(dstInfo.alphaType())
     , fSrcOffset(srcOffset)
     , fDstOffset(dstOffset)
     , fSrcOffsetUnits(srcOffset * srcBPP)
@@ -951,6 +960,12 @@ int SkSwizzler::onSetSampleX(int sampleX) {
 
 void SkSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     SkASSERT(nullptr != dst && nullptr != src);
-    fActualProc(SkTAddOffset<void>(dst, fDstOffsetBytes), src, fSwizzleWidth, fSrcBPP,
-            fSampleX * fSrcBPP, fSrcOffsetUnits, fColorTable);
+    void* dstRow = SkTAddOffset<void>(dst, fDstOffsetBytes);
+    fActualProc(dstRow, src, fSwizzleWidth, fSrcBPP, fSampleX * fSrcBPP, fSrcOffsetUnits,
+            fColorTable);
+    if (fColorXform) {
+        // The row is still in cache, so this is the cheapest place to convert it.
+        uint32_t* row = static_cast<uint32_t*>(dstRow);
+        fColorXform->apply(row, row, fSwizzleWidth, fDstColorType, fDstAlphaType);
+    }
 }
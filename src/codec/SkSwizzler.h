@@ -13,6 +13,8 @@
 #include "SkImageInfo.h"
 #include "SkSampler.h"
 
+class SkColorSpaceXform;
+
 class SkSwizzler : public SkSampler {
 public:
     /**
@@ -106,7 +108,8 @@ public:
      */
     static SkSwizzler* CreateSwizzler(SrcConfig, const SkPMColor* ctable,
                                       const SkImageInfo& dstInfo, const SkCodec::Options&,
-                                      const SkIRect* frame = nullptr);
+                                      const SkIRect* frame = nullptr,
+                                      const SkColorSpaceXform* colorXform = nullptr);
 
     /**
      *  Swizzle a line. Generally this will be called height times, once
@@ -178,6 +181,12 @@ private:
 
     const SkPMColor*    fColorTable;      // Unowned pointer
 
+    // If non-NULL, converts each row to the destination's color space once it is swizzled.
+    // Unowned pointer.  Only set for 8888 destinations.
+    const SkColorSpaceXform* fColorXform;
+    const SkColorType   fDstColorType;
+    const SkAlphaType   fDstAlphaType;
+
     // Subset Swizzles
     // There are two types of subset swizzles that we support.  We do not
     // support both at the same time.
@@ -263,7 +272,8 @@ private:
     const int           fDstBPP;          // Bytes per pixel for the destination color type
 
     SkSwizzler(RowProc fastProc, RowProc proc, const SkPMColor* ctable, int srcOffset,
-            int srcWidth, int dstOffset, int dstWidth, int srcBPP, int dstBPP);
+            int srcWidth, int dstOffset, int dstWidth, int srcBPP, int dstBPP,
+            const SkColorSpaceXform* colorXform, const SkImageInfo& dstInfo);
 
     int onSetSampleX(int) override;
 
@@ -31,7 +31,9 @@ bool SkWebpCodec::IsWebp(const void* buf, size_t bytesRead) {
 // Parse headers of RIFF container, and check for valid Webp (VP8) content.
 // NOTE: This calls peek instead of read, since onGetPixels will need these
 // bytes again.
-static bool webp_parse_header(SkStream* stream, SkImageInfo* info) {
+// If isLossy is not null, it is set to whether the image is lossy (VP8) without alpha, and so
+// stored as YUV 4:2:0.
+static bool webp_parse_header(SkStream* stream, SkImageInfo* info, bool* isLossy) {
     unsigned char buffer[WEBP_VP8_HEADER_SIZE];
     SkASSERT(WEBP_VP8_HEADER_SIZE <= SkCodec::MinBufferedBytesNeeded());
 
@@ -70,14 +72,18 @@ static bool webp_parse_header(SkStream* stream, SkImageInfo* info) {
                                   SkToBool(features.has_alpha) ? kUnpremul_SkAlphaType
                                                               : kOpaque_SkAlphaType);
     }
+    if (isLossy) {
+        *isLossy = 1 == features.format && !features.has_alpha;
+    }
     return true;
 }
 
 SkCodec* SkWebpCodec::NewFromStream(SkStream* stream) {
     SkAutoTDelete<SkStream> streamDeleter(stream);
     SkImageInfo info;
-    if (webp_parse_header(stream, &info)) {
-        return new SkWebpCodec(info, streamDeleter.detach());
+    bool isLossy;
+    if (webp_parse_header(stream, &info, &isLossy)) {
+        return new SkWebpCodec(info, streamDeleter.detach(), isLossy);
     }
     return nullptr;
 }
@@ -139,6 +145,40 @@ static WEBP_CSP_MODE webp_decode_mode(SkColorType ct, bool premultiply) {
 // is arbitrary.
 static const size_t BUFFER_SIZE = 4096;
 
+/*
+ * Feeds the stream to libwebp, which decodes into config->output.  If the stream ends early,
+ * sets rowsDecoded, if it is not nullptr, to the number of rows of RGB output.
+ */
+static SkCodec::Result webp_decode(SkStream* stream, WebPDecoderConfig* config,
+                                   int* rowsDecoded) {
+    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> idec(WebPIDecode(nullptr, 0, config));
+    if (!idec) {
+        return SkCodec::kInvalidInput;
+    }
+
+    SkAutoTMalloc<uint8_t> storage(BUFFER_SIZE);
+    uint8_t* buffer = storage.get();
+    while (true) {
+        const size_t bytesRead = stream->read(buffer, BUFFER_SIZE);
+        if (0 == bytesRead) {
+            if (rowsDecoded) {
+                WebPIDecGetRGB(idec, rowsDecoded, NULL, NULL, NULL);
+            }
+            return SkCodec::kIncompleteInput;
+        }
+
+        switch (WebPIAppend(idec, buffer, bytesRead)) {
+            case VP8_STATUS_OK:
+                return SkCodec::kSuccess;
+            case VP8_STATUS_SUSPENDED:
+                // Break out of the switch statement. Continue the loop.
+                break;
+            default:
+                return SkCodec::kInvalidInput;
+        }
+    }
+}
+
 bool SkWebpCodec::onGetValidSubset(SkIRect* desiredSubset) const {
     if (!desiredSubset) {
         return false;
@@ -225,31 +265,74 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     config.output.u.RGBA.size = dstInfo.getSafeSize(rowBytes);
     config.output.is_external_memory = 1;
 
-    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> idec(WebPIDecode(nullptr, 0, &config));
-    if (!idec) {
-        return kInvalidInput;
+    return webp_decode(this->stream(), &config, rowsDecoded);
+}
+
+bool SkWebpCodec::onQueryYUV8(YUVSizeInfo* sizeInfo, SkYUVColorSpace* colorSpace) const {
+    if (!fIsLossy) {
+        return false;
     }
 
-    SkAutoTMalloc<uint8_t> storage(BUFFER_SIZE);
-    uint8_t* buffer = storage.get();
-    while (true) {
-        const size_t bytesRead = stream()->read(buffer, BUFFER_SIZE);
-        if (0 == bytesRead) {
-            WebPIDecGetRGB(idec, rowsDecoded, NULL, NULL, NULL);
-            return kIncompleteInput;
-        }
+    // VP8 is always 4:2:0, with chroma rounded up.
+    const SkISize size = this->getInfo().dimensions();
+    sizeInfo->fYSize = size;
+    sizeInfo->fUSize.set((size.width() + 1) / 2, (size.height() + 1) / 2);
+    sizeInfo->fVSize = sizeInfo->fUSize;
+    // libwebp has no alignment requirements, but match the widths SkJpegCodec asks for, so
+    // that clients can allocate the same way for both.
+    sizeInfo->fYWidthBytes = SkAlign8(sizeInfo->fYSize.width());
+    sizeInfo->fUWidthBytes = SkAlign8(sizeInfo->fUSize.width());
+    sizeInfo->fVWidthBytes = SkAlign8(sizeInfo->fVSize.width());
+
+    if (colorSpace) {
+        // VP8 uses BT.601 with studio swing.
+        *colorSpace = kRec601_SkYUVColorSpace;
+    }
+    return true;
+}
 
-        switch (WebPIAppend(idec, buffer, bytesRead)) {
-            case VP8_STATUS_OK:
-                return kSuccess;
-            case VP8_STATUS_SUSPENDED:
-                // Break out of the switch statement. Continue the loop.
-                break;
-            default:
-                return kInvalidInput;
-        }
+SkCodec::Result SkWebpCodec::onGetYUV8Planes(const YUVSizeInfo& sizeInfo, void* planes[3]) {
+    YUVSizeInfo defaultInfo;
+    if (!this->onQueryYUV8(&defaultInfo, nullptr) ||
+            sizeInfo.fYSize != defaultInfo.fYSize ||
+            sizeInfo.fUSize != defaultInfo.fUSize ||
+            sizeInfo.fVSize != defaultInfo.fVSize ||
+            sizeInfo.fYWidthBytes < (size_t) defaultInfo.fYSize.width() ||
+            sizeInfo.fUWidthBytes < (size_t) defaultInfo.fUSize.width() ||
+            sizeInfo.fVWidthBytes < (size_t) defaultInfo.fVSize.width()) {
+        return kInvalidInput;
+    }
+
+    WebPDecoderConfig config;
+    if (0 == WebPInitDecoderConfig(&config)) {
+        // ABI mismatch.
+        return kInvalidInput;
     }
+
+    // Free any memory associated with the buffer. Must be called last, so we declare it first.
+    SkAutoTCallVProc<WebPDecBuffer, WebPFreeDecBuffer> autoFree(&(config.output));
+
+    // Have libwebp hand over its planes as they are, skipping its upsampling and conversion.
+    config.output.colorspace = MODE_YUV;
+    WebPYUVABuffer& yuv = config.output.u.YUVA;
+    yuv.y = (uint8_t*) planes[0];
+    yuv.u = (uint8_t*) planes[1];
+    yuv.v = (uint8_t*) planes[2];
+    yuv.a = nullptr;
+    yuv.y_stride = (int) sizeInfo.fYWidthBytes;
+    yuv.u_stride = (int) sizeInfo.fUWidthBytes;
+    yuv.v_stride = (int) sizeInfo.fVWidthBytes;
+    yuv.a_stride = 0;
+    yuv.y_size = sizeInfo.fYWidthBytes * sizeInfo.fYSize.height();
+    yuv.u_size = sizeInfo.fUWidthBytes * sizeInfo.fUSize.height();
+    yuv.v_size = sizeInfo.fVWidthBytes * sizeInfo.fVSize.height();
+    yuv.a_size = 0;
+    config.output.is_external_memory = 1;
+
+    return webp_decode(this->stream(), &config, nullptr);
 }
 
-SkWebpCodec::SkWebpCodec(const SkImageInfo& info, SkStream* stream)
-    : INHERITED(info, stream) {}
+SkWebpCodec::SkWebpCodec(const SkImageInfo& info, SkStream* stream, bool isLossy)
+    : INHERITED(info, stream)
+    , fIsLossy(isLossy)
+{}
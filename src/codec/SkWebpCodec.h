@@ -32,8 +32,15 @@ protected:
     bool onDimensionsSupported(const SkISize&) override;
 
     bool onGetValidSubset(SkIRect* /* desiredSubset */) const override;
+
+    bool onQueryYUV8(YUVSizeInfo* sizeInfo, SkYUVColorSpace* colorSpace) const override;
+
+    Result onGetYUV8Planes(const YUVSizeInfo& sizeInfo, void* planes[3]) override;
 private:
-    SkWebpCodec(const SkImageInfo&, SkStream*);
+    SkWebpCodec(const SkImageInfo&, SkStream*, bool isLossy);
+
+    // Lossy without alpha, so the image is stored as YUV.
+    const bool fIsLossy;
 
     typedef SkCodec INHERITED;
 };
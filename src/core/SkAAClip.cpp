@@ -56,9 +56,10 @@ struct SkAAClip::YOffset {
 };
 
 struct SkAAClip::RunHead {
-    int32_t fRefCnt;
-    int32_t fRowCount;
-    size_t  fDataSize;
+    int32_t  fRefCnt;
+    int32_t  fRowCount;
+    size_t   fDataSize;
+    uint32_t fUniqueID;
 
     YOffset* yoffsets() {
         return (YOffset*)((char*)this + sizeof(RunHead));
@@ -79,9 +80,20 @@ struct SkAAClip::RunHead {
         head->fRefCnt = 1;
         head->fRowCount = rowCount;
         head->fDataSize = dataSize;
+        head->fUniqueID = NextUniqueID();
         return head;
     }
 
+    // Runs are never edited once they are shared, so this ID stands for their contents.
+    static uint32_t NextUniqueID() {
+        static int32_t gNextID;
+        uint32_t id;
+        do {
+            id = sk_atomic_inc(&gNextID) + 1;
+        } while (0 == id);
+        return id;
+    }
+
     static int ComputeRowSizeForWidth(int width) {
         // 2 bytes per segment, where each segment can store up to 255 for count
         int segments = 0;
@@ -695,6 +707,17 @@ bool SkAAClip::set(const SkAAClip& src) {
     return !this->isEmpty();
 }
 
+uint32_t SkAAClip::uniqueID() const {
+    return fRunHead ? fRunHead->fUniqueID : 0;
+}
+
+size_t SkAAClip::approximateBytesUsed() const {
+    if (nullptr == fRunHead) {
+        return 0;
+    }
+    return sizeof(RunHead) + fRunHead->fRowCount * sizeof(YOffset) + fRunHead->fDataSize;
+}
+
 bool SkAAClip::setEmpty() {
     this->freeRuns();
     fBounds.setEmpty();
@@ -945,12 +968,15 @@ bool SkAAClip::quickContains(int left, int top, int right, int bottom) const {
 
 class SkAAClip::Builder {
     SkIRect fBounds;
+    // Rows are built one after another into fData, each starting at its fOffset, so the
+    // current row is always the one at the end of fData.
     struct Row {
         int fY;
         int fWidth;
-        SkTDArray<uint8_t>* fData;
+        int fOffset;
     };
     SkTDArray<Row>  fRows;
+    SkTDArray<uint8_t> fData;
     Row* fCurrRow;
     int fPrevY;
     int fWidth;
@@ -964,15 +990,6 @@ public:
         fMinY = bounds.fTop;
     }
 
-    ~Builder() {
-        Row* row = fRows.begin();
-        Row* stop = fRows.end();
-        while (row < stop) {
-            delete row->fData;
-            row += 1;
-        }
-    }
-
     const SkIRect& getBounds() const { return fBounds; }
 
     void addRun(int x, int y, U8CPU alpha, int count) {
@@ -990,24 +1007,21 @@ public:
             row = this->flushRow(true);
             row->fY = y;
             row->fWidth = 0;
-            SkASSERT(row->fData);
-            SkASSERT(0 == row->fData->count());
+            SkASSERT(row->fOffset == fData.count());
             fCurrRow = row;
         }
 
         SkASSERT(row->fWidth <= x);
         SkASSERT(row->fWidth < fBounds.width());
 
-        SkTDArray<uint8_t>& data = *row->fData;
-
         int gap = x - row->fWidth;
         if (gap) {
-            AppendRun(data, 0, gap);
+            AppendRun(fData, 0, gap);
             row->fWidth += gap;
             SkASSERT(row->fWidth < fBounds.width());
         }
 
-        AppendRun(data, alpha, count);
+        AppendRun(fData, alpha, count);
         row->fWidth += count;
         SkASSERT(row->fWidth <= fBounds.width());
     }
@@ -1074,12 +1088,7 @@ public:
         const Row* row = fRows.begin();
         const Row* stop = fRows.end();
 
-        size_t dataSize = 0;
-        while (row < stop) {
-            dataSize += row->fData->count();
-            row += 1;
-        }
-
+        size_t dataSize = fData.count();
         if (0 == dataSize) {
             return target->setEmpty();
         }
@@ -1092,7 +1101,7 @@ public:
         RunHead* head = RunHead::Alloc(fRows.count(), dataSize);
         YOffset* yoffset = head->yoffsets();
         uint8_t* data = head->data();
-        uint8_t* baseData = data;
+        memcpy(data, fData.begin(), dataSize);
 
         row = fRows.begin();
         SkDEBUGCODE(int prevY = row->fY - 1;)
@@ -1101,17 +1110,13 @@ public:
             SkDEBUGCODE(prevY = row->fY);
 
             yoffset->fY = row->fY - adjustY;
-            yoffset->fOffset = SkToU32(data - baseData);
+            yoffset->fOffset = SkToU32(row->fOffset);
             yoffset += 1;
 
-            size_t n = row->fData->count();
-            memcpy(data, row->fData->begin(), n);
 #ifdef SK_DEBUG
-            size_t bytesNeeded = compute_row_length(data, fBounds.width());
-            SkASSERT(bytesNeeded == n);
+            size_t bytesNeeded = compute_row_length(data + row->fOffset, fBounds.width());
+            SkASSERT(bytesNeeded == this->rowSize(row));
 #endif
-            data += n;
-
             row += 1;
         }
 
@@ -1127,10 +1132,9 @@ public:
         for (y = 0; y < fRows.count(); ++y) {
             const Row& row = fRows[y];
             SkDebugf("Y:%3d W:%3d", row.fY, row.fWidth);
-            const SkTDArray<uint8_t>& data = *row.fData;
-            int count = data.count();
+            int count = SkToInt(this->rowSize(&row));
             SkASSERT(!(count & 1));
-            const uint8_t* ptr = data.begin();
+            const uint8_t* ptr = fData.begin() + row.fOffset;
             for (int x = 0; x < count; x += 2) {
                 SkDebugf(" [%3d:%02X]", ptr[0], ptr[1]);
                 ptr += 2;
@@ -1149,8 +1153,8 @@ public:
             const Row& row = fRows[i];
             SkASSERT(prevY < row.fY);
             SkASSERT(fWidth == row.fWidth);
-            int count = row.fData->count();
-            const uint8_t* ptr = row.fData->begin();
+            int count = SkToInt(this->rowSize(&row));
+            const uint8_t* ptr = fData.begin() + row.fOffset;
             SkASSERT(!(count & 1));
             int w = 0;
             for (int x = 0; x < count; x += 2) {
@@ -1172,14 +1176,26 @@ public:
     }
 
 private:
+    size_t rowSize(const Row* row) const {
+        const Row* next = row + 1;
+        return (next < fRows.end() ? next->fOffset : fData.count()) - row->fOffset;
+    }
+
     void flushRowH(Row* row) {
         // flush current row if needed
+        SkASSERT(row == fRows.end() - 1);
         if (row->fWidth < fWidth) {
-            AppendRun(*row->fData, 0, fWidth - row->fWidth);
+            AppendRun(fData, 0, fWidth - row->fWidth);
             row->fWidth = fWidth;
         }
     }
 
+    Row* appendRow() {
+        Row* row = fRows.append();
+        row->fOffset = fData.count();
+        return row;
+    }
+
     Row* flushRow(bool readyForAnother) {
         Row* next = nullptr;
         int count = fRows.count();
@@ -1192,25 +1208,24 @@ private:
             Row* curr = &fRows[count - 1];
             SkASSERT(prev->fWidth == fWidth);
             SkASSERT(curr->fWidth == fWidth);
-            if (*prev->fData == *curr->fData) {
+            const size_t size = curr->fOffset - prev->fOffset;
+            if (this->rowSize(curr) == size &&
+                !memcmp(fData.begin() + prev->fOffset, fData.begin() + curr->fOffset, size)) {
                 prev->fY = curr->fY;
+                fData.setCount(curr->fOffset);
                 if (readyForAnother) {
-                    curr->fData->rewind();
                     next = curr;
                 } else {
-                    delete curr->fData;
                     fRows.removeShuffle(count - 1);
                 }
             } else {
                 if (readyForAnother) {
-                    next = fRows.append();
-                    next->fData = new SkTDArray<uint8_t>;
+                    next = this->appendRow();
                 }
             }
         } else {
             if (readyForAnother) {
-                next = fRows.append();
-                next->fData = new SkTDArray<uint8_t>;
+                next = this->appendRow();
             }
         }
         return next;
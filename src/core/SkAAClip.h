@@ -33,6 +33,15 @@ public:
     // If true, getBounds() can be used in place of this clip.
     bool isRect() const;
 
+    /**
+     *  Returns an ID for this clip's runs, or 0 if it is empty. Copies and translations share
+     *  the runs, and so the ID, of the clip they came from; together with getBounds() it
+     *  identifies the clip.
+     */
+    uint32_t uniqueID() const;
+
+    size_t approximateBytesUsed() const;
+
     bool setEmpty();
     bool setRect(const SkIRect&);
     bool setRect(const SkRect&, bool doAA = true);
@@ -31,6 +31,16 @@ public:
      */
     virtual void search(const SkRect& query, SkTDArray<int>* results) const = 0;
 
+    /**
+     * As search(), but also append the bounds of each result to bounds, in the same order.
+     * Returns false, leaving bounds untouched, if this hierarchy does not keep them.
+     */
+    virtual bool searchWithBounds(const SkRect& query, SkTDArray<int>* results,
+                                  SkTDArray<SkRect>* bounds) const {
+        this->search(query, results);
+        return false;
+    }
+
     virtual size_t bytesUsed() const = 0;
 
     // Get the root bound.
@@ -367,6 +367,22 @@ void SkBitmapDevice::drawVertices(const SkDraw& draw, SkCanvas::VertexMode vmode
                       indices, indexCount, paint);
 }
 
+void SkBitmapDevice::drawAtlas(const SkDraw& draw, const SkImage* atlas, const SkRSXform xform[],
+                               const SkRect tex[], const SkColor colors[], int count,
+                               SkXfermode::Mode mode, const SkPaint& paint) {
+    // SkDraw only fills, and blends each sprite's color before applying the paint's alpha where
+    // the base class's color filter would apply after it.  Anything else draws sprite by sprite.
+    const bool batchable = SkPaint::kFill_Style == paint.getStyle() &&
+                           !paint.getMaskFilter() && !paint.getPathEffect() &&
+                           !paint.getRasterizer() &&
+                           (!colors || 0xFF == paint.getAlpha());
+    if (!batchable) {
+        this->INHERITED::drawAtlas(draw, atlas, xform, tex, colors, count, mode, paint);
+        return;
+    }
+    draw.drawAtlas(atlas, xform, tex, colors, count, mode, paint);
+}
+
 void SkBitmapDevice::drawDevice(const SkDraw& draw, SkBaseDevice* device,
                                 int x, int y, const SkPaint& paint) {
     draw.drawSprite(static_cast<SkBitmapDevice*>(device)->fBitmap, x, y, paint);
@@ -10,6 +10,8 @@
 #include "SkBitmapProvider.h"
 #include "SkColorPriv.h"
 #include "SkErrorInternals.h"
+#include "SkLinearBitmapPipeline.h"
+#include "SkPM4fPriv.h"
 #include "SkPixelRef.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
@@ -20,10 +22,73 @@
 #include "effects/GrSimpleTextureEffect.h"
 #endif
 
+/**
+ *  Shades with SkLinearBitmapPipeline, for clients that want SkPM4f.  Like the
+ *  SkBitmapProcState of BitmapProcShaderContext, the controller's state is stored just past
+ *  the context.
+ */
+class LinearPipelineContext : public SkShader::Context {
+public:
+    LinearPipelineContext(const SkShader& shader, const SkShader::ContextRec& rec,
+                          SkShader::TileMode tmx, SkShader::TileMode tmy,
+                          SkBitmapController::State* state, void* stateStorage)
+        : INHERITED(shader, rec)
+        , fState(state)
+        , fStateStorage(stateStorage)
+    {
+        // Shader storage is only four byte aligned, and the pipeline's stages need sixteen.
+        void* pipelineStorage = (void*)(((uintptr_t)fPipelineStorage + 15) & ~(uintptr_t)15);
+        fPipeline = new (pipelineStorage) SkLinearBitmapPipeline(
+            state->invMatrix(), state->quality(), tmx, tmy, rec.fPaint->getColor(),
+            state->pixmap());
+
+        fFlags = SkShader::kPrefers4f_Flag;
+        if (state->pixmap().isOpaque() && (255 == this->getPaintAlpha())) {
+            fFlags |= SkShader::kOpaqueAlpha_Flag;
+        }
+    }
+
+    ~LinearPipelineContext() override {
+        fPipeline->~SkLinearBitmapPipeline();
+        SkInPlaceDeleteCheck(fState, fStateStorage);
+    }
+
+    void shadeSpan(int x, int y, SkPMColor dstC[], int count) override {
+        const int N = 128;
+        SkPM4f tmp[N];
+        while (count > 0) {
+            const int n = SkTMin(count, N);
+            fPipeline->shadeSpan4f(x, y, tmp, n);
+            for (int i = 0; i < n; ++i) {
+                dstC[i] = Sk4f_toL32(Sk4f::Load(tmp[i].fVec));
+            }
+            dstC += n;
+            x += n;
+            count -= n;
+        }
+    }
+
+    void shadeSpan4f(int x, int y, SkPM4f dstC[], int count) override {
+        fPipeline->shadeSpan4f(x, y, dstC, count);
+    }
+
+    uint32_t getFlags() const override { return fFlags; }
+
+private:
+    SkBitmapController::State*  fState;
+    void*                       fStateStorage;
+    SkLinearBitmapPipeline*     fPipeline;
+    char                        fPipelineStorage[sizeof(SkLinearBitmapPipeline) + 15];
+    uint32_t                    fFlags;
+
+    typedef SkShader::Context INHERITED;
+};
+
 size_t SkBitmapProcShader::ContextSize() {
     // The SkBitmapProcState is stored outside of the context object, with the context holding
-    // a pointer to it.
-    return sizeof(BitmapProcShaderContext) + sizeof(SkBitmapProcState);
+    // a pointer to it.  The linear pipeline's context keeps its controller state there instead.
+    return SkTMax(sizeof(BitmapProcShaderContext) + sizeof(SkBitmapProcState),
+                  sizeof(LinearPipelineContext) + SkBitmapProcState::kBMStateSize);
 }
 
 SkBitmapProcShader::SkBitmapProcShader(const SkBitmap& src, TileMode tmx, TileMode tmy,
@@ -82,6 +147,24 @@ bool SkBitmapProcShader::isOpaque() const {
     return fRawBitmap.isOpaque();
 }
 
+// The bitmaps SkBitmapProcState::chooseProcs() has procs for.
+static bool procs_can_shade(const SkImageInfo& info) {
+    const bool premul = kPremul_SkAlphaType == info.alphaType() ||
+                        kOpaque_SkAlphaType == info.alphaType();
+    switch (info.colorType()) {
+        case kN32_SkColorType:
+        case kIndex_8_SkColorType:
+        case kARGB_4444_SkColorType:
+            return premul;
+        case kRGB_565_SkColorType:
+        case kAlpha_8_SkColorType:
+        case kGray_8_SkColorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
 SkShader::Context* SkBitmapProcShader::MakeContext(const SkShader& shader,
                                                    TileMode tmx, TileMode tmy,
                                                    const SkBitmapProvider& provider,
@@ -92,6 +175,25 @@ SkShader::Context* SkBitmapProcShader::MakeContext(const SkShader& shader,
         return nullptr;
     }
 
+    // Clients that shade into SkPM4f get the linear pipeline, when it handles the bitmap the
+    // controller hands back.  The pipeline filters in float, which is more precise than the
+    // procs' fixed point but slower, so filtered draws only go to it when the procs can't
+    // shade the bitmap at all.
+    if (SkShader::ContextRec::kPM4f_DstType == rec.fPreferredDstType &&
+        SkLinearBitmapPipeline::CanShade(provider.info())) {
+        void* stateStorage = (char*)storage + sizeof(LinearPipelineContext);
+        SkDefaultBitmapController controller;
+        SkBitmapController::State* state =
+            controller.requestBitmap(provider, totalInverse, rec.fPaint->getFilterQuality(),
+                                     stateStorage, SkBitmapProcState::kBMStateSize);
+        if (state && SkLinearBitmapPipeline::CanShade(state->pixmap().info()) &&
+            (kNone_SkFilterQuality == state->quality() ||
+             !procs_can_shade(state->pixmap().info()))) {
+            return new (storage) LinearPipelineContext(shader, rec, tmx, tmy, state, stateStorage);
+        }
+        SkInPlaceDeleteCheck(state, stateStorage);
+    }
+
     void* stateStorage = (char*)storage + sizeof(BitmapProcShaderContext);
     SkBitmapProcState* state = new (stateStorage) SkBitmapProcState(provider, tmx, tmy);
 
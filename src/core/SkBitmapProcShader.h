@@ -85,7 +85,7 @@ private:
 
 // Commonly used allocator. It currently is only used to allocate up to 3 objects. The total
 // bytes requested is calculated using one of our large shaders, its context size plus the size of
-// an Sk3DBlitter in SkDraw.cpp
+// an Sk3DBlitter in SkDraw.cpp (or of a fused blitter, which is never used alongside one)
 // Note that some contexts may contain other contexts (e.g. for compose shaders), but we've not
 // yet found a situation where the size below isn't big enough.
 typedef SkSmallAllocator<3, 1500> SkTBlitterAllocator;
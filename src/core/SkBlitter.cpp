@@ -956,6 +956,13 @@ SkBlitter* SkBlitter::Choose(const SkPixmap& device,
         blitter = allocator->createT<SkNullBlitter>();
     }
 
+    if (shaderContext && !shader3D) {
+        if (SkBlitter* fused = SkBlitter_ChooseFused(device, *paint, shaderContext, blitter,
+                                                     allocator)) {
+            blitter = fused;
+        }
+    }
+
     if (shader3D) {
         SkBlitter* innerBlitter = blitter;
         // innerBlitter was allocated by allocator, which will delete it.
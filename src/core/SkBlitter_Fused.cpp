@@ -0,0 +1,483 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Sk4px.h"
+#include "SkCoreBlitters.h"
+#include "SkColorPriv.h"
+#include "SkShader.h"
+#include "SkXfermode.h"
+
+/*
+ *  The shader blitters shade a whole span into a buffer, then make a second pass over it to
+ *  blend it into the device, calling through the xfermode or a blit-row proc.  For the most
+ *  common shader x xfermode x device combinations we can do better: these blitters are
+ *  generated from templates over a Source (produces 4 pixels at a time), a Mode (blends them
+ *  with Sk4px) and a Dst (loads and stores device pixels), so shading, coverage and blending
+ *  all happen in one pass, in registers.
+ *
+ *  Anything they do not handle (non-A8 masks, a new shader context) goes to the blitter
+ *  that SkBlitter::Choose() would otherwise have used.
+ */
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Sources: beginRow() positions the source at a device pixel, and nextN() returns the next
+// N pixels (in the low lanes) and advances.
+
+// Any shader that shades the same color everywhere.
+class SolidSource {
+public:
+    explicit SolidSource(SkPMColor color) : fColor(color) {}
+
+    void beginRow(int x, int y) {}
+
+    Sk4px next4() { return Sk4px::DupPMColor(fColor); }
+    Sk4px next2() { return Sk4px::DupPMColor(fColor); }
+    Sk4px next1() { return Sk4px::DupPMColor(fColor); }
+
+private:
+    SkPMColor fColor;
+};
+
+// An N32 premul bitmap, clamped, translated by whole pixels.
+class BitmapSource {
+public:
+    BitmapSource(const SkBitmap& bitmap, int dx, int dy) : fBitmap(bitmap), fDx(dx), fDy(dy) {
+        fBitmap.lockPixels();
+    }
+
+    void beginRow(int x, int y) {
+        fRow = fBitmap.getAddr32(0, SkTPin(y + fDy, 0, fBitmap.height() - 1));
+        fX = x + fDx;
+    }
+
+    Sk4px next4() { SkPMColor tmp[4]; return Sk4px::Load4(this->fetch(4, tmp)); }
+    Sk4px next2() { SkPMColor tmp[2]; return Sk4px::Load2(this->fetch(2, tmp)); }
+    Sk4px next1() { SkPMColor tmp[1]; return Sk4px::Load1(this->fetch(1, tmp)); }
+
+private:
+    // Points straight into the bitmap unless some of the n pixels need clamping.
+    const SkPMColor* fetch(int n, SkPMColor tmp[]) {
+        const int x = fX;
+        fX += n;
+        if (x >= 0 && x + n <= fBitmap.width()) {
+            return fRow + x;
+        }
+        for (int i = 0; i < n; ++i) {
+            tmp[i] = fRow[SkTPin(x + i, 0, fBitmap.width() - 1)];
+        }
+        return tmp;
+    }
+
+    SkBitmap            fBitmap;
+    const int           fDx, fDy;
+    const SkPMColor*    fRow;
+    int                 fX;
+};
+
+// A clamped two-color linear gradient between opaque colors (so interpolating before or after
+// premultiplying is the same), without dithering.  t is affine in device space.
+class LinearGradientSource {
+public:
+    LinearGradientSource(const SkPMColor colors[2], float t0, float dtdx, float dtdy)
+        : fT0(t0), fDtDx(dtdx), fDtDy(dtdy) {
+        const Sk4f c0 = SkNx_cast<float>(Sk4b::Load(&colors[0])),
+                   c1 = SkNx_cast<float>(Sk4b::Load(&colors[1]));
+        // Bias by 1/2 so that truncating to bytes rounds.
+        (c0 + Sk4f(0.5f)).store(fC0);
+        (c1 - c0).store(fDC);
+    }
+
+    void beginRow(int x, int y) {
+        fT = fT0 + fDtDx * (x + 0.5f) + fDtDy * (y + 0.5f);
+    }
+
+    Sk4px next4() {
+        const Sk4f c0 = Sk4f::Load(fC0),
+                   dc = Sk4f::Load(fDC);
+        SkPMColor px[4];
+        Sk4f_ToBytes((uint8_t*)px, this->color(c0, dc, 0), this->color(c0, dc, 1),
+                                   this->color(c0, dc, 2), this->color(c0, dc, 3));
+        fT += 4 * fDtDx;
+        return Sk4px::Load4(px);
+    }
+    Sk4px next2() { SkPMColor px[2]; this->store(px, 2); return Sk4px::Load2(px); }
+    Sk4px next1() { SkPMColor px[1]; this->store(px, 1); return Sk4px::Load1(px); }
+
+private:
+    Sk4f color(const Sk4f& c0, const Sk4f& dc, int i) const {
+        return c0 + dc * Sk4f(SkTPin(fT + i * fDtDx, 0.0f, 1.0f));
+    }
+
+    void store(SkPMColor px[], int n) {
+        const Sk4f c0 = Sk4f::Load(fC0),
+                   dc = Sk4f::Load(fDC);
+        for (int i = 0; i < n; ++i) {
+            SkNx_cast<uint8_t>(this->color(c0, dc, i)).store(&px[i]);
+        }
+        fT += n * fDtDx;
+    }
+
+    // Sk4f members would not be aligned in the blitter allocator, so colors are kept as floats.
+    float       fC0[4];
+    float       fDC[4];
+    const float fT0, fDtDx, fDtDy;
+    float       fT;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Modes, matching SkXfermode_opts.h.
+
+struct SrcOver {
+    static Sk4px Xfer(const Sk4px& s, const Sk4px& d) {
+        return s + d.approxMulDiv255(s.alphas().inv());
+    }
+};
+
+struct Src {
+    static Sk4px Xfer(const Sk4px& s, const Sk4px& d) { return s; }
+};
+
+struct Multiply {
+    static Sk4px Xfer(const Sk4px& s, const Sk4px& d) {
+        return (s * d.alphas().inv() + d * s.alphas().inv() + s*d).div255();
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Devices.
+
+struct Dst32 {
+    typedef uint32_t Pixel;
+    static Pixel* Addr(const SkPixmap& device, int x, int y) {
+        return device.writable_addr32(x, y);
+    }
+
+    static Sk4px Load4(const Pixel* p) { return Sk4px::Load4(p); }
+    static Sk4px Load2(const Pixel* p) { return Sk4px::Load2(p); }
+    static Sk4px Load1(const Pixel* p) { return Sk4px::Load1(p); }
+    static void Store4(Pixel* p, const Sk4px& px) { px.store4(p); }
+    static void Store2(Pixel* p, const Sk4px& px) { px.store2(p); }
+    static void Store1(Pixel* p, const Sk4px& px) { px.store1(p); }
+};
+
+struct Dst565 {
+    typedef uint16_t Pixel;
+    static Pixel* Addr(const SkPixmap& device, int x, int y) {
+        return device.writable_addr16(x, y);
+    }
+
+    static Sk4px Load4(const Pixel* p) { SkPMColor t[4]; return Sk4px::Load4(Expand(p, t, 4)); }
+    static Sk4px Load2(const Pixel* p) { SkPMColor t[2]; return Sk4px::Load2(Expand(p, t, 2)); }
+    static Sk4px Load1(const Pixel* p) { SkPMColor t[1]; return Sk4px::Load1(Expand(p, t, 1)); }
+    static void Store4(Pixel* p, const Sk4px& px) { SkPMColor t[4]; px.store4(t); Pack(p, t, 4); }
+    static void Store2(Pixel* p, const Sk4px& px) { SkPMColor t[2]; px.store2(t); Pack(p, t, 2); }
+    static void Store1(Pixel* p, const Sk4px& px) { SkPMColor t[1]; px.store1(t); Pack(p, t, 1); }
+
+private:
+    static const SkPMColor* Expand(const Pixel* p, SkPMColor tmp[], int n) {
+        for (int i = 0; i < n; ++i) {
+            tmp[i] = SkPixel16ToPixel32(p[i]);
+        }
+        return tmp;
+    }
+    static void Pack(Pixel* p, const SkPMColor tmp[], int n) {
+        for (int i = 0; i < n; ++i) {
+            p[i] = SkPixel32ToPixel16(tmp[i]);
+        }
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Coverage: how to lerp the blended result r back towards the device d.
+
+struct FullCoverage {
+    Sk4px lerp4(const Sk4px& d, const Sk4px& r) { return r; }
+    Sk4px lerp2(const Sk4px& d, const Sk4px& r) { return r; }
+    Sk4px lerp1(const Sk4px& d, const Sk4px& r) { return r; }
+};
+
+struct ConstCoverage {
+    explicit ConstCoverage(SkAlpha aa) : fAA(aa) {}
+
+    Sk4px lerp(const Sk4px& d, const Sk4px& r) const {
+        const Sk4px aa = Sk4px::DupAlpha(fAA);
+        return (r * aa + d * aa.inv()).div255();
+    }
+    Sk4px lerp4(const Sk4px& d, const Sk4px& r) { return this->lerp(d, r); }
+    Sk4px lerp2(const Sk4px& d, const Sk4px& r) { return this->lerp(d, r); }
+    Sk4px lerp1(const Sk4px& d, const Sk4px& r) { return this->lerp(d, r); }
+
+    SkAlpha fAA;
+};
+
+struct MaskCoverage {
+    explicit MaskCoverage(const SkAlpha* aa) : fAA(aa) {}
+
+    static Sk4px Lerp(const Sk4px& d, const Sk4px& r, const Sk4px& aa) {
+        return (r * aa + d * aa.inv()).div255();
+    }
+    Sk4px lerp4(const Sk4px& d, const Sk4px& r) {
+        const Sk4px aa = Sk4px::Load4Alphas(fAA);
+        fAA += 4;
+        return Lerp(d, r, aa);
+    }
+    Sk4px lerp2(const Sk4px& d, const Sk4px& r) {
+        const Sk4px aa = Sk4px::Load2Alphas(fAA);
+        fAA += 2;
+        return Lerp(d, r, aa);
+    }
+    Sk4px lerp1(const Sk4px& d, const Sk4px& r) {
+        return Lerp(d, r, Sk4px::DupAlpha(*fAA++));
+    }
+
+    const SkAlpha* fAA;
+};
+
+template <typename Mode, typename Dst, typename Source, typename Coverage>
+static void blend_row(typename Dst::Pixel* dst, Source* src, int n, Coverage cov) {
+    while (n >= 4) {
+        const Sk4px d = Dst::Load4(dst);
+        Dst::Store4(dst, cov.lerp4(d, Mode::Xfer(src->next4(), d)));
+        dst += 4;
+        n -= 4;
+    }
+    if (n & 2) {
+        const Sk4px d = Dst::Load2(dst);
+        Dst::Store2(dst, cov.lerp2(d, Mode::Xfer(src->next2(), d)));
+        dst += 2;
+    }
+    if (n & 1) {
+        const Sk4px d = Dst::Load1(dst);
+        Dst::Store1(dst, cov.lerp1(d, Mode::Xfer(src->next1(), d)));
+    }
+}
+
+template <typename Source, typename Mode, typename Dst>
+class SkFusedBlitter : public SkRasterBlitter {
+public:
+    template <typename... Args>
+    SkFusedBlitter(const SkPixmap& device, SkBlitter* fallback, const Args&... args)
+        : INHERITED(device)
+        , fFallback(fallback)
+        , fSource(args...)
+        , fUseFallback(false) {}
+
+    void blitH(int x, int y, int width) override {
+        if (fUseFallback) {
+            return fFallback->blitH(x, y, width);
+        }
+        this->blitRow(x, y, width, FullCoverage());
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        if (fUseFallback) {
+            return fFallback->blitAntiH(x, y, antialias, runs);
+        }
+        for (;;) {
+            const int count = *runs;
+            if (count <= 0) {
+                break;
+            }
+            const SkAlpha aa = *antialias;
+            if (0xFF == aa) {
+                this->blitRow(x, y, count, FullCoverage());
+            } else if (aa) {
+                this->blitRow(x, y, count, ConstCoverage(aa));
+            }
+            runs += count;
+            antialias += count;
+            x += count;
+        }
+    }
+
+    void blitV(int x, int y, int height, SkAlpha alpha) override {
+        if (fUseFallback) {
+            return fFallback->blitV(x, y, height, alpha);
+        }
+        for (int i = 0; i < height; ++i) {
+            if (0xFF == alpha) {
+                this->blitRow(x, y + i, 1, FullCoverage());
+            } else {
+                this->blitRow(x, y + i, 1, ConstCoverage(alpha));
+            }
+        }
+    }
+
+    void blitRect(int x, int y, int width, int height) override {
+        if (fUseFallback) {
+            return fFallback->blitRect(x, y, width, height);
+        }
+        for (int i = 0; i < height; ++i) {
+            this->blitRow(x, y + i, width, FullCoverage());
+        }
+    }
+
+    void blitMask(const SkMask& mask, const SkIRect& clip) override {
+        if (fUseFallback || SkMask::kA8_Format != mask.fFormat) {
+            return fFallback->blitMask(mask, clip);
+        }
+        for (int y = clip.fTop; y < clip.fBottom; ++y) {
+            this->blitRow(clip.fLeft, y, clip.width(),
+                          MaskCoverage(mask.getAddr8(clip.fLeft, y)));
+        }
+    }
+
+    // Our source was resolved from the old context, so from here on the fallback draws.
+    bool resetShaderContext(const SkShader::ContextRec& rec) override {
+        fUseFallback = true;
+        return fFallback->resetShaderContext(rec);
+    }
+
+    SkShader::Context* getShaderContext() const override {
+        return fFallback->getShaderContext();
+    }
+
+private:
+    template <typename Coverage>
+    void blitRow(int x, int y, int width, Coverage cov) {
+        fSource.beginRow(x, y);
+        blend_row<Mode, Dst>(Dst::Addr(fDevice, x, y), &fSource, width, cov);
+    }
+
+    SkBlitter*  fFallback;
+    Source      fSource;
+    bool        fUseFallback;
+
+    typedef SkRasterBlitter INHERITED;
+};
+
+template <typename Source, typename Mode, typename... Args>
+SkBlitter* create_for_dst(const SkPixmap& device, SkBlitter* fallback,
+                          SkTBlitterAllocator* allocator, const Args&... args) {
+    switch (device.colorType()) {
+        case kN32_SkColorType:
+            return allocator->createT<SkFusedBlitter<Source, Mode, Dst32>>(device, fallback,
+                                                                           args...);
+        case kRGB_565_SkColorType:
+            return allocator->createT<SkFusedBlitter<Source, Mode, Dst565>>(device, fallback,
+                                                                            args...);
+        default:
+            return nullptr;
+    }
+}
+
+template <typename Source, typename... Args>
+SkBlitter* create_for_mode(SkXfermode::Mode mode, const SkPixmap& device, SkBlitter* fallback,
+                           SkTBlitterAllocator* allocator, const Args&... args) {
+    switch (mode) {
+        case SkXfermode::kSrcOver_Mode:
+            return create_for_dst<Source, SrcOver>(device, fallback, allocator, args...);
+        case SkXfermode::kSrc_Mode:
+            return create_for_dst<Source, Src>(device, fallback, allocator, args...);
+        case SkXfermode::kMultiply_Mode:
+            return create_for_dst<Source, Multiply>(device, fallback, allocator, args...);
+        default:
+            return nullptr;
+    }
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+SkBlitter* SkBlitter_ChooseFused(const SkPixmap& device, const SkPaint& paint,
+                                 SkShader::Context* shaderContext, SkBlitter* fallback,
+                                 SkTBlitterAllocator* allocator) {
+    SkASSERT(shaderContext && fallback);
+
+    if (SkBlitter::PreferredShaderDest(device.info()) != SkShader::ContextRec::kPMColor_DstType) {
+        return nullptr;
+    }
+    if (kRGB_565_SkColorType == device.colorType()) {
+        // The 565 shader blitters dither.
+        if (paint.isDither()) {
+            return nullptr;
+        }
+    } else if (kN32_SkColorType != device.colorType()) {
+        return nullptr;
+    }
+
+    SkXfermode::Mode mode = SkXfermode::kSrcOver_Mode;
+    if (!SkXfermode::AsMode(paint.getXfermode(), &mode)) {
+        return nullptr;
+    }
+    if (mode != SkXfermode::kSrcOver_Mode &&
+        mode != SkXfermode::kSrc_Mode &&
+        mode != SkXfermode::kMultiply_Mode) {
+        return nullptr;
+    }
+
+    const SkShader* shader = paint.getShader();
+    const SkMatrix& inverse = shaderContext->getTotalInverse();
+
+    SkColor colors[2];
+    SkShader::GradientInfo info;
+    sk_bzero(&info, sizeof(info));
+    info.fColors = colors;
+    info.fColorCount = SK_ARRAY_COUNT(colors);
+
+    switch (shader->asAGradient(&info)) {
+        case SkShader::kColor_GradientType: {
+            // Let the context apply the paint's alpha.
+            SkPMColor color;
+            shaderContext->shadeSpan(0, 0, &color, 1);
+            return create_for_mode<SolidSource>(mode, device, fallback, allocator, color);
+        }
+        case SkShader::kLinear_GradientType: {
+            if (2 != info.fColorCount || SkShader::kClamp_TileMode != info.fTileMode ||
+                0xFF != SkColorGetA(colors[0]) || 0xFF != SkColorGetA(colors[1]) ||
+                paint.isDither() || inverse.hasPerspective()) {
+                return nullptr;
+            }
+            const SkVector v = info.fPoint[1] - info.fPoint[0];
+            const SkScalar len2 = v.lengthSqd();
+            if (SkScalarNearlyZero(len2)) {
+                return nullptr;
+            }
+            // t = (inverse(x, y) - fPoint[0]) . v / |v|^2
+            const float dtdx = (inverse.getScaleX() * v.fX + inverse.getSkewY() * v.fY) / len2,
+                        dtdy = (inverse.getSkewX() * v.fX + inverse.getScaleY() * v.fY) / len2,
+                        t0   = ((inverse.getTranslateX() - info.fPoint[0].fX) * v.fX +
+                                (inverse.getTranslateY() - info.fPoint[0].fY) * v.fY) / len2;
+
+            // Scaled the way the gradient context does it, so we match.
+            const unsigned scale = paint.getAlpha() + (paint.getAlpha() >> 7);
+            SkPMColor pmcolors[2];
+            for (int i = 0; i < 2; ++i) {
+                pmcolors[i] = SkAlphaMulQ(SkPreMultiplyColor(colors[i]), scale);
+            }
+            return create_for_mode<LinearGradientSource>(mode, device, fallback, allocator,
+                                                         pmcolors, t0, dtdx, dtdy);
+        }
+        default:
+            break;
+    }
+
+    SkBitmap bitmap;
+    SkMatrix texM;
+    SkShader::TileMode tm[2];
+    if (shader->isABitmap(&bitmap, &texM, tm)) {
+        if (SkShader::kClamp_TileMode != tm[0] || SkShader::kClamp_TileMode != tm[1] ||
+            !texM.isIdentity() || 0xFF != paint.getAlpha() ||
+            kN32_SkColorType != bitmap.colorType() ||
+            kUnpremul_SkAlphaType == bitmap.alphaType() ||
+            inverse.getType() > SkMatrix::kTranslate_Mask ||
+            !SkScalarIsInt(inverse.getTranslateX()) || !SkScalarIsInt(inverse.getTranslateY())) {
+            return nullptr;
+        }
+        SkAutoLockPixels alp(bitmap);
+        if (!bitmap.getPixels()) {
+            return nullptr;
+        }
+        return create_for_mode<BitmapSource>(mode, device, fallback, allocator, bitmap,
+                                             SkScalarRoundToInt(inverse.getTranslateX()),
+                                             SkScalarRoundToInt(inverse.getTranslateY()));
+    }
+    return nullptr;
+}
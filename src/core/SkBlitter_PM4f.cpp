@@ -13,6 +13,7 @@
 #include "SkBlitMask.h"
 #include "SkTemplates.h"
 #include "SkPM4f.h"
+#include "SkPM4fPriv.h"
 
 template <typename State> class SkState_Blitter : public SkRasterBlitter {
     typedef SkRasterBlitter INHERITED;
@@ -27,8 +28,7 @@ public:
     void blitH(int x, int y, int width) override {
         SkASSERT(x >= 0 && y >= 0 && x + width <= fDevice.width());
         
-        fState.fProc1(fState.fXfer, State::WritableAddr(fDevice, x, y),
-                      &fState.fPM4f, width, nullptr);
+        fState.blend1(State::WritableAddr(fDevice, x, y), x, y, &fState.fPM4f, width, nullptr);
     }
 
     void blitV(int x, int y, int height, SkAlpha alpha) override {
@@ -38,7 +38,7 @@ public:
         size_t                 deviceRB = fDevice.rowBytes();
         
         for (int i = 0; i < height; ++i) {
-            fState.fProc1(fState.fXfer, device, &fState.fPM4f, 1, &alpha);
+            fState.blend1(device, x, y + i, &fState.fPM4f, 1, &alpha);
             device = (typename State::DstType*)((char*)device + deviceRB);
         }
     }
@@ -51,7 +51,7 @@ public:
         size_t        deviceRB = fDevice.rowBytes();
         
         do {
-            fState.fProc1(fState.fXfer, device, &fState.fPM4f, width, nullptr);
+            fState.blend1(device, x, y, &fState.fPM4f, width, nullptr);
             y += 1;
             device = (typename State::DstType*)((char*)device + deviceRB);
         } while (--height > 0);
@@ -68,11 +68,10 @@ public:
             int aa = *antialias;
             if (aa) {
                 if (aa == 255) {
-                    fState.fProc1(fState.fXfer, device, &fState.fPM4f, count, nullptr);
+                    fState.blend1(device, x, y, &fState.fPM4f, count, nullptr);
                 } else {
-                    for (int i = 0; i < count; ++i) {
-                        fState.fProc1(fState.fXfer, &device[i], &fState.fPM4f, 1, antialias);
-                    }
+                    memset(fState.fCoverage.get(), aa, count);
+                    fState.blend1(device, x, y, &fState.fPM4f, count, fState.fCoverage.get());
                 }
             }
             device += count;
@@ -125,7 +124,7 @@ public:
         const size_t maskRB = mask.fRowBytes;
         
         for (int i = 0; i < height; ++i) {
-            fState.fProc1(fState.fXfer, device, &fState.fPM4f, width, maskRow);
+            fState.blend1(device, x, y + i, &fState.fPM4f, width, maskRow);
             device = (typename State::DstType*)((char*)device + dstRB);
             maskRow += maskRB;
         }
@@ -147,7 +146,7 @@ public:
         
         typename State::DstType* device = State::WritableAddr(fDevice, x, y);
         fShaderContext->shadeSpan4f(x, y, fState.fBuffer, width);
-        fState.fProcN(fState.fXfer, device, fState.fBuffer, width, nullptr);
+        fState.blendN(device, x, y, fState.fBuffer, width, nullptr);
     }
 
     void blitV(int x, int y, int height, SkAlpha alpha) override {
@@ -164,7 +163,7 @@ public:
             if (!fConstInY) {
                 fShaderContext->shadeSpan4f(x, y, fState.fBuffer, 1);
             }
-            fState.fProcN(fState.fXfer, device, fState.fBuffer, 1, &alpha);
+            fState.blendN(device, x, y, fState.fBuffer, 1, &alpha);
             device = (typename State::DstType*)((char*)device + deviceRB);
         }
     }
@@ -184,7 +183,7 @@ public:
             if (!fConstInY) {
                 fShaderContext->shadeSpan4f(x, y, fState.fBuffer, width);
             }
-            fState.fProcN(fState.fXfer, device, fState.fBuffer, width, nullptr);
+            fState.blendN(device, x, y, fState.fBuffer, width, nullptr);
             device = (typename State::DstType*)((char*)device + deviceRB);
         }
     }
@@ -201,11 +200,10 @@ public:
             if (aa) {
                 fShaderContext->shadeSpan4f(x, y, fState.fBuffer, count);
                 if (aa == 255) {
-                    fState.fProcN(fState.fXfer, device, fState.fBuffer, count, nullptr);
+                    fState.blendN(device, x, y, fState.fBuffer, count, nullptr);
                 } else {
-                    for (int i = 0; i < count; ++i) {
-                        fState.fProcN(fState.fXfer, &device[i], &fState.fBuffer[i], 1, antialias);
-                    }
+                    memset(fState.fCoverage.get(), aa, count);
+                    fState.blendN(device, x, y, fState.fBuffer, count, fState.fCoverage.get());
                 }
             }
             device += count;
@@ -268,7 +266,7 @@ public:
             if (!fConstInY) {
                 fShaderContext->shadeSpan4f(x, y, fState.fBuffer, width);
             }
-            fState.fProcN(fState.fXfer, device, fState.fBuffer, width, maskRow);
+            fState.blendN(device, x, y, fState.fBuffer, width, maskRow);
             device = (typename State::DstType*)((char*)device + deviceRB);
             maskRow += maskRB;
         }
@@ -295,20 +293,68 @@ struct State4f {
         } else {
             fPM4f = SkColor4f::FromColor(paint.getColor()).premul();
         }
+        fCoverage.reset(info.width());
         fFlags = 0;
     }
 
     SkXfermode*             fXfer;
     SkPM4f                  fPM4f;
     SkAutoTMalloc<SkPM4f>   fBuffer;
+    // A run of partial coverage from blitAntiH, spread out so the procs can take it in one go.
+    SkAutoTMalloc<SkAlpha>  fCoverage;
     uint32_t                fFlags;
 };
 
+// A 4x4 ordered dither, as offsets of less than half an 8-bit step either way.
+static const float gDither4x4[16] = {
+    -15/32.0f,   1/32.0f, -11/32.0f,   5/32.0f,
+      9/32.0f,  -7/32.0f,  13/32.0f,  -3/32.0f,
+     -9/32.0f,   7/32.0f, -13/32.0f,   3/32.0f,
+     15/32.0f,  -1/32.0f,  11/32.0f,  -5/32.0f,
+};
+
+// Blends like the kDstIsSRGB_D32Flag procs, but dithers the color channels as it rounds them
+// back to sRGB bytes, so soft gradients and blurs don't band.  The D32 procs aren't told where
+// their pixels are, so this blends here instead, with srcover inlined and other modes through
+// their SkXfermodeProc4f.
+template <bool kSingleSrc>
+static void blend_srgb_dither(SkXfermodeProc4f proc, uint32_t dst[], int x, int y,
+                              const SkPM4f src[], int count, const SkAlpha aa[]) {
+    static_assert(3 == SkPM4f::A, "");
+    const float* ditherRow = gDither4x4 + (y & 3) * 4;
+    SkPM4f d;
+    for (int i = 0; i < count; ++i) {
+        const unsigned a = aa ? aa[i] : 0xFF;
+        if (0 == a) {
+            continue;
+        }
+        const SkPM4f& s = src[kSingleSrc ? 0 : i];
+        const Sk4f d4 = Sk4f_fromS32(dst[i]);
+        Sk4f r4;
+        if (proc) {
+            d4.store(d.fVec);
+            r4 = Sk4f::Load(proc(s, d).fVec);
+        } else {
+            const Sk4f s4 = Sk4f::Load(s.fVec);
+            r4 = s4 + d4 * Sk4f(1 - get_alpha(s4));
+        }
+        if (a != 0xFF) {
+            r4 = d4 + (r4 - d4) * Sk4f(a * (1/255.0f));
+        }
+        const float dither = ditherRow[(x + i) & 3];
+        dst[i] = to_4b(linear_to_srgb(r4) * Sk4f(255) +
+                       Sk4f(0.5f + dither, 0.5f + dither, 0.5f + dither, 0.5f));
+    }
+}
+
 struct State32 : State4f {
     typedef uint32_t    DstType;
     
     SkXfermode::D32Proc fProc1;
     SkXfermode::D32Proc fProcN;
+    // When dithering, the mode's proc, or nullptr for srcover.
+    SkXfermodeProc4f    fDitherProc;
+    bool                fDither;
     
     State32(const SkImageInfo& info, const SkPaint& paint, const SkShader::Context* shaderContext)
         : State4f(info, paint, shaderContext)
@@ -321,6 +367,29 @@ struct State32 : State4f {
         }
         fProc1 = SkXfermode::GetD32Proc(fXfer, fFlags | SkXfermode::kSrcIsSingle_D32Flag);
         fProcN = SkXfermode::GetD32Proc(fXfer, fFlags);
+
+        // Linear 8888 stores are exact enough already; only the sRGB encode loses precision.
+        fDither = info.isSRGB() && paint.isDither();
+        fDitherProc = nullptr;
+        if (fDither && !SkXfermode::IsMode(fXfer, SkXfermode::kSrcOver_Mode)) {
+            fDitherProc = fXfer->getProc4f();
+        }
+    }
+
+    void blend1(DstType* dst, int x, int y, const SkPM4f* src, int count, const SkAlpha aa[]) {
+        if (fDither) {
+            blend_srgb_dither<true>(fDitherProc, dst, x, y, src, count, aa);
+        } else {
+            fProc1(fXfer, dst, src, count, aa);
+        }
+    }
+
+    void blendN(DstType* dst, int x, int y, const SkPM4f src[], int count, const SkAlpha aa[]) {
+        if (fDither) {
+            blend_srgb_dither<false>(fDitherProc, dst, x, y, src, count, aa);
+        } else {
+            fProcN(fXfer, dst, src, count, aa);
+        }
     }
     
     SkXfermode::LCD32Proc getLCDProc(uint32_t oneOrManyFlag) const {
@@ -355,6 +424,14 @@ struct State64 : State4f {
         fProcN = SkXfermode::GetD64Proc(fXfer, fFlags);
     }
 
+    void blend1(DstType* dst, int, int, const SkPM4f* src, int count, const SkAlpha aa[]) {
+        fProc1(fXfer, dst, src, count, aa);
+    }
+
+    void blendN(DstType* dst, int, int, const SkPM4f src[], int count, const SkAlpha aa[]) {
+        fProcN(fXfer, dst, src, count, aa);
+    }
+
     SkXfermode::LCD64Proc getLCDProc(uint32_t oneOrManyFlag) const {
         uint32_t flags = fFlags & 1;
         if (!(fFlags & SkXfermode::kDstIsFloat16_D64Flag)) {
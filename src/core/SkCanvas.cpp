@@ -353,6 +353,11 @@ public:
             fDevice = rec->fDevice;
             if (!fDevice->accessPixels(&fDst)) {
                 fDst.reset(fDevice->imageInfo(), nullptr, 0);
+            } else if (fDevice->surfaceProps().isGammaCorrect() &&
+                       kN32_SkColorType == fDst.colorType() && !fDst.info().isSRGB()) {
+                // Draw as if the pixels were tagged sRGB, so the blitters blend in linear light.
+                fDst.reset(fDst.info().makeProfileType(kSRGB_SkColorProfileType),
+                           fDst.writable_addr(), fDst.rowBytes());
             }
             fPaint  = rec->fPaint;
             SkDEBUGCODE(this->validate();)
@@ -1777,6 +1782,23 @@ static SK_NEVER_INLINE bool quick_reject_slow_path(const SkRect& src, const SkRe
     return !deviceRect.isFinite() || !deviceRect.intersect(deviceClip);
 }
 
+static inline bool quick_reject_scale_translate(const SkRect& src, const Sk4f& scale,
+                                                const Sk4f& trans, const Sk4f& devClip) {
+    // Apply matrix.
+    Sk4f ltrb = Sk4f::Load(&src.fLeft) * scale + trans;
+
+    // Make sure left < right, top < bottom.
+    Sk4f rblt(ltrb[2], ltrb[3], ltrb[0], ltrb[1]);
+    Sk4f min = Sk4f::Min(ltrb, rblt);
+    Sk4f max = Sk4f::Max(ltrb, rblt);
+    // We can extract either pair [0,1] or [2,3] from min and max and be correct, but on
+    // ARM this sequence generates the fastest (a single instruction).
+    Sk4f devRect = Sk4f(min[2], min[3], max[0], max[1]);
+
+    // Check if the device rect is NaN or outside the clip.
+    return is_nan_or_clipped(devRect, devClip);
+}
+
 bool SkCanvas::quickReject(const SkRect& src) const {
 #ifdef SK_DEBUG
     // Verify that fDeviceClipBounds are set properly.
@@ -1803,19 +1825,63 @@ bool SkCanvas::quickReject(const SkRect& src) const {
     Sk4f scale(sx, sy, sx, sy);
     Sk4f trans(tx, ty, tx, ty);
 
-    // Apply matrix.
-    Sk4f ltrb = Sk4f::Load(&src.fLeft) * scale + trans;
+    return quick_reject_scale_translate(src, scale, trans, Sk4f::Load(&fDeviceClipBounds.fLeft));
+}
 
-    // Make sure left < right, top < bottom.
-    Sk4f rblt(ltrb[2], ltrb[3], ltrb[0], ltrb[1]);
-    Sk4f min = Sk4f::Min(ltrb, rblt);
-    Sk4f max = Sk4f::Max(ltrb, rblt);
-    // We can extract either pair [0,1] or [2,3] from min and max and be correct, but on
-    // ARM this sequence generates the fastest (a single instruction).
-    Sk4f devRect = Sk4f(min[2], min[3], max[0], max[1]);
+int SkCanvas::quickReject(const SkRect rects[], int count, bool rejected[]) const {
+    int rejectCount = 0;
 
-    // Check if the device rect is NaN or outside the clip.
-    return is_nan_or_clipped(devRect, Sk4f::Load(&fDeviceClipBounds.fLeft));
+    // Pick the mapping once for the whole array, rather than once per rect.
+    const SkMatrix& matrix = fMCRec->fMatrix;
+    if (matrix.hasPerspective()) {
+        for (int i = 0; i < count; ++i) {
+            rejected[i] = quick_reject_slow_path(rects[i], fDeviceClipBounds, matrix);
+            rejectCount += rejected[i];
+        }
+        return rejectCount;
+    }
+
+    const Sk4f devClip = Sk4f::Load(&fDeviceClipBounds.fLeft);
+
+    if (!fConservativeIsScaleTranslate) {
+        // Map all four corners of each rect at once, and take their bounds.
+        const Sk4f sx(matrix.getScaleX()), kx(matrix.getSkewX()), tx(matrix.getTranslateX());
+        const Sk4f ky(matrix.getSkewY()), sy(matrix.getScaleY()), ty(matrix.getTranslateY());
+        for (int i = 0; i < count; ++i) {
+            const SkRect& r = rects[i];
+            Sk4f x(r.fLeft, r.fRight, r.fRight, r.fLeft);
+            Sk4f y(r.fTop, r.fTop, r.fBottom, r.fBottom);
+            Sk4f devX = x * sx + y * kx + tx;
+            Sk4f devY = x * ky + y * sy + ty;
+
+            Sk4f xyxy01(devX[0], devY[0], devX[1], devY[1]);
+            Sk4f xyxy23(devX[2], devY[2], devX[3], devY[3]);
+            Sk4f min = Sk4f::Min(xyxy01, xyxy23);
+            Sk4f max = Sk4f::Max(xyxy01, xyxy23);
+            Sk4f devRect(SkTMin(min[0], min[2]), SkTMin(min[1], min[3]),
+                         SkTMax(max[0], max[2]), SkTMax(max[1], max[3]));
+
+            // As mapRect() does, reject the rect if any corner maps to NaN or infinity.
+            const Sk4f zero(0);
+            const bool finite = (devX * zero + devY * zero == zero).allTrue();
+            rejected[i] = !finite || is_nan_or_clipped(devRect, devClip);
+            rejectCount += rejected[i];
+        }
+        return rejectCount;
+    }
+
+    float sx = fMCRec->fMatrix.getScaleX();
+    float sy = fMCRec->fMatrix.getScaleY();
+    float tx = fMCRec->fMatrix.getTranslateX();
+    float ty = fMCRec->fMatrix.getTranslateY();
+    const Sk4f scale(sx, sy, sx, sy);
+    const Sk4f trans(tx, ty, tx, ty);
+
+    for (int i = 0; i < count; ++i) {
+        rejected[i] = quick_reject_scale_translate(rects[i], scale, trans, devClip);
+        rejectCount += rejected[i];
+    }
+    return rejectCount;
 }
 
 bool SkCanvas::quickReject(const SkPath& path) const {
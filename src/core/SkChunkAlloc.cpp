@@ -66,7 +66,7 @@ SkChunkAlloc::SkChunkAlloc(size_t minSize) {
     fTotalCapacity = 0;
     fTotalUsed = 0;
     SkDEBUGCODE(fTotalLost = 0;)
-    SkDEBUGCODE(fBlockCount = 0;)
+    fBlockCount = 0;
 }
 
 SkChunkAlloc::~SkChunkAlloc() {
@@ -80,7 +80,7 @@ void SkChunkAlloc::reset() {
     fTotalCapacity = 0;
     fTotalUsed = 0;
     SkDEBUGCODE(fTotalLost = 0;)
-    SkDEBUGCODE(fBlockCount = 0;)
+    fBlockCount = 0;
 }
 
 void SkChunkAlloc::rewind() {
@@ -102,10 +102,10 @@ void SkChunkAlloc::rewind() {
 
         largest->reset();
         fTotalCapacity = largest->blockSize();
-        SkDEBUGCODE(fBlockCount = 1;)
+        fBlockCount = 1;
     } else {
         fTotalCapacity = 0;
-        SkDEBUGCODE(fBlockCount = 0;)
+        fBlockCount = 0;
     }
 
     fBlock = largest;
@@ -129,7 +129,7 @@ SkChunkAlloc::Block* SkChunkAlloc::newBlock(size_t bytes, AllocFailType ftype) {
         block->fFreePtr = block->startOfData();
 
         fTotalCapacity += size;
-        SkDEBUGCODE(fBlockCount += 1;)
+        fBlockCount += 1;
 
         fChunkSize = increase_next_size(fChunkSize);
     }
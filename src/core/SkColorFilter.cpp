@@ -170,10 +170,12 @@ SkColorFilter* SkColorFilter::CreateComposeFilter(SkColorFilter* outer, SkColorF
     return new SkComposeColorFilter(outer, inner, count);
 }
 
+#include "SkColorSpaceXform.h"
 #include "SkModeColorFilter.h"
 
 SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_START(SkColorFilter)
 SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkComposeColorFilter)
 SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkModeColorFilter)
+SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkColorSpaceXformFilter)
 SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_END
 
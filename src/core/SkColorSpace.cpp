@@ -144,12 +144,21 @@ const SkFloat3x3 gSRGB_toXYZD50 {{
     0.1430f, 0.0606f, 0.7139f,    // * B
 }};
 
+// Display P3 has the DCI-P3 primaries, with the D65 white point and the gamma of sRGB.
+const SkFloat3x3 gDisplayP3_toXYZD50 {{
+    0.5151f, 0.2412f, -0.0011f,   // * R
+    0.2919f, 0.6922f,  0.0419f,   // * G
+    0.1571f, 0.0666f,  0.7841f,   // * B
+}};
+
 SkColorSpace* SkColorSpace::NewNamed(Named named) {
     switch (named) {
         case kDevice_Named:
             return new SkColorSpace(gDevice_toXYZD50, gDevice_gamma, kDevice_Named);
         case kSRGB_Named:
             return new SkColorSpace(gSRGB_toXYZD50, gSRGB_gamma, kSRGB_Named);
+        case kDisplayP3_Named:
+            return new SkColorSpace(gDisplayP3_toXYZD50, gSRGB_gamma, kDisplayP3_Named);
         default:
             break;
     }
@@ -158,16 +167,176 @@ SkColorSpace* SkColorSpace::NewNamed(Named named) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <math.h>
+
+static uint16_t read_be16(const uint8_t* p) {
+    return (p[0] << 8) | p[1];
+}
+
+static uint32_t read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static float read_s15Fixed16(const uint8_t* p) {
+    return (int32_t)read_be32(p) * (1.0f / 65536);
+}
+
+static bool tag_is(const uint8_t* p, const char sig[4]) {
+    return 0 == memcmp(p, sig, 4);
+}
+
+struct ICCTag {
+    const uint8_t* fData;
+    uint32_t       fLength;
+};
+
+static const size_t kICCHeaderSize   = 128;
+static const size_t kICCTagTableOffset = kICCHeaderSize + 4;
+static const size_t kICCTagEntrySize = 12;
+
+// Looks up a tag in the tag table of the profile, checking that it lies within the profile.
+// NewICC() has already checked that the table fits in len.
+static bool find_icc_tag(const uint8_t* base, size_t len, const char sig[4], ICCTag* tag) {
+    const uint32_t count = read_be32(base + kICCHeaderSize);
+    SkASSERT(len >= kICCTagTableOffset + count * kICCTagEntrySize);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t* entry = base + kICCTagTableOffset + kICCTagEntrySize * i;
+        if (tag_is(entry, sig)) {
+            const uint32_t offset = read_be32(entry + 4),
+                           length = read_be32(entry + 8);
+            if (offset > len || length > len - offset || length < 12) {
+                return false;
+            }
+            tag->fData = base + offset;
+            tag->fLength = length;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parse_xyz(const ICCTag& tag, float xyz[3]) {
+    if (!tag_is(tag.fData, "XYZ ") || tag.fLength < 20) {
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        xyz[i] = read_s15Fixed16(tag.fData + 8 + 4 * i);
+    }
+    return true;
+}
+
+// Evaluates a parametric curve, following the function types of ICC.1:2010, 10.15.
+static float eval_parametric(int type, const float p[7], float x) {
+    const float g = p[0], a = p[1], b = p[2], c = p[3], d = p[4], e = p[5], f = p[6];
+    switch (type) {
+        case 0: return powf(x, g);
+        case 1: return x >= -b / a ? powf(a * x + b, g) : 0;
+        case 2: return x >= -b / a ? powf(a * x + b, g) + c : c;
+        case 3: return x >= d ? powf(a * x + b, g) : c * x;
+        case 4: return x >= d ? powf(a * x + b, g) + e : c * x + f;
+    }
+    SkASSERT(false);
+    return x;
+}
+
+// Returns the exponent that matches the curve at the middle of its range.
+static float fit_gamma(float yAtHalf) {
+    if (!(yAtHalf > 0 && yAtHalf < 1)) {
+        return 0;
+    }
+    return logf(yAtHalf) / logf(0.5f);
+}
+
+// SkColorSpace only knows power functions, so curves that are anything else are replaced
+// by the power function that agrees with them at 0.5.
+static bool parse_trc(const ICCTag& tag, float* gamma) {
+    const uint8_t* data = tag.fData;
+    if (tag_is(data, "curv")) {
+        const uint32_t count = read_be32(data + 8);
+        if (count > (tag.fLength - 12) / 2) {
+            return false;
+        }
+        if (0 == count) {
+            *gamma = 1;
+        } else if (1 == count) {
+            *gamma = read_be16(data + 12) * (1.0f / 256);
+        } else {
+            const float pos = 0.5f * (count - 1);
+            const uint32_t lo = (uint32_t)pos;
+            const uint32_t hi = SkTMin(lo + 1, count - 1);
+            const float t = pos - lo;
+            const float y = (read_be16(data + 12 + 2 * lo) * (1 - t) +
+                             read_be16(data + 12 + 2 * hi) * t) * (1.0f / 65535);
+            *gamma = fit_gamma(y);
+        }
+    } else if (tag_is(data, "para")) {
+        static const int kParamCounts[] = { 1, 3, 4, 5, 7 };
+        const int type = read_be16(data + 8);
+        if (type >= (int)SK_ARRAY_COUNT(kParamCounts) ||
+            tag.fLength < 12u + 4 * kParamCounts[type]) {
+            return false;
+        }
+        float params[7] = { 1, 1, 0, 0, 0, 0, 0 };
+        for (int i = 0; i < kParamCounts[type]; ++i) {
+            params[i] = read_s15Fixed16(data + 12 + 4 * i);
+        }
+        *gamma = 0 == type ? params[0] : fit_gamma(eval_parametric(type, params, 0.5f));
+    } else {
+        return false;
+    }
+    return *gamma > 0 && SkFloatIsFinite(*gamma);
+}
+
+SkColorSpace* SkColorSpace::NewICC(const void* input, size_t len) {
+    const uint8_t* base = static_cast<const uint8_t*>(input);
+    if (!base || len < kICCTagTableOffset) {
+        return nullptr;
+    }
+    // The header gives the size of the profile, its color space and its connection space.
+    // The profile may be followed by padding, but must hold at least its header and tag table.
+    const uint32_t size = read_be32(base);
+    if (size < kICCTagTableOffset || size > len || !tag_is(base + 36, "acsp") ||
+        !tag_is(base + 16, "RGB ") || !tag_is(base + 20, "XYZ ")) {
+        return nullptr;
+    }
+    len = size;
+    const uint32_t tagCount = read_be32(base + kICCHeaderSize);
+    if (tagCount > (len - kICCTagTableOffset) / kICCTagEntrySize) {
+        return nullptr;
+    }
+
+    static const char* kXYZTags[] = { "rXYZ", "gXYZ", "bXYZ" };
+    static const char* kTRCTags[] = { "rTRC", "gTRC", "bTRC" };
+    SkFloat3x3 toXYZD50;
+    SkFloat3 gamma;
+    for (int i = 0; i < 3; ++i) {
+        ICCTag tag;
+        if (!find_icc_tag(base, len, kXYZTags[i], &tag) || !parse_xyz(tag, toXYZD50.fMat + 3*i)) {
+            return nullptr;
+        }
+        if (!find_icc_tag(base, len, kTRCTags[i], &tag) || !parse_trc(tag, gamma.fVec + i)) {
+            return nullptr;
+        }
+    }
+    return NewRGB(toXYZD50, gamma);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 SkColorSpace::Result SkColorSpace::Concat(const SkColorSpace* src, const SkColorSpace* dst,
                                           SkFloat3x3* result) {
-    if (!src || !dst || (src->named() == kDevice_Named) || (src->named() == dst->named())) {
+    // Spaces with no name can only be compared by their contents.
+    const bool sameNamed = src && dst && src->named() == dst->named() &&
+                           kUnknown_Named != src->named();
+    if (!src || !dst || (src->named() == kDevice_Named) || sameNamed) {
         if (result) {
             *result = {{ 1, 0, 0, 0, 1, 0, 0, 0, 1 }};
         }
         return kIdentity_Result;
     }
     if (result) {
-        *result = concat(src->fToXYZD50, invert(dst->fToXYZD50));
+        // src_linear_RGB --> XYZ --> dst_linear_RGB, so the inverse is applied last.
+        *result = concat(invert(dst->fToXYZD50), src->fToXYZD50);
     }
     return kNormal_Result;
 }
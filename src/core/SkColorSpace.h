@@ -44,6 +44,7 @@ public:
         kUnknown_Named,
         kDevice_Named,
         kSRGB_Named,
+        kDisplayP3_Named,
     };
 
     /**
@@ -53,9 +54,16 @@ public:
     static SkColorSpace* NewRGB(const SkFloat3x3& toXYZD50, const SkFloat3& gamma);
 
     static SkColorSpace* NewNamed(Named);
+
+    /**
+     *  Return a colorspace from an RGB ICC profile built from a matrix and tone curves
+     *  (rXYZ/gXYZ/bXYZ and rTRC/gTRC/bTRC), or nullptr if the profile is not one of those.
+     *  Tone curves that are not a plain power function are approximated by one.
+     */
     static SkColorSpace* NewICC(const void*, size_t);
 
     SkFloat3 gamma() const { return fGamma; }
+    const SkFloat3x3& xyz() const { return fToXYZD50; }
     Named named() const { return fNamed; }
     uint32_t uniqueID() const { return fUniqueID; }
 
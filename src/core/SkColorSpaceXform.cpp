@@ -0,0 +1,296 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkColorSpaceXform.h"
+#include "SkMutex.h"
+#include "SkNx.h"
+#include "SkPM4f.h"
+#include "SkReadBuffer.h"
+#include "SkString.h"
+#include "SkUnPreMultiply.h"
+#include "SkWriteBuffer.h"
+
+#include <math.h>
+
+SkColorSpaceXform::SkColorSpaceXform(const SkFloat3x3& matrix, const SkFloat3& srcGamma,
+                                     const SkFloat3& dstGamma)
+    : fMatrix(matrix)
+    , fSrcGamma(srcGamma)
+    , fDstGamma(dstGamma)
+{
+    for (int c = 0; c < 3; ++c) {
+        for (int i = 0; i < 256; ++i) {
+            fToLinear[c][i] = powf(i * (1.0f / 255), srcGamma.fVec[c]);
+        }
+        const float invGamma = 1 / dstGamma.fVec[c];
+        for (int i = 0; i < kDstTableSize; ++i) {
+            const float root = i * (1.0f / (kDstTableSize - 1));
+            fFromLinear[c][i] = (uint8_t)(255 * powf(root * root, invGamma) + 0.5f);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct XformKey {
+    SkFloat3x3 fMatrix;
+    SkFloat3   fSrcGamma;
+    SkFloat3   fDstGamma;
+
+    bool operator==(const XformKey& other) const {
+        return 0 == memcmp(this, &other, sizeof(XformKey));
+    }
+};
+
+// A handful of spaces covers what a page or an app draws, so a short most-recently-used
+// list is all the cache needs.
+const int kXformCacheCount = 8;
+struct XformCacheEntry {
+    XformKey           fKey;
+    SkColorSpaceXform* fXform;
+};
+
+}
+
+SK_DECLARE_STATIC_MUTEX(gXformCacheMutex);
+static XformCacheEntry gXformCache[kXformCacheCount];
+static int gXformCacheUsed;
+
+SkColorSpaceXform* SkColorSpaceXform::Find(const SkFloat3x3& matrix, const SkFloat3& srcGamma,
+                                           const SkFloat3& dstGamma) {
+    XformKey key;
+    // Zero the key first, so that memcmp does not see padding.
+    sk_bzero(&key, sizeof(key));
+    key.fMatrix = matrix;
+    key.fSrcGamma = srcGamma;
+    key.fDstGamma = dstGamma;
+
+    SkAutoMutexAcquire lock(gXformCacheMutex);
+    int found = 0;
+    while (found < gXformCacheUsed && !(gXformCache[found].fKey == key)) {
+        found++;
+    }
+
+    XformCacheEntry entry;
+    if (found < gXformCacheUsed) {
+        entry = gXformCache[found];
+    } else {
+        entry.fKey = key;
+        entry.fXform = new SkColorSpaceXform(matrix, srcGamma, dstGamma);
+        if (gXformCacheUsed < kXformCacheCount) {
+            gXformCacheUsed++;
+        } else {
+            // Evict the least recently used.
+            found = kXformCacheCount - 1;
+            gXformCache[found].fXform->unref();
+        }
+    }
+
+    // Move the entry to the front.
+    memmove(&gXformCache[1], &gXformCache[0], found * sizeof(XformCacheEntry));
+    gXformCache[0] = entry;
+    return SkRef(entry.fXform);
+}
+
+SkColorSpaceXform* SkColorSpaceXform::New(const SkColorSpace* src, const SkColorSpace* dst) {
+    if (!src || !dst ||
+        SkColorSpace::kDevice_Named == src->named() ||
+        SkColorSpace::kDevice_Named == dst->named()) {
+        return nullptr;
+    }
+
+    SkFloat3x3 matrix;
+    switch (SkColorSpace::Concat(src, dst, &matrix)) {
+        case SkColorSpace::kFailure_Result:
+            return nullptr;
+        case SkColorSpace::kIdentity_Result: {
+            const SkFloat3 srcGamma = src->gamma(),
+                           dstGamma = dst->gamma();
+            if (0 == memcmp(&srcGamma, &dstGamma, sizeof(SkFloat3))) {
+                return nullptr;
+            }
+            break;
+        }
+        case SkColorSpace::kNormal_Result:
+            break;
+    }
+    return Find(matrix, src->gamma(), dst->gamma());
+}
+
+SkColorFilter* SkColorSpaceXform::NewColorFilter(const SkColorSpace* src,
+                                                 const SkColorSpace* dst) {
+    SkAutoTUnref<SkColorSpaceXform> xform(New(src, dst));
+    return xform ? new SkColorSpaceXformFilter(xform) : nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Converts four pixels at a time: the channels are linearized into one Sk4f per channel,
+// so the 3x3 is nine multiplies by broadcast constants, and the results are encoded by
+// looking up their square roots.
+template <int kRShift, int kBShift, bool kPremul>
+static void xform_8888(uint32_t dst[], const uint32_t src[], int count,
+                       const float toLinear[3][256], const uint8_t fromLinear[3][1024],
+                       const float m[9]) {
+    const Sk4f kMaxIndex(SkColorSpaceXform::kDstTableSize - 1);
+
+    while (count > 0) {
+        const int n = SkTMin(count, 4);
+        float r[4] = { 0, 0, 0, 0 },
+              g[4] = { 0, 0, 0, 0 },
+              b[4] = { 0, 0, 0, 0 };
+        unsigned alphas[4];
+        for (int i = 0; i < n; ++i) {
+            const uint32_t p = src[i];
+            alphas[i] = p >> 24;
+            unsigned r8 = (p >> kRShift) & 0xFF,
+                     g8 = (p >>       8) & 0xFF,
+                     b8 = (p >> kBShift) & 0xFF;
+            if (kPremul && alphas[i] != 0xFF) {
+                const SkUnPreMultiply::Scale scale = SkUnPreMultiply::GetScale(alphas[i]);
+                r8 = SkUnPreMultiply::ApplyScale(scale, r8);
+                g8 = SkUnPreMultiply::ApplyScale(scale, g8);
+                b8 = SkUnPreMultiply::ApplyScale(scale, b8);
+            }
+            r[i] = toLinear[0][r8];
+            g[i] = toLinear[1][g8];
+            b[i] = toLinear[2][b8];
+        }
+
+        const Sk4f r4 = Sk4f::Load(r),
+                   g4 = Sk4f::Load(g),
+                   b4 = Sk4f::Load(b);
+        Sk4f dr = r4 * Sk4f(m[0]) + g4 * Sk4f(m[3]) + b4 * Sk4f(m[6]),
+             dg = r4 * Sk4f(m[1]) + g4 * Sk4f(m[4]) + b4 * Sk4f(m[7]),
+             db = r4 * Sk4f(m[2]) + g4 * Sk4f(m[5]) + b4 * Sk4f(m[8]);
+
+        int ri[4], gi[4], bi[4];
+        auto to_index = [&kMaxIndex](const Sk4f& linear) {
+            const Sk4f unit = Sk4f::Min(Sk4f::Max(linear, Sk4f(0)), Sk4f(1));
+            return SkNx_cast<int>(unit.sqrt() * kMaxIndex + Sk4f(0.5f));
+        };
+        to_index(dr).store(ri);
+        to_index(dg).store(gi);
+        to_index(db).store(bi);
+
+        for (int i = 0; i < n; ++i) {
+            const unsigned a = alphas[i];
+            unsigned r8 = fromLinear[0][ri[i]],
+                     g8 = fromLinear[1][gi[i]],
+                     b8 = fromLinear[2][bi[i]];
+            if (kPremul && a != 0xFF) {
+                r8 = SkMulDiv255Round(r8, a);
+                g8 = SkMulDiv255Round(g8, a);
+                b8 = SkMulDiv255Round(b8, a);
+            }
+            dst[i] = (a << 24) | (r8 << kRShift) | (g8 << 8) | (b8 << kBShift);
+        }
+
+        src += n;
+        dst += n;
+        count -= n;
+    }
+}
+
+void SkColorSpaceXform::apply(uint32_t dst[], const uint32_t src[], int count,
+                              SkColorType colorType, SkAlphaType alphaType) const {
+    SkASSERT(kRGBA_8888_SkColorType == colorType || kBGRA_8888_SkColorType == colorType);
+    const bool premul = kPremul_SkAlphaType == alphaType;
+    if (kRGBA_8888_SkColorType == colorType) {
+        (premul ? xform_8888<0, 16, true> : xform_8888<0, 16, false>)
+                (dst, src, count, fToLinear, fFromLinear, fMatrix.fMat);
+    } else {
+        (premul ? xform_8888<16, 0, true> : xform_8888<16, 0, false>)
+                (dst, src, count, fToLinear, fFromLinear, fMatrix.fMat);
+    }
+}
+
+// Looks up x in [0,1] in a table of count entries, interpolating between them.
+template <typename T>
+static float lerp_table(const T table[], int count, float x) {
+    const float pos = SkTPin(x, 0.0f, 1.0f) * (count - 1);
+    const int lo = SkTMin((int)pos, count - 2);
+    const float t = pos - lo;
+    return table[lo] + (table[lo + 1] - table[lo]) * t;
+}
+
+void SkColorSpaceXform::apply(SkPM4f dst[], const SkPM4f src[], int count) const {
+    const float* m = fMatrix.fMat;
+    for (int i = 0; i < count; ++i) {
+        const float a = src[i].fVec[SkPM4f::A];
+        if (0 == a) {
+            dst[i] = src[i];
+            continue;
+        }
+        const float invA = 1 / a;
+        const float r = lerp_table(fToLinear[0], 256, src[i].fVec[SkPM4f::R] * invA),
+                    g = lerp_table(fToLinear[1], 256, src[i].fVec[SkPM4f::G] * invA),
+                    b = lerp_table(fToLinear[2], 256, src[i].fVec[SkPM4f::B] * invA);
+        const float rgb[3] = {
+            r * m[0] + g * m[3] + b * m[6],
+            r * m[1] + g * m[4] + b * m[7],
+            r * m[2] + g * m[5] + b * m[8],
+        };
+        const float scale = a * (1.0f / 255);
+        SkPM4f result;
+        result.fVec[SkPM4f::A] = a;
+        result.fVec[SkPM4f::R] = scale *
+                lerp_table(fFromLinear[0], kDstTableSize, sqrtf(SkTMax(rgb[0], 0.0f)));
+        result.fVec[SkPM4f::G] = scale *
+                lerp_table(fFromLinear[1], kDstTableSize, sqrtf(SkTMax(rgb[1], 0.0f)));
+        result.fVec[SkPM4f::B] = scale *
+                lerp_table(fFromLinear[2], kDstTableSize, sqrtf(SkTMax(rgb[2], 0.0f)));
+        dst[i] = result;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SkColorSpaceXformFilter::filterSpan(const SkPMColor src[], int count,
+                                         SkPMColor result[]) const {
+    fXform->apply(result, src, count, kN32_SkColorType, kPremul_SkAlphaType);
+}
+
+void SkColorSpaceXformFilter::filterSpan4f(const SkPM4f src[], int count,
+                                           SkPM4f result[]) const {
+    fXform->apply(result, src, count);
+}
+
+#ifndef SK_IGNORE_TO_STRING
+void SkColorSpaceXformFilter::toString(SkString* str) const {
+    const SkFloat3& src = fXform->srcGamma();
+    const SkFloat3& dst = fXform->dstGamma();
+    str->appendf("SkColorSpaceXformFilter: gamma (%g %g %g) -> (%g %g %g)",
+                 src.fVec[0], src.fVec[1], src.fVec[2], dst.fVec[0], dst.fVec[1], dst.fVec[2]);
+}
+#endif
+
+void SkColorSpaceXformFilter::flatten(SkWriteBuffer& buffer) const {
+    buffer.writeScalarArray(fXform->matrix().fMat, 9);
+    buffer.writeScalarArray(fXform->srcGamma().fVec, 3);
+    buffer.writeScalarArray(fXform->dstGamma().fVec, 3);
+}
+
+SkFlattenable* SkColorSpaceXformFilter::CreateProc(SkReadBuffer& buffer) {
+    SkFloat3x3 matrix;
+    SkFloat3 srcGamma, dstGamma;
+    if (!buffer.readScalarArray(matrix.fMat, 9) ||
+        !buffer.readScalarArray(srcGamma.fVec, 3) ||
+        !buffer.readScalarArray(dstGamma.fVec, 3)) {
+        return nullptr;
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (!buffer.validate(srcGamma.fVec[i] > 0 && dstGamma.fVec[i] > 0)) {
+            return nullptr;
+        }
+    }
+    SkAutoTUnref<SkColorSpaceXform> xform(SkColorSpaceXform::Find(matrix, srcGamma, dstGamma));
+    return new SkColorSpaceXformFilter(xform);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkColorSpaceXform_DEFINED
+#define SkColorSpaceXform_DEFINED
+
+#include "SkColorFilter.h"
+#include "SkColorSpace.h"
+#include "SkImageInfo.h"
+
+struct SkPM4f;
+
+/**
+ *  Converts colors from one SkColorSpace to another: each channel is linearized through a
+ *  table built from the source gamma, the 3x3 from SkColorSpace::Concat() is applied, and
+ *  the result is re-encoded through a table built from the destination gamma.
+ *
+ *  Building the tables is the expensive part, so transforms are cached by the contents of
+ *  their source and destination spaces, and shared.
+ */
+class SkColorSpaceXform : public SkRefCnt {
+public:
+    /**
+     *  Returns a ref to the transform from src to dst, or nullptr if colors need no
+     *  conversion between them (e.g. they are the same space, or either is kDevice).
+     */
+    static SkColorSpaceXform* New(const SkColorSpace* src, const SkColorSpace* dst);
+
+    /**
+     *  Returns a color filter that applies New(src, dst) to everything drawn with it, or
+     *  nullptr if no conversion is needed.
+     */
+    static SkColorFilter* NewColorFilter(const SkColorSpace* src, const SkColorSpace* dst);
+
+    /**
+     *  Returns a ref to the transform that applies matrix between the two gammas.  Unlike
+     *  New(), this never returns nullptr.
+     */
+    static SkColorSpaceXform* Find(const SkFloat3x3& matrix, const SkFloat3& srcGamma,
+                                   const SkFloat3& dstGamma);
+
+    /**
+     *  Converts count pixels of colorType, which must be kRGBA_8888 or kBGRA_8888.  If
+     *  alphaType is kPremul, the pixels are unpremultiplied before conversion, and
+     *  premultiplied again after.  dst may be the same as src.
+     */
+    void apply(uint32_t dst[], const uint32_t src[], int count, SkColorType colorType,
+               SkAlphaType alphaType) const;
+
+    /**
+     *  Converts count premultiplied float pixels, which hold encoded (not linear) values.
+     *  dst may be the same as src.
+     */
+    void apply(SkPM4f dst[], const SkPM4f src[], int count) const;
+
+    const SkFloat3x3& matrix() const { return fMatrix; }
+    const SkFloat3& srcGamma() const { return fSrcGamma; }
+    const SkFloat3& dstGamma() const { return fDstGamma; }
+
+    // Entries in the table that encodes linear values.  It is indexed by sqrt(linear), so
+    // that dark values, where the encoding is steepest, get their share of the entries.
+    static const int kDstTableSize = 1024;
+
+private:
+    SkColorSpaceXform(const SkFloat3x3& matrix, const SkFloat3& srcGamma,
+                      const SkFloat3& dstGamma);
+
+    const SkFloat3x3 fMatrix;
+    const SkFloat3   fSrcGamma;
+    const SkFloat3   fDstGamma;
+
+    // Encoded 8-bit value -> linear float, per channel.
+    float   fToLinear[3][256];
+    // sqrt(linear) * (kDstTableSize - 1) -> encoded 8-bit value, per channel.
+    uint8_t fFromLinear[3][kDstTableSize];
+
+    typedef SkRefCnt INHERITED;
+};
+
+/**
+ *  Applies an SkColorSpaceXform to the colors drawn with it.  Created by
+ *  SkColorSpaceXform::NewColorFilter().
+ */
+class SkColorSpaceXformFilter : public SkColorFilter {
+public:
+    uint32_t getFlags() const override { return kAlphaUnchanged_Flag; }
+    void filterSpan(const SkPMColor src[], int count, SkPMColor result[]) const override;
+    void filterSpan4f(const SkPM4f src[], int count, SkPM4f result[]) const override;
+
+#ifndef SK_IGNORE_TO_STRING
+    void toString(SkString* str) const override;
+#endif
+
+    SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkColorSpaceXformFilter)
+
+protected:
+    void flatten(SkWriteBuffer&) const override;
+
+private:
+    explicit SkColorSpaceXformFilter(SkColorSpaceXform* xform) : fXform(SkRef(xform)) {}
+
+    SkAutoTUnref<SkColorSpaceXform> fXform;
+
+    friend class SkColorFilter;
+    friend class SkColorSpaceXform;
+
+    typedef SkColorFilter INHERITED;
+};
+
+#endif
@@ -3,22 +3,13 @@
 // found in the LICENSE file.
 
 #include "SkConvolver.h"
-#include "SkTArray.h"
+#include "SkOpts.h"
+#include "SkTLS.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
 
 namespace {
 
-    // Converts the argument to an 8-bit unsigned value by clamping to the range
-    // 0-255.
-    inline unsigned char ClampTo8(int a) {
-        if (static_cast<unsigned>(a) < 256) {
-            return a;  // Avoid the extra check in the common case.
-        }
-        if (a < 0) {
-            return 0;
-        }
-        return 255;
-    }
-
     // Stores a list of rows in a circular buffer. The usage is you write into it
     // by calling AdvanceRow. It will keep track of which row in the buffer it
     // should use next, and the total number of rows added.
@@ -30,14 +21,17 @@ namespace {
         //
         // We use the |firstInputRow| to compute the coordinates of all of the
         // following rows returned by Advance().
+        //
+        // The rows live in |storage|, which must hold
+        // destRowPixelWidth * 4 * maxYFilterSize bytes.
         CircularRowBuffer(int destRowPixelWidth, int maxYFilterSize,
-                          int firstInputRow)
-            : fRowByteWidth(destRowPixelWidth * 4),
+                          int firstInputRow, unsigned char* storage)
+            : fBuffer(storage),
+              fRowByteWidth(destRowPixelWidth * 4),
               fNumRows(maxYFilterSize),
               fNextRow(0),
-              fNextRowCoordinate(firstInputRow) {
-            fBuffer.reset(fRowByteWidth * maxYFilterSize);
-            fRowAddresses.reset(fNumRows);
+              fNextRowCoordinate(firstInputRow),
+              fRowAddresses(fNumRows) {
         }
 
         // Moves to the next row in the buffer, returning a pointer to the beginning
@@ -88,7 +82,7 @@ namespace {
 
     private:
         // The buffer storing the rows. They are packed, each one fRowByteWidth.
-        SkTArray<unsigned char> fBuffer;
+        unsigned char* fBuffer;
 
         // Number of bytes per row in the |buffer|.
         int fRowByteWidth;
@@ -105,169 +99,107 @@ namespace {
         int fNextRowCoordinate;
 
         // Buffer used by GetRowAddresses().
-        SkTArray<unsigned char*> fRowAddresses;
+        SkAutoSTMalloc<32, unsigned char*> fRowAddresses;
     };
 
-// Convolves horizontally along a single row. The row data is given in
-// |srcData| and continues for the numValues() of the filter.
-template<bool hasAlpha>
-    void ConvolveHorizontally(const unsigned char* srcData,
-                              const SkConvolutionFilter1D& filter,
-                              unsigned char* outRow) {
-        // Loop over each pixel on this row in the output image.
-        int numValues = filter.numValues();
-        for (int outX = 0; outX < numValues; outX++) {
-            // Get the filter that determines the current output pixel.
-            int filterOffset, filterLength;
-            const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
-                filter.FilterForValue(outX, &filterOffset, &filterLength);
-
-            // Compute the first pixel in this row that the filter affects. It will
-            // touch |filterLength| pixels (4 bytes each) after this.
-            const unsigned char* rowToFilter = &srcData[filterOffset * 4];
-
-            // Apply the filter to the row to get the destination pixel in |accum|.
-            int accum[4] = {0};
-            for (int filterX = 0; filterX < filterLength; filterX++) {
-                SkConvolutionFilter1D::ConvolutionFixed curFilter = filterValues[filterX];
-                accum[0] += curFilter * rowToFilter[filterX * 4 + 0];
-                accum[1] += curFilter * rowToFilter[filterX * 4 + 1];
-                accum[2] += curFilter * rowToFilter[filterX * 4 + 2];
-                if (hasAlpha) {
-                    accum[3] += curFilter * rowToFilter[filterX * 4 + 3];
-                }
-            }
+    // Each thread keeps its row buffer from one convolution to the next, so
+    // repeated resizes don't reallocate it.  Buffers bigger than this are
+    // freed when they're done instead.
+    const size_t kMaxCachedRowBufferBytes = 1 << 20;
 
-            // Bring this value back in range. All of the filter scaling factors
-            // are in fixed point with kShiftBits bits of fractional part.
-            accum[0] >>= SkConvolutionFilter1D::kShiftBits;
-            accum[1] >>= SkConvolutionFilter1D::kShiftBits;
-            accum[2] >>= SkConvolutionFilter1D::kShiftBits;
-            if (hasAlpha) {
-                accum[3] >>= SkConvolutionFilter1D::kShiftBits;
-            }
+    struct RowBufferStorage {
+        SkAutoTMalloc<unsigned char> fStorage;
+        size_t                       fSize = 0;
+    };
 
-            // Store the new pixel.
-            outRow[outX * 4 + 0] = ClampTo8(accum[0]);
-            outRow[outX * 4 + 1] = ClampTo8(accum[1]);
-            outRow[outX * 4 + 2] = ClampTo8(accum[2]);
-            if (hasAlpha) {
-                outRow[outX * 4 + 3] = ClampTo8(accum[3]);
+    void* create_row_buffer_storage() { return new RowBufferStorage; }
+    void delete_row_buffer_storage(void* p) { delete (RowBufferStorage*)p; }
+
+    // Convolves output rows [firstOutputRow, endOutputRow), horizontally
+    // convolving just the input rows those need into its own row buffer.
+    void ConvolveRows(const unsigned char* sourceData,
+                      int sourceByteRowStride,
+                      bool sourceHasAlpha,
+                      const SkConvolutionFilter1D& filterX,
+                      const SkConvolutionFilter1D& filterY,
+                      int outputByteRowStride,
+                      unsigned char* output,
+                      int rowBufferWidth,
+                      int rowBufferHeight,
+                      int firstOutputRow,
+                      int endOutputRow) {
+        const size_t storageSize = (size_t)rowBufferWidth * 4 * rowBufferHeight;
+        SkAutoTMalloc<unsigned char> uncachedStorage;
+        unsigned char* storage;
+        if (storageSize <= kMaxCachedRowBufferBytes) {
+            RowBufferStorage* cached = (RowBufferStorage*)SkTLS::Get(create_row_buffer_storage,
+                                                                     delete_row_buffer_storage);
+            if (cached->fSize < storageSize) {
+                cached->fStorage.reset(storageSize);
+                cached->fSize = storageSize;
             }
+            storage = cached->fStorage.get();
+        } else {
+            storage = uncachedStorage.reset(storageSize);
         }
-    }
 
-    // There's a bug somewhere here with GCC autovectorization (-ftree-vectorize).  We originally
-    // thought this was 32 bit only, but subsequent tests show that some 64 bit gcc compiles
-    // suffer here too.
-    //
-    // Dropping to -O2 disables -ftree-vectorize.  GCC 4.6 needs noinline.  https://bug.skia.org/2575
-    #if SK_HAS_ATTRIBUTE(optimize) && defined(SK_RELEASE)
-        #define SK_MAYBE_DISABLE_VECTORIZATION __attribute__((optimize("O2"), noinline))
-    #else
-        #define SK_MAYBE_DISABLE_VECTORIZATION
-    #endif
-
-    SK_MAYBE_DISABLE_VECTORIZATION
-    static void ConvolveHorizontallyAlpha(const unsigned char* srcData,
-                                          const SkConvolutionFilter1D& filter,
-                                          unsigned char* outRow) {
-        return ConvolveHorizontally<true>(srcData, filter, outRow);
-    }
-
-    SK_MAYBE_DISABLE_VECTORIZATION
-    static void ConvolveHorizontallyNoAlpha(const unsigned char* srcData,
-                                            const SkConvolutionFilter1D& filter,
-                                            unsigned char* outRow) {
-        return ConvolveHorizontally<false>(srcData, filter, outRow);
-    }
-
-    #undef SK_MAYBE_DISABLE_VECTORIZATION
-
-
-// Does vertical convolution to produce one output row. The filter values and
-// length are given in the first two parameters. These are applied to each
-// of the rows pointed to in the |sourceDataRows| array, with each row
-// being |pixelWidth| wide.
-//
-// The output must have room for |pixelWidth * 4| bytes.
-template<bool hasAlpha>
-    void ConvolveVertically(const SkConvolutionFilter1D::ConvolutionFixed* filterValues,
-                            int filterLength,
-                            unsigned char* const* sourceDataRows,
-                            int pixelWidth,
-                            unsigned char* outRow) {
-        // We go through each column in the output and do a vertical convolution,
-        // generating one output pixel each time.
-        for (int outX = 0; outX < pixelWidth; outX++) {
-            // Compute the number of bytes over in each row that the current column
-            // we're convolving starts at. The pixel will cover the next 4 bytes.
-            int byteOffset = outX * 4;
-
-            // Apply the filter to one column of pixels.
-            int accum[4] = {0};
-            for (int filterY = 0; filterY < filterLength; filterY++) {
-                SkConvolutionFilter1D::ConvolutionFixed curFilter = filterValues[filterY];
-                accum[0] += curFilter * sourceDataRows[filterY][byteOffset + 0];
-                accum[1] += curFilter * sourceDataRows[filterY][byteOffset + 1];
-                accum[2] += curFilter * sourceDataRows[filterY][byteOffset + 2];
-                if (hasAlpha) {
-                    accum[3] += curFilter * sourceDataRows[filterY][byteOffset + 3];
+        // The next row in the input that we will generate a horizontally
+        // convolved row for. If the filter doesn't start at the beginning of the
+        // image (this is the case when we are only resizing a subset), then we
+        // don't want to generate any output rows before that. Compute the starting
+        // row for convolution as the first pixel for the first vertical filter.
+        int filterOffset, filterLength;
+        const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
+            filterY.FilterForValue(firstOutputRow, &filterOffset, &filterLength);
+        int nextXRow = filterOffset;
+
+        CircularRowBuffer rowBuffer(rowBufferWidth, rowBufferHeight, filterOffset, storage);
+
+        // Rows past the last one our last filter needs aren't worth generating,
+        // and may not exist.
+        int lastFilterOffset, lastFilterLength;
+        filterY.FilterForValue(endOutputRow - 1, &lastFilterOffset, &lastFilterLength);
+        const int endXRow = lastFilterOffset + lastFilterLength;
+
+        for (int outY = firstOutputRow; outY < endOutputRow; outY++) {
+            filterValues = filterY.FilterForValue(outY, &filterOffset, &filterLength);
+
+            // Generate output rows until we have enough to run the current filter.
+            while (nextXRow < filterOffset + filterLength) {
+                if (nextXRow + 4 <= endXRow) {
+                    const unsigned char* src[4];
+                    unsigned char* outRow[4];
+                    for (int i = 0; i < 4; ++i) {
+                        src[i] = &sourceData[(uint64_t)(nextXRow + i) * sourceByteRowStride];
+                        outRow[i] = rowBuffer.advanceRow();
+                    }
+                    SkOpts::convolve_4_rows_horizontally(src, filterX, outRow, 4*rowBufferWidth);
+                    nextXRow += 4;
+                } else {
+                    SkOpts::convolve_horizontally(
+                        &sourceData[(uint64_t)nextXRow * sourceByteRowStride],
+                        filterX, rowBuffer.advanceRow(), sourceHasAlpha);
+                    nextXRow++;
                 }
             }
 
-            // Bring this value back in range. All of the filter scaling factors
-            // are in fixed point with kShiftBits bits of precision.
-            accum[0] >>= SkConvolutionFilter1D::kShiftBits;
-            accum[1] >>= SkConvolutionFilter1D::kShiftBits;
-            accum[2] >>= SkConvolutionFilter1D::kShiftBits;
-            if (hasAlpha) {
-                accum[3] >>= SkConvolutionFilter1D::kShiftBits;
-            }
+            // Compute where in the output image this row of final data will go.
+            unsigned char* curOutputRow = &output[(uint64_t)outY * outputByteRowStride];
 
-            // Store the new pixel.
-            outRow[byteOffset + 0] = ClampTo8(accum[0]);
-            outRow[byteOffset + 1] = ClampTo8(accum[1]);
-            outRow[byteOffset + 2] = ClampTo8(accum[2]);
-            if (hasAlpha) {
-                unsigned char alpha = ClampTo8(accum[3]);
-
-                // Make sure the alpha channel doesn't come out smaller than any of the
-                // color channels. We use premultipled alpha channels, so this should
-                // never happen, but rounding errors will cause this from time to time.
-                // These "impossible" colors will cause overflows (and hence random pixel
-                // values) when the resulting bitmap is drawn to the screen.
-                //
-                // We only need to do this when generating the final output row (here).
-                int maxColorChannel = SkTMax(outRow[byteOffset + 0],
-                                               SkTMax(outRow[byteOffset + 1],
-                                                      outRow[byteOffset + 2]));
-                if (alpha < maxColorChannel) {
-                    outRow[byteOffset + 3] = maxColorChannel;
-                } else {
-                    outRow[byteOffset + 3] = alpha;
-                }
-            } else {
-                // No alpha channel, the image is opaque.
-                outRow[byteOffset + 3] = 0xff;
-            }
-        }
-    }
+            // Get the list of rows that the circular buffer has, in order.
+            int firstRowInCircularBuffer;
+            unsigned char* const* rowsToConvolve =
+                rowBuffer.GetRowAddresses(&firstRowInCircularBuffer);
 
-    void ConvolveVertically(const SkConvolutionFilter1D::ConvolutionFixed* filterValues,
-                            int filterLength,
-                            unsigned char* const* sourceDataRows,
-                            int pixelWidth,
-                            unsigned char* outRow,
-                            bool sourceHasAlpha) {
-        if (sourceHasAlpha) {
-            ConvolveVertically<true>(filterValues, filterLength,
-                                     sourceDataRows, pixelWidth,
-                                     outRow);
-        } else {
-            ConvolveVertically<false>(filterValues, filterLength,
-                                      sourceDataRows, pixelWidth,
-                                      outRow);
+            // Now compute the start of the subset of those rows that the filter
+            // needs.
+            unsigned char* const* firstRowForFilter =
+                &rowsToConvolve[filterOffset - firstRowInCircularBuffer];
+
+            SkOpts::convolve_vertically(filterValues, filterLength,
+                                        firstRowForFilter,
+                                        filterX.numValues(), curOutputRow,
+                                        sourceHasAlpha);
         }
     }
 
@@ -346,22 +278,10 @@ bool BGRAConvolve2D(const unsigned char* sourceData,
                     const SkConvolutionFilter1D& filterX,
                     const SkConvolutionFilter1D& filterY,
                     int outputByteRowStride,
-                    unsigned char* output,
-                    const SkConvolutionProcs& convolveProcs,
-                    bool useSimdIfPossible) {
+                    unsigned char* output) {
 
     int maxYFilterSize = filterY.maxFilter();
 
-    // The next row in the input that we will generate a horizontally
-    // convolved row for. If the filter doesn't start at the beginning of the
-    // image (this is the case when we are only resizing a subset), then we
-    // don't want to generate any output rows before that. Compute the starting
-    // row for convolution as the first pixel for the first vertical filter.
-    int filterOffset, filterLength;
-    const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
-        filterY.FilterForValue(0, &filterOffset, &filterLength);
-    int nextXRow = filterOffset;
-
     // We loop over each row in the input doing a horizontal convolution. This
     // will result in a horizontally convolved image. We write the results into
     // a circular buffer of convolved rows and do vertical convolution as rows
@@ -370,11 +290,8 @@ bool BGRAConvolve2D(const unsigned char* sourceData,
     // We will need four extra rows to allow horizontal convolution could be done
     // simultaneously. We also pad each row in row buffer to be aligned-up to
     // 16 bytes.
-    // TODO(jiesun): We do not use aligned load from row buffer in vertical
-    // convolution pass yet. Somehow Windows does not like it.
     int rowBufferWidth = (filterX.numValues() + 15) & ~0xF;
-    int rowBufferHeight = maxYFilterSize +
-                          (convolveProcs.fConvolve4RowsHorizontally ? 4 : 0);
+    int rowBufferHeight = maxYFilterSize + 4;
 
     // check for too-big allocation requests : crbug.com/528628
     {
@@ -389,98 +306,30 @@ bool BGRAConvolve2D(const unsigned char* sourceData,
         }
     }
 
-    CircularRowBuffer rowBuffer(rowBufferWidth,
-                                rowBufferHeight,
-                                filterOffset);
-
-    // Loop over every possible output row, processing just enough horizontal
-    // convolutions to run each subsequent vertical convolution.
     SkASSERT(outputByteRowStride >= filterX.numValues() * 4);
     int numOutputRows = filterY.numValues();
 
-    // We need to check which is the last line to convolve before we advance 4
-    // lines in one iteration.
-    int lastFilterOffset, lastFilterLength;
-
-    // SSE2 can access up to 3 extra pixels past the end of the
-    // buffer. At the bottom of the image, we have to be careful
-    // not to access data past the end of the buffer. Normally
-    // we fall back to the C++ implementation for the last row.
-    // If the last row is less than 3 pixels wide, we may have to fall
-    // back to the C++ version for more rows. Compute how many
-    // rows we need to avoid the SSE implementation for here.
-    filterX.FilterForValue(filterX.numValues() - 1, &lastFilterOffset,
-                           &lastFilterLength);
-    int avoidSimdRows = 1 + convolveProcs.fExtraHorizontalReads /
-        (lastFilterOffset + lastFilterLength);
-
-    filterY.FilterForValue(numOutputRows - 1, &lastFilterOffset,
-                           &lastFilterLength);
-
-    for (int outY = 0; outY < numOutputRows; outY++) {
-        filterValues = filterY.FilterForValue(outY,
-                                              &filterOffset, &filterLength);
-
-        // Generate output rows until we have enough to run the current filter.
-        while (nextXRow < filterOffset + filterLength) {
-            if (convolveProcs.fConvolve4RowsHorizontally &&
-                nextXRow + 3 < lastFilterOffset + lastFilterLength -
-                avoidSimdRows) {
-                const unsigned char* src[4];
-                unsigned char* outRow[4];
-                for (int i = 0; i < 4; ++i) {
-                    src[i] = &sourceData[(uint64_t)(nextXRow + i) * sourceByteRowStride];
-                    outRow[i] = rowBuffer.advanceRow();
-                }
-                convolveProcs.fConvolve4RowsHorizontally(src, filterX, outRow, 4*rowBufferWidth);
-                nextXRow += 4;
-            } else {
-                // Check if we need to avoid SSE2 for this row.
-                if (convolveProcs.fConvolveHorizontally &&
-                    nextXRow < lastFilterOffset + lastFilterLength -
-                    avoidSimdRows) {
-                    convolveProcs.fConvolveHorizontally(
-                        &sourceData[(uint64_t)nextXRow * sourceByteRowStride],
-                        filterX, rowBuffer.advanceRow(), sourceHasAlpha);
-                } else {
-                    if (sourceHasAlpha) {
-                        ConvolveHorizontallyAlpha(
-                            &sourceData[(uint64_t)nextXRow * sourceByteRowStride],
-                            filterX, rowBuffer.advanceRow());
-                    } else {
-                        ConvolveHorizontallyNoAlpha(
-                            &sourceData[(uint64_t)nextXRow * sourceByteRowStride],
-                            filterX, rowBuffer.advanceRow());
-                    }
-                }
-                nextXRow++;
-            }
-        }
-
-        // Compute where in the output image this row of final data will go.
-        unsigned char* curOutputRow = &output[(uint64_t)outY * outputByteRowStride];
-
-        // Get the list of rows that the circular buffer has, in order.
-        int firstRowInCircularBuffer;
-        unsigned char* const* rowsToConvolve =
-            rowBuffer.GetRowAddresses(&firstRowInCircularBuffer);
-
-        // Now compute the start of the subset of those rows that the filter
-        // needs.
-        unsigned char* const* firstRowForFilter =
-            &rowsToConvolve[filterOffset - firstRowInCircularBuffer];
-
-        if (convolveProcs.fConvolveVertically) {
-            convolveProcs.fConvolveVertically(filterValues, filterLength,
-                                               firstRowForFilter,
-                                               filterX.numValues(), curOutputRow,
-                                               sourceHasAlpha);
-        } else {
-            ConvolveVertically(filterValues, filterLength,
-                               firstRowForFilter,
-                               filterX.numValues(), curOutputRow,
-                               sourceHasAlpha);
-        }
+    // Each band of output rows convolves the input rows it needs on its own, so
+    // bands overlap by about a vertical filter's worth of horizontal passes.
+    // Keep them big enough that this stays a small part of their work.
+    const int kMinBandRows = 64;
+    const int64_t kMinBandPixels = 256 * 1024;
+    const int64_t outputPixels = sk_64_mul(filterX.numValues(), numOutputRows);
+    const int bands = (int)SkTMin<int64_t>(SkTMin(sk_num_cores(), numOutputRows / kMinBandRows),
+                                           outputPixels / kMinBandPixels);
+
+    if (bands <= 1) {
+        ConvolveRows(sourceData, sourceByteRowStride, sourceHasAlpha, filterX, filterY,
+                     outputByteRowStride, output, rowBufferWidth, rowBufferHeight,
+                     0, numOutputRows);
+        return true;
     }
+
+    SkTaskGroup().batch(bands, [&](int band) {
+        ConvolveRows(sourceData, sourceByteRowStride, sourceHasAlpha, filterX, filterY,
+                     outputByteRowStride, output, rowBufferWidth, rowBufferHeight,
+                     (int)((int64_t)numOutputRows *  band      / bands),
+                     (int)((int64_t)numOutputRows * (band + 1) / bands));
+    });
     return true;
 }
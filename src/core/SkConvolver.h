@@ -105,12 +105,6 @@ public:
         int* filterOffset,
         int* filterLength) const;
 
-    // Add another value to the fFilterValues array -- useful for
-    // SIMD padding which happens outside of this class.
-
-    void addFilterValue( ConvolutionFixed val ) {
-        fFilterValues.push( val );
-    }
 private:
     struct FilterInstance {
         // Offset within filterValues for this instance of the filter.
@@ -157,20 +151,6 @@ typedef void (*SkConvolveHorizontally_pointer)(
     const SkConvolutionFilter1D& filter,
     unsigned char* outRow,
     bool hasAlpha);
-typedef void (*SkConvolveFilterPadding_pointer)(
-    SkConvolutionFilter1D* filter);
-
-struct SkConvolutionProcs {
-  // This is how many extra pixels may be read by the
-  // conolve*horizontally functions.
-    int fExtraHorizontalReads;
-    SkConvolveVertically_pointer fConvolveVertically;
-    SkConvolve4RowsHorizontally_pointer fConvolve4RowsHorizontally;
-    SkConvolveHorizontally_pointer fConvolveHorizontally;
-    SkConvolveFilterPadding_pointer fApplySIMDPadding;
-};
-
-
 
 // Does a two-dimensional convolution on the given source image.
 //
@@ -190,6 +170,9 @@ struct SkConvolutionProcs {
 //
 // The layout in memory is assumed to be 4-bytes per pixel in B-G-R-A order
 // (this is ARGB when loaded into 32-bit words on a little-endian machine).
+//
+// The passes run through SkOpts.  Large outputs are split into bands of rows
+// that convolve in parallel on SkTaskGroup's threads.
 /**
  *  Returns false if it was unable to perform the convolution/rescale. in which case the output
  *  buffer is assumed to be undefined.
@@ -200,8 +183,6 @@ SK_API bool BGRAConvolve2D(const unsigned char* sourceData,
     const SkConvolutionFilter1D& xfilter,
     const SkConvolutionFilter1D& yfilter,
     int outputByteRowStride,
-    unsigned char* output,
-    const SkConvolutionProcs&,
-    bool useSimdIfPossible);
+    unsigned char* output);
 
 #endif  // SK_CONVOLVER_H
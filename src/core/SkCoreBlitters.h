@@ -218,4 +218,12 @@ SkBlitter* SkBlitter_ChooseD565(const SkPixmap& device, const SkPaint& paint,
                                 SkShader::Context* shaderContext,
                                 SkTBlitterAllocator* allocator);
 
+/*  Returns a blitter that shades, applies coverage and blends in one pass, if the paint's
+    shader, xfermode and the device are a combination we have one for, or nullptr.  fallback
+    is the blitter otherwise chosen; it handles the calls the fused blitter does not.
+ */
+SkBlitter* SkBlitter_ChooseFused(const SkPixmap& device, const SkPaint& paint,
+                                 SkShader::Context* shaderContext, SkBlitter* fallback,
+                                 SkTBlitterAllocator* allocator);
+
 #endif
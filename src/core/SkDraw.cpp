@@ -12,15 +12,20 @@
 #include "SkColorPriv.h"
 #include "SkDevice.h"
 #include "SkDeviceLooper.h"
+#include "SkFillPathCache.h"
 #include "SkFindAndPlaceGlyph.h"
 #include "SkFixed.h"
+#include "SkImage.h"
 #include "SkMaskFilter.h"
 #include "SkMatrix.h"
+#include "SkNx.h"
 #include "SkPaint.h"
 #include "SkPathEffect.h"
+#include "SkQuadPathCache.h"
 #include "SkRasterClip.h"
 #include "SkRasterizer.h"
 #include "SkRRect.h"
+#include "SkRSXform.h"
 #include "SkScan.h"
 #include "SkShader.h"
 #include "SkSmallAllocator.h"
@@ -1122,8 +1127,14 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         if (this->computeConservativeLocalClipBounds(&cullRect)) {
             cullRectPtr = &cullRect;
         }
-        doFill = paint->getFillPath(*pathPtr, &tmpPath, cullRectPtr,
-                                    ComputeResScaleForStroking(*fMatrix));
+        const SkScalar resScale = ComputeResScaleForStroking(*fMatrix);
+        // Mutable paths are temporaries, never to be drawn again, so not worth caching.
+        if (pathIsMutable) {
+            doFill = paint->getFillPath(*pathPtr, &tmpPath, cullRectPtr, resScale);
+        } else {
+            doFill = SkFillPathCache::GetFillPath(*paint, *pathPtr, &tmpPath, cullRectPtr,
+                                                  resScale);
+        }
         pathPtr = &tmpPath;
     }
 
@@ -1138,6 +1149,15 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         return;
     }
 
+    // Fills of long-lived paths with conics can reuse the quads cut from them for a nearby
+    // scale. They are transformed in place below, leaving the cached copy alone.
+    if (doFill && pathPtr == &origSrcPath && fDevice &&
+            fDevice->surfaceProps().isCacheConicQuads() &&
+            SkQuadPathCache::GetQuadPath(*pathPtr, *matrix, &tmpPath)) {
+        pathPtr = &tmpPath;
+        pathIsMutable = true;
+    }
+
     // avoid possibly allocating a new path in transform if we can
     SkPath* devPathPtr = pathIsMutable ? pathPtr : &tmpPath;
 
@@ -1856,6 +1876,20 @@ void SkTriColorShader::toString(SkString* str) const {
 }
 #endif
 
+// Mirrors the early-out in SkScan::FillTriangle, so that triangles which won't touch a pixel
+// don't pay to set up their shader contexts first.
+static bool triangle_is_visible(const SkPoint tri[3], const SkIRect& clipBounds) {
+    // Track (minX, minY, -maxX, -maxY) so that one Min finds all four edges of the bounds.
+    Sk4s a(tri[0].fX, tri[0].fY, -tri[0].fX, -tri[0].fY),
+         b(tri[1].fX, tri[1].fY, -tri[1].fX, -tri[1].fY),
+         c(tri[2].fX, tri[2].fY, -tri[2].fX, -tri[2].fY);
+    Sk4s lo = Sk4s::Min(Sk4s::Min(a, b), c);
+
+    SkIRect ir;
+    SkRect::MakeLTRB(lo[0], lo[1], -lo[2], -lo[3]).round(&ir);
+    return !ir.isEmpty() && SkIRect::Intersects(ir, clipBounds);
+}
+
 void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
                           const SkPoint vertices[], const SkPoint textures[],
                           const SkColor colors[], SkXfermode* xmode,
@@ -1930,7 +1964,14 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
     VertState::Proc vertProc = state.chooseProc(vmode);
 
     if (textures || colors) {
+        const SkIRect& clipBounds = fRC->getBounds();
         while (vertProc(&state)) {
+            SkPoint tmp[] = {
+                devVerts[state.f0], devVerts[state.f1], devVerts[state.f2]
+            };
+            if (!triangle_is_visible(tmp, clipBounds)) {
+                continue;
+            }
             if (textures) {
                 SkMatrix tempM;
                 if (texture_to_matrix(state, vertices, textures, &tempM)) {
@@ -1967,9 +2008,6 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
                 }
             }
 
-            SkPoint tmp[] = {
-                devVerts[state.f0], devVerts[state.f1], devVerts[state.f2]
-            };
             SkScan::FillTriangle(tmp, *fRC, blitter.get());
         }
     } else {
@@ -1985,6 +2023,160 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
     }
 }
 
+// Supplies drawAtlas() with the current sprite's color. drawAtlas() changes the color between
+// sprites and then resets the blitter's shader context, which picks it up.
+class SkAtlasColorShader : public SkShader {
+public:
+    SkAtlasColorShader() : fPMColor(0) {}
+
+    void setColor(SkColor color) { fPMColor = SkPreMultiplyColor(color); }
+
+    size_t contextSize(const ContextRec&) const override { return sizeof(AtlasColorContext); }
+
+    class AtlasColorContext : public SkShader::Context {
+    public:
+        AtlasColorContext(const SkAtlasColorShader& shader, const ContextRec& rec)
+            : INHERITED(shader, rec)
+            , fPMColor(shader.fPMColor) {}
+
+        void shadeSpan(int x, int y, SkPMColor dstC[], int count) override {
+            sk_memset32(dstC, fPMColor, count);
+        }
+
+    private:
+        SkPMColor fPMColor;
+
+        typedef SkShader::Context INHERITED;
+    };
+
+    SK_TO_STRING_OVERRIDE()
+
+    // For serialization.  This will never be called.
+    Factory getFactory() const override { sk_throw(); return nullptr; }
+
+protected:
+    Context* onCreateContext(const ContextRec& rec, void* storage) const override {
+        return new (storage) AtlasColorContext(*this, rec);
+    }
+
+private:
+    SkPMColor fPMColor;
+
+    typedef SkShader INHERITED;
+};
+
+#ifndef SK_IGNORE_TO_STRING
+void SkAtlasColorShader::toString(SkString* str) const {
+    str->append("SkAtlasColorShader: (");
+
+    this->INHERITED::toString(str);
+
+    str->append(")");
+}
+#endif
+
+static bool quad_is_axis_aligned(const SkPoint q[4]) {
+    return (q[0].fY == q[1].fY && q[1].fX == q[2].fX && q[2].fY == q[3].fY && q[3].fX == q[0].fX) ||
+           (q[0].fX == q[1].fX && q[1].fY == q[2].fY && q[2].fX == q[3].fX && q[3].fY == q[0].fY);
+}
+
+void SkDraw::drawAtlas(const SkImage* atlas, const SkRSXform xform[], const SkRect tex[],
+                       const SkColor colors[], int count, SkXfermode::Mode mode,
+                       const SkPaint& paint) const {
+    SkASSERT(SkPaint::kFill_Style == paint.getStyle());
+    SkASSERT(!paint.getMaskFilter() && !paint.getPathEffect() && !paint.getRasterizer());
+
+    if (count <= 0 || fRC->isEmpty()) {
+        return;
+    }
+
+    // Map every sprite's quad into device space up front: the RSXforms four sprite corners at a
+    // time, then all of the corners through the matrix in one call.
+    SkAutoSTMalloc<64, SkPoint> storage(count * 4);
+    SkPoint* devQuads = storage.get();
+    for (int i = 0; i < count; ++i) {
+        const Sk4s w(0, tex[i].width(), tex[i].width(), 0),
+                   h(0, 0, tex[i].height(), tex[i].height());
+        const Sk4s scos(xform[i].fSCos),
+                   ssin(xform[i].fSSin);
+        const Sk4s x = Sk4s(xform[i].fTx) + scos * w - ssin * h,
+                   y = Sk4s(xform[i].fTy) + ssin * w + scos * h;
+        for (int k = 0; k < 4; ++k) {
+            devQuads[4*i + k].set(x[k], y[k]);
+        }
+    }
+    fMatrix->mapPoints(devQuads, count * 4);
+
+    // One atlas shader serves every sprite; each sprite passes its own local matrix when the
+    // blitter's shader context is reset.  Colors are blended with a compose shader, which
+    // matches drawing each sprite through a mode color filter (we're only called for opaque
+    // paints when there are colors).
+    SkAutoTUnref<SkShader> atlasShader(atlas->newShader(SkShader::kClamp_TileMode,
+                                                        SkShader::kClamp_TileMode));
+    if (!atlasShader) {
+        return;
+    }
+
+    SkAtlasColorShader colorShader;  // must be above declaration of p
+    SkPaint p(paint);
+    p.setShader(atlasShader);
+
+    SkAutoTUnref<SkComposeShader> composeShader;
+    if (colors) {
+        SkAutoTUnref<SkXfermode> xfer(SkXfermode::Create(mode));
+        composeShader.reset(new SkComposeShader(atlasShader, &colorShader, xfer));
+        p.setShader(composeShader);
+        p.setColorFilter(nullptr);
+    }
+
+    SkAutoBlitterChoose blitter(fDst, *fMatrix, p);
+    if (blitter->isNullBlitter()) {
+        return;
+    }
+
+    const SkShader::ContextRec::DstType dstType = SkBlitter::PreferredShaderDest(fDst.info());
+    const SkRect clipBounds = SkRect::Make(fRC->getBounds());
+    SkPath path;
+    path.setIsVolatile(true);
+
+    for (int i = 0; i < count; ++i) {
+        const SkPoint* quad = devQuads + 4*i;
+
+        SkRect bounds;
+        if (!bounds.setBoundsCheck(quad, 4) || !SkRect::Intersects(bounds, clipBounds)) {
+            continue;
+        }
+
+        SkMatrix localM;
+        localM.setRSXform(xform[i]);
+        localM.preTranslate(-tex[i].left(), -tex[i].top());
+        if (colors) {
+            colorShader.setColor(colors[i]);
+        }
+        SkShader::ContextRec rec(p, *fMatrix, &localM, dstType);
+        if (!blitter->resetShaderContext(rec)) {
+            continue;
+        }
+
+        if (quad_is_axis_aligned(quad)) {
+            if (paint.isAntiAlias()) {
+                SkScan::AntiFillRect(bounds, *fRC, blitter.get());
+            } else {
+                SkScan::FillRect(bounds, *fRC, blitter.get());
+            }
+        } else {
+            path.rewind();
+            path.addPoly(quad, 4, true);
+            path.setConvexity(SkPath::kConvex_Convexity);
+            if (paint.isAntiAlias()) {
+                SkScan::AntiFillPath(path, *fRC, blitter.get());
+            } else {
+                SkScan::FillPath(path, *fRC, blitter.get());
+            }
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -39,6 +39,8 @@ struct SkEdge {
     int setLine(const SkPoint& p0, const SkPoint& p1, const SkIRect* clip, int shiftUp);
     // call this version if you know you don't have a clip
     inline int setLine(const SkPoint& p0, const SkPoint& p1, int shiftUp);
+    // or this one, if you've also already converted the points to FDot6
+    inline int setLine(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1);
     inline int updateLine(SkFixed ax, SkFixed ay, SkFixed bx, SkFixed by);
     void chopLineWithClip(const SkIRect& clip);
 
@@ -101,7 +103,10 @@ int SkEdge::setLine(const SkPoint& p0, const SkPoint& p1, int shift) {
         y1 = int(p1.fY * scale);
 #endif
     }
+    return this->setLine(x0, y0, x1, y1);
+}
 
+int SkEdge::setLine(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1) {
     int winding = 1;
 
     if (y0 > y1) {
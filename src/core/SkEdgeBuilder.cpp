@@ -11,6 +11,7 @@
 #include "SkEdgeClipper.h"
 #include "SkLineClipper.h"
 #include "SkGeometry.h"
+#include "SkNx.h"
 
 template <typename T> static T* typedAllocThrow(SkChunkAlloc& alloc) {
     return static_cast<T*>(alloc.allocThrow(sizeof(T)));
@@ -135,6 +136,24 @@ static void setShiftedClip(SkRect* dst, const SkIRect& src, int shift) {
              SkIntToScalar(src.fBottom >> shift));
 }
 
+static const int kLineBatchCount = 64;
+
+// Converts count lines, each a pair of points, to FDot6 x0, y0, x1, y1 as SkEdge::setLine()
+// does, but a whole line at a time.
+static void lines_to_fdot6(const SkPoint lines[], int count, int shift, SkFDot6 dst[]) {
+#ifdef SK_RASTERIZE_EVEN_ROUNDING
+    for (int i = 0; i < 2 * count; i++) {
+        dst[2 * i + 0] = SkScalarRoundToFDot6(lines[i].fX, shift);
+        dst[2 * i + 1] = SkScalarRoundToFDot6(lines[i].fY, shift);
+    }
+#else
+    const Sk4f scale(float(1 << (shift + 6)));
+    for (int i = 0; i < count; i++) {
+        SkNx_cast<int>(Sk4f::Load(&lines[2 * i]) * scale).store(&dst[4 * i]);
+    }
+#endif
+}
+
 SkEdgeBuilder::Combine SkEdgeBuilder::checkVertical(const SkEdge* edge, SkEdge** edgePtr) {
     return !vertical_line(edge) || edgePtr <= fEdgeList ? kNo_Combine :
             CombineVertical(edge, edgePtr[-1]);
@@ -196,15 +215,33 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
             }
         }
     } else {
-        while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        // Gather a batch of lines at a time, to convert them to FDot6 together.
+        SkPoint lines[2 * kLineBatchCount];
+        SkFDot6 fdot6[4 * kLineBatchCount];
+        int lineCount = 0;
+        do {
+            verb = iter.next(pts, false);
             switch (verb) {
                 case SkPath::kMove_Verb:
                 case SkPath::kClose_Verb:
+                case SkPath::kDone_Verb:
                     // we ignore these, and just get the whole segment from
                     // the corresponding line/quad/cubic verbs
                     break;
                 case SkPath::kLine_Verb:
-                    if (edge->setLine(pts[0], pts[1], shiftUp)) {
+                    lines[2 * lineCount + 0] = pts[0];
+                    lines[2 * lineCount + 1] = pts[1];
+                    lineCount += 1;
+                    break;
+                default:
+                    SkDEBUGFAIL("unexpected verb");
+                    break;
+            }
+            if (lineCount == kLineBatchCount || (SkPath::kDone_Verb == verb && lineCount > 0)) {
+                lines_to_fdot6(lines, lineCount, shiftUp, fdot6);
+                for (int i = 0; i < lineCount; i++) {
+                    const SkFDot6* line = &fdot6[4 * i];
+                    if (edge->setLine(line[0], line[1], line[2], line[3])) {
                         Combine combine = checkVertical(edge, edgePtr);
                         if (kNo_Combine == combine) {
                             *edgePtr++ = edge++;
@@ -212,12 +249,10 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
                             --edgePtr;
                         }
                     }
-                    break;
-                default:
-                    SkDEBUGFAIL("unexpected verb");
-                    break;
+                }
+                lineCount = 0;
             }
-        }
+        } while (verb != SkPath::kDone_Verb);
     }
     SkASSERT((char*)edge <= (char*)fEdgeList);
     SkASSERT(edgePtr - fEdgeList <= maxEdgeCount);
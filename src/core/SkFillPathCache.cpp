@@ -0,0 +1,133 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkFillPathCache.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPathEffect.h"
+#include "SkStrokeRec.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+// Shorter paths stroke about as fast as they can be looked up.
+static const int kMinVerbCount = 8;
+// Longer dash patterns are rare enough not to be worth a bigger key.
+static const int kMaxDashIntervals = 8;
+
+struct FillPathValue {
+    SkPath  fPath;
+    bool    fFill;
+};
+
+namespace {
+static unsigned gFillPathKeyNamespaceLabel;
+
+struct FillPathKey : public SkResourceCache::Key {
+public:
+    FillPathKey(const SkPath& path, const SkStrokeRec& rec, SkScalar resScale,
+                const SkPathEffect::DashInfo& dash)
+        : fGenID(path.getGenerationID())
+        , fFillType(path.getFillType())
+        , fResScale(resScale)
+        , fWidth(rec.getWidth())
+        , fMiter(rec.getMiter())
+        , fCap(rec.getCap())
+        , fJoin(rec.getJoin())
+        , fStyle(rec.getStyle())
+        , fDashPhase(dash.fPhase)
+        , fDashCount(dash.fCount)
+    {
+        for (int i = 0; i < kMaxDashIntervals; ++i) {
+            fDashIntervals[i] = i < dash.fCount ? dash.fIntervals[i] : 0;
+        }
+        // Editing a path gives it a new gen ID, so entries for the old contents can never be
+        // hit again; they just age out of the LRU.  We don't purge them eagerly with a gen ID
+        // change listener, as adding one mutates an SkPathRef that other threads may be drawing.
+        this->init(&gFillPathKeyNamespaceLabel, 0,
+                   sizeof(fGenID) + sizeof(fFillType) + sizeof(fResScale) + sizeof(fWidth) +
+                   sizeof(fMiter) + sizeof(fCap) + sizeof(fJoin) + sizeof(fStyle) +
+                   sizeof(fDashPhase) + sizeof(fDashCount) + sizeof(fDashIntervals));
+    }
+
+    uint32_t fGenID;
+    int32_t  fFillType;
+    SkScalar fResScale;
+    SkScalar fWidth;
+    SkScalar fMiter;
+    int32_t  fCap;
+    int32_t  fJoin;
+    int32_t  fStyle;
+    SkScalar fDashPhase;
+    int32_t  fDashCount;
+    SkScalar fDashIntervals[kMaxDashIntervals];
+};
+
+struct FillPathRec : public SkResourceCache::Rec {
+    FillPathRec(const FillPathKey& key, const SkPath& path, bool fill)
+        : fKey(key)
+    {
+        fValue.fPath = path;
+        fValue.fFill = fill;
+    }
+
+    FillPathKey    fKey;
+    FillPathValue  fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fValue.fPath.countPoints() * sizeof(SkPoint)
+                             + fValue.fPath.countVerbs();
+    }
+    const char* getCategory() const override { return "fill-path"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const FillPathRec& rec = static_cast<const FillPathRec&>(baseRec);
+        FillPathValue* result = (FillPathValue*)contextData;
+
+        *result = rec.fValue;
+        return true;
+    }
+};
+} // namespace
+
+bool SkFillPathCache::GetFillPath(const SkPaint& paint, const SkPath& src, SkPath* dst,
+                                  const SkRect* cullRect, SkScalar resScale,
+                                  SkResourceCache* localCache) {
+    const SkPathEffect* effect = paint.getPathEffect();
+    const SkStrokeRec rec(paint, resScale);
+
+    // Hairlines and fills without an effect are returned as is, and the cull rect only
+    // changes how dashed lines come out, which are too short to cache anyway.
+    bool cacheable = !src.isVolatile() && src.countVerbs() >= kMinVerbCount &&
+                     (effect || !(rec.isFillStyle() || rec.isHairlineStyle()));
+
+    SkPathEffect::DashInfo dash;
+    SkScalar intervals[kMaxDashIntervals];
+    if (cacheable && effect) {
+        cacheable = SkPathEffect::kDash_DashType == effect->asADash(&dash) &&
+                    dash.fCount <= kMaxDashIntervals;
+        if (cacheable) {
+            dash.fIntervals = intervals;
+            effect->asADash(&dash);
+        }
+    }
+    if (!cacheable) {
+        return paint.getFillPath(src, dst, cullRect, resScale);
+    }
+
+    FillPathKey key(src, rec, resScale, dash);
+    FillPathValue result;
+    if (CHECK_LOCAL(localCache, find, Find, key, FillPathRec::Visitor, &result)) {
+        *dst = result.fPath;
+        return result.fFill;
+    }
+
+    const bool fill = paint.getFillPath(src, dst, cullRect, resScale);
+    CHECK_LOCAL(localCache, add, Add, new FillPathRec(key, *dst, fill));
+    return fill;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFillPathCache_DEFINED
+#define SkFillPathCache_DEFINED
+
+#include "SkResourceCache.h"
+
+class SkPaint;
+class SkPath;
+struct SkRect;
+
+class SkFillPathCache {
+public:
+    /**
+     *  Same as paint.getFillPath(src, dst, cullRect, resScale), but for paths that are drawn
+     *  again and again (not volatile, and long enough that stroking them costs more than a
+     *  lookup) with a plain stroke and/or a dash, the result is kept in the resource cache,
+     *  keyed by the path's generation ID and the stroke and dash parameters.
+     */
+    static bool GetFillPath(const SkPaint& paint, const SkPath& src, SkPath* dst,
+                            const SkRect* cullRect, SkScalar resScale,
+                            SkResourceCache* localCache = nullptr);
+};
+
+#endif
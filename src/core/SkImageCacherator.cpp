@@ -94,8 +94,21 @@ bool SkImageCacherator::generateBitmap(SkBitmap* bitmap) {
         // fast-case, no copy needed
         return generator->tryGenerateBitmap(bitmap, fInfo, allocator);
     } else {
-        // need to handle subsetting, so we first generate the full size version, and then
-        // "read" from it to get our subset. See https://bug.skia.org/4213
+        // need to handle subsetting. Generators that can produce a subset directly (e.g. block
+        // compressed textures) only generate what we need.
+        if (generator->canGenerateScaledPixels() && kIndex_8_SkColorType != fInfo.colorType()) {
+            if (bitmap->setInfo(fInfo) && bitmap->tryAllocPixels(allocator, nullptr)) {
+                SkPixmap pmap;
+                if (bitmap->peekPixels(&pmap) &&
+                    generator->generateScaledPixels(genInfo.dimensions(), fOrigin, pmap)) {
+                    return true;
+                }
+            }
+            bitmap->reset();
+        }
+
+        // Otherwise we first generate the full size version, and then "read" from it to get
+        // our subset. See https://bug.skia.org/4213
 
         SkBitmap full;
         if (!generator->tryGenerateBitmap(&full, genInfo, allocator)) {
@@ -113,9 +126,12 @@ bool SkImageCacherator::directGeneratePixels(const SkImageInfo& info, void* pixe
                                              int srcX, int srcY) {
     ScopedGenerator generator(this);
     const SkImageInfo& genInfo = generator->getInfo();
-    // Currently generators do not natively handle subsets, so check that first.
     if (srcX || srcY || genInfo.width() != info.width() || genInfo.height() != info.height()) {
-        return false;
+        // Most generators do not natively handle subsets, but some can through
+        // generateScaledPixels() at full size.
+        const SkIPoint origin = SkIPoint::Make(fOrigin.x() + srcX, fOrigin.y() + srcY);
+        return generator->generateScaledPixels(genInfo.dimensions(), origin,
+                                               SkPixmap(info, pixels, rb));
     }
     return generator->getPixels(info, pixels, rb);
 }
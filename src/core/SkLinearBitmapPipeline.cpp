@@ -12,6 +12,9 @@
 #include <cmath>
 #include <limits>
 #include "SkColor.h"
+#include "SkColorTable.h"
+#include "SkHalf.h"
+#include "SkPM4fPriv.h"
 #include "SkSize.h"
 
 // Tweak ABI of functions that pass Sk4f by value to pass them via registers.
@@ -46,7 +49,9 @@ public:
 class SkLinearBitmapPipeline::BilerpProcessorInterface
     : public SkLinearBitmapPipeline::PointProcessorInterface {
 public:
-    // The x's and y's are setup in the following order:
+    // A filtered pixel is a weighted sum of source pixels, which come through here four at a
+    // time, as pixel centers. The weights are worked out before tiling, since tiling moves the
+    // points around. Bilerp sends one list per destination pixel:
     // +--------+--------+
     // |        |        |
     // |  px00  |  px10  |
@@ -56,9 +61,9 @@ public:
     // |  px01  |  px11  |
     // |    2   |    3   |
     // +--------+--------+
-    // These pixels coordinates are arranged in the following order in xs and ys:
-    // px00  px10  px01  px11
-    virtual void VECTORCALL bilerpList(Sk4f xs, Sk4f ys) = 0;
+    // Bicubic sends four, one for each row of the 4x4 neighborhood. The sampler places the
+    // pixel when it gets the last list.
+    virtual void VECTORCALL filterList(Sk4f xs, Sk4f ys, Sk4f weights, bool last) = 0;
 };
 
 class SkLinearBitmapPipeline::PixelPlacerInterface {
@@ -94,7 +99,10 @@ private:
 template <typename Stage>
 void span_fallback(SkPoint start, SkScalar length, int count, Stage* stage) {
     // If count == 1 use PointListFew instead.
-    SkASSERT(count > 1);
+    if (count == 1) {
+        stage->pointListFew(1, Sk4f{X(start)}, Sk4f{Y(start)});
+        return;
+    }
 
     float dx = length / (count - 1);
     Sk4f Xs = Sk4f(X(start)) + Sk4f{0.0f, 1.0f, 2.0f, 3.0f} * Sk4f{dx};
@@ -172,9 +180,9 @@ public:
         fNext->pointList4(xs, ys);
     }
 
-    void VECTORCALL bilerpList(Sk4f xs, Sk4f ys) override {
+    void VECTORCALL filterList(Sk4f xs, Sk4f ys, Sk4f weights, bool last) override {
         fStrategy.processPoints(&xs, &ys);
-        fNext->bilerpList(xs, ys);
+        fNext->filterList(xs, ys, weights, last);
     }
 
     void pointSpan(SkPoint start, SkScalar length, int count) override {
@@ -195,7 +203,7 @@ class SkippedStage final : public SkLinearBitmapPipeline::BilerpProcessorInterfa
     void VECTORCALL pointList4(Sk4f xs, Sk4f ys) override {
         SkFAIL("Skipped stage.");
     }
-    void VECTORCALL bilerpList(Sk4f xs, Sk4f ys) override {
+    void VECTORCALL filterList(Sk4f xs, Sk4f ys, Sk4f weights, bool last) override {
         SkFAIL("Skipped stage.");
     }
     void pointSpan(SkPoint start, SkScalar length, int count) override {
@@ -279,12 +287,49 @@ private:
 template <typename Next = SkLinearBitmapPipeline::PointProcessorInterface>
 using AffineMatrix = PointProcessor<AffineMatrixStrategy, Next>;
 
+class PerspectiveMatrixStrategy {
+public:
+    PerspectiveMatrixStrategy(SkVector offset, SkVector scale, SkVector skew,
+                              SkVector zSkew, SkScalar zOffset)
+        : fXOffset{X(offset)}, fYOffset{Y(offset)}, fZOffset{zOffset}
+        , fXScale{X(scale)},   fYScale{Y(scale)}
+        , fXSkew{X(skew)},     fYSkew{Y(skew)}
+        , fZXSkew{X(zSkew)},   fZYSkew{Y(zSkew)} { }
+    void processPoints(Sk4f* xs, Sk4f* ys) {
+        Sk4f newXs = fXScale * *xs +  fXSkew * *ys + fXOffset;
+        Sk4f newYs =  fYSkew * *xs + fYScale * *ys + fYOffset;
+        Sk4f newZs = fZXSkew * *xs + fZYSkew * *ys + fZOffset;
+
+        *xs = newXs / newZs;
+        *ys = newYs / newZs;
+    }
+
+    template <typename Next>
+    bool maybeProcessSpan(SkPoint start, SkScalar length, int count, Next* next) {
+        return false;
+    }
+
+private:
+    const Sk4f fXOffset, fYOffset, fZOffset;
+    const Sk4f fXScale,  fYScale;
+    const Sk4f fXSkew,   fYSkew;
+    const Sk4f fZXSkew,  fZYSkew;
+};
+template <typename Next = SkLinearBitmapPipeline::PointProcessorInterface>
+using PerspectiveMatrix = PointProcessor<PerspectiveMatrixStrategy, Next>;
+
 static SkLinearBitmapPipeline::PointProcessorInterface* choose_matrix(
     SkLinearBitmapPipeline::PointProcessorInterface* next,
     const SkMatrix& inverse,
     SkLinearBitmapPipeline::MatrixStage* matrixProc) {
     if (inverse.hasPerspective()) {
-        SkFAIL("Not implemented.");
+        matrixProc->Initialize<PerspectiveMatrix<>>(
+            next,
+            SkVector{inverse.getTranslateX(), inverse.getTranslateY()},
+            SkVector{inverse.getScaleX(), inverse.getScaleY()},
+            SkVector{inverse.getSkewX(), inverse.getSkewY()},
+            SkVector{inverse.getPerspX(), inverse.getPerspY()},
+            inverse.get(SkMatrix::kMPersp2));
     } else if (inverse.getSkewX() != 0.0f || inverse.getSkewY() != 0.0f) {
         matrixProc->Initialize<AffineMatrix<>>(
             next,
@@ -314,22 +359,16 @@ public:
 
     void VECTORCALL pointListFew(int n, Sk4f xs, Sk4f ys) override {
         SkASSERT(0 < n && n < 4);
-        //                    px00   px10   px01  px11
-        const Sk4f kXOffsets{-0.5f,  0.5f, -0.5f, 0.5f},
-                   kYOffsets{-0.5f, -0.5f,  0.5f, 0.5f};
-        if (n >= 1) fNext->bilerpList(Sk4f{xs[0]} + kXOffsets, Sk4f{ys[0]} + kYOffsets);
-        if (n >= 2) fNext->bilerpList(Sk4f{xs[1]} + kXOffsets, Sk4f{ys[1]} + kYOffsets);
-        if (n >= 3) fNext->bilerpList(Sk4f{xs[2]} + kXOffsets, Sk4f{ys[2]} + kYOffsets);
+        if (n >= 1) this->bilerpPoint(xs[0], ys[0]);
+        if (n >= 2) this->bilerpPoint(xs[1], ys[1]);
+        if (n >= 3) this->bilerpPoint(xs[2], ys[2]);
     }
 
     void VECTORCALL pointList4(Sk4f xs, Sk4f ys) override {
-        //                    px00   px10   px01  px11
-        const Sk4f kXOffsets{-0.5f,  0.5f, -0.5f, 0.5f},
-                   kYOffsets{-0.5f, -0.5f,  0.5f, 0.5f};
-        fNext->bilerpList(Sk4f{xs[0]} + kXOffsets, Sk4f{ys[0]} + kYOffsets);
-        fNext->bilerpList(Sk4f{xs[1]} + kXOffsets, Sk4f{ys[1]} + kYOffsets);
-        fNext->bilerpList(Sk4f{xs[2]} + kXOffsets, Sk4f{ys[2]} + kYOffsets);
-        fNext->bilerpList(Sk4f{xs[3]} + kXOffsets, Sk4f{ys[3]} + kYOffsets);
+        this->bilerpPoint(xs[0], ys[0]);
+        this->bilerpPoint(xs[1], ys[1]);
+        this->bilerpPoint(xs[2], ys[2]);
+        this->bilerpPoint(xs[3], ys[3]);
     }
 
     void pointSpan(SkPoint start, SkScalar length, int count) override {
@@ -337,6 +376,83 @@ public:
     }
 
 private:
+    // Explaination of the math:
+    //              1 - x      x
+    //           +--------+--------+
+    //           |        |        |
+    //  1 - y    |  px00  |  px10  |
+    //           |        |        |
+    //           +--------+--------+
+    //           |        |        |
+    //    y      |  px01  |  px11  |
+    //           |        |        |
+    //           +--------+--------+
+    //
+    // where x and y are the fractional parts of the point relative to the center of px00.
+    void bilerpPoint(float x, float y) {
+        x -= 0.5f;
+        y -= 0.5f;
+        const float x0 = std::floor(x), y0 = std::floor(y);
+        const float fx = x - x0, fy = y - y0;
+        //                             px00     px10      px01     px11
+        const Sk4f xs = Sk4f{x0} + Sk4f{0.5f,    1.5f,    0.5f,    1.5f},
+                   ys = Sk4f{y0} + Sk4f{0.5f,    0.5f,    1.5f,    1.5f};
+        const Sk4f weights =       Sk4f{1 - fx,  fx,      1 - fx,  fx}
+                                 * Sk4f{1 - fy,  1 - fy,  fy,      fy};
+        fNext->filterList(xs, ys, weights, true);
+    }
+
+    Next* const fNext;
+};
+
+// Mitchell-Netravali filter with B = C = 1/3, the same as SkBitmapProcState's bicubic, for
+// the distances {1 + t, t, 1 - t, 2 - t} of a point from its four neighbors.
+static Sk4f VECTORCALL bicubic_weights(float t) {
+    const Sk4f d  = Sk4f{1 + t, t, 1 - t, 2 - t},
+               d2 = d * d,
+               d3 = d2 * d;
+    const Sk4f near = (Sk4f{21} * d3 - Sk4f{36} * d2 + Sk4f{16}) * Sk4f{1.0f / 18},
+               far  = (Sk4f{-7} * d3 + Sk4f{36} * d2 - Sk4f{60} * d + Sk4f{32}) * Sk4f{1.0f / 18};
+    return far + (near - far) * Sk4f{0, 1, 1, 0};
+}
+
+template <typename Next = SkLinearBitmapPipeline::BilerpProcessorInterface>
+class ExpandBicubic final : public SkLinearBitmapPipeline::PointProcessorInterface {
+public:
+    ExpandBicubic(Next* next) : fNext{next} { }
+
+    void VECTORCALL pointListFew(int n, Sk4f xs, Sk4f ys) override {
+        SkASSERT(0 < n && n < 4);
+        if (n >= 1) this->bicubicPoint(xs[0], ys[0]);
+        if (n >= 2) this->bicubicPoint(xs[1], ys[1]);
+        if (n >= 3) this->bicubicPoint(xs[2], ys[2]);
+    }
+
+    void VECTORCALL pointList4(Sk4f xs, Sk4f ys) override {
+        this->bicubicPoint(xs[0], ys[0]);
+        this->bicubicPoint(xs[1], ys[1]);
+        this->bicubicPoint(xs[2], ys[2]);
+        this->bicubicPoint(xs[3], ys[3]);
+    }
+
+    void pointSpan(SkPoint start, SkScalar length, int count) override {
+        span_fallback(start, length, count, this);
+    }
+
+private:
+    void bicubicPoint(float x, float y) {
+        x -= 0.5f;
+        y -= 0.5f;
+        const float x0 = std::floor(x), y0 = std::floor(y);
+        const Sk4f xs = Sk4f{x0} + Sk4f{-0.5f, 0.5f, 1.5f, 2.5f};
+        const Sk4f xWeights = bicubic_weights(x - x0),
+                   yWeights = bicubic_weights(y - y0);
+        fNext->filterList(xs, Sk4f{y0 - 0.5f}, xWeights * Sk4f{yWeights[0]}, false);
+        fNext->filterList(xs, Sk4f{y0 + 0.5f}, xWeights * Sk4f{yWeights[1]}, false);
+        fNext->filterList(xs, Sk4f{y0 + 1.5f}, xWeights * Sk4f{yWeights[2]}, false);
+        fNext->filterList(xs, Sk4f{y0 + 2.5f}, xWeights * Sk4f{yWeights[3]}, true);
+    }
+
     Next* const fNext;
 };
 
@@ -344,15 +460,23 @@ static SkLinearBitmapPipeline::PointProcessorInterface* choose_filter(
     SkLinearBitmapPipeline::BilerpProcessorInterface* next,
     SkFilterQuality filterQuailty,
     SkLinearBitmapPipeline::FilterStage* filterProc) {
-    if (SkFilterQuality::kNone_SkFilterQuality == filterQuailty) {
-        filterProc->Initialize<SkippedStage>();
-        return next;
-    } else {
-        filterProc->Initialize<ExpandBilerp<>>(next);
-        return filterProc->get();
+    switch (filterQuailty) {
+        case kNone_SkFilterQuality:
+            filterProc->Initialize<SkippedStage>();
+            return next;
+        case kHigh_SkFilterQuality:
+            filterProc->Initialize<ExpandBicubic<>>(next);
+            break;
+        default:
+            // Medium is bilerp from a mipmap level, which the caller has already picked.
+            filterProc->Initialize<ExpandBilerp<>>(next);
+            break;
     }
+    return filterProc->get();
 }
 
+// The tilers only have to leave each point somewhere in the pixel it should sample, since any
+// filtering has already been worked out. So they all end with the point in [0, max - 1].
 class ClampStrategy {
 public:
     ClampStrategy(X max)
@@ -372,9 +496,42 @@ public:
         *ys = Sk4f::Min(Sk4f::Max(*ys, fYMin), fYMax);
     }
 
+    // Splits the span into the part left of the bitmap, which is all the left edge, the part
+    // over it, and the part right of it, which is all the right edge.
     template <typename Next>
     bool maybeProcessSpan(SkPoint start, SkScalar length, int count, Next* next) {
-        return false;
+        const SkScalar y = SkTMin(SkTMax((float) Y(start), fYMin[0]), fYMax[0]);
+        SkScalar x = X(start);
+        const SkScalar xMin = fXMin[0], xMax = fXMax[0];
+        if (xMax == SK_FloatInfinity) {
+            next->pointSpan(SkPoint{x, y}, length, count);
+            return true;
+        }
+        if (count == 1 || length == 0.0f) {
+            next->pointSpan(SkPoint{SkTMin(SkTMax(x, xMin), xMax), y}, 0.0f, count);
+            return true;
+        }
+
+        const SkScalar dx = length / (count - 1);
+        if (dx < 0.0f) {
+            return false;
+        }
+        if (x < xMin) {
+            const int n = SkTMin(count, (int) std::ceil((xMin - x) / dx));
+            next->pointSpan(SkPoint{xMin, y}, 0.0f, n);
+            x += n * dx;
+            count -= n;
+        }
+        if (count > 0 && x <= xMax) {
+            const int n = SkTMin(count, (int) std::floor((xMax - x) / dx) + 1);
+            next->pointSpan(SkPoint{x, y}, (n - 1) * dx, n);
+            x += n * dx;
+            count -= n;
+        }
+        if (count > 0) {
+            next->pointSpan(SkPoint{xMax, y}, 0.0f, count);
+        }
+        return true;
     }
 
 private:
@@ -388,38 +545,133 @@ using Clamp = BilerpProcessor<ClampStrategy, Next>;
 
 class RepeatStrategy {
 public:
-    RepeatStrategy(X max) : fXMax{max}, fXInvMax{1.0f/max} { }
-    RepeatStrategy(Y max) : fYMax{max}, fYInvMax{1.0f/max} { }
+    RepeatStrategy(X max) : fXMax{max}, fXInvMax{1.0f/max}, fXLast{max - 1.0f} { }
+    RepeatStrategy(Y max) : fYMax{max}, fYInvMax{1.0f/max}, fYLast{max - 1.0f} { }
     RepeatStrategy(SkSize max)
         : fXMax{X(max)}
         , fXInvMax{1.0f / X(max)}
+        , fXLast{X(max) - 1.0f}
         , fYMax{Y(max)}
-        , fYInvMax{1.0f / Y(max)} { }
+        , fYInvMax{1.0f / Y(max)}
+        , fYLast{Y(max) - 1.0f} { }
 
     void processPoints(Sk4f* xs, Sk4f* ys) {
-        Sk4f divX = (*xs * fXInvMax).floor();
-        Sk4f divY = (*ys * fYInvMax).floor();
-        Sk4f baseX = (divX * fXMax);
-        Sk4f baseY = (divY * fYMax);
-        *xs = *xs - baseX;
-        *ys = *ys - baseY;
+        *xs = Repeat(*xs, fXMax, fXInvMax, fXLast);
+        *ys = Repeat(*ys, fYMax, fYInvMax, fYLast);
     }
 
+    // Splits the span where it crosses from one copy of the bitmap to the next.
     template <typename Next>
     bool maybeProcessSpan(SkPoint start, SkScalar length, int count, Next* next) {
-        return false;
+        const SkScalar y = Repeat(Sk4f{Y(start)}, fYMax, fYInvMax, fYLast)[0];
+        SkScalar x = X(start);
+        const SkScalar xMax = fXMax[0];
+        if (xMax == 0.0f) {
+            next->pointSpan(SkPoint{x, y}, length, count);
+            return true;
+        }
+        x = Repeat(Sk4f{x}, fXMax, fXInvMax, fXLast)[0];
+        if (count == 1 || length == 0.0f) {
+            next->pointSpan(SkPoint{x, y}, 0.0f, count);
+            return true;
+        }
+
+        const SkScalar dx = length / (count - 1);
+        if (dx <= 0.0f) {
+            return false;
+        }
+        while (count > 0) {
+            const int n = SkTMin(count, SkTMax(1, (int) std::ceil((xMax - x) / dx)));
+            next->pointSpan(SkPoint{x, y}, (n - 1) * dx, n);
+            x = SkTMin(SkTMax(x + n * dx - xMax, 0.0f), fXLast[0]);
+            count -= n;
+        }
+        return true;
     }
 
 private:
+    static Sk4f VECTORCALL Repeat(Sk4f vs, Sk4f max, Sk4f invMax, Sk4f last) {
+        // An axis we are not tiling has a max of zero, and comes through unchanged.
+        if (max[0] == 0.0f) {
+            return vs;
+        }
+        Sk4f base = (vs * invMax).floor() * max;
+        return Sk4f::Min(Sk4f::Max(vs - base, Sk4f{0.0f}), last);
+    }
+
     const Sk4f fXMax{0.0f};
     const Sk4f fXInvMax{0.0f};
+    const Sk4f fXLast{SK_FloatInfinity};
     const Sk4f fYMax{0.0f};
     const Sk4f fYInvMax{0.0f};
+    const Sk4f fYLast{SK_FloatInfinity};
 };
 
 template <typename Next = SkLinearBitmapPipeline::BilerpProcessorInterface>
 using Repeat = BilerpProcessor<RepeatStrategy, Next>;
 
+class MirrorStrategy {
+public:
+    MirrorStrategy(X max) : fXMax{max}, fXInvMax{0.5f/max} { }
+    MirrorStrategy(Y max) : fYMax{max}, fYInvMax{0.5f/max} { }
+    MirrorStrategy(SkSize max)
+        : fXMax{X(max)}
+        , fXInvMax{0.5f / X(max)}
+        , fYMax{Y(max)}
+        , fYInvMax{0.5f / Y(max)} { }
+
+    void processPoints(Sk4f* xs, Sk4f* ys) {
+        *xs = Mirror(*xs, fXMax, fXInvMax);
+        *ys = Mirror(*ys, fYMax, fYInvMax);
+    }
+
+    template <typename Next>
+    bool maybeProcessSpan(SkPoint start, SkScalar length, int count, Next* next) {
+        return false;
+    }
+
+private:
+    // Works in whole pixels, so that a point exactly on the edge between a copy and its mirror
+    // image lands in the right pixel.
+    static Sk4f VECTORCALL Mirror(Sk4f vs, Sk4f max, Sk4f invHalfMax) {
+        // An axis we are not mirroring has a max of zero, and comes through unchanged.
+        if (max[0] == 0.0f) {
+            return vs;
+        }
+        Sk4f twoMax = max + max;
+        Sk4f pixels = (vs - (vs * invHalfMax).floor() * twoMax).floor();
+        // [0, max) stays put, and [max, 2 * max) maps to (max - 1 ... 0].
+        Sk4f half = Sk4f{0.5f};
+        Sk4f mirrored = max - half - (pixels + half - max).abs();
+        return Sk4f::Min(Sk4f::Max(mirrored, Sk4f{0.0f}), max - Sk4f{1.0f});
+    }
+
+    const Sk4f fXMax{0.0f};
+    const Sk4f fXInvMax{0.0f};
+    const Sk4f fYMax{0.0f};
+    const Sk4f fYInvMax{0.0f};
+};
+
+template <typename Next = SkLinearBitmapPipeline::BilerpProcessorInterface>
+using Mirror = BilerpProcessor<MirrorStrategy, Next>;
+
+template <typename Dimension>
+static void init_tiler(SkShader::TileMode mode, SkLinearBitmapPipeline::TileStage* tileProc,
+                       SkLinearBitmapPipeline::BilerpProcessorInterface* next,
+                       Dimension dimension) {
+    switch (mode) {
+        case SkShader::kClamp_TileMode:
+            tileProc->Initialize<Clamp<>>(next, dimension);
+            break;
+        case SkShader::kRepeat_TileMode:
+            tileProc->Initialize<Repeat<>>(next, dimension);
+            break;
+        case SkShader::kMirror_TileMode:
+            tileProc->Initialize<Mirror<>>(next, dimension);
+            break;
+    }
+}
+
 static SkLinearBitmapPipeline::BilerpProcessorInterface* choose_tiler(
     SkLinearBitmapPipeline::BilerpProcessorInterface* next,
     SkSize dimensions,
@@ -428,41 +680,11 @@ static SkLinearBitmapPipeline::BilerpProcessorInterface* choose_tiler(
     SkLinearBitmapPipeline::TileStage* tileProcXOrBoth,
     SkLinearBitmapPipeline::TileStage* tileProcY) {
     if (xMode == yMode) {
-        switch (xMode) {
-            case SkShader::kClamp_TileMode:
-                tileProcXOrBoth->Initialize<Clamp<>>(next, dimensions);
-                break;
-            case SkShader::kRepeat_TileMode:
-                tileProcXOrBoth->Initialize<Repeat<>>(next, dimensions);
-                break;
-            case SkShader::kMirror_TileMode:
-                SkFAIL("Not implemented.");
-                break;
-        }
+        init_tiler(xMode, tileProcXOrBoth, next, dimensions);
         tileProcY->Initialize<SkippedStage>();
     } else {
-        switch (yMode) {
-            case SkShader::kClamp_TileMode:
-                tileProcY->Initialize<Clamp<>>(next, Y(dimensions));
-                break;
-            case SkShader::kRepeat_TileMode:
-                tileProcY->Initialize<Repeat<>>(next, Y(dimensions));
-                break;
-            case SkShader::kMirror_TileMode:
-                SkFAIL("Not implemented.");
-                break;
-        }
-        switch (xMode) {
-            case SkShader::kClamp_TileMode:
-                tileProcXOrBoth->Initialize<Clamp<>>(tileProcY->get(), X(dimensions));
-                break;
-            case SkShader::kRepeat_TileMode:
-                tileProcXOrBoth->Initialize<Repeat<>>(tileProcY->get(), X(dimensions));
-                break;
-            case SkShader::kMirror_TileMode:
-                SkFAIL("Not implemented.");
-                break;
-        }
+        init_tiler(yMode, tileProcY, next, Y(dimensions));
+        init_tiler(xMode, tileProcXOrBoth, tileProcY->get(), X(dimensions));
     }
     return tileProcXOrBoth->get();
 }
@@ -475,11 +697,138 @@ public:
     }
 };
 
-template <SkColorProfileType colorProfile>
-class Passthrough8888 {
+// Builds a pixel in SkPM4f's channel order.
+static Sk4f VECTORCALL pm4f_from_rgba(float r, float g, float b, float a) {
+    float pixel[4];
+    pixel[SkPM4f::R] = r;
+    pixel[SkPM4f::G] = g;
+    pixel[SkPM4f::B] = b;
+    pixel[SkPM4f::A] = a;
+    return Sk4f::Load(pixel);
+}
+
+// The pixel getters turn the pixel at an index into the source into an Sk4f, in the channel
+// order of SkPM4f.
+
+// kRGBA_8888 and kBGRA_8888. The one that is not kN32 has red and blue swapped.
+template <SkColorProfileType colorProfile, bool kSwapRB>
+class Pixel8888 {
 public:
-    Passthrough8888(int width, const uint32_t* src)
-        : fSrc{src}, fWidth{width}{ }
+    using Element = uint32_t;
+    Pixel8888(const SkPixmap& srcPixmap) : fSrc{srcPixmap.addr32()} { }
+
+    Sk4f getPixelAt(int index) const {
+        Sk4b bytePixel = Sk4b::Load((const uint8_t *)(&fSrc[index]));
+        Sk4f pixel = SkNx_cast<float, uint8_t>(bytePixel);
+        if (kSwapRB) {
+            pixel = SkNx_shuffle<2, 1, 0, 3>(pixel);
+        }
+        pixel = pixel * Sk4f{1.0f/255.0f};
+        if (colorProfile == kSRGB_SkColorProfileType) {
+            pixel = sRGBFast::sRGBToLinear(pixel);
+        }
+        return pixel;
+    }
+
+private:
+    const uint32_t* const fSrc;
+};
+
+class Pixel565 {
+public:
+    using Element = uint16_t;
+    Pixel565(const SkPixmap& srcPixmap) : fSrc{srcPixmap.addr16()} { }
+
+    Sk4f getPixelAt(int index) const {
+        const uint16_t pixel = fSrc[index];
+        return pm4f_from_rgba(SkGetPackedR16(pixel) * (1.0f / SK_R16_MASK),
+                              SkGetPackedG16(pixel) * (1.0f / SK_G16_MASK),
+                              SkGetPackedB16(pixel) * (1.0f / SK_B16_MASK),
+                              1.0f);
+    }
+
+private:
+    const uint16_t* const fSrc;
+};
+
+// The color table holds premultiplied SkPMColors.
+class PixelIndex8 {
+public:
+    using Element = uint8_t;
+    PixelIndex8(const SkPixmap& srcPixmap)
+        : fSrc{srcPixmap.addr8()}
+        , fColors{srcPixmap.ctable()->readColors()} { }
+
+    Sk4f getPixelAt(int index) const {
+        Sk4b bytePixel = Sk4b::Load((const uint8_t *)(&fColors[fSrc[index]]));
+        return SkNx_cast<float, uint8_t>(bytePixel) * Sk4f{1.0f/255.0f};
+    }
+
+private:
+    const uint8_t* const fSrc;
+    const SkPMColor* const fColors;
+};
+
+// Alpha-only bitmaps are drawn in the color of the paint.
+class PixelA8 {
+public:
+    using Element = uint8_t;
+    PixelA8(const SkPixmap& srcPixmap, SkColor paintColor)
+        : fSrc{srcPixmap.addr8()}
+        , fColor{premul_color(paintColor) * Sk4f{1.0f/255.0f}} { }
+
+    Sk4f getPixelAt(int index) const {
+        return fColor * Sk4f{(float) fSrc[index]};
+    }
+
+private:
+    static Sk4f premul_color(SkColor color) {
+        const float a = SkColorGetA(color) * (1.0f / 255.0f);
+        return pm4f_from_rgba(SkColorGetR(color) * (a / 255.0f),
+                              SkColorGetG(color) * (a / 255.0f),
+                              SkColorGetB(color) * (a / 255.0f),
+                              a);
+    }
+
+    const uint8_t* const fSrc;
+    const Sk4f fColor;
+};
+
+class PixelGray8 {
+public:
+    using Element = uint8_t;
+    PixelGray8(const SkPixmap& srcPixmap) : fSrc{srcPixmap.addr8()} { }
+
+    Sk4f getPixelAt(int index) const {
+        const float gray = fSrc[index] * (1.0f / 255.0f);
+        return Sk4f{gray, gray, gray, 1.0f};
+    }
+
+private:
+    const uint8_t* const fSrc;
+};
+
+// F16 is already linear.
+class PixelF16 {
+public:
+    using Element = uint64_t;
+    PixelF16(const SkPixmap& srcPixmap) : fSrc{srcPixmap.addr64()} { }
+
+    Sk4f getPixelAt(int index) const {
+        return Sk4f_fromF16(fSrc[index]);
+    }
+
+private:
+    const uint64_t* const fSrc;
+};
+
+template <typename PixelGetter>
+class PixelAccessor {
+public:
+    template <typename... Args>
+    PixelAccessor(const SkPixmap& srcPixmap, Args&&... args)
+        : fWidth{static_cast<int>(srcPixmap.rowBytes() / sizeof(typename PixelGetter::Element))}
+        , fGetter{srcPixmap, std::forward<Args>(args)...} { }
 
     void VECTORCALL getFewPixels(int n, Sk4f xs, Sk4f ys, Sk4f* px0, Sk4f* px1, Sk4f* px2) {
         Sk4i XIs = SkNx_cast<int, float>(xs);
@@ -487,11 +836,11 @@ public:
         Sk4i bufferLoc = YIs * fWidth + XIs;
         switch (n) {
             case 3:
-                *px2 = getPixel(fSrc, bufferLoc[2]);
+                *px2 = fGetter.getPixelAt(bufferLoc[2]);
             case 2:
-                *px1 = getPixel(fSrc, bufferLoc[1]);
+                *px1 = fGetter.getPixelAt(bufferLoc[1]);
             case 1:
-                *px0 = getPixel(fSrc, bufferLoc[0]);
+                *px0 = fGetter.getPixelAt(bufferLoc[0]);
             default:
                 break;
         }
@@ -501,67 +850,28 @@ public:
         Sk4i XIs = SkNx_cast<int, float>(xs);
         Sk4i YIs = SkNx_cast<int, float>(ys);
         Sk4i bufferLoc = YIs * fWidth + XIs;
-        *px0 = getPixel(fSrc, bufferLoc[0]);
-        *px1 = getPixel(fSrc, bufferLoc[1]);
-        *px2 = getPixel(fSrc, bufferLoc[2]);
-        *px3 = getPixel(fSrc, bufferLoc[3]);
+        *px0 = fGetter.getPixelAt(bufferLoc[0]);
+        *px1 = fGetter.getPixelAt(bufferLoc[1]);
+        *px2 = fGetter.getPixelAt(bufferLoc[2]);
+        *px3 = fGetter.getPixelAt(bufferLoc[3]);
     }
 
-    const uint32_t* row(int y) { return fSrc + y * fWidth[0]; }
+    Sk4f getPixelAt(int index) const { return fGetter.getPixelAt(index); }
+
+    int rowStart(int y) const { return y * fWidth[0]; }
 
 private:
-    Sk4f getPixel(const uint32_t* src, int index) {
-        Sk4b bytePixel = Sk4b::Load((uint8_t *)(&src[index]));
-        Sk4f pixel = SkNx_cast<float, uint8_t>(bytePixel);
-        pixel = pixel * Sk4f{1.0f/255.0f};
-        if (colorProfile == kSRGB_SkColorProfileType) {
-            pixel = sRGBFast::sRGBToLinear(pixel);
-        }
-        return pixel;
-    }
-    const uint32_t* const fSrc;
     const Sk4i fWidth;
+    PixelGetter fGetter;
 };
 
-// Explaination of the math:
-//              1 - x      x
-//           +--------+--------+
-//           |        |        |
-//  1 - y    |  px00  |  px10  |
-//           |        |        |
-//           +--------+--------+
-//           |        |        |
-//    y      |  px01  |  px11  |
-//           |        |        |
-//           +--------+--------+
-//
-//
-// Given a pixelxy each is multiplied by a different factor derived from the fractional part of x
-// and y:
-// * px00 -> (1 - x)(1 - y) = 1 - x - y + xy
-// * px10 -> x(1 - y) = x - xy
-// * px01 -> (1 - x)y = y - xy
-// * px11 -> xy
-// So x * y is calculated first and then used to calculate all the other factors.
-static Sk4f VECTORCALL bilerp4(Sk4f xs, Sk4f ys, Sk4f px00, Sk4f px10,
-                                                 Sk4f px01, Sk4f px11) {
-    // Calculate fractional xs and ys.
-    Sk4f fxs = xs - xs.floor();
-    Sk4f fys = ys - ys.floor();
-    Sk4f fxys{fxs * fys};
-    Sk4f sum =  px11 * fxys;
-    sum = sum + px01 * (fys - fxys);
-    sum = sum + px10 * (fxs - fxys);
-    sum = sum + px00 * (Sk4f{1.0f} - fxs - fys + fxys);
-    return sum;
-}
-
 template <typename SourceStrategy>
 class Sampler final : public SkLinearBitmapPipeline::BilerpProcessorInterface {
 public:
     template <typename... Args>
-    Sampler(SkLinearBitmapPipeline::PixelPlacerInterface* next, Args&&... args)
+    Sampler(SkLinearBitmapPipeline::PixelPlacerInterface* next, bool isPremul, Args&&... args)
         : fNext{next}
+        , fIsPremul{isPremul}
         , fStrategy{std::forward<Args>(args)...} { }
 
     void VECTORCALL pointListFew(int n, Sk4f xs, Sk4f ys) override {
@@ -579,44 +889,120 @@ public:
         fNext->place4Pixels(px0, px1, px2, px3);
     }
 
-    void VECTORCALL bilerpList(Sk4f xs, Sk4f ys) override {
-        Sk4f px00, px10, px01, px11;
-        fStrategy.get4Pixels(xs, ys, &px00, &px10, &px01, &px11);
-        Sk4f pixel = bilerp4(xs, ys, px00, px10, px01, px11);
-        fNext->placePixel(pixel);
+    void VECTORCALL filterList(Sk4f xs, Sk4f ys, Sk4f weights, bool last) override {
+        Sk4f px0, px1, px2, px3;
+        fStrategy.get4Pixels(xs, ys, &px0, &px1, &px2, &px3);
+        fSum = fSum + px0 * Sk4f{weights[0]} + px1 * Sk4f{weights[1]}
+                    + px2 * Sk4f{weights[2]} + px3 * Sk4f{weights[3]};
+        if (last) {
+            // Bicubic weights can be negative, and overshoot.
+            Sk4f pixel = Sk4f::Min(Sk4f::Max(fSum, Sk4f{0.0f}), Sk4f{1.0f});
+            if (fIsPremul) {
+                pixel = Sk4f::Min(pixel, Sk4f{pixel[SkPM4f::A]});
+            }
+            fNext->placePixel(pixel);
+            fSum = Sk4f{0.0f};
+        }
     }
 
+    // Only reached without filtering, so each destination pixel is the source pixel its
+    // point lands in.
     void pointSpan(SkPoint start, SkScalar length, int count) override {
-        span_fallback(start, length, count, this);
+        const int rowStart = fStrategy.rowStart((int) Y(start));
+        const float x = X(start);
+        if (count == 1 || length == 0.0f) {
+            const Sk4f pixel = fStrategy.getPixelAt(rowStart + (int) x);
+            for (; count >= 4; count -= 4) {
+                fNext->place4Pixels(pixel, pixel, pixel, pixel);
+            }
+            for (; count > 0; count--) {
+                fNext->placePixel(pixel);
+            }
+        } else if (length == count - 1) {
+            // Translate only, so the pixels are all next to each other.
+            int index = rowStart + (int) x;
+            for (; count >= 4; count -= 4, index += 4) {
+                fNext->place4Pixels(fStrategy.getPixelAt(index),
+                                    fStrategy.getPixelAt(index + 1),
+                                    fStrategy.getPixelAt(index + 2),
+                                    fStrategy.getPixelAt(index + 3));
+            }
+            for (; count > 0; count--, index++) {
+                fNext->placePixel(fStrategy.getPixelAt(index));
+            }
+        } else {
+            const float dx = length / (count - 1);
+            float fx = x;
+            for (; count >= 4; count -= 4, fx += 4 * dx) {
+                fNext->place4Pixels(fStrategy.getPixelAt(rowStart + (int) (fx)),
+                                    fStrategy.getPixelAt(rowStart + (int) (fx + dx)),
+                                    fStrategy.getPixelAt(rowStart + (int) (fx + 2 * dx)),
+                                    fStrategy.getPixelAt(rowStart + (int) (fx + 3 * dx)));
+            }
+            for (; count > 0; count--, fx += dx) {
+                fNext->placePixel(fStrategy.getPixelAt(rowStart + (int) fx));
+            }
+        }
     }
 
 private:
     SkLinearBitmapPipeline::PixelPlacerInterface* const fNext;
+    const bool fIsPremul;
+    Sk4f fSum{0.0f};
     SourceStrategy fStrategy;
 };
 
+template <typename PixelGetter, typename... Args>
+static void init_sampler(SkLinearBitmapPipeline::SampleStage* sampleStage,
+                         SkLinearBitmapPipeline::PixelPlacerInterface* next,
+                         const SkPixmap& srcPixmap, Args&&... args) {
+    const bool isPremul = srcPixmap.alphaType() != kUnpremul_SkAlphaType;
+    sampleStage->Initialize<Sampler<PixelAccessor<PixelGetter>>>(
+        next, isPremul, srcPixmap, std::forward<Args>(args)...);
+}
+
+template <bool kSwapRB>
+static void init_8888_sampler(SkLinearBitmapPipeline::SampleStage* sampleStage,
+                              SkLinearBitmapPipeline::PixelPlacerInterface* next,
+                              const SkPixmap& srcPixmap) {
+    if (srcPixmap.info().profileType() == kSRGB_SkColorProfileType) {
+        init_sampler<Pixel8888<kSRGB_SkColorProfileType, kSwapRB>>(sampleStage, next, srcPixmap);
+    } else {
+        init_sampler<Pixel8888<kLinear_SkColorProfileType, kSwapRB>>(sampleStage, next,
+                                                                     srcPixmap);
+    }
+}
+
 static SkLinearBitmapPipeline::BilerpProcessorInterface* choose_pixel_sampler(
     SkLinearBitmapPipeline::PixelPlacerInterface* next,
     const SkPixmap& srcPixmap,
+    SkColor paintColor,
     SkLinearBitmapPipeline::SampleStage* sampleStage) {
     const SkImageInfo& imageInfo = srcPixmap.info();
     switch (imageInfo.colorType()) {
         case kRGBA_8888_SkColorType:
         case kBGRA_8888_SkColorType:
             if (kN32_SkColorType == imageInfo.colorType()) {
-                if (imageInfo.profileType() == kSRGB_SkColorProfileType) {
-                    sampleStage->Initialize<Sampler<Passthrough8888<kSRGB_SkColorProfileType>>>(
-                        next, static_cast<int>(srcPixmap.rowBytes() / 4),
-                        srcPixmap.addr32());
-                } else {
-                    sampleStage->Initialize<Sampler<Passthrough8888<kLinear_SkColorProfileType>>>(
-                        next, static_cast<int>(srcPixmap.rowBytes() / 4),
-                        srcPixmap.addr32());
-                }
+                init_8888_sampler<false>(sampleStage, next, srcPixmap);
             } else {
-                SkFAIL("Not implemented. No 8888 Swizzle");
+                init_8888_sampler<true>(sampleStage, next, srcPixmap);
             }
             break;
+        case kRGB_565_SkColorType:
+            init_sampler<Pixel565>(sampleStage, next, srcPixmap);
+            break;
+        case kIndex_8_SkColorType:
+            init_sampler<PixelIndex8>(sampleStage, next, srcPixmap);
+            break;
+        case kAlpha_8_SkColorType:
+            init_sampler<PixelA8>(sampleStage, next, srcPixmap, paintColor);
+            break;
+        case kGray_8_SkColorType:
+            init_sampler<PixelGray8>(sampleStage, next, srcPixmap);
+            break;
+        case kRGBA_F16_SkColorType:
+            init_sampler<PixelF16>(sampleStage, next, srcPixmap);
+            break;
         default:
             SkFAIL("Not implemented. Unsupported src");
             break;
@@ -627,6 +1013,8 @@ static SkLinearBitmapPipeline::BilerpProcessorInterface* choose_pixel_sampler(
 template <SkAlphaType alphaType>
 class PlaceFPPixel final : public SkLinearBitmapPipeline::PixelPlacerInterface {
 public:
+    PlaceFPPixel(float postAlpha) : fPostAlpha{postAlpha} { }
+
     void VECTORCALL placePixel(Sk4f pixel) override {
         PlacePixel(fDst, pixel, 0);
         fDst += 1;
@@ -646,11 +1034,12 @@ public:
     }
 
 private:
-    static void VECTORCALL PlacePixel(SkPM4f* dst, Sk4f pixel, int index) {
+    void VECTORCALL PlacePixel(SkPM4f* dst, Sk4f pixel, int index) {
         Sk4f newPixel = pixel;
         if (alphaType == kUnpremul_SkAlphaType) {
             newPixel = Premultiply(pixel);
         }
+        newPixel = newPixel * fPostAlpha;
         newPixel.store(dst + index);
     }
     static Sk4f VECTORCALL Premultiply(Sk4f pixel) {
@@ -659,35 +1048,62 @@ private:
     }
 
     SkPM4f* fDst;
+    const Sk4f fPostAlpha;
 };
 
 static SkLinearBitmapPipeline::PixelPlacerInterface* choose_pixel_placer(
     SkAlphaType alphaType,
+    float postAlpha,
     SkLinearBitmapPipeline::PixelStage* placerStage) {
     if (alphaType == kUnpremul_SkAlphaType) {
-        placerStage->Initialize<PlaceFPPixel<kUnpremul_SkAlphaType>>();
+        placerStage->Initialize<PlaceFPPixel<kUnpremul_SkAlphaType>>(postAlpha);
     } else {
         // kOpaque_SkAlphaType is treated the same as kPremul_SkAlphaType
-        placerStage->Initialize<PlaceFPPixel<kPremul_SkAlphaType>>();
+        placerStage->Initialize<PlaceFPPixel<kPremul_SkAlphaType>>(postAlpha);
     }
     return placerStage->get();
 }
 }  // namespace
 
+bool SkLinearBitmapPipeline::CanShade(const SkImageInfo& srcInfo) {
+    switch (srcInfo.colorType()) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kRGB_565_SkColorType:
+        case kIndex_8_SkColorType:
+        case kAlpha_8_SkColorType:
+        case kGray_8_SkColorType:
+        case kRGBA_F16_SkColorType:
+            return !srcInfo.isEmpty();
+        default:
+            return false;
+    }
+}
+
 SkLinearBitmapPipeline::~SkLinearBitmapPipeline() {}
 
 SkLinearBitmapPipeline::SkLinearBitmapPipeline(
     const SkMatrix& inverse,
     SkFilterQuality filterQuality,
     SkShader::TileMode xTile, SkShader::TileMode yTile,
+    SkColor paintColor,
     const SkPixmap& srcPixmap) {
+    SkASSERT(CanShade(srcPixmap.info()));
     SkSize size = SkSize::Make(srcPixmap.width(), srcPixmap.height());
     const SkImageInfo& srcImageInfo = srcPixmap.info();
 
+    // A8 is drawn in the paint's color, alpha included. Everything else just takes on the
+    // paint's alpha.
+    float postAlpha = SkColorGetA(paintColor) * (1.0f / 255.0f);
+    if (kAlpha_8_SkColorType == srcImageInfo.colorType()) {
+        postAlpha = 1.0f;
+    }
+
     // As the stages are built, the chooser function may skip a stage. For example, with the
     // identity matrix, the matrix stage is skipped, and the tilerStage is the first stage.
-    auto placementStage = choose_pixel_placer(srcImageInfo.alphaType(), &fPixelStage);
-    auto samplerStage   = choose_pixel_sampler(placementStage, srcPixmap, &fSampleStage);
+    auto placementStage = choose_pixel_placer(srcImageInfo.alphaType(), postAlpha, &fPixelStage);
+    auto samplerStage   = choose_pixel_sampler(placementStage, srcPixmap, paintColor,
+                                               &fSampleStage);
     auto tilerStage     = choose_tiler(samplerStage, size, xTile, yTile, &fTileXOrBothStage,
                                        &fTileYStage);
     auto filterStage    = choose_filter(tilerStage, filterQuality, &fFilterStage);
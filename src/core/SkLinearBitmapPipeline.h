@@ -17,10 +17,21 @@
 
 class SkLinearBitmapPipeline {
 public:
+    /**
+     *  Returns true if the pipeline can shade a bitmap of this kind: 8888, 565, Index8, A8,
+     *  Gray8 or F16.
+     */
+    static bool CanShade(const SkImageInfo& srcInfo);
+
+    /**
+     *  The paint's color is only used for its alpha, except with A8 sources, which are drawn in
+     *  the paint's color.
+     */
     SkLinearBitmapPipeline(
         const SkMatrix& inverse,
         SkFilterQuality filterQuality,
         SkShader::TileMode xTile, SkShader::TileMode yTile,
+        SkColor paintColor,
         const SkPixmap& srcPixmap);
     ~SkLinearBitmapPipeline();
 
@@ -35,8 +46,7 @@ public:
 
         template<typename Variant, typename... Args>
         void Initialize(Args&&... args) {
-            SkASSERTF(sizeof(Variant) <= sizeof(fSpace),
-                      "Size Variant: %d, Space: %d", sizeof(Variant), sizeof(fSpace));
+            static_assert(sizeof(Variant) <= sizeof(Space), "Stage too big for its space.");
 
             new(&fSpace) Variant(std::forward<Args>(args)...);
         };
@@ -56,10 +66,10 @@ public:
     class BilerpProcessorInterface;
     class PixelPlacerInterface;
 
-    using MatrixStage = PolymorphicUnion<PointProcessorInterface, 112>;
-    using FilterStage = PolymorphicUnion<PointProcessorInterface,   8>;
-    using TileStage   = PolymorphicUnion<BilerpProcessorInterface, 96>;
-    using SampleStage = PolymorphicUnion<BilerpProcessorInterface, 80>;
+    using MatrixStage = PolymorphicUnion<PointProcessorInterface, 160>;
+    using FilterStage = PolymorphicUnion<PointProcessorInterface,  16>;
+    using TileStage   = PolymorphicUnion<BilerpProcessorInterface, 112>;
+    using SampleStage = PolymorphicUnion<BilerpProcessorInterface, 96>;
     using PixelStage  = PolymorphicUnion<PixelPlacerInterface,     80>;
 
 private:
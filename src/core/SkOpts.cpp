@@ -10,6 +10,7 @@
 #include "SkOpts.h"
 
 #define SK_OPTS_NS sk_default
+#include "SkBitmapFilter_opts.h"
 #include "SkBlitMask_opts.h"
 #include "SkBlitRow_opts.h"
 #include "SkBlurImageFilter_opts.h"
@@ -19,6 +20,7 @@
 #include "SkSwizzler_opts.h"
 #include "SkTextureCompressor_opts.h"
 #include "SkXfermode_opts.h"
+#include "SkYUV_opts.h"
 
 namespace SK_OPTS_NS {
     static void float_to_half(uint16_t dst[], const float src[], int n) {
@@ -101,15 +103,25 @@ namespace SkOpts {
     decltype(inverted_CMYK_to_RGB1) inverted_CMYK_to_RGB1 = sk_default::inverted_CMYK_to_RGB1;
     decltype(inverted_CMYK_to_BGR1) inverted_CMYK_to_BGR1 = sk_default::inverted_CMYK_to_BGR1;
 
+    decltype(YUV_to_RGB1) YUV_to_RGB1 = sk_default::YUV_to_RGB1;
+    decltype(YUV_to_BGR1) YUV_to_BGR1 = sk_default::YUV_to_BGR1;
+
     decltype(half_to_float) half_to_float = sk_default::half_to_float;
     decltype(float_to_half) float_to_half = sk_default::float_to_half;
 
+    decltype(convolve_horizontally)        convolve_horizontally =
+        sk_default::convolve_horizontally;
+    decltype(convolve_4_rows_horizontally) convolve_4_rows_horizontally =
+        sk_default::convolve_4_rows_horizontally;
+    decltype(convolve_vertically)          convolve_vertically =
+        sk_default::convolve_vertically;
+
     // Each Init_foo() is defined in src/opts/SkOpts_foo.cpp.
     void Init_ssse3();
     void Init_sse41();
     void Init_sse42() {}
     void Init_avx() {}
-    void Init_avx2() {}
+    void Init_avx2();
     void Init_neon();
 
     static void init() {
@@ -8,6 +8,8 @@
 #ifndef SkOpts_DEFINED
 #define SkOpts_DEFINED
 
+#include "SkConvolver.h"
+#include "SkImageInfo.h"
 #include "SkMatrix.h"
 #include "SkTextureCompressor.h"
 #include "SkTypes.h"
@@ -64,8 +66,20 @@ namespace SkOpts {
                         inverted_CMYK_to_RGB1, // i.e. convert color space
                         inverted_CMYK_to_BGR1; // i.e. convert color space
 
+    // Convert rows of 8-bit Y, U, and V samples to opaque 8888, {rgba,bgra}.  If halfChroma,
+    // each U and V sample covers two pixels, as in 4:2:0 and 4:2:2.
+    typedef void (*YUV_8888)(uint32_t*, const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                             int count, SkYUVColorSpace, bool halfChroma);
+    extern YUV_8888 YUV_to_RGB1,
+                    YUV_to_BGR1;
+
     extern void (*half_to_float)(float[], const uint16_t[], int);
     extern void (*float_to_half)(uint16_t[], const float[], int);
+
+    // The passes of BGRAConvolve2D(): one row or four rows horizontally, and one row vertically.
+    extern SkConvolveHorizontally_pointer      convolve_horizontally;
+    extern SkConvolve4RowsHorizontally_pointer convolve_4_rows_horizontally;
+    extern SkConvolveVertically_pointer        convolve_vertically;
 }
 
 #endif//SkOpts_DEFINED
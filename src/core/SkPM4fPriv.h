@@ -7,6 +7,7 @@
 
 #include "SkPM4f.h"
 #include "SkColorPriv.h"
+#include "SkHalf.h"
 #include "SkNx.h"
 
 static inline float get_alpha(const Sk4f& f4) {
@@ -53,3 +54,14 @@ static inline uint32_t Sk4f_toL32(const Sk4f& x4) {
 static inline uint32_t Sk4f_toS32(const Sk4f& x4) {
     return to_4b(linear_to_srgb(x4) * Sk4f(255) + Sk4f(0.5f));
 }
+
+// F16 pixels are always stored RGBA, but SkPM4f is BGRA on some platforms, so these swap
+// red and blue to and from SkPM4f's order.  Values must be in [0,1], as for SkFloatToHalf_01.
+static inline Sk4f Sk4f_fromF16(uint64_t f16) {
+    const Sk4f rgba = SkHalfToFloat_01(f16);
+    return 0 == SkPM4f::R ? rgba : SkNx_shuffle<2, 1, 0, 3>(rgba);
+}
+
+static inline uint64_t Sk4f_toF16(const Sk4f& x4) {
+    return SkFloatToHalf_01(0 == SkPM4f::R ? x4 : SkNx_shuffle<2, 1, 0, 3>(x4));
+}
@@ -1566,9 +1566,23 @@ void SkPath::reversePathTo(const SkPath& path) {
 
     while (--i > 0) {
         switch (verbs[~i]) {
-            case kLine_Verb:
-                this->lineTo(pts[-1].fX, pts[-1].fY);
+            case kLine_Verb: {
+                // append a run of lines all at once
+                int count = 1;
+                while (count < i && kLine_Verb == verbs[~(i - count)]) {
+                    ++count;
+                }
+                this->injectMoveToIfNeeded();
+                SkPathRef::Editor ed(&fPathRef);
+                SkPoint* dst = ed.growForRepeatedVerb(kLine_Verb, count);
+                for (int j = 0; j < count; ++j) {
+                    dst[j] = pts[~j];
+                }
+                DIRTY_AFTER_EDIT;
+                pts -= count - 1;
+                i -= count - 1;
                 break;
+            }
             case kQuad_Verb:
                 this->quadTo(pts[-1].fX, pts[-1].fY, pts[-2].fX, pts[-2].fY);
                 break;
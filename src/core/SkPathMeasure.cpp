@@ -10,6 +10,7 @@
 #include "SkPathMeasure.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
+#include "SkResourceCache.h"
 #include "SkTSearch.h"
 
 // these must be 0,1,2,3 since they are in our 2-bit field
@@ -22,6 +23,9 @@ enum {
 
 #define kMaxTValue  0x3FFFFFFF
 
+// Contours with fewer segments measure about as fast as they can be looked up.
+static const int kMinCachedSegments = 16;
+
 static inline SkScalar tValue2Scalar(int t) {
     SkASSERT((unsigned)t <= kMaxTValue);
     const SkScalar kMaxTReciprocal = 1.0f / kMaxTValue;
@@ -215,8 +219,22 @@ SkScalar SkPathMeasure::compute_cubic_segs(const SkPoint pts[4],
 }
 
 void SkPathMeasure::buildSegments() {
+    // Only the current contour's points are kept. Past the first contour, measuring the last
+    // one has already read the moveTo that starts this one.
+    if (fFirstPtIndex >= 0) {
+        const SkPoint moveTo = fPts[fFirstPtIndex];
+        fPts.setCount(1);
+        fPts[0] = moveTo;
+        fFirstPtIndex = 0;
+    }
+    fContourIndex += 1;
+    if (fCacheable && this->findCachedContour()) {
+        return;
+    }
+
     SkPoint         pts[4];
     int             ptIndex = fFirstPtIndex;
+    int             ptCount = -1;   // of this contour, without the next one's moveTo
     SkScalar        distance = 0;
     bool            isClosed = fForceClosed;
     bool            firstMoveTo = ptIndex < 0;
@@ -237,6 +255,7 @@ void SkPathMeasure::buildSegments() {
                 ptIndex += 1;
                 fPts.append(1, pts);
                 if (!firstMoveTo) {
+                    ptCount = ptIndex;
                     done = true;
                     break;
                 }
@@ -317,6 +336,9 @@ void SkPathMeasure::buildSegments() {
     fLength = distance;
     fIsClosed = isClosed;
     fFirstPtIndex = ptIndex;
+    if (fCacheable && fSegments.count() >= kMinCachedSegments) {
+        this->addCachedContour(ptCount < 0 ? fPts.count() : ptCount);
+    }
 
 #ifdef SK_DEBUG
     {
@@ -346,6 +368,102 @@ void SkPathMeasure::buildSegments() {
 #endif
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPathMeasureKeyNamespaceLabel;
+
+struct PathMeasureKey : public SkResourceCache::Key {
+public:
+    PathMeasureKey(const SkPath& path, bool forceClosed, SkScalar tolerance, int contourIndex)
+        : fGenID(path.getGenerationID())
+        , fForceClosed(forceClosed)
+        , fTolerance(tolerance)
+        , fContourIndex(contourIndex)
+    {
+        this->init(&gPathMeasureKeyNamespaceLabel, 0,
+                   sizeof(fGenID) + sizeof(fForceClosed) + sizeof(fTolerance) +
+                   sizeof(fContourIndex));
+    }
+
+    uint32_t fGenID;
+    int32_t  fForceClosed;
+    SkScalar fTolerance;
+    int32_t  fContourIndex;
+};
+} // namespace
+
+// A measured contour: its segments, and the points they index.
+struct SkPathMeasure::ContourRec : public SkResourceCache::Rec {
+    ContourRec(const PathMeasureKey& key, const SkPathMeasure& meas, int ptCount)
+        : fKey(key)
+        , fLength(meas.fLength)
+        , fIsClosed(meas.fIsClosed)
+    {
+        fSegments.append(meas.fSegments.count(), meas.fSegments.begin());
+        fPts.append(ptCount, meas.fPts.begin());
+    }
+
+    PathMeasureKey      fKey;
+    SkTDArray<Segment>  fSegments;
+    SkTDArray<SkPoint>  fPts;
+    SkScalar            fLength;
+    bool                fIsClosed;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fSegments.count() * sizeof(Segment)
+                             + fPts.count() * sizeof(SkPoint);
+    }
+    const char* getCategory() const override { return "path-measure"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const ContourRec& rec = static_cast<const ContourRec&>(baseRec);
+        SkPathMeasure* meas = (SkPathMeasure*)contextData;
+
+        meas->fSegments.setCount(0);
+        meas->fSegments.append(rec.fSegments.count(), rec.fSegments.begin());
+        meas->fPts.setCount(0);
+        meas->fPts.append(rec.fPts.count(), rec.fPts.begin());
+        meas->fLength = rec.fLength;
+        meas->fIsClosed = rec.fIsClosed;
+        return true;
+    }
+};
+
+bool SkPathMeasure::findCachedContour() {
+    const PathMeasureKey key(*fPath, fForceClosed, fTolerance, fContourIndex);
+    if (!SkResourceCache::Find(key, ContourRec::Visitor, this)) {
+        return false;
+    }
+
+    // Step the iterator over the contour, just as measuring it would have.
+    SkPoint pts[4];
+    bool firstMoveTo = fFirstPtIndex < 0;
+    for (;;) {
+        const SkPath::Verb verb = fIter.next(pts);
+        if (SkPath::kDone_Verb == verb) {
+            break;
+        }
+        if (SkPath::kMove_Verb == verb) {
+            if (!firstMoveTo) {
+                fPts.append(1, pts);
+                break;
+            }
+            firstMoveTo = false;
+        }
+    }
+    fFirstPtIndex = fPts.count() - 1;
+    return true;
+}
+
+void SkPathMeasure::addCachedContour(int ptCount) {
+    const PathMeasureKey key(*fPath, fForceClosed, fTolerance, fContourIndex);
+    SkResourceCache::Add(new ContourRec(key, *this, ptCount));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 static void compute_pos_tan(const SkPoint pts[], int segType,
                             SkScalar t, SkPoint* pos, SkVector* tangent) {
     switch (segType) {
@@ -475,12 +593,20 @@ static void seg_to(const SkPoint pts[], int segType,
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+// Contours of only lines measure about as fast as they can be looked up, and volatile paths
+// won't be measured again.
+static bool is_cacheable(const SkPath& path) {
+    return !path.isVolatile() && (path.getSegmentMasks() & ~SkPath::kLine_SegmentMask);
+}
+
 SkPathMeasure::SkPathMeasure() {
     fPath = nullptr;
     fTolerance = CHEAP_DIST_LIMIT;
     fLength = -1;   // signal we need to compute it
     fForceClosed = false;
     fFirstPtIndex = -1;
+    fContourIndex = -1;
+    fCacheable = false;
 }
 
 SkPathMeasure::SkPathMeasure(const SkPath& path, bool forceClosed, SkScalar resScale) {
@@ -489,6 +615,8 @@ SkPathMeasure::SkPathMeasure(const SkPath& path, bool forceClosed, SkScalar resS
     fLength = -1;   // signal we need to compute it
     fForceClosed = forceClosed;
     fFirstPtIndex = -1;
+    fContourIndex = -1;
+    fCacheable = is_cacheable(path);
 
     fIter.setPath(path, forceClosed);
 }
@@ -502,6 +630,8 @@ void SkPathMeasure::setPath(const SkPath* path, bool forceClosed) {
     fLength = -1;   // signal we need to compute it
     fForceClosed = forceClosed;
     fFirstPtIndex = -1;
+    fContourIndex = -1;
+    fCacheable = path && is_cacheable(*path);
 
     if (path) {
         fIter.setPath(*path, forceClosed);
@@ -562,7 +692,12 @@ const SkPathMeasure::Segment* SkPathMeasure::distanceToSegment(
     int index = SkTKSearch<Segment, SkScalar>(seg, count, distance);
     // don't care if we hit an exact match or not, so we xor index if it is negative
     index ^= (index >> 31);
-    seg = &seg[index];
+    return this->interpolateSegment(index, distance, t);
+}
+
+const SkPathMeasure::Segment* SkPathMeasure::interpolateSegment(int index, SkScalar distance,
+                                                                SkScalar* t) {
+    const Segment* seg = &fSegments[index];
 
     // now interpolate t-values with the prev segment (if possible)
     SkScalar    startT = 0, startD = 0;
@@ -612,6 +747,51 @@ bool SkPathMeasure::getPosTan(SkScalar distance, SkPoint* pos,
     return true;
 }
 
+bool SkPathMeasure::getPosTans(const SkScalar distances[], int count, SkPoint positions[],
+                               SkVector tangents[]) {
+    if (nullptr == fPath) {
+        return false;
+    }
+
+    SkScalar    length = this->getLength(); // call this to force computing it
+    int         segCount = fSegments.count();
+
+    if (segCount == 0 || length == 0) {
+        return false;
+    }
+
+    const Segment* segs = fSegments.begin();
+    int index = 0;
+    for (int i = 0; i < count; ++i) {
+        SkScalar distance = distances[i];
+        // pin the distance to a legal range
+        if (distance < 0) {
+            distance = 0;
+        } else if (distance > length) {
+            distance = length;
+        }
+
+        // Like distanceToSegment(), find the first segment that ends at or past distance:
+        // sweeping forward from the last one while the distances increase, and searching
+        // again only when they don't.
+        if (index > 0 && !(segs[index - 1].fDistance < distance)) {
+            index = SkTKSearch<Segment, SkScalar>(segs, segCount, distance);
+            index ^= (index >> 31);
+        } else {
+            while (index < segCount - 1 && segs[index].fDistance < distance) {
+                index += 1;
+            }
+        }
+
+        SkScalar        t;
+        const Segment*  seg = this->interpolateSegment(index, distance, &t);
+
+        compute_pos_tan(&fPts[seg->fPtIndex], seg->fType, t,
+                        positions ? &positions[i] : nullptr, tangents ? &tangents[i] : nullptr);
+    }
+    return true;
+}
+
 bool SkPathMeasure::getMatrix(SkScalar distance, SkMatrix* matrix,
                               MatrixFlags flags) {
     if (nullptr == fPath) {
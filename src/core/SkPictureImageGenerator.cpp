@@ -23,6 +23,7 @@ protected:
                      int* ctableCount) override;
     bool onComputeScaledDimensions(SkScalar scale, SupportedSizes*) override;
     bool onGenerateScaledPixels(const SkISize&, const SkIPoint&, const SkPixmap&) override;
+    bool onCanGenerateScaledPixels() const override { return true; }
 
 #if SK_SUPPORT_GPU
     GrTexture* onGenerateTexture(GrContext*, const SkIRect*) override;
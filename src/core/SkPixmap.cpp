@@ -202,6 +202,8 @@ bool SkPixmap::erase(SkColor color, const SkIRect& inArea) const {
             }
             break;
         }
+        case kRGBA_F16_SkColorType:
+            return this->erase(SkColor4f::FromColor(color), &area);
         default:
             return false; // no change, so don't call notifyPixelsChanged()
     }
@@ -210,6 +212,7 @@ bool SkPixmap::erase(SkColor color, const SkIRect& inArea) const {
 
 #include "SkNx.h"
 #include "SkHalf.h"
+#include "SkPM4fPriv.h"
 
 static void sk_memset64(uint64_t dst[], uint64_t value, int count) {
     for (int i = 0; i < count; ++i) {
@@ -236,7 +239,7 @@ bool SkPixmap::erase(const SkColor4f& origColor, const SkIRect* subset) const {
         return pm.erase(c);
     }
 
-    const uint64_t half4 = color.premul().toF16();
+    const uint64_t half4 = Sk4f_toF16(Sk4f::Load(color.premul().fVec));
     for (int y = 0; y < pm.height(); ++y) {
         sk_memset64(pm.writable_addr64(0, y), half4, pm.width());
     }
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGeometry.h"
+#include "SkMatrix.h"
+#include "SkPath.h"
+#include "SkQuadPathCache.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+// The same tolerance SkEdgeBuilder cuts conics up with.
+const SkScalar SkQuadPathCache::kTolerance = SK_Scalar1 / 4;
+
+// Scales are rounded up to a power of 2^(1/kBucketsPerOctave), and conics cut up for that scale.
+static const int kBucketsPerOctave = 4;
+// Past these, a path is drawn at too extreme a scale to be worth caching.
+static const int kMinBucket = -16 * kBucketsPerOctave;
+static const int kMaxBucket =  16 * kBucketsPerOctave;
+
+namespace {
+static unsigned gQuadPathKeyNamespaceLabel;
+
+struct QuadPathKey : public SkResourceCache::Key {
+public:
+    QuadPathKey(const SkPath& path, int bucket)
+        : fGenID(path.getGenerationID())
+        , fBucket(bucket)
+    {
+        this->init(&gQuadPathKeyNamespaceLabel, 0, sizeof(fGenID) + sizeof(fBucket));
+    }
+
+    uint32_t fGenID;
+    int32_t  fBucket;
+};
+
+struct QuadPathRec : public SkResourceCache::Rec {
+    QuadPathRec(const QuadPathKey& key, const SkPath& path)
+        : fKey(key)
+        , fPath(path)
+    {}
+
+    QuadPathKey fKey;
+    SkPath      fPath;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fPath.countPoints() * sizeof(SkPoint) + fPath.countVerbs();
+    }
+    const char* getCategory() const override { return "quad-path"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const QuadPathRec& rec = static_cast<const QuadPathRec&>(baseRec);
+        SkPath* result = (SkPath*)contextData;
+
+        *result = rec.fPath;
+        return true;
+    }
+};
+} // namespace
+
+static void conics_to_quads(const SkPath& src, SkScalar tol, SkPath* dst) {
+    dst->reset();
+    dst->incReserve(src.countPoints() * 2);
+
+    SkAutoConicToQuads quadder;
+    SkPath::RawIter iter(src);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                dst->moveTo(pts[0]);
+                break;
+            case SkPath::kLine_Verb:
+                dst->lineTo(pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                dst->quadTo(pts[1], pts[2]);
+                break;
+            case SkPath::kConic_Verb: {
+                const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(), tol);
+                for (int i = 0; i < quadder.countQuads(); ++i) {
+                    dst->quadTo(quadPts[1], quadPts[2]);
+                    quadPts += 2;
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                dst->cubicTo(pts[1], pts[2], pts[3]);
+                break;
+            case SkPath::kClose_Verb:
+                dst->close();
+                break;
+            default:
+                SkDEBUGFAIL("unexpected verb");
+                break;
+        }
+    }
+}
+
+bool SkQuadPathCache::GetQuadPath(const SkPath& src, const SkMatrix& matrix, SkPath* dst,
+                                  SkResourceCache* localCache) {
+    if (src.isVolatile() || !(src.getSegmentMasks() & SkPath::kConic_SegmentMask)) {
+        return false;
+    }
+
+    // getMaxScale() is negative for perspective, which we leave to SkEdgeBuilder.
+    const SkScalar scale = matrix.getMaxScale();
+    if (!(scale > 0) || !SkScalarIsFinite(scale)) {
+        return false;
+    }
+    const int bucket = SkScalarCeilToInt(SkScalarLog2(scale) * kBucketsPerOctave);
+    if (bucket < kMinBucket || bucket > kMaxBucket) {
+        return false;
+    }
+
+    const SkPath::FillType fillType = src.getFillType();
+    QuadPathKey key(src, bucket);
+    if (!CHECK_LOCAL(localCache, find, Find, key, QuadPathRec::Visitor, dst)) {
+        const SkScalar bucketScale = SkScalarPow(2, SkIntToScalar(bucket) / kBucketsPerOctave);
+        conics_to_quads(src, kTolerance / bucketScale, dst);
+        CHECK_LOCAL(localCache, add, Add, new QuadPathRec(key, *dst));
+    }
+    // The fill type need not be part of the generation ID, so take it from src.
+    dst->setFillType(fillType);
+    return true;
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkQuadPathCache_DEFINED
+#define SkQuadPathCache_DEFINED
+
+#include "SkResourceCache.h"
+
+class SkMatrix;
+class SkPath;
+
+class SkQuadPathCache {
+public:
+    /**
+     *  For a path with conics that is drawn again and again (not volatile), set dst to a copy
+     *  of src with each conic replaced by the quads SkEdgeBuilder would otherwise cut it into
+     *  when drawing with matrix, and return true. The copy is kept in the resource cache, keyed
+     *  by the path's generation ID and matrix's scale rounded up to a bucket, so that draws at
+     *  nearby scales share it. Returns false, leaving dst alone, for paths to be drawn as is.
+     */
+    static bool GetQuadPath(const SkPath& src, const SkMatrix& matrix, SkPath* dst,
+                            SkResourceCache* localCache = nullptr);
+
+    // Exposed for tests: the largest distance, in pixels, of the quads from their conics.
+    static const SkScalar kTolerance;
+};
+
+#endif
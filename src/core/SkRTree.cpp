@@ -163,17 +163,29 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
 
 void SkRTree::search(const SkRect& query, SkTDArray<int>* results) const {
     if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
-        this->search(fRoot.fSubtree, query, results);
+        this->search(fRoot.fSubtree, query, results, nullptr);
     }
 }
 
-void SkRTree::search(Node* node, const SkRect& query, SkTDArray<int>* results) const {
+bool SkRTree::searchWithBounds(const SkRect& query, SkTDArray<int>* results,
+                               SkTDArray<SkRect>* bounds) const {
+    if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
+        this->search(fRoot.fSubtree, query, results, bounds);
+    }
+    return true;
+}
+
+void SkRTree::search(Node* node, const SkRect& query, SkTDArray<int>* results,
+                     SkTDArray<SkRect>* bounds) const {
     for (int i = 0; i < node->fNumChildren; ++i) {
         if (SkRect::Intersects(node->fChildren[i].fBounds, query)) {
             if (0 == node->fLevel) {
                 results->push(node->fChildren[i].fOpIndex);
+                if (bounds) {
+                    bounds->push(node->fChildren[i].fBounds);
+                }
             } else {
-                this->search(node->fChildren[i].fSubtree, query, results);
+                this->search(node->fChildren[i].fSubtree, query, results, bounds);
             }
         }
     }
@@ -43,6 +43,8 @@ public:
 
     void insert(const SkRect[], int N) override;
     void search(const SkRect& query, SkTDArray<int>* results) const override;
+    bool searchWithBounds(const SkRect& query, SkTDArray<int>* results,
+                          SkTDArray<SkRect>* bounds) const override;
     size_t bytesUsed() const override;
 
     // Methods and constants below here are only public for tests.
@@ -76,7 +78,8 @@ private:
         Branch fChildren[kMaxChildren];
     };
 
-    void search(Node* root, const SkRect& query, SkTDArray<int>* results) const;
+    void search(Node* root, const SkRect& query, SkTDArray<int>* results,
+                SkTDArray<SkRect>* bounds) const;
 
     // Consumes the input array.
     Branch bulkLoad(SkTDArray<Branch>* branches, int level = 0);
@@ -6,6 +6,7 @@
  */
 
 #include "SkRasterClip.h"
+#include "SkRasterClipCache.h"
 #include "SkPath.h"
 
 SkRasterClip::SkRasterClip(const SkRasterClip& src) {
@@ -166,10 +167,7 @@ bool SkRasterClip::op(const SkRRect& rrect, const SkIRect& bounds, SkRegion::Op
         return this->op(rrect.getBounds(), bounds, op, doAA);
     }
 
-    SkPath path;
-    path.addRRect(rrect);
-
-    return this->op(path, bounds, op, doAA);
+    return SkRasterClipCache::OpRRect(this, rrect, bounds, op, doAA);
 }
 
 bool SkRasterClip::op(const SkPath& path, const SkIRect& bounds, SkRegion::Op op, bool doAA) {
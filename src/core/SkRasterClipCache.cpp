@@ -0,0 +1,135 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkChecksum.h"
+#include "SkPath.h"
+#include "SkRasterClip.h"
+#include "SkRasterClipCache.h"
+#include "SkRRect.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+// Slots for the shapes last clipped to (see seen_before()).
+static const int kSeenCount = 1024;
+
+// An AA clip is named by its runs, which copies and translations of it share, and its bounds.
+// A BW clip that is empty or a rect is named by its bounds alone.
+static bool get_clip_id(const SkRasterClip& clip, uint32_t* id, SkIRect* bounds) {
+    if (clip.isAA()) {
+        *id = clip.aaRgn().uniqueID();
+    } else if (clip.isEmpty() || clip.isRect()) {
+        *id = 0;
+    } else {
+        return false;
+    }
+    *bounds = clip.getBounds();
+    return true;
+}
+
+namespace {
+static unsigned gRasterClipKeyNamespaceLabel;
+
+struct RasterClipKey : public SkResourceCache::Key {
+public:
+    RasterClipKey(uint32_t clipID, const SkIRect& clipBounds, const SkRRect& rrect,
+                  const SkIRect& bounds, SkRegion::Op op)
+        : fClipID(clipID)
+        , fClipBounds(clipBounds)
+        , fRect(rrect.rect())
+        , fBounds(bounds)
+        , fOp(op)
+    {
+        for (int i = 0; i < 4; ++i) {
+            fRadii[i] = rrect.radii((SkRRect::Corner)i);
+        }
+        this->init(&gRasterClipKeyNamespaceLabel, 0,
+                   sizeof(fClipID) + sizeof(fClipBounds) + sizeof(fRect) + sizeof(fRadii) +
+                   sizeof(fBounds) + sizeof(fOp));
+    }
+
+    // Hashes just the rrect, whichever clip it is applied to.
+    uint32_t shapeHash() const {
+        return SkChecksum::Murmur3(&fRect, sizeof(fRect) + sizeof(fRadii));
+    }
+
+    uint32_t fClipID;
+    SkIRect  fClipBounds;
+    SkRect   fRect;
+    SkVector fRadii[4];
+    SkIRect  fBounds;
+    int32_t  fOp;
+};
+
+struct RasterClipRec : public SkResourceCache::Rec {
+    RasterClipRec(const RasterClipKey& key, const SkRasterClip& clip)
+        : fKey(key)
+        , fClip(clip)
+    {}
+
+    RasterClipKey fKey;
+    SkRasterClip  fClip;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + (fClip.isAA() ? fClip.aaRgn().approximateBytesUsed()
+                                             : fClip.bwRgn().writeToMemory(nullptr));
+    }
+    const char* getCategory() const override { return "raster-clip"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const RasterClipRec& rec = static_cast<const RasterClipRec&>(baseRec);
+        SkRasterClip* result = (SkRasterClip*)contextData;
+
+        *result = rec.fClip;
+        return true;
+    }
+};
+} // namespace
+
+// Adding a clip costs more than building it saves when it is never asked for again, as with
+// content that moves from draw to draw. So we only add clips for rrects that have been clipped
+// to before, remembering recent ones by hash. Each hash has two slots, so that two rrects of
+// the same frame that share one don't keep each other out of the cache (and with them every
+// clip nested inside them). Racing threads at worst add or skip one clip.
+static bool seen_before(uint32_t hash) {
+    static uint32_t gSeen[kSeenCount];
+
+    uint32_t* first = &gSeen[hash & (kSeenCount - 1)];
+    uint32_t* second = &gSeen[(hash >> 16) & (kSeenCount - 1)];
+    const uint32_t firstHash = sk_atomic_load(first, sk_memory_order_relaxed);
+    if (firstHash == hash || sk_atomic_load(second, sk_memory_order_relaxed) == hash) {
+        return true;
+    }
+    sk_atomic_store(0 == firstHash ? first : second, hash, sk_memory_order_relaxed);
+    return false;
+}
+
+bool SkRasterClipCache::OpRRect(SkRasterClip* clip, const SkRRect& rrect, const SkIRect& bounds,
+                                SkRegion::Op op, bool doAA, SkResourceCache* localCache) {
+    SkPath path;
+    path.addRRect(rrect);
+
+    // BW rrects are quick to scan convert, and usually leave a complex BW clip behind.
+    uint32_t clipID;
+    SkIRect clipBounds;
+    if (!doAA || clip->isForceConservativeRects() || !get_clip_id(*clip, &clipID, &clipBounds)) {
+        return clip->op(path, bounds, op, doAA);
+    }
+
+    RasterClipKey key(clipID, clipBounds, rrect, bounds, op);
+    if (CHECK_LOCAL(localCache, find, Find, key, RasterClipRec::Visitor, clip)) {
+        return !clip->isEmpty();
+    }
+
+    const bool nonEmpty = clip->op(path, bounds, op, doAA);
+    if (seen_before(key.shapeHash())) {
+        CHECK_LOCAL(localCache, add, Add, new RasterClipRec(key, *clip));
+    }
+    return nonEmpty;
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRasterClipCache_DEFINED
+#define SkRasterClipCache_DEFINED
+
+#include "SkRegion.h"
+#include "SkResourceCache.h"
+
+class SkRasterClip;
+class SkRRect;
+
+class SkRasterClipCache {
+public:
+    /**
+     *  Same as clip->op(rrect, bounds, op, doAA), but for antialiased rrects the resulting clip
+     *  is kept in the resource cache, keyed by the clip it was applied to and by the rrect,
+     *  bounds and op, so that clips that are set up the same way draw after draw (say, nested
+     *  rounded rects) are not scan converted and combined every time. A clip is only added once
+     *  its rrect has been seen before, and complex BW clips, which have no cheap identity, are
+     *  never cached.
+     */
+    static bool OpRRect(SkRasterClip* clip, const SkRRect& rrect, const SkIRect& bounds,
+                        SkRegion::Op op, bool doAA, SkResourceCache* localCache = nullptr);
+};
+
+#endif
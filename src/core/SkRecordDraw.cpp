@@ -30,7 +30,23 @@ void SkRecordDraw(const SkRecord& record,
         }
 
         SkTDArray<int> ops;
-        bbh->search(query, &ops);
+        SkTDArray<SkRect> bounds;
+        if (canvas->getTotalMatrix().isScaleTranslate()) {
+            bbh->search(query, &ops);
+        } else if (bbh->searchWithBounds(query, &ops, &bounds)) {
+            // Under a rotation or skew, query bounds the clip only loosely, so the BBH finds
+            // ops that miss the clip itself.  Cull those in device space, all at once.
+            SkAutoSTMalloc<256, bool> rejected(ops.count());
+            if (canvas->quickReject(bounds.begin(), ops.count(), rejected.get()) > 0) {
+                int kept = 0;
+                for (int i = 0; i < ops.count(); i++) {
+                    if (!rejected[i]) {
+                        ops[kept++] = ops[i];
+                    }
+                }
+                ops.setCount(kept);
+            }
+        }
 
         SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
         for (int i = 0; i < ops.count(); i++) {
@@ -9,7 +9,9 @@
 
 #include "SkAtomics.h"
 #include "SkRegionPriv.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
+#include "SkTSort.h"
 #include "SkUtils.h"
 
 /* Region Layout
@@ -281,14 +283,19 @@ bool SkRegion::setRuns(RunType runs[], int count) {
 
     //  if we get here, we need to become a complex region
 
-    if (!this->isComplex() || fRunHead->fRunCount != count) {
+    // Reuse our runs in place if no one else shares them and they have room,
+    // so that a region built up by repeated op()s doesn't reallocate each time.
+    // Once we do outgrow them, leave some headroom for the next op.
+    if (this->isComplex() && 1 == fRunHead->fRefCnt &&
+            fRunHead->getRunCapacity() >= count && fRunHead->getRunCapacity() <= 2 * count) {
+        fRunHead->fRunCount = count;
+    } else {
+        const bool grow = this->isComplex() && fRunHead->fRunCount < count;
         this->freeRuns();
-        this->allocateRuns(count);
+        fRunHead = RunHead::Alloc(count, grow ? count + (count >> 2) : count);
     }
 
-    // must call this before we can write directly into runs()
-    // in case we are sharing the buffer with another region (copy on write)
-    fRunHead = fRunHead->ensureWritable();
+    SkASSERT(1 == fRunHead->fRefCnt);
     memcpy(fRunHead->writable_runs(), runs, count * sizeof(RunType));
     fRunHead->computeRunBounds(&fBounds);
 
@@ -585,16 +592,105 @@ void SkRegion::translate(int dx, int dy, SkRegion* dst) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+struct RectTopLT {
+    bool operator()(const SkIRect& a, const SkIRect& b) const {
+        return a.fTop < b.fTop;
+    }
+};
+
+/*  Rather than rebuilding the whole region once per rect, sweep down the Y
+    edges of all the rects, keeping the rects that cross the current scanline
+    sorted by their left edge. Each scanline's intervals are then the merge of
+    those rects' [left, right) spans, and a scanline that matches the one above
+    it just extends that one's bottom.
+ */
 bool SkRegion::setRects(const SkIRect rects[], int count) {
-    if (0 == count) {
-        this->setEmpty();
-    } else {
-        this->setRect(rects[0]);
-        for (int i = 1; i < count; i++) {
-            this->op(rects[i], kUnion_Op);
+    SkTDArray<SkIRect> sorted;
+    sorted.setReserve(count);
+    for (int i = 0; i < count; i++) {
+        if (!rects[i].isEmpty()) {
+            *sorted.append() = rects[i];
+        }
+    }
+    if (sorted.count() <= 1) {
+        return sorted.isEmpty() ? this->setEmpty() : this->setRect(sorted[0]);
+    }
+    SkTQSort<SkIRect>(sorted.begin(), sorted.end() - 1, RectTopLT());
+
+    SkTDArray<int32_t> ys;
+    ys.setCount(sorted.count() * 2);
+    for (int i = 0; i < sorted.count(); i++) {
+        ys[2 * i + 0] = sorted[i].fTop;
+        ys[2 * i + 1] = sorted[i].fBottom;
+    }
+    SkTQSort<int32_t>(ys.begin(), ys.end() - 1);
+    int yCount = 1;
+    for (int i = 1; i < ys.count(); i++) {
+        if (ys[i] != ys[yCount - 1]) {
+            ys[yCount++] = ys[i];
         }
     }
-    return !this->isEmpty();
+
+    SkTDArray<RunType> runs;
+    runs.setReserve(yCount * 6);
+    *runs.append() = ys[0];
+
+    SkTDArray<SkIRect> active;
+    int next = 0;
+    int prevStart = -1;
+    for (int i = 0; i < yCount - 1; i++) {
+        const int32_t top = ys[i];
+
+        // drop the rects that ended above this scanline
+        int activeCount = 0;
+        for (int j = 0; j < active.count(); j++) {
+            if (active[j].fBottom > top) {
+                active[activeCount++] = active[j];
+            }
+        }
+        active.setCount(activeCount);
+
+        // insert the rects that start here, keeping active sorted by left
+        for (; next < sorted.count() && sorted[next].fTop == top; next++) {
+            const SkIRect& r = sorted[next];
+            active.append();
+            int j = active.count() - 1;
+            while (j > 0 && active[j - 1].fLeft > r.fLeft) {
+                active[j] = active[j - 1];
+                j -= 1;
+            }
+            active[j] = r;
+        }
+
+        // [Bottom, X-Intervals, [Left, Right]..., X-Sentinel]
+        const int start = runs.count();
+        *runs.append() = ys[i + 1];
+        *runs.append() = 0;
+        int intervals = 0;
+        for (int j = 0; j < active.count();) {
+            RunType* interval = runs.append(2);
+            interval[0] = active[j].fLeft;
+            interval[1] = active[j].fRight;
+            for (j++; j < active.count() && active[j].fLeft <= interval[1]; j++) {
+                interval[1] = SkTMax(interval[1], active[j].fRight);
+            }
+            intervals += 1;
+        }
+        *runs.append() = kRunTypeSentinel;
+        runs[start + 1] = intervals;
+
+        if (prevStart >= 0 && runs[prevStart + 1] == intervals &&
+                !memcmp(&runs[prevStart + 2], &runs[start + 2],
+                        intervals * 2 * sizeof(RunType))) {
+            runs[prevStart] = ys[i + 1];
+            runs.setCount(start);
+        } else {
+            prevStart = start;
+        }
+    }
+    *runs.append() = kRunTypeSentinel;
+
+    return this->setRuns(runs.begin(), runs.count());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -708,6 +804,30 @@ static SkRegion::RunType* operate_on_span(const SkRegion::RunType a_runs[],
                                           const SkRegion::RunType b_runs[],
                                           SkRegion::RunType dst[],
                                           int min, int max) {
+    // If only one side has intervals on this scanline, the result is either a
+    // copy of that side's intervals or nothing, so we can skip the merge. This
+    // is the common case for the scanlines of a complex region that lie above
+    // or below a rect it is combined with.
+    const bool a_empty = SkRegion::kRunTypeSentinel == a_runs[0];
+    const bool b_empty = SkRegion::kRunTypeSentinel == b_runs[0];
+    if (a_empty | b_empty) {
+        const SkRegion::RunType* src = b_runs;
+        int inside = 2;
+        if (b_empty) {
+            src = a_runs;
+            inside = 1;
+        }
+        if ((unsigned)(inside - min) <= (unsigned)(max - min)) {
+            // the interval count sits just before the intervals
+            const int n = src[-1] * 2;
+            SkASSERT(SkRegion::kRunTypeSentinel == src[n]);
+            memcpy(dst, src, n * sizeof(SkRegion::RunType));
+            dst += n;
+        }
+        *dst++ = SkRegion::kRunTypeSentinel;
+        return dst;
+    }
+
     spanRec rec;
     bool    firstInterval = true;
 
@@ -950,18 +1070,31 @@ static int count_to_intervals(int count) {
     Worst case (from a storage perspective), is a vertical stack of single
     intervals:  TOP + N * (BOTTOM INTERVALCOUNT LEFT RIGHT SENTINEL) + SENTINEL
  */
-static int intervals_to_count(int intervals) {
+static int64_t intervals_to_count(int64_t intervals) {
     return 1 + intervals * 5 + 1;
 }
 
-/*  Given the intervalCounts of RunTypes in two regions, return the worst-case number
-    of RunTypes need to store the result after a region-op.
+/*  Given the intervalCounts and Y-span counts of two regions, return the
+    worst-case number of RunTypes need to store the result after a region-op.
  */
-static int compute_worst_case_count(int a_intervals, int b_intervals) {
+static int compute_worst_case_count(int a_intervals, int a_spans,
+                                    int b_intervals, int b_spans) {
     // Our heuristic worst case is ai * (bi + 1) + bi * (ai + 1)
-    int intervals = 2 * a_intervals * b_intervals + a_intervals + b_intervals;
-    // convert back to number of RunType values
-    return intervals_to_count(intervals);
+    int64_t intervals = 2 * (int64_t)a_intervals * b_intervals + a_intervals + b_intervals;
+    int64_t count = intervals_to_count(intervals);
+
+    // That treats every interval as its own scanline, which is far too big for
+    // regions with many intervals per scanline. Those are better bounded by
+    // their scanlines: the result has at most one scanline between each pair of
+    // Y edges of a and b, and a scanline of a can be split by each Y edge of b
+    // (and vice versa), repeating its intervals in every piece.
+    const int64_t spans = a_spans + b_spans + 1;
+    const int64_t pieces = (int64_t)a_intervals * (b_spans + 2) +
+                           (int64_t)b_intervals * (a_spans + 2);
+    count = SkTMin(count, 1 + spans * 3 + pieces * 2 + 1);
+
+    if (!sk_64_isS32(count)) { SK_ABORT("Invalid Size"); }
+    return (int)count;
 }
 
 static bool setEmptyCheck(SkRegion* result) {
@@ -1066,7 +1199,10 @@ bool SkRegion::Oper(const SkRegion& rgnaOrig, const SkRegion& rgnbOrig, Op op,
     const RunType* a_runs = rgna->getRuns(tmpA, &a_intervals);
     const RunType* b_runs = rgnb->getRuns(tmpB, &b_intervals);
 
-    int dstCount = compute_worst_case_count(a_intervals, b_intervals);
+    int a_spans = rgna->isComplex() ? rgna->fRunHead->getYSpanCount() : a_intervals;
+    int b_spans = rgnb->isComplex() ? rgnb->fRunHead->getYSpanCount() : b_intervals;
+
+    int dstCount = compute_worst_case_count(a_intervals, a_spans, b_intervals, b_spans);
     SkAutoSTMalloc<256, RunType> array(dstCount);
 
 #ifdef SK_DEBUG
@@ -1127,6 +1263,58 @@ size_t SkRegion::writeToMemory(void* storage) const {
     return buffer.pos();
 }
 
+/*  Returns true if runs[0..count) are the runs of a complex region with these
+    bounds, Y-span count and interval count. Ops size their scratch space from
+    the counts and copy scanlines by their stored interval counts, so runs read
+    from memory (possibly from another process) must be checked before we use
+    them. The caller has already checked that count is the run count implied by
+    ySpanCount and intervalCount; we never read outside of runs[0..count).
+ */
+static bool validate_runs(const SkRegion::RunType runs[], int count, const SkIRect& bounds,
+                          int ySpanCount, int intervalCount) {
+    // Top, then per Y-span: Bottom, X-Intervals, [Left, Right]..., X-Sentinel, then Y-Sentinel
+    const SkRegion::RunType* const stop = runs + count;
+    if (SkRegion::kRunTypeSentinel != stop[-1]) {
+        return false;
+    }
+
+    SkIRect computed = { SK_MaxS32, 0, SK_MinS32, 0 };
+    int bottom = computed.fTop = *runs++;
+    for (int span = 0; span < ySpanCount; span++) {
+        // bottom, X-intervals, and at least the X-sentinel and the Y-sentinel after it
+        if (stop - runs < 4) {
+            return false;
+        }
+        const int top = bottom;
+        bottom = *runs++;
+        const int intervals = *runs++;
+        if (top >= bottom || bottom >= SkRegion::kRunTypeSentinel ||
+                intervals < 0 || intervals > intervalCount || stop - runs < 2 * intervals + 2) {
+            return false;
+        }
+        intervalCount -= intervals;
+        int prevRite = SK_MinS32;
+        for (int i = 0; i < intervals; i++) {
+            const int left = *runs++;
+            const int rite = *runs++;
+            if (left <= prevRite || left >= rite || rite >= SkRegion::kRunTypeSentinel) {
+                return false;
+            }
+            prevRite = rite;
+        }
+        if (intervals > 0) {
+            computed.fLeft = SkTMin<int>(computed.fLeft, runs[-2 * intervals]);
+            computed.fRight = SkTMax<int>(computed.fRight, prevRite);
+        }
+        if (SkRegion::kRunTypeSentinel != *runs++) {
+            return false;
+        }
+    }
+    computed.fBottom = bottom;
+    // Every interval was accounted for, and we are at the Y-sentinel.
+    return 0 == intervalCount && runs == stop - 1 && computed == bounds;
+}
+
 size_t SkRegion::readFromMemory(const void* storage, size_t length) {
     SkRBufferWithSizeCheck  buffer(storage, length);
     SkRegion                tmp;
@@ -1134,12 +1322,26 @@ size_t SkRegion::readFromMemory(const void* storage, size_t length) {
 
     if (buffer.readS32(&count) && (count >= 0) && buffer.read(&tmp.fBounds, sizeof(tmp.fBounds))) {
         if (count == 0) {
+            if (tmp.fBounds.isEmpty()) {
+                return 0;
+            }
             tmp.fRunHead = SkRegion_gRectRunHeadPtr;
         } else {
             int32_t ySpanCount, intervalCount;
             if (buffer.readS32(&ySpanCount) && buffer.readS32(&intervalCount)) {
+                // Check the counts agree, and that the runs fit in what is left of the buffer,
+                // before trusting them with an allocation.
+                if (ySpanCount < 1 || intervalCount < 1 ||
+                        (int64_t)count != 2 + 3 * (int64_t)ySpanCount + 2 * (int64_t)intervalCount ||
+                        (size_t)count > (length - buffer.pos()) / sizeof(RunType)) {
+                    return 0;
+                }
                 tmp.allocateRuns(count, ySpanCount, intervalCount);
-                buffer.read(tmp.fRunHead->writable_runs(), count * sizeof(RunType));
+                if (buffer.read(tmp.fRunHead->writable_runs(), count * sizeof(RunType)) &&
+                        !validate_runs(tmp.fRunHead->readonly_runs(), count, tmp.fBounds,
+                                       ySpanCount, intervalCount)) {
+                    return 0;
+                }
             }
         }
     }
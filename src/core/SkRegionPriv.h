@@ -59,18 +59,33 @@ public:
         return fIntervalCount;
     }
 
+    /**
+     *  Number of RunTypes this head has room for. This is at least fRunCount,
+     *  and may be more when a region was grown in place by op().
+     */
+    int getRunCapacity() const {
+        return fRunCapacity;
+    }
+
     static RunHead* Alloc(int count) {
+        return Alloc(count, count);
+    }
+
+    // Allocate room for capacity runs, of which the first count are in use.
+    static RunHead* Alloc(int count, int capacity) {
         //SkDEBUGCODE(sk_atomic_inc(&gRgnAllocCounter);)
         //SkDEBUGF(("************** gRgnAllocCounter::alloc %d\n", gRgnAllocCounter));
 
         SkASSERT(count >= SkRegion::kRectRegionRuns);
+        SkASSERT(capacity >= count);
 
-        const int64_t size = sk_64_mul(count, sizeof(RunType)) + sizeof(RunHead);
+        const int64_t size = sk_64_mul(capacity, sizeof(RunType)) + sizeof(RunHead);
         if (count < 0 || !sk_64_isS32(size)) { SK_ABORT("Invalid Size"); }
 
         RunHead* head = (RunHead*)sk_malloc_throw(size);
         head->fRefCnt = 1;
         head->fRunCount = count;
+        head->fRunCapacity = capacity;
         // these must be filled in later, otherwise we will be invalid
         head->fYSpanCount = 0;
         head->fIntervalCount = 0;
@@ -231,6 +246,7 @@ public:
 private:
     int32_t fYSpanCount;
     int32_t fIntervalCount;
+    int32_t fRunCapacity;
 };
 
 #endif
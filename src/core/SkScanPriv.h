@@ -33,6 +33,12 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
                   const SkRegion& clipRgn);
 
+#ifdef SK_DEBUG
+// Edge lists at least this long are radix sorted, shorter ones are sorted with SkTQSort.
+// Tests change it to compare the two.
+extern int gMinRadixSortEdges;
+#endif
+
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
 void sk_blit_below(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
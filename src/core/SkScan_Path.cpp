@@ -36,87 +36,16 @@
     #define validate_sort(edge)
 #endif
 
-static inline void remove_edge(SkEdge* edge) {
-    edge->fPrev->fNext = edge->fNext;
-    edge->fNext->fPrev = edge->fPrev;
-}
-
-static inline void insert_edge_after(SkEdge* edge, SkEdge* afterMe) {
-    edge->fPrev = afterMe;
-    edge->fNext = afterMe->fNext;
-    afterMe->fNext->fPrev = edge;
-    afterMe->fNext = edge;
-}
-
-static void backward_insert_edge_based_on_x(SkEdge* edge SkDECLAREPARAM(int, curr_y)) {
-    SkFixed x = edge->fX;
-
-    SkEdge* prev = edge->fPrev;
-    while (prev->fX > x) {
-        prev = prev->fPrev;
-    }
-    if (prev->fNext != edge) {
-        remove_edge(edge);
-        insert_edge_after(edge, prev);
-    }
-}
-
-// Start from the right side, searching backwards for the point to begin the new edge list
-// insertion, marching forwards from here. The implementation could have started from the left
-// of the prior insertion, and search to the right, or with some additional caching, binary
-// search the starting point. More work could be done to determine optimal new edge insertion.
-static SkEdge* backward_insert_start(SkEdge* prev, SkFixed x) {
-    while (prev->fX > x) {
-        prev = prev->fPrev;
-    }
-    return prev;
-}
-
-static void insert_new_edges(SkEdge* newEdge, int curr_y) {
-    if (newEdge->fFirstY != curr_y) {
-        return;
-    }
-    SkEdge* prev = newEdge->fPrev;
-    if (prev->fX <= newEdge->fX) {
-        return;
-    }
-    // find first x pos to insert
-    SkEdge* start = backward_insert_start(prev, newEdge->fX);
-    // insert the lot, fixing up the links as we go
-    do {
-        SkEdge* next = newEdge->fNext;
-        do {
-            if (start->fNext == newEdge) {
-                goto nextEdge;
-            }
-            SkEdge* after = start->fNext;
-            if (after->fX >= newEdge->fX) {
-                break;
-            }
-            start = after;
-        } while (true);
-        remove_edge(newEdge);
-        insert_edge_after(newEdge, start);
-nextEdge:
-        start = newEdge;
-        newEdge = next;
-    } while (newEdge->fFirstY == curr_y);
-}
-
 #ifdef SK_DEBUG
-static void validate_edges_for_y(const SkEdge* edge, int curr_y) {
-    while (edge->fFirstY <= curr_y) {
-        SkASSERT(edge->fPrev && edge->fNext);
-        SkASSERT(edge->fPrev->fNext == edge);
-        SkASSERT(edge->fNext->fPrev == edge);
-        SkASSERT(edge->fFirstY <= edge->fLastY);
-
-        SkASSERT(edge->fPrev->fX <= edge->fX);
-        edge = edge->fNext;
+static void validate_edges_for_y(SkEdge* const active[], int count, int curr_y) {
+    for (int i = 0; i < count; ++i) {
+        SkASSERT(active[i]->fFirstY <= curr_y);
+        SkASSERT(active[i]->fFirstY <= active[i]->fLastY);
+        SkASSERT(i == 0 || active[i - 1]->fX <= active[i]->fX);
     }
 }
 #else
-    #define validate_edges_for_y(edge, curr_y)
+    #define validate_edges_for_y(active, count, curr_y)
 #endif
 
 #if defined _WIN32 && _MSC_VER >= 1300  // disable warning : local variable used without having been initialized
@@ -128,10 +57,25 @@ typedef void (*PrePostProc)(SkBlitter* blitter, int y, bool isStartOfScanline);
 #define PREPOST_START   true
 #define PREPOST_END     false
 
-static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
+/*
+ *  The edges crossing the current scanline are kept in an array, sorted by x. An edge that
+ *  crosses its neighbors is rippled back into place as it steps, and each scanline's new edges
+ *  (list[] is sorted by fFirstY, then fX) are merged in: the first after every active edge at
+ *  or left of it, the rest only after the active edges strictly left of them.
+ */
+static void walk_edges(SkEdge* list[], int count, SkPath::FillType fillType,
                        SkBlitter* blitter, int start_y, int stop_y,
                        PrePostProc proc, int rightClip) {
-    validate_sort(prevHead->fNext);
+    // the active edges, and room to merge new ones into them
+    SkAutoSTMalloc<128, SkEdge*> storage(2 * count);
+    SkEdge** active = storage.get();
+    SkEdge** merged = active + count;
+    int activeCount = 0;
+    int next = 0;   // index in list of the first edge not yet active
+
+    while (next < count && list[next]->fFirstY <= start_y) {
+        active[activeCount++] = list[next++];
+    }
 
     int curr_y = start_y;
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
@@ -141,16 +85,17 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
         int     w = 0;
         int     left SK_INIT_TO_AVOID_WARNING;
         bool    in_interval = false;
-        SkEdge* currE = prevHead->fNext;
-        SkFixed prevX = prevHead->fX;
+        SkFixed prevX = SK_MinS32;
+        int     kept = 0;
 
-        validate_edges_for_y(currE, curr_y);
+        validate_edges_for_y(active, activeCount, curr_y);
 
         if (proc) {
             proc(blitter, curr_y, PREPOST_START);    // pre-proc
         }
 
-        while (currE->fFirstY <= curr_y) {
+        for (int i = 0; i < activeCount; ++i) {
+            SkEdge* currE = active[i];
             SkASSERT(currE->fLastY >= curr_y);
 
             int x = SkFixedRoundToInt(currE->fX);
@@ -167,7 +112,6 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
                 in_interval = true;
             }
 
-            SkEdge* next = currE->fNext;
             SkFixed newX;
 
             if (currE->fLastY == curr_y) {    // are we done with this edge?
@@ -184,21 +128,27 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
                         goto NEXT_X;
                     }
                 }
-                remove_edge(currE);
+                continue;   // drop it from the active edges
             } else {
                 SkASSERT(currE->fLastY > curr_y);
                 newX = currE->fX + currE->fDX;
                 currE->fX = newX;
-            NEXT_X:
-                if (newX < prevX) { // ripple currE backwards until it is x-sorted
-                    backward_insert_edge_based_on_x(currE  SkPARAM(curr_y));
-                } else {
-                    prevX = newX;
+            }
+        NEXT_X:
+            if (newX < prevX) { // ripple currE backwards until it is x-sorted
+                int j = kept;
+                while (j > 0 && active[j - 1]->fX > newX) {
+                    active[j] = active[j - 1];
+                    j -= 1;
                 }
+                active[j] = currE;
+            } else {
+                prevX = newX;
+                active[kept] = currE;
             }
-            currE = next;
-            SkASSERT(currE);
+            kept += 1;
         }
+        activeCount = kept;
 
         // was our right-edge culled away?
         if (in_interval) {
@@ -216,8 +166,28 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
         if (curr_y >= stop_y) {
             break;
         }
-        // now currE points to the first edge with a Yint larger than curr_y
-        insert_new_edges(currE, curr_y);
+
+        // merge in the edges that start on the new scanline
+        if (next < count && list[next]->fFirstY == curr_y) {
+            int n = 0, a = 0;
+            SkFixed x = list[next]->fX;
+            while (a < activeCount && active[a]->fX <= x) {
+                merged[n++] = active[a++];
+            }
+            merged[n++] = list[next++];
+            while (next < count && list[next]->fFirstY == curr_y) {
+                x = list[next]->fX;
+                while (a < activeCount && active[a]->fX < x) {
+                    merged[n++] = active[a++];
+                }
+                merged[n++] = list[next++];
+            }
+            while (a < activeCount) {
+                merged[n++] = active[a++];
+            }
+            SkTSwap(active, merged);
+            activeCount = n;
+        }
     }
 }
 
@@ -408,8 +378,77 @@ static bool operator<(const SkEdge& a, const SkEdge& b) {
     return valuea < valueb;
 }
 
+// Fewer edges than this are quicker to sort by comparing them.
+static const int kMinRadixSortEdges = 64;
+
+#ifdef SK_DEBUG
+int gMinRadixSortEdges = kMinRadixSortEdges;
+#endif
+
+// Sorts edges by fFirstY, then fX, with an LSD radix sort of both packed into one key, which
+// beats comparing them through their pointers once there are more than a few. It is stable, so
+// edges that tie stay in the order they were built.
+static void radix_sort_edges(SkEdge* list[], int count) {
+    struct Entry {
+        uint64_t    fKey;
+        SkEdge*     fEdge;
+    };
+    SkAutoSTMalloc<2 * kMinRadixSortEdges, Entry> storage(2 * count);
+    Entry* src = storage.get();
+    Entry* dst = src + count;
+
+    // Flipping the sign bits makes signed order unsigned order.
+    uint32_t counts[8][256];
+    sk_bzero(counts, sizeof(counts));
+    for (int i = 0; i < count; ++i) {
+        const uint64_t key = (uint64_t)((uint32_t)list[i]->fFirstY ^ 0x80000000) << 32 |
+                             ((uint32_t)list[i]->fX ^ 0x80000000);
+        src[i].fKey = key;
+        src[i].fEdge = list[i];
+        for (int digit = 0; digit < 8; ++digit) {
+            counts[digit][(key >> (digit * 8)) & 0xFF] += 1;
+        }
+    }
+
+    for (int digit = 0; digit < 8; ++digit) {
+        const int shift = digit * 8;
+        uint32_t* offsets = counts[digit];
+        // skip digits every edge shares, like the high bytes of fFirstY
+        if (offsets[(src[0].fKey >> shift) & 0xFF] == (uint32_t)count) {
+            continue;
+        }
+        uint32_t offset = 0;
+        for (int i = 0; i < 256; ++i) {
+            const uint32_t n = offsets[i];
+            offsets[i] = offset;
+            offset += n;
+        }
+        for (int i = 0; i < count; ++i) {
+            dst[offsets[(src[i].fKey >> shift) & 0xFF]++] = src[i];
+        }
+        SkTSwap(src, dst);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        list[i] = src[i].fEdge;
+    }
+}
+
+static void sort_edges(SkEdge* list[], int count) {
+#ifdef SK_DEBUG
+    const int minRadixSortEdges = gMinRadixSortEdges;
+#else
+    const int minRadixSortEdges = kMinRadixSortEdges;
+#endif
+    if (count < minRadixSortEdges) {
+        SkTQSort(list, list + count - 1);
+    } else {
+        radix_sort_edges(list, count);
+    }
+}
+
 static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
-    SkTQSort(list, list + count - 1);
+    sort_edges(list, count);
 
     // now make the edges linked in sorted order
     for (int i = 1; i < count; i++) {
@@ -465,23 +504,6 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
         return;
     }
 
-    SkEdge headEdge, tailEdge, *last;
-    // this returns the first and last edge after they're sorted into a dlink list
-    SkEdge* edge = sort_edges(list, count, &last);
-
-    headEdge.fPrev = nullptr;
-    headEdge.fNext = edge;
-    headEdge.fFirstY = kEDGE_HEAD_Y;
-    headEdge.fX = SK_MinS32;
-    edge->fPrev = &headEdge;
-
-    tailEdge.fPrev = last;
-    tailEdge.fNext = nullptr;
-    tailEdge.fFirstY = kEDGE_TAIL_Y;
-    last->fNext = &tailEdge;
-
-    // now edge is the head of the sorted linklist
-
     start_y = SkLeftShift(start_y, shiftEdgesUp);
     stop_y = SkLeftShift(stop_y, shiftEdgesUp);
     if (clipRect && start_y < clipRect->fTop) {
@@ -502,6 +524,23 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
 
     if (path.isConvex() && (nullptr == proc)) {
         SkASSERT(count >= 2);   // convex walker does not handle missing right edges
+
+        SkEdge headEdge, tailEdge, *last;
+        // this returns the first and last edge after they're sorted into a dlink list
+        SkEdge* edge = sort_edges(list, count, &last);
+
+        headEdge.fPrev = nullptr;
+        headEdge.fNext = edge;
+        headEdge.fFirstY = kEDGE_HEAD_Y;
+        headEdge.fX = SK_MinS32;
+        edge->fPrev = &headEdge;
+
+        tailEdge.fPrev = last;
+        tailEdge.fNext = nullptr;
+        tailEdge.fFirstY = kEDGE_TAIL_Y;
+        last->fNext = &tailEdge;
+
+        // now edge is the head of the sorted linklist
         walk_convex_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, nullptr);
     } else {
         int rightEdge;
@@ -510,8 +549,9 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
         } else {
             rightEdge = SkScalarRoundToInt(path.getBounds().right()) << shiftEdgesUp;
         }
-        
-        walk_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, proc, rightEdge);
+
+        sort_edges(list, count);
+        walk_edges(list, count, path.getFillType(), blitter, start_y, stop_y, proc, rightEdge);
     }
 }
 
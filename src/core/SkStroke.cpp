@@ -74,6 +74,22 @@ static bool set_normal_unitnormal(const SkVector& vec,
     return true;
 }
 
+// The unit normals set_normal_unitnormal() finds for the lines pts[0]..pts[count]. Lines that are
+// too short (or too long) to normalize in floats get a zero normal. This sticks to the scalar
+// setNormalize(), since Sk4f's divide and sqrt are only estimates on some CPUs (ARMv7 NEON), and
+// the polyline route must match the generic one exactly.
+static void set_unit_normals(const SkPoint pts[], int count, SkScalar scale,
+                             SkVector unitNormals[]) {
+    for (int i = 0; i < count; i++) {
+        if (unitNormals[i].setNormalize((pts[i + 1].fX - pts[i].fX) * scale,
+                                        (pts[i + 1].fY - pts[i].fY) * scale)) {
+            unitNormals[i].rotateCCW();
+        } else {
+            unitNormals[i].set(0, 0);
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct SkQuadConstruct {    // The state of the quad stroke under construction.
@@ -131,6 +147,7 @@ public:
     void conicTo(const SkPoint&, const SkPoint&, SkScalar weight);
     void cubicTo(const SkPoint&, const SkPoint&, const SkPoint&);
     void close(bool isLine) { this->finishContour(true, isLine); }
+    bool strokePolyline(const SkPath& src);
 
     void done(SkPath* dst, bool isLine) {
         this->finishContour(false, isLine);
@@ -159,10 +176,15 @@ private:
 
     SkStrokerPriv::CapProc  fCapper;
     SkStrokerPriv::JoinProc fJoiner;
+    SkStrokerPriv::EdgeJoinProc fEdgeJoiner;
 
     SkPath  fInner, fOuter; // outer is our working answer, inner is temp
     SkPath  fExtra;         // added as extra complete contours
 
+    // what a run of lines adds to fOuter and fInner, and the lines' unit normals
+    SkStrokeEdge        fOuterEdge, fInnerEdge;
+    SkTDArray<SkVector> fUnitNormals;
+
     enum StrokeType {
         kOuter_StrokeType = 1,      // use sign-opposite values later to flip perpendicular axis
         kInner_StrokeType = -1
@@ -239,6 +261,8 @@ private:
                        const SkVector& unitNormal);
 
     void    line_to(const SkPoint& currPt, const SkVector& normal);
+    void    lineRun(const SkPoint pts[], int count, bool closeHasTangent);
+    static void AppendEdge(SkPath* path, SkStrokeEdge* edge);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -339,6 +363,7 @@ SkPathStroker::SkPathStroker(const SkPath& src,
     }
     fCapper = SkStrokerPriv::CapFactory(cap);
     fJoiner = SkStrokerPriv::JoinFactory(join);
+    fEdgeJoiner = SkStrokerPriv::EdgeJoinFactory(join);
     fSegmentCount = -1;
     fPrevIsLine = false;
 
@@ -422,6 +447,196 @@ void SkPathStroker::lineTo(const SkPoint& currPt, const SkPath::Iter* iter) {
     this->postJoinTo(currPt, normal, unitNormal);
 }
 
+// has_valid_tangent() for the line ending at pts[index], in a run of lines pts[0]..pts[count].
+static bool run_has_valid_tangent(const SkPoint pts[], int index, int count,
+                                  bool closeHasTangent) {
+    for (int i = index + 1; i <= count; ++i) {
+        if (pts[i] != pts[i - 1]) {
+            return true;
+        }
+    }
+    return closeHasTangent;
+}
+
+/*  Strokes a path made only of lines, making the same calls on this stroker that strokePath()
+    would, except that each run of lines is stroked by lineRun(). Returns whether the last
+    segment strokePath() would have seen is a line.
+*/
+bool SkPathStroker::strokePolyline(const SkPath& src) {
+    const SkPathRef& ref = *src.fPathRef;
+    const SkPoint* pts = ref.points();
+    const int verbCount = ref.countVerbs();
+    const bool buttCap = SkStrokerPriv::CapFactory(SkPaint::kButt_Cap) == fCapper;
+    // the contour's start and the last point seen, as SkPath::Iter tracks them
+    SkPoint moveToPt = { 0, 0 };
+    SkPoint lastPt = { 0, 0 };
+    bool lastIsLine = false;
+    int ptIndex = 0;
+
+    int verb = 0;
+    while (verb < verbCount) {
+        switch (ref.atVerb(verb)) {
+            case SkPath::kMove_Verb:
+                if (verb == verbCount - 1) {  // a trailing moveTo
+                    return lastIsLine;
+                }
+                moveToPt = lastPt = pts[ptIndex++];
+                this->moveTo(moveToPt);
+                verb += 1;
+                break;
+            case SkPath::kLine_Verb: {
+                SkASSERT(ptIndex > 0);
+                int count = 1;
+                while (verb + count < verbCount &&
+                       SkPath::kLine_Verb == ref.atVerb(verb + count)) {
+                    ++count;
+                }
+                verb += count;
+                const SkPoint* run = pts + ptIndex - 1;
+                const bool closeHasTangent = verb < verbCount &&
+                        SkPath::kClose_Verb == ref.atVerb(verb) && run[count] != moveToPt &&
+                        !SkScalarIsNaN(run[count].fX) && !SkScalarIsNaN(run[count].fY) &&
+                        !SkScalarIsNaN(moveToPt.fX) && !SkScalarIsNaN(moveToPt.fY);
+                this->lineRun(run, count, closeHasTangent);
+                ptIndex += count;
+                lastPt = run[count];
+                lastIsLine = true;
+                break;
+            }
+            case SkPath::kClose_Verb:
+                verb += 1;
+                // SkPath::Iter closes the contour with a line, if it isn't already closed
+                if (lastPt != moveToPt &&
+                        !SkScalarIsNaN(lastPt.fX) && !SkScalarIsNaN(lastPt.fY) &&
+                        !SkScalarIsNaN(moveToPt.fX) && !SkScalarIsNaN(moveToPt.fY)) {
+                    this->lineTo(moveToPt);
+                    lastIsLine = true;
+                }
+                lastPt = moveToPt;
+                if (!buttCap) {
+                    if (this->hasOnlyMoveTo()) {
+                        this->lineTo(this->moveToPt());
+                        lastIsLine = true;
+                        break;
+                    }
+                    if (this->isZeroLength()) {
+                        lastIsLine = true;
+                        break;
+                    }
+                }
+                this->close(lastIsLine);
+                break;
+            default:
+                SkDEBUGFAIL("only lines expected");
+                return lastIsLine;
+        }
+    }
+    return lastIsLine;
+}
+
+/*  Does what lineTo() does for each of the lines pts[0]..pts[count], but with their normals
+    computed up front, and what they add to fOuter and fInner collected in fOuterEdge and
+    fInnerEdge, to be appended once the run is done.
+*/
+void SkPathStroker::lineRun(const SkPoint pts[], int count, bool closeHasTangent) {
+    if (fSegmentCount < 0) {  // lines without a moveTo
+        for (int i = 1; i <= count; ++i) {
+            this->lineTo(pts[i]);
+        }
+        return;
+    }
+
+    fUnitNormals.setCount(count);
+    set_unit_normals(pts, count, fResScale, fUnitNormals.begin());
+    const bool buttCap = SkStrokerPriv::CapFactory(SkPaint::kButt_Cap) == fCapper;
+
+    for (int i = 1; i <= count; ++i) {
+        const SkPoint& currPt = pts[i];
+        if (buttCap && fPrevPt.equalsWithinTolerance(currPt, SK_ScalarNearlyZero * fInvResScale)) {
+            continue;
+        }
+        if (fPrevPt == currPt &&
+                (fJoinCompleted || run_has_valid_tangent(pts, i, count, closeHasTangent))) {
+            continue;
+        }
+
+        SkVector normal, unitNormal;
+        const SkVector& precomputed = fUnitNormals[i - 1];
+        // The precomputed normal is good if the last line kept ended at this one's start.
+        if (!precomputed.isZero() && !memcmp(&fPrevPt, &pts[i - 1], sizeof(SkPoint))) {
+            unitNormal = precomputed;
+            unitNormal.scale(fRadius, &normal);
+        } else if (!set_normal_unitnormal(fPrevPt, currPt, fResScale, fRadius,
+                                          &normal, &unitNormal)) {
+            if (buttCap) {
+                continue;
+            }
+            normal.set(fRadius, 0);
+            unitNormal.set(1, 0);
+        }
+
+        if (fSegmentCount == 0) {
+            fFirstNormal = normal;
+            fFirstUnitNormal = unitNormal;
+            fFirstOuterPt.set(fPrevPt.fX + normal.fX, fPrevPt.fY + normal.fY);
+
+            AppendEdge(&fOuter, &fOuterEdge);
+            AppendEdge(&fInner, &fInnerEdge);
+            fOuter.moveTo(fFirstOuterPt.fX, fFirstOuterPt.fY);
+            fInner.moveTo(fPrevPt.fX - normal.fX, fPrevPt.fY - normal.fY);
+        } else {
+            fEdgeJoiner(&fOuterEdge, &fInnerEdge, fPrevUnitNormal, fPrevPt, unitNormal,
+                        fRadius, fInvMiterLimit, fPrevIsLine, true);
+        }
+        fPrevIsLine = true;
+
+        fOuterEdge.lineTo(currPt.fX + normal.fX, currPt.fY + normal.fY);
+        fInnerEdge.lineTo(currPt.fX - normal.fX, currPt.fY - normal.fY);
+        this->postJoinTo(currPt, normal, unitNormal);
+    }
+    AppendEdge(&fOuter, &fOuterEdge);
+    AppendEdge(&fInner, &fInnerEdge);
+}
+
+// Appends the edge's verbs to the path a run of same verbs at a time, then empties the edge.
+void SkPathStroker::AppendEdge(SkPath* path, SkStrokeEdge* edge) {
+    const int verbCount = edge->fVerbs.count();
+    if (0 == verbCount) {
+        return;
+    }
+    // every contour's first line starts with a moveTo on both edges
+    SkASSERT(path->fLastMoveToIndex >= 0);
+
+    SkPathRef::Editor ed(&path->fPathRef, verbCount, edge->fPts.count());
+    const uint8_t* verbs = edge->fVerbs.begin();
+    const SkPoint* pts = edge->fPts.begin();
+    const SkScalar* weights = edge->fWeights.begin();
+    int i = 0;
+    while (i < verbCount) {
+        const uint8_t verb = verbs[i];
+        int count = 1;
+        while (i + count < verbCount && verb == verbs[i + count]) {
+            ++count;
+        }
+        SkScalar* dstWeights = nullptr;
+        SkPoint* dst = ed.growForRepeatedVerb(verb, count, &dstWeights);
+        if (SkPath::kConic_Verb == verb) {
+            memcpy(dst, pts, 2 * count * sizeof(SkPoint));
+            memcpy(dstWeights, weights, count * sizeof(SkScalar));
+            pts += 2 * count;
+            weights += count;
+        } else {
+            SkASSERT(SkPath::kLine_Verb == verb);
+            memcpy(dst, pts, count * sizeof(SkPoint));
+            pts += count;
+        }
+        i += count;
+    }
+    path->fConvexity = SkPath::kUnknown_Convexity;
+    path->fFirstDirection = SkPathPriv::kUnknown_FirstDirection;
+    edge->rewind();
+}
+
 void SkPathStroker::setQuadEndNormal(const SkPoint quad[3], const SkVector& normalAB,
         const SkVector& unitNormalAB, SkVector* normalBC, SkVector* unitNormalBC) {
     if (!set_normal_unitnormal(quad[1], quad[2], fResScale, fRadius, normalBC, unitNormalBC)) {
@@ -1371,58 +1586,67 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
     }
 
     SkPathStroker   stroker(src, radius, fMiterLimit, this->getCap(), this->getJoin(), fResScale);
-    SkPath::Iter    iter(src, false);
-    SkPath::Verb    lastSegment = SkPath::kMove_Verb;
+    bool            lastIsLine;
 
-    for (;;) {
-        SkPoint  pts[4];
-        switch (iter.next(pts, false)) {
-            case SkPath::kMove_Verb:
-                stroker.moveTo(pts[0]);
-                break;
-            case SkPath::kLine_Verb:
-                stroker.lineTo(pts[1], &iter);
-                lastSegment = SkPath::kLine_Verb;
-                break;
-            case SkPath::kQuad_Verb:
-                stroker.quadTo(pts[1], pts[2]);
-                lastSegment = SkPath::kQuad_Verb;
-                break;
-            case SkPath::kConic_Verb: {
-                stroker.conicTo(pts[1], pts[2], iter.conicWeight());
-                lastSegment = SkPath::kConic_Verb;
-                break;
-            } break;
-            case SkPath::kCubic_Verb:
-                stroker.cubicTo(pts[1], pts[2], pts[3]);
-                lastSegment = SkPath::kCubic_Verb;
-                break;
-            case SkPath::kClose_Verb:
-                if (SkPaint::kButt_Cap != this->getCap()) {
-                    /* If the stroke consists of a moveTo followed by a close, treat it
-                       as if it were followed by a zero-length line. Lines without length
-                       can have square and round end caps. */
-                    if (stroker.hasOnlyMoveTo()) {
-                        stroker.lineTo(stroker.moveToPt());
-                        goto ZERO_LENGTH;
-                    }
-                    /* If the stroke consists of a moveTo followed by one or more zero-length
-                       verbs, then followed by a close, treat is as if it were followed by a
-                       zero-length line. Lines without length can have square & round end caps. */
-                    if (stroker.isZeroLength()) {
-                ZERO_LENGTH:
-                        lastSegment = SkPath::kLine_Verb;
-                        break;
+    // Paths of only lines, like polylines, take a faster route to the same stroke.
+    if (SkPath::kLine_SegmentMask == src.getSegmentMasks()) {
+        lastIsLine = stroker.strokePolyline(src);
+    } else {
+        SkPath::Iter    iter(src, false);
+        SkPath::Verb    lastSegment = SkPath::kMove_Verb;
+
+        for (;;) {
+            SkPoint  pts[4];
+            switch (iter.next(pts, false)) {
+                case SkPath::kMove_Verb:
+                    stroker.moveTo(pts[0]);
+                    break;
+                case SkPath::kLine_Verb:
+                    stroker.lineTo(pts[1], &iter);
+                    lastSegment = SkPath::kLine_Verb;
+                    break;
+                case SkPath::kQuad_Verb:
+                    stroker.quadTo(pts[1], pts[2]);
+                    lastSegment = SkPath::kQuad_Verb;
+                    break;
+                case SkPath::kConic_Verb: {
+                    stroker.conicTo(pts[1], pts[2], iter.conicWeight());
+                    lastSegment = SkPath::kConic_Verb;
+                    break;
+                } break;
+                case SkPath::kCubic_Verb:
+                    stroker.cubicTo(pts[1], pts[2], pts[3]);
+                    lastSegment = SkPath::kCubic_Verb;
+                    break;
+                case SkPath::kClose_Verb:
+                    if (SkPaint::kButt_Cap != this->getCap()) {
+                        /* If the stroke consists of a moveTo followed by a close, treat it
+                           as if it were followed by a zero-length line. Lines without length
+                           can have square and round end caps. */
+                        if (stroker.hasOnlyMoveTo()) {
+                            stroker.lineTo(stroker.moveToPt());
+                            goto ZERO_LENGTH;
+                        }
+                        /* If the stroke consists of a moveTo followed by one or more
+                           zero-length verbs, then followed by a close, treat is as if it were
+                           followed by a zero-length line. Lines without length can have square
+                           & round end caps. */
+                        if (stroker.isZeroLength()) {
+                    ZERO_LENGTH:
+                            lastSegment = SkPath::kLine_Verb;
+                            break;
+                        }
                     }
-                }
-                stroker.close(lastSegment == SkPath::kLine_Verb);
-                break;
-            case SkPath::kDone_Verb:
-                goto DONE;
+                    stroker.close(lastSegment == SkPath::kLine_Verb);
+                    break;
+                case SkPath::kDone_Verb:
+                    goto DONE;
+            }
         }
+    DONE:
+        lastIsLine = lastSegment == SkPath::kLine_Verb;
     }
-DONE:
-    stroker.done(dst, lastSegment == SkPath::kLine_Verb);
+    stroker.done(dst, lastIsLine);
 
     if (fDoFill) {
         if (SkPathPriv::CheapIsFirstDirection(src, SkPathPriv::kCCW_FirstDirection)) {
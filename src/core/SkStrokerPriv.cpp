@@ -76,7 +76,8 @@ static AngleType Dot2AngleType(SkScalar dot)
         return SkScalarNearlyZero(SK_Scalar1 + dot) ? kNearly180_AngleType : kSharp_AngleType;
 }
 
-static void HandleInnerJoin(SkPath* inner, const SkPoint& pivot, const SkVector& after)
+template <typename Edge>
+static void HandleInnerJoin(Edge* inner, const SkPoint& pivot, const SkVector& after)
 {
 #if 1
     /*  In the degenerate case that the stroke radius is larger than our segments
@@ -91,7 +92,8 @@ static void HandleInnerJoin(SkPath* inner, const SkPoint& pivot, const SkVector&
     inner->lineTo(pivot.fX - after.fX, pivot.fY - after.fY);
 }
 
-static void BluntJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Edge>
+static void BluntJoiner(Edge* outer, Edge* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit, bool, bool)
 {
@@ -100,7 +102,7 @@ static void BluntJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
 
     if (!is_clockwise(beforeUnitNormal, afterUnitNormal))
     {
-        SkTSwap<SkPath*>(outer, inner);
+        SkTSwap<Edge*>(outer, inner);
         after.negate();
     }
 
@@ -108,7 +110,8 @@ static void BluntJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
     HandleInnerJoin(inner, pivot, after);
 }
 
-static void RoundJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Edge>
+static void RoundJoiner(Edge* outer, Edge* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit, bool, bool)
 {
@@ -124,7 +127,7 @@ static void RoundJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
 
     if (!is_clockwise(before, after))
     {
-        SkTSwap<SkPath*>(outer, inner);
+        SkTSwap<Edge*>(outer, inner);
         before.negate();
         after.negate();
         dir = kCCW_SkRotationDirection;
@@ -146,7 +149,8 @@ static void RoundJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
 
 #define kOneOverSqrt2   (0.707106781f)
 
-static void MiterJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Edge>
+static void MiterJoiner(Edge* outer, Edge* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit,
                         bool prevIsLine, bool currIsLine)
@@ -171,7 +175,7 @@ static void MiterJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
     ccw = !is_clockwise(before, after);
     if (ccw)
     {
-        SkTSwap<SkPath*>(outer, inner);
+        SkTSwap<Edge*>(outer, inner);
         before.negate();
         after.negate();
     }
@@ -243,7 +247,17 @@ SkStrokerPriv::CapProc SkStrokerPriv::CapFactory(SkPaint::Cap cap)
 SkStrokerPriv::JoinProc SkStrokerPriv::JoinFactory(SkPaint::Join join)
 {
     static const SkStrokerPriv::JoinProc gJoiners[] = {
-        MiterJoiner, RoundJoiner, BluntJoiner
+        MiterJoiner<SkPath>, RoundJoiner<SkPath>, BluntJoiner<SkPath>
+    };
+
+    SkASSERT((unsigned)join < SkPaint::kJoinCount);
+    return gJoiners[join];
+}
+
+SkStrokerPriv::EdgeJoinProc SkStrokerPriv::EdgeJoinFactory(SkPaint::Join join)
+{
+    static const SkStrokerPriv::EdgeJoinProc gJoiners[] = {
+        MiterJoiner<SkStrokeEdge>, RoundJoiner<SkStrokeEdge>, BluntJoiner<SkStrokeEdge>
     };
 
     SkASSERT((unsigned)join < SkPaint::kJoinCount);
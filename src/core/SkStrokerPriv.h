@@ -11,6 +11,7 @@
 #define SkStrokerPriv_DEFINED
 
 #include "SkStroke.h"
+#include "SkTDArray.h"
 
 #define CWX(x, y)   (-y)
 #define CWY(x, y)   (x)
@@ -19,6 +20,40 @@
 
 #define CUBIC_ARC_FACTOR    ((SK_ScalarSqrt2 - SK_Scalar1) * 4 / 3)
 
+/** The verbs, points and conic weights a join or a line adds to one edge of a polyline's stroke,
+    held until they can be appended to the edge's SkPath all at once.
+*/
+class SkStrokeEdge {
+public:
+    void lineTo(SkScalar x, SkScalar y) {
+        *fVerbs.append() = SkPath::kLine_Verb;
+        fPts.append()->set(x, y);
+    }
+
+    void conicTo(const SkPoint& pt1, const SkPoint& pt2, SkScalar weight) {
+        *fVerbs.append() = SkPath::kConic_Verb;
+        SkPoint* pts = fPts.append(2);
+        pts[0] = pt1;
+        pts[1] = pt2;
+        *fWeights.append() = weight;
+    }
+
+    void setLastPt(SkScalar x, SkScalar y) {
+        SkASSERT(fPts.count() > 0);
+        fPts.top().set(x, y);
+    }
+
+    void rewind() {
+        fVerbs.rewind();
+        fPts.rewind();
+        fWeights.rewind();
+    }
+
+    SkTDArray<uint8_t>  fVerbs;
+    SkTDArray<SkPoint>  fPts;
+    SkTDArray<SkScalar> fWeights;
+};
+
 class SkStrokerPriv {
 public:
     typedef void (*CapProc)(SkPath* path,
@@ -34,8 +69,17 @@ public:
                              SkScalar radius, SkScalar invMiterLimit,
                              bool prevIsLine, bool currIsLine);
 
+    typedef void (*EdgeJoinProc)(SkStrokeEdge* outer, SkStrokeEdge* inner,
+                                 const SkVector& beforeUnitNormal,
+                                 const SkPoint& pivot,
+                                 const SkVector& afterUnitNormal,
+                                 SkScalar radius, SkScalar invMiterLimit,
+                                 bool prevIsLine, bool currIsLine);
+
     static CapProc  CapFactory(SkPaint::Cap);
     static JoinProc JoinFactory(SkPaint::Join);
+    // The same joins, made into SkStrokeEdges instead of SkPaths.
+    static EdgeJoinProc EdgeJoinFactory(SkPaint::Join);
 };
 
 #endif
@@ -7,7 +7,9 @@
 
 #include "SkXfermode.h"
 #include "SkXfermode_proccoeff.h"
+#include "SkXfermode_nonseparable.h"
 #include "SkColorPriv.h"
+#include "SkHalf.h"
 #include "SkMathPriv.h"
 #include "SkOncePtr.h"
 #include "SkOpts.h"
@@ -15,6 +17,7 @@
 #include "SkString.h"
 #include "SkWriteBuffer.h"
 #include "SkPM4f.h"
+#include "SkPM4fPriv.h"
 
 #define SkAlphaMulAlpha(a, b)   SkMulDiv255Round(a, b)
 
@@ -185,168 +188,25 @@ static Sk4f exclusion_4f(const Sk4f& s, const Sk4f& d) {
 
 ////////////////////////////////////////////////////
 
-// The CSS compositing spec introduces the following formulas:
-// (See https://dvcs.w3.org/hg/FXTF/rawfile/tip/compositing/index.html#blendingnonseparable)
-// SkComputeLuminance is similar to this formula but it uses the new definition from Rec. 709
-// while PDF and CG uses the one from Rec. Rec. 601
-// See http://www.glennchan.info/articles/technical/hd-versus-sd-color-space/hd-versus-sd-color-space.htm
-static inline float Lum(float r, float g, float b) {
-    return r * 0.2126f + g * 0.7152f + b * 0.0722f;
-}
-
-static inline float max(float a, float b, float c) {
-    return SkTMax(a, SkTMax(b, c));
-}
-
-static inline float min(float a, float b, float c) {
-    return SkTMin(a, SkTMin(b, c));
-}
-
-static inline float Sat(float r, float g, float b) {
-    return max(r, g, b) - min(r, g, b);
-}
-
-static inline void setSaturationComponents(float* Cmin, float* Cmid, float* Cmax, float s) {
-    if(*Cmax > *Cmin) {
-        *Cmid = (*Cmid - *Cmin) * s / (*Cmax - *Cmin);
-        *Cmax = s;
-    } else {
-        *Cmax = 0;
-        *Cmid = 0;
-    }
-    *Cmin = 0;
+// The non-separable modes blend four pixels at a time, each channel in its own Sk4f.  One
+// pixel is splatted across all four to blend it alone.
+static SkPlanes4f splat_planes(const Sk4f& c) {
+    return { Sk4f(c[SkPM4f::R]), Sk4f(c[SkPM4f::G]), Sk4f(c[SkPM4f::B]), Sk4f(c[SkPM4f::A]) };
 }
 
-static inline void SetSat(float* r, float* g, float* b, float s) {
-    if(*r <= *g) {
-        if(*g <= *b) {
-            setSaturationComponents(r, g, b, s);
-        } else if(*r <= *b) {
-            setSaturationComponents(r, b, g, s);
-        } else {
-            setSaturationComponents(b, r, g, s);
-        }
-    } else if(*r <= *b) {
-        setSaturationComponents(g, r, b, s);
-    } else if(*g <= *b) {
-        setSaturationComponents(g, b, r, s);
-    } else {
-        setSaturationComponents(b, g, r, s);
-    }
-}
-
-static inline void clipColor(float* r, float* g, float* b, float a) {
-    float L = Lum(*r, *g, *b);
-    float n = min(*r, *g, *b);
-    float x = max(*r, *g, *b);
-    float denom;
-    if ((n < 0) && (denom = L - n)) { // Compute denom and make sure it's non zero
-        float scale = L / denom;
-        *r = L + (*r - L) * scale;
-        *g = L + (*g - L) * scale;
-        *b = L + (*b - L) * scale;
-    }
-    
-    if ((x > a) && (denom = x - L)) { // Compute denom and make sure it's non zero
-        float scale = (a - L) / denom;
-        *r = L + (*r - L) * scale;
-        *g = L + (*g - L) * scale;
-        *b = L + (*b - L) * scale;
-    }
-}
-
-static inline void SetLum(float* r, float* g, float* b, float a, float l) {
-    float d = l - Lum(*r, *g, *b);
-    *r += d;
-    *g += d;
-    *b += d;
-    clipColor(r, g, b, a);
-}
-
-static Sk4f hue_4f(const Sk4f& s, const Sk4f& d) {
-    float sa = s[SkPM4f::A];
-    float sr = s[SkPM4f::R];
-    float sg = s[SkPM4f::G];
-    float sb = s[SkPM4f::B];
-    
-    float da = d[SkPM4f::A];
-    float dr = d[SkPM4f::R];
-    float dg = d[SkPM4f::G];
-    float db = d[SkPM4f::B];
-
-    float Sr = sr;
-    float Sg = sg;
-    float Sb = sb;
-    SetSat(&Sr, &Sg, &Sb, Sat(dr, dg, db) * sa);
-    SetLum(&Sr, &Sg, &Sb, sa * da, Lum(dr, dg, db) * sa);
-
-    return color_alpha(s * inv_alpha(d) + d * inv_alpha(s) + set_argb(0, Sr, Sg, Sb),
-                       sa + da - sa * da);
+template <SkPlanes4f (blend)(const SkPlanes4f&, const SkPlanes4f&)>
+static Sk4f nonsep_4f(const Sk4f& s, const Sk4f& d) {
+    const SkPlanes4f r = blend(splat_planes(s), splat_planes(d));
+    return set_argb(r.a[0], r.r[0], r.g[0], r.b[0]);
 }
 
+static Sk4f hue_4f(const Sk4f& s, const Sk4f& d)        { return nonsep_4f<planes_hue>(s, d); }
 static Sk4f saturation_4f(const Sk4f& s, const Sk4f& d) {
-    float sa = s[SkPM4f::A];
-    float sr = s[SkPM4f::R];
-    float sg = s[SkPM4f::G];
-    float sb = s[SkPM4f::B];
-    
-    float da = d[SkPM4f::A];
-    float dr = d[SkPM4f::R];
-    float dg = d[SkPM4f::G];
-    float db = d[SkPM4f::B];
-    
-    float Dr = dr;
-    float Dg = dg;
-    float Db = db;
-    SetSat(&Dr, &Dg, &Db, Sat(sr, sg, sb) * da);
-    SetLum(&Dr, &Dg, &Db, sa * da, Lum(dr, dg, db) * sa);
-    
-    return color_alpha(s * inv_alpha(d) + d * inv_alpha(s) + set_argb(0, Dr, Dg, Db),
-                       sa + da - sa * da);
-}
-
-static Sk4f color_4f(const Sk4f& s, const Sk4f& d) {
-    float sa = s[SkPM4f::A];
-    float sr = s[SkPM4f::R];
-    float sg = s[SkPM4f::G];
-    float sb = s[SkPM4f::B];
-    
-    float da = d[SkPM4f::A];
-    float dr = d[SkPM4f::R];
-    float dg = d[SkPM4f::G];
-    float db = d[SkPM4f::B];
-
-    float Sr = sr;
-    float Sg = sg;
-    float Sb = sb;
-    SetLum(&Sr, &Sg, &Sb, sa * da, Lum(dr, dg, db) * sa);
-    
-    Sk4f res = color_alpha(s * inv_alpha(d) + d * inv_alpha(s) + set_argb(0, Sr, Sg, Sb),
-                           sa + da - sa * da);
-    // Can return tiny negative values ...
-    return Sk4f::Max(res, Sk4f(0));
+    return nonsep_4f<planes_saturation>(s, d);
 }
-
+static Sk4f color_4f(const Sk4f& s, const Sk4f& d)      { return nonsep_4f<planes_color>(s, d); }
 static Sk4f luminosity_4f(const Sk4f& s, const Sk4f& d) {
-    float sa = s[SkPM4f::A];
-    float sr = s[SkPM4f::R];
-    float sg = s[SkPM4f::G];
-    float sb = s[SkPM4f::B];
-    
-    float da = d[SkPM4f::A];
-    float dr = d[SkPM4f::R];
-    float dg = d[SkPM4f::G];
-    float db = d[SkPM4f::B];
-    
-    float Dr = dr;
-    float Dg = dg;
-    float Db = db;
-    SetLum(&Dr, &Dg, &Db, sa * da, Lum(sr, sg, sb) * da);
-    
-    Sk4f res = color_alpha(s * inv_alpha(d) + d * inv_alpha(s) + set_argb(0, Dr, Dg, Db),
-                           sa + da - sa * da);
-    // Can return tiny negative values ...
-    return Sk4f::Max(res, Sk4f(0));
+    return nonsep_4f<planes_luminosity>(s, d);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -980,6 +840,192 @@ const ProcCoeff gProcCoeffs[] = {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Blends a span into F16 with the mode's blend inlined, rather than called through its
+// SkXfermodeProc4f for every pixel.
+template <Sk4f (blend)(const Sk4f&, const Sk4f&), bool kSrcIsSingle>
+void blend_f16(const SkXfermode*, uint64_t dst[], const SkPM4f src[], int count,
+               const SkAlpha aa[]) {
+    for (int i = 0; i < count; ++i) {
+        const Sk4f s4 = Sk4f::Load(src[kSrcIsSingle ? 0 : i].fVec);
+        const Sk4f d4 = Sk4f_fromF16(dst[i]);
+        Sk4f r4 = blend(s4, d4);
+        if (aa) {
+            r4 = d4 + (r4 - d4) * Sk4f(aa[i] * (1/255.0f));
+        }
+        // The blends can stray a little outside of [0,1], which Sk4f_toF16 can't take.
+        dst[i] = Sk4f_toF16(Sk4f::Min(Sk4f::Max(r4, Sk4f(0)), Sk4f(1)));
+    }
+}
+
+#define F16_PROCS(blend)    { blend_f16<blend, false>, blend_f16<blend, true> }
+
+const SkXfermode::D64Proc gF16Procs[][2] = {
+    F16_PROCS(clear_4f),      F16_PROCS(src_4f),        F16_PROCS(dst_4f),
+    F16_PROCS(srcover_4f),    F16_PROCS(dstover_4f),    F16_PROCS(srcin_4f),
+    F16_PROCS(dstin_4f),      F16_PROCS(srcout_4f),     F16_PROCS(dstout_4f),
+    F16_PROCS(srcatop_4f),    F16_PROCS(dstatop_4f),    F16_PROCS(xor_4f),
+
+    F16_PROCS(plus_4f),       F16_PROCS(modulate_4f),   F16_PROCS(screen_4f),
+    F16_PROCS(overlay_4f),    F16_PROCS(darken_4f),     F16_PROCS(lighten_4f),
+    F16_PROCS(colordodge_4f), F16_PROCS(colorburn_4f),  F16_PROCS(hardlight_4f),
+    F16_PROCS(softlight_4f),  F16_PROCS(difference_4f), F16_PROCS(exclusion_4f),
+    F16_PROCS(multiply_4f),   F16_PROCS(hue_4f),        F16_PROCS(saturation_4f),
+    F16_PROCS(color_4f),      F16_PROCS(luminosity_4f),
+};
+
+#undef F16_PROCS
+
+SkXfermode::D64Proc SkXfermode_F16Proc(SkXfermode::Mode mode, bool srcIsSingle) {
+    static_assert(SK_ARRAY_COUNT(gF16Procs) == SkXfermode::kLastMode + 1, "F16 procs missing");
+    SkASSERT((unsigned)mode <= (unsigned)SkXfermode::kLastMode);
+    return gF16Procs[mode][srcIsSingle];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <bool kSRGB> static Sk4f load_d32(uint32_t c) {
+    return kSRGB ? Sk4f_fromS32(c) : Sk4f_fromL32(c);
+}
+
+template <bool kSRGB> static uint32_t store_d32(const Sk4f& x) {
+    return kSRGB ? Sk4f_toS32(x) : Sk4f_toL32(x);
+}
+
+// Blends a span into 8888 with the mode's blend inlined, rather than called through its
+// SkXfermodeProc4f for every pixel.
+template <Sk4f (blend)(const Sk4f&, const Sk4f&), bool kSRGB, bool kSrcIsSingle>
+void blend_d32(const SkXfermode*, uint32_t dst[], const SkPM4f src[], int count,
+               const SkAlpha aa[]) {
+    for (int i = 0; i < count; ++i) {
+        const Sk4f s4 = Sk4f::Load(src[kSrcIsSingle ? 0 : i].fVec);
+        const Sk4f d4 = load_d32<kSRGB>(dst[i]);
+        Sk4f r4 = blend(s4, d4);
+        if (aa) {
+            r4 = d4 + (r4 - d4) * Sk4f(aa[i] * (1/255.0f));
+        }
+        dst[i] = store_d32<kSRGB>(r4);
+    }
+}
+
+static Sk4f gather_channel(const SkPM4f px[4], int c) {
+    return Sk4f(px[0].fVec[c], px[1].fVec[c], px[2].fVec[c], px[3].fVec[c]);
+}
+
+static SkPlanes4f to_planes(const SkPM4f px[4]) {
+    return {
+        gather_channel(px, SkPM4f::R), gather_channel(px, SkPM4f::G),
+        gather_channel(px, SkPM4f::B), gather_channel(px, SkPM4f::A),
+    };
+}
+
+template <bool kSRGB> static SkPlanes4f load_d32_planes(const uint32_t c[4]) {
+    const Sk4i px = Sk4i::Load(c);
+    const Sk4f scale(1.0f/255);
+    SkPlanes4f p = {
+        SkNx_cast<float>((px >> SK_R32_SHIFT) & 0xFF) * scale,
+        SkNx_cast<float>((px >> SK_G32_SHIFT) & 0xFF) * scale,
+        SkNx_cast<float>((px >> SK_B32_SHIFT) & 0xFF) * scale,
+        SkNx_cast<float>((px >> SK_A32_SHIFT) & 0xFF) * scale,
+    };
+    if (kSRGB) {
+        // Like Sk4f_fromS32().
+        p.r = p.r * p.r;
+        p.g = p.g * p.g;
+        p.b = p.b * p.b;
+    }
+    return p;
+}
+
+static Sk4i round_to_byte(const Sk4f& x) {
+    return SkNx_cast<int>(Sk4f::Min(Sk4f::Max(x, Sk4f(0)), Sk4f(1)) * Sk4f(255) + Sk4f(0.5f));
+}
+
+template <bool kSRGB> static void store_d32_planes(uint32_t c[4], SkPlanes4f p) {
+    if (kSRGB) {
+        // Like Sk4f_toS32().
+        p.r = p.r.sqrt();
+        p.g = p.g.sqrt();
+        p.b = p.b.sqrt();
+    }
+    const Sk4i px = (round_to_byte(p.a) << SK_A32_SHIFT) | (round_to_byte(p.r) << SK_R32_SHIFT) |
+                    (round_to_byte(p.g) << SK_G32_SHIFT) | (round_to_byte(p.b) << SK_B32_SHIFT);
+    px.store(c);
+}
+
+static Sk4f lerp_planes(const Sk4f& from, const Sk4f& to, const Sk4f& t) {
+    return from + (to - from) * t;
+}
+
+// The non-separable modes blend four pixels at a time.  Short spans repeat their last pixel.
+template <SkPlanes4f (blend)(const SkPlanes4f&, const SkPlanes4f&), bool kSRGB, bool kSrcIsSingle>
+void blend_nonsep_d32(const SkXfermode*, uint32_t dst[], const SkPM4f src[], int count,
+                      const SkAlpha aa[]) {
+    const SkPM4f single[4] = { src[0], src[0], src[0], src[0] };
+    const SkPlanes4f singlePlanes = to_planes(single);
+
+    for (int i = 0; i < count; i += 4) {
+        const int n = SkTMin(count - i, 4);
+        uint32_t d32[4];
+        SkPM4f s4f[4];
+        uint8_t cov[4];
+        for (int j = 0; j < 4; ++j) {
+            const int k = i + SkTMin(j, n - 1);
+            d32[j] = dst[k];
+            s4f[j] = src[kSrcIsSingle ? 0 : k];
+            cov[j] = aa ? aa[k] : 0;
+        }
+
+        const SkPlanes4f d = load_d32_planes<kSRGB>(d32);
+        SkPlanes4f r = blend(kSrcIsSingle ? singlePlanes : to_planes(s4f), d);
+        if (aa) {
+            const Sk4f t = SkNx_cast<float>(Sk4b::Load(cov)) * Sk4f(1/255.0f);
+            r.r = lerp_planes(d.r, r.r, t);
+            r.g = lerp_planes(d.g, r.g, t);
+            r.b = lerp_planes(d.b, r.b, t);
+            r.a = lerp_planes(d.a, r.a, t);
+        }
+        store_d32_planes<kSRGB>(d32, r);
+        memcpy(dst + i, d32, n * sizeof(uint32_t));
+    }
+}
+
+#define D32_PROCS(blend) \
+    { blend_d32<blend, false, false>, blend_d32<blend, false, true>, \
+      blend_d32<blend, true,  false>, blend_d32<blend, true,  true> }
+#define D32_NONSEP_PROCS(blend) \
+    { blend_nonsep_d32<blend, false, false>, blend_nonsep_d32<blend, false, true>, \
+      blend_nonsep_d32<blend, true,  false>, blend_nonsep_d32<blend, true,  true> }
+
+// Indexed by mode, then by kSrcIsSingle_D32Flag and kDstIsSRGB_D32Flag, without kSrcIsOpaque.
+const SkXfermode::D32Proc gD32Procs[][4] = {
+    D32_PROCS(clear_4f),      D32_PROCS(src_4f),        D32_PROCS(dst_4f),
+    D32_PROCS(srcover_4f),    D32_PROCS(dstover_4f),    D32_PROCS(srcin_4f),
+    D32_PROCS(dstin_4f),      D32_PROCS(srcout_4f),     D32_PROCS(dstout_4f),
+    D32_PROCS(srcatop_4f),    D32_PROCS(dstatop_4f),    D32_PROCS(xor_4f),
+
+    D32_PROCS(plus_4f),       D32_PROCS(modulate_4f),   D32_PROCS(screen_4f),
+    D32_PROCS(overlay_4f),    D32_PROCS(darken_4f),     D32_PROCS(lighten_4f),
+    D32_PROCS(colordodge_4f), D32_PROCS(colorburn_4f),  D32_PROCS(hardlight_4f),
+    D32_PROCS(softlight_4f),  D32_PROCS(difference_4f), D32_PROCS(exclusion_4f),
+    D32_PROCS(multiply_4f),
+
+    D32_NONSEP_PROCS(planes_hue),   D32_NONSEP_PROCS(planes_saturation),
+    D32_NONSEP_PROCS(planes_color), D32_NONSEP_PROCS(planes_luminosity),
+};
+
+#undef D32_PROCS
+#undef D32_NONSEP_PROCS
+
+SkXfermode::D32Proc SkXfermode_D32Proc(SkXfermode::Mode mode, uint32_t flags) {
+    static_assert(SK_ARRAY_COUNT(gD32Procs) == SkXfermode::kLastMode + 1, "D32 procs missing");
+    static_assert(SkXfermode::kSrcIsSingle_D32Flag == 2 && SkXfermode::kDstIsSRGB_D32Flag == 4,
+                  "D32 flags moved");
+    SkASSERT((unsigned)mode <= (unsigned)SkXfermode::kLastMode);
+    return gD32Procs[mode][(flags >> 1) & 3];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 bool SkXfermode::asMode(Mode* mode) const {
     return false;
 }
@@ -8,6 +8,7 @@
 #include "SkPM4fPriv.h"
 #include "SkUtils.h"
 #include "SkXfermode.h"
+#include "SkXfermode_proccoeff.h"
 
 enum DstType {
     kLinear_Dst,
@@ -357,7 +358,7 @@ static SkXfermode::D32Proc find_proc(SkXfermode::Mode mode, uint32_t flags) {
         default:
             break;
     }
-    return gProcs_General[flags];
+    return SkXfermode_D32Proc(mode, flags);
 }
 
 SkXfermode::D32Proc SkXfermode::onGetD32Proc(uint32_t flags) const {
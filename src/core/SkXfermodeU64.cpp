@@ -5,10 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "SkColorPriv.h"
 #include "SkHalf.h"
 #include "SkPM4fPriv.h"
 #include "SkUtils.h"
 #include "SkXfermode.h"
+#include "SkXfermode_proccoeff.h"
 
 static void sk_memset64(uint64_t dst[], uint64_t value, int count) {
     for (int i = 0; i < count; ++i) {
@@ -238,6 +240,9 @@ static SkXfermode::D64Proc find_proc(SkXfermode::Mode mode, uint32_t flags) {
         default:
             break;
     }
+    if (flags & SkXfermode::kDstIsFloat16_D64Flag) {
+        return SkXfermode_F16Proc(mode, SkToBool(flags & SkXfermode::kSrcIsSingle_D64Flag));
+    }
     return gProcs_General[flags];
 }
 
@@ -253,3 +258,40 @@ SkXfermode::D64Proc SkXfermode::GetD64Proc(SkXfermode* xfer, uint32_t flags) {
     return xfer ? xfer->onGetD64Proc(flags) : find_proc(SkXfermode::kSrcOver_Mode, flags);
 }
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// LCD coverage for each of R, G, and B, in RGBA order.  Alpha gets none; it ends up opaque.
+static Sk4f lcd16_to_rgba_unit_4f(uint16_t rgb) {
+    Sk4i rgbi = Sk4i(SkGetPackedR16(rgb), SkGetPackedG16(rgb), SkGetPackedB16(rgb), 0);
+    return SkNx_cast<float>(rgbi) * Sk4f(1.0f/31, 1.0f/63, 1.0f/31, 0);
+}
+
+template <DstType D, bool kSrcOver, bool kSrcIsSingle>
+void lcd(uint64_t dst[], const SkPM4f src[], int count, const uint16_t lcd[]) {
+    for (int i = 0; i < count; ++i) {
+        const uint16_t rgb = lcd[i];
+        if (0 == rgb) {
+            continue;
+        }
+        const Sk4f s4 = pm_to_rgba_order(Sk4f::Load(src[kSrcIsSingle ? 0 : i].fVec));
+        const Sk4f d4 = bias_to_unit<D>(load_from_dst<D>(dst[i]));
+        Sk4f r4 = kSrcOver ? s4 + d4 * Sk4f(1 - get_alpha(s4)) : s4;
+        r4 = set_alpha(d4 + (r4 - d4) * lcd16_to_rgba_unit_4f(rgb), 1);
+        dst[i] = store_to_dst<D>(unit_to_bias<D>(r4));
+    }
+}
+
+SkXfermode::LCD64Proc SkXfermode::GetLCD64Proc(uint32_t flags) {
+    SkASSERT((flags & ~7) == 0);
+    flags &= 7;
+
+    const LCD64Proc procs[] = {
+        lcd<kF16_Dst, true, false>,    lcd<kF16_Dst, false, false>,
+        lcd<kF16_Dst, true, true>,     lcd<kF16_Dst, false, true>,
+
+        lcd<kU16_Dst, true, false>,    lcd<kU16_Dst, false, false>,
+        lcd<kU16_Dst, true, true>,     lcd<kU16_Dst, false, true>,
+    };
+    return procs[flags];
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkXfermode_nonseparable_DEFINED
+#define SkXfermode_nonseparable_DEFINED
+
+#include "SkNx.h"
+
+// The non-separable modes (Hue, Saturation, Color and Luminosity) mix each pixel's color
+// channels together, so rather than putting one pixel's channels in an Sk4f, they blend four
+// pixels at once with each channel in its own Sk4f.  Colors are premultiplied, in [0,1].
+//
+// The formulas are from the CSS compositing spec, scaled through by Sa*Da to work on premul:
+// https://dvcs.w3.org/hg/FXTF/rawfile/tip/compositing/index.html#blendingnonseparable
+//
+// The divides are done with invert(), which is plenty precise for 8 and 16-bit results.
+
+struct SkPlanes4f {
+    Sk4f r, g, b, a;
+};
+
+// Like the GPU and the SkPMColor modeprocs, this uses the Rec. 601 luminance that PDF and CG use.
+static inline Sk4f planes_lum(const SkPlanes4f& c) {
+    return c.r * Sk4f(0.30f) + c.g * Sk4f(0.59f) + c.b * Sk4f(0.11f);
+}
+
+static inline Sk4f planes_min(const SkPlanes4f& c) {
+    return Sk4f::Min(c.r, Sk4f::Min(c.g, c.b));
+}
+
+static inline Sk4f planes_max(const SkPlanes4f& c) {
+    return Sk4f::Max(c.r, Sk4f::Max(c.g, c.b));
+}
+
+static inline Sk4f planes_sat(const SkPlanes4f& c) {
+    return planes_max(c) - planes_min(c);
+}
+
+// Moves c's colors towards L by scale, i.e. L + (c - L) * scale.
+static inline void planes_scale_about(SkPlanes4f* c, const Sk4f& L, const Sk4f& scale) {
+    c->r = L + (c->r - L) * scale;
+    c->g = L + (c->g - L) * scale;
+    c->b = L + (c->b - L) * scale;
+}
+
+// Stretches c's colors so their min becomes 0 and their max becomes s.  Grays go to 0.
+static inline void planes_set_sat(SkPlanes4f* c, const Sk4f& s) {
+    const Sk4f mn = planes_min(*c),
+               range = planes_max(*c) - mn,
+               scale = (range > Sk4f(0)).thenElse(s * range.invert(), Sk4f(0));
+    c->r = (c->r - mn) * scale;
+    c->g = (c->g - mn) * scale;
+    c->b = (c->b - mn) * scale;
+}
+
+// Pulls c's colors towards their luminance until they fit in [0,a].
+static inline void planes_clip_color(SkPlanes4f* c, const Sk4f& a) {
+    const Sk4f L = planes_lum(*c),
+               n = planes_min(*c),
+               x = planes_max(*c);
+    const Sk4f one(1),
+               loDenom = L - n,
+               hiDenom = x - L;
+
+    // Pulling up the negatives and pulling down past a both scale about L, so they combine.
+    const Sk4f lo = (n < Sk4f(0)).thenElse(
+                    (loDenom != Sk4f(0)).thenElse(L * loDenom.invert(), one), one),
+               hi = (x > a).thenElse(
+                    (hiDenom != Sk4f(0)).thenElse((a - L) * hiDenom.invert(), one), one);
+    planes_scale_about(c, L, lo * hi);
+}
+
+static inline void planes_set_lum(SkPlanes4f* c, const Sk4f& a, const Sk4f& l) {
+    const Sk4f d = l - planes_lum(*c);
+    c->r = c->r + d;
+    c->g = c->g + d;
+    c->b = c->b + d;
+    planes_clip_color(c, a);
+}
+
+// [ Sa + Da - Sa*Da, S*(1-Da) + D*(1-Sa) + blend ], with tiny negatives clamped away.
+static inline SkPlanes4f planes_nonsep_result(const SkPlanes4f& s, const SkPlanes4f& d,
+                                              const SkPlanes4f& blend) {
+    const Sk4f isa = Sk4f(1) - s.a,
+               ida = Sk4f(1) - d.a,
+               zero(0);
+    return {
+        Sk4f::Max(zero, s.r * ida + d.r * isa + blend.r),
+        Sk4f::Max(zero, s.g * ida + d.g * isa + blend.g),
+        Sk4f::Max(zero, s.b * ida + d.b * isa + blend.b),
+        s.a + d.a * isa,
+    };
+}
+
+// SetLum(SetSat(S * Da, Sat(D) * Sa), Lum(D) * Sa)
+static inline SkPlanes4f planes_hue(const SkPlanes4f& s, const SkPlanes4f& d) {
+    SkPlanes4f c = { s.r * d.a, s.g * d.a, s.b * d.a, s.a };
+    planes_set_sat(&c, planes_sat(d) * s.a);
+    planes_set_lum(&c, s.a * d.a, planes_lum(d) * s.a);
+    return planes_nonsep_result(s, d, c);
+}
+
+// SetLum(SetSat(D * Sa, Sat(S) * Da), Lum(D) * Sa)
+static inline SkPlanes4f planes_saturation(const SkPlanes4f& s, const SkPlanes4f& d) {
+    SkPlanes4f c = { d.r * s.a, d.g * s.a, d.b * s.a, d.a };
+    planes_set_sat(&c, planes_sat(s) * d.a);
+    planes_set_lum(&c, s.a * d.a, planes_lum(d) * s.a);
+    return planes_nonsep_result(s, d, c);
+}
+
+// SetLum(S * Da, Lum(D) * Sa)
+static inline SkPlanes4f planes_color(const SkPlanes4f& s, const SkPlanes4f& d) {
+    SkPlanes4f c = { s.r * d.a, s.g * d.a, s.b * d.a, s.a };
+    planes_set_lum(&c, s.a * d.a, planes_lum(d) * s.a);
+    return planes_nonsep_result(s, d, c);
+}
+
+// SetLum(D * Sa, Lum(S) * Da)
+static inline SkPlanes4f planes_luminosity(const SkPlanes4f& s, const SkPlanes4f& d) {
+    SkPlanes4f c = { d.r * s.a, d.g * s.a, d.b * s.a, d.a };
+    planes_set_lum(&c, s.a * d.a, planes_lum(s) * d.a);
+    return planes_nonsep_result(s, d, c);
+}
+
+#endif
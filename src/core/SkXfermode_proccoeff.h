@@ -21,6 +21,18 @@ struct ProcCoeff {
 
 #define CANNOT_USE_COEFF    SkXfermode::Coeff(-1)
 
+/**
+ *  Returns a D64Proc for F16 destinations that blends with the mode's Sk4f math inlined.
+ *  It ignores kSrcIsOpaque_D64Flag.
+ */
+SkXfermode::D64Proc SkXfermode_F16Proc(SkXfermode::Mode, bool srcIsSingle);
+
+/**
+ *  Returns a D32Proc that blends with the mode's Sk4f math inlined, four pixels at a time for
+ *  the non-separable modes.  It ignores kSrcIsOpaque_D32Flag.
+ */
+SkXfermode::D32Proc SkXfermode_D32Proc(SkXfermode::Mode, uint32_t flags);
+
 class SK_API SkProcCoeffXfermode : public SkXfermode {
 public:
     SkProcCoeffXfermode(const ProcCoeff& rec, Mode mode) {
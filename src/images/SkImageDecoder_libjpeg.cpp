@@ -10,10 +10,12 @@
 #include "SkImageEncoder.h"
 #include "SkJpegUtility.h"
 #include "SkColorPriv.h"
+#include "SkData.h"
 #include "SkDither.h"
 #include "SkMSAN.h"
 #include "SkScaledBitmapSampler.h"
 #include "SkStream.h"
+#include "SkStripEncoder.h"
 #include "SkTemplates.h"
 #include "SkTime.h"
 #include "SkUtils.h"
@@ -807,8 +809,8 @@ static void Write_Index_RGB(uint8_t* SK_RESTRICT dst,
     }
 }
 
-static WriteScanline ChooseWriter(const SkBitmap& bm) {
-    switch (bm.colorType()) {
+static WriteScanline ChooseWriter(SkColorType colorType) {
+    switch (colorType) {
         case kN32_SkColorType:
             return Write_32_RGB;
         case kRGB_565_SkColorType:
@@ -822,78 +824,234 @@ static WriteScanline ChooseWriter(const SkBitmap& bm) {
     }
 }
 
-class SkJPEGImageEncoder : public SkImageEncoder {
-protected:
-    virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) {
-#ifdef TIME_ENCODE
-        SkAutoTime atm("JPEG Encode");
-#endif
+struct JpegEncodeParams {
+    WriteScanline       fWriter;
+    const SkPMColor*    fColors;
+    int                 fWidth;
+    int                 fQuality;
+    bool                fOptimizeCoding;
+    J_DCT_METHOD        fDCTMethod;
+    int                 fRestartInRows;     // 0 means no restart markers
+};
 
-        SkAutoLockPixels alp(bm);
-        if (nullptr == bm.getPixels()) {
-            return false;
-        }
+static bool encode_jpeg_rows(SkWStream* stream, const JpegEncodeParams& params,
+                             const void* srcRows, size_t rowBytes, int height) {
+    jpeg_compress_struct    cinfo;
+    skjpeg_error_mgr        sk_err;
+    skjpeg_destination_mgr  sk_wstream(stream);
 
-        jpeg_compress_struct    cinfo;
-        skjpeg_error_mgr        sk_err;
-        skjpeg_destination_mgr  sk_wstream(stream);
+    // allocate these before set call setjmp
+    SkAutoTMalloc<uint8_t>  oneRow;
 
-        // allocate these before set call setjmp
-        SkAutoTMalloc<uint8_t>  oneRow;
+    cinfo.err = jpeg_std_error(&sk_err);
+    sk_err.error_exit = skjpeg_error_exit;
+    if (setjmp(sk_err.fJmpBuf)) {
+        return false;
+    }
 
-        cinfo.err = jpeg_std_error(&sk_err);
-        sk_err.error_exit = skjpeg_error_exit;
-        if (setjmp(sk_err.fJmpBuf)) {
-            return false;
-        }
+    jpeg_create_compress(&cinfo);
+    cinfo.dest = &sk_wstream;
+    cinfo.image_width = params.fWidth;
+    cinfo.image_height = height;
+    cinfo.input_components = 3;
+    // FIXME: Can we take advantage of other in_color_spaces in libjpeg-turbo?
+    cinfo.in_color_space = JCS_RGB;
 
-        // Keep after setjmp or mark volatile.
-        const WriteScanline writer = ChooseWriter(bm);
-        if (nullptr == writer) {
-            return false;
-        }
+    // The gamma value is ignored by libjpeg-turbo.
+    cinfo.input_gamma = 1;
+
+    jpeg_set_defaults(&cinfo);
+
+    // Tells libjpeg-turbo to compute optimal Huffman coding tables
+    // for the image.  This improves compression at the cost of
+    // slower encode performance.
+    cinfo.optimize_coding = params.fOptimizeCoding ? TRUE : FALSE;
+    cinfo.dct_method = params.fDCTMethod;
+    cinfo.restart_in_rows = params.fRestartInRows;
+    jpeg_set_quality(&cinfo, params.fQuality, TRUE /* limit to baseline-JPEG values */);
+
+    jpeg_start_compress(&cinfo, TRUE);
+
+    const int       width = params.fWidth;
+    uint8_t*        oneRowP = oneRow.reset(width * 3);
+    const void*     srcRow = srcRows;
+
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row_pointer[1];    /* pointer to JSAMPLE row[s] */
+
+        params.fWriter(oneRowP, srcRow, width, params.fColors);
+        row_pointer[0] = oneRowP;
+        (void) jpeg_write_scanlines(&cinfo, row_pointer, 1);
+        srcRow = (const void*)((const char*)srcRow + rowBytes);
+    }
+
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    return true;
+}
 
-        jpeg_create_compress(&cinfo);
-        cinfo.dest = &sk_wstream;
-        cinfo.image_width = bm.width();
-        cinfo.image_height = bm.height();
-        cinfo.input_components = 3;
-        // FIXME: Can we take advantage of other in_color_spaces in libjpeg-turbo?
-        cinfo.in_color_space = JCS_RGB;
+/*  Strip encoding.
 
-        // The gamma value is ignored by libjpeg-turbo.
-        cinfo.input_gamma = 1;
+    Each strip is encoded as a complete baseline JPEG with the same quantization and
+    (standard) Huffman tables, and a restart marker after every MCU row. At a restart
+    marker the DC predictors reset and the entropy coder starts on a byte boundary, which
+    is exactly the state at the start of a fresh JPEG. So we can stitch the entropy-coded
+    data of every strip together, separated by restart markers, under the headers of the
+    first strip (with its height patched to the full image height).
 
-        jpeg_set_defaults(&cinfo);
+    Restart markers are numbered modulo 8 within each strip, so they are renumbered as they
+    are copied.
+*/
 
-        // Tells libjpeg-turbo to compute optimal Huffman coding tables
-        // for the image.  This improves compression at the cost of
-        // slower encode performance.
-        cinfo.optimize_coding = TRUE;
-        jpeg_set_quality(&cinfo, quality, TRUE /* limit to baseline-JPEG values */);
+// Every strip but the last must hold a whole number of MCU rows. With the sampling factors
+// jpeg_set_defaults() picks for RGB input, an MCU is at most 16 rows tall.
+static const int kMaxMCUHeight = 16;
 
-        jpeg_start_compress(&cinfo, TRUE);
+struct JpegStripLayout {
+    size_t fHeightOffset;   // offset of the 16-bit image height in the SOF segment
+    size_t fScanStart;      // first byte of entropy-coded data
+    size_t fScanEnd;        // offset of the EOI marker
+};
 
-        const int       width = bm.width();
-        uint8_t*        oneRowP = oneRow.reset(width * 3);
+static bool parse_jpeg_strip(const uint8_t* data, size_t size, JpegStripLayout* layout) {
+    if (size < 4 || 0xFF != data[0] || 0xD8 != data[1] ||
+        0xFF != data[size - 2] || 0xD9 != data[size - 1]) {
+        return false;
+    }
+    layout->fHeightOffset = 0;
+    size_t offset = 2;
+    while (offset + 4 <= size) {
+        if (0xFF != data[offset]) {
+            return false;
+        }
+        const uint8_t marker = data[offset + 1];
+        const size_t length = (data[offset + 2] << 8) | data[offset + 3];
+        if (0xC0 == marker || 0xC1 == marker) {
+            // Ls (2 bytes), P (1 byte), then Y.
+            layout->fHeightOffset = offset + 5;
+        } else if (0xDA == marker) {
+            layout->fScanStart = offset + 2 + length;
+            layout->fScanEnd = size - 2;
+            return 0 != layout->fHeightOffset && layout->fScanStart <= layout->fScanEnd;
+        }
+        offset += 2 + length;
+    }
+    return false;
+}
 
-        const SkPMColor* colors = bm.getColorTable() ? bm.getColorTable()->readColors() : nullptr;
-        const void*      srcRow = bm.getPixels();
+// Copies entropy-coded data, renumbering restart markers to continue from *nextRestart.
+static bool write_jpeg_scan(SkWStream* stream, const uint8_t* data, size_t size,
+                            unsigned* nextRestart) {
+    size_t runStart = 0;
+    for (size_t i = 0; i + 1 < size; i++) {
+        if (0xFF != data[i]) {
+            continue;
+        }
+        const uint8_t next = data[i + 1];
+        if (next >= 0xD0 && next <= 0xD7) {
+            // Write through the 0xFF, then the renumbered marker.
+            const uint8_t marker = 0xD0 + (*nextRestart & 7);
+            *nextRestart += 1;
+            if (!stream->write(data + runStart, i + 1 - runStart) || !stream->write(&marker, 1)) {
+                return false;
+            }
+            runStart = i + 2;
+        }
+        // Whether stuffed (0xFF00) or a marker, the next byte is not the start of a marker.
+        i++;
+    }
+    return stream->write(data + runStart, size - runStart);
+}
 
-        while (cinfo.next_scanline < cinfo.image_height) {
-            JSAMPROW row_pointer[1];    /* pointer to JSAMPLE row[s] */
+class SkJPEGImageEncoder : public SkImageEncoder {
+protected:
+    virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) {
+#ifdef TIME_ENCODE
+        SkAutoTime atm("JPEG Encode");
+#endif
 
-            writer(oneRowP, srcRow, width, colors);
-            row_pointer[0] = oneRowP;
-            (void) jpeg_write_scanlines(&cinfo, row_pointer, 1);
-            srcRow = (const void*)((const char*)srcRow + bm.rowBytes());
+        SkAutoLockPixels alp(bm);
+        if (nullptr == bm.getPixels()) {
+            return false;
         }
 
-        jpeg_finish_compress(&cinfo);
-        jpeg_destroy_compress(&cinfo);
+        JpegEncodeParams params;
+        params.fWriter = ChooseWriter(bm.colorType());
+        if (nullptr == params.fWriter) {
+            return false;
+        }
+        params.fColors = bm.getColorTable() ? bm.getColorTable()->readColors() : nullptr;
+        params.fWidth = bm.width();
+        params.fQuality = quality;
+        params.fOptimizeCoding = true;
+        params.fDCTMethod = JDCT_DEFAULT;
+        params.fRestartInRows = 0;
+
+        return encode_jpeg_rows(stream, params, bm.getPixels(), bm.rowBytes(), bm.height());
+    }
 
-        return true;
+    bool onEncodeStrips(SkWStream* stream, const SkImageInfo& info, RowSource* src,
+                        int quality, const StripOptions& options) override {
+        JpegEncodeParams params;
+        params.fWriter = ChooseWriter(info.colorType());
+        // Optimized Huffman tables would differ from strip to strip, so kSmall_Preset encodes
+        // the whole image at once.
+        if (nullptr == params.fWriter || kSmall_Preset == options.fPreset) {
+            return INHERITED::onEncodeStrips(stream, info, src, quality, options);
+        }
+        params.fColors = nullptr;
+        params.fWidth = info.width();
+        params.fQuality = quality;
+        params.fOptimizeCoding = false;
+        params.fDCTMethod = kFast_Preset == options.fPreset ? JDCT_IFAST : JDCT_ISLOW;
+        params.fRestartInRows = 1;
+
+        int stripHeight = options.fStripHeight > 0 ? options.fStripHeight
+                : SkStripEncoder::DefaultStripHeight(info, options.fMaxConcurrentStrips);
+        stripHeight = (stripHeight + kMaxMCUHeight - 1) / kMaxMCUHeight * kMaxMCUHeight;
+
+        SkStripEncoder encoder(info, src, stripHeight, options.fMaxConcurrentStrips);
+        unsigned nextRestart = 0;
+
+        auto compress = [&](const SkStripEncoder::Strip& strip, SkDynamicMemoryWStream* dst) {
+            return encode_jpeg_rows(dst, params, strip.fRows, strip.fRowBytes, strip.fHeight);
+        };
+        auto emit = [&](int index, SkDynamicMemoryWStream* compressed) {
+            SkAutoTUnref<SkData> data(compressed->copyToData());
+            const uint8_t* bytes = data->bytes();
+            JpegStripLayout layout;
+            if (!parse_jpeg_strip(bytes, data->size(), &layout)) {
+                return false;
+            }
+            if (0 == index) {
+                const uint8_t height[2] = { (uint8_t)(info.height() >> 8),
+                                            (uint8_t)(info.height() & 0xFF) };
+                if (!stream->write(bytes, layout.fHeightOffset) ||
+                    !stream->write(height, sizeof(height)) ||
+                    !stream->write(bytes + layout.fHeightOffset + 2,
+                                   layout.fScanStart - layout.fHeightOffset - 2)) {
+                    return false;
+                }
+            } else {
+                const uint8_t marker[2] = { 0xFF, (uint8_t)(0xD0 + (nextRestart & 7)) };
+                nextRestart += 1;
+                if (!stream->write(marker, sizeof(marker))) {
+                    return false;
+                }
+            }
+            return write_jpeg_scan(stream, bytes + layout.fScanStart,
+                                   layout.fScanEnd - layout.fScanStart, &nextRestart);
+        };
+        if (!encoder.run(compress, emit)) {
+            return false;
+        }
+        static const uint8_t kEOI[2] = { 0xFF, 0xD9 };
+        return stream->write(kEOI, sizeof(kEOI));
     }
+
+private:
+    typedef SkImageEncoder INHERITED;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -9,16 +9,19 @@
 #include "SkImageEncoder.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
+#include "SkData.h"
 #include "SkDither.h"
 #include "SkMath.h"
 #include "SkRTConf.h"
 #include "SkScaledBitmapSampler.h"
 #include "SkStream.h"
+#include "SkStripEncoder.h"
 #include "SkTemplates.h"
 #include "SkUtils.h"
 #include "transform_scanline.h"
 
 #include "png.h"
+#include "zlib.h"
 
 /* These were dropped in libpng >= 1.4 */
 #ifndef png_infopp_NULL
@@ -816,6 +819,8 @@ static inline int pack_palette(SkColorTable* ctable,
 class SkPNGImageEncoder : public SkImageEncoder {
 protected:
     bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) override;
+    bool onEncodeStrips(SkWStream*, const SkImageInfo&, RowSource*, int quality,
+                        const StripOptions&) override;
 private:
     bool doEncode(SkWStream* stream, const SkBitmap& bm,
                   const bool& hasAlpha, int colorType,
@@ -984,6 +989,316 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+/*  Strip encoding.
+
+    Each strip is filtered and deflated independently, as a raw deflate stream (no zlib
+    header or trailer) that ends on a byte boundary with a sync flush. Concatenated, these
+    form one valid deflate stream, since no strip refers back into another strip's data.
+    We wrap that in a zlib header, append the adler32 of the whole image (combined from the
+    per-strip checksums), and write each strip as its own IDAT chunk.
+
+    We write the chunks ourselves rather than going through libpng, which has no way to
+    accept pre-compressed image data.
+*/
+
+enum {
+    kNone_PngFilter,
+    kSub_PngFilter,
+    kUp_PngFilter,
+    kAvg_PngFilter,
+    kPaeth_PngFilter,
+
+    kPngFilterCount
+};
+
+struct PngStripParams {
+    transform_scanline_proc fProc;
+    int                     fWidth;
+    int                     fBpp;       // bytes per pixel written by fProc
+    int                     fZLevel;
+    int                     fFilter;    // or -1 to pick a filter for each row
+};
+
+static inline uint8_t paeth_predictor(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = SkAbs32(p - a);
+    const int pb = SkAbs32(p - b);
+    const int pc = SkAbs32(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+static void filter_png_row(int filter, const uint8_t* SK_RESTRICT cur,
+                           const uint8_t* SK_RESTRICT prev, int bpp, size_t len,
+                           uint8_t* SK_RESTRICT dst) {
+    switch (filter) {
+        case kNone_PngFilter:
+            memcpy(dst, cur, len);
+            break;
+        case kSub_PngFilter:
+            memcpy(dst, cur, bpp);
+            for (size_t i = bpp; i < len; i++) {
+                dst[i] = cur[i] - cur[i - bpp];
+            }
+            break;
+        case kUp_PngFilter:
+            for (size_t i = 0; i < len; i++) {
+                dst[i] = cur[i] - prev[i];
+            }
+            break;
+        case kAvg_PngFilter:
+            for (int i = 0; i < bpp; i++) {
+                dst[i] = cur[i] - (prev[i] >> 1);
+            }
+            for (size_t i = bpp; i < len; i++) {
+                dst[i] = cur[i] - ((cur[i - bpp] + prev[i]) >> 1);
+            }
+            break;
+        case kPaeth_PngFilter:
+            for (int i = 0; i < bpp; i++) {
+                dst[i] = cur[i] - prev[i];  // a and c are zero, so Paeth picks b.
+            }
+            for (size_t i = bpp; i < len; i++) {
+                dst[i] = cur[i] - paeth_predictor(cur[i - bpp], prev[i], prev[i - bpp]);
+            }
+            break;
+        default:
+            SkASSERT(false);
+    }
+}
+
+// The usual heuristic (also libpng's): pick the filter whose output has the smallest sum of
+// absolute values, treating each byte as signed.
+static uint32_t png_filter_cost(const uint8_t* row, size_t len) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < len; i++) {
+        sum += SkAbs32((int8_t)row[i]);
+    }
+    return sum;
+}
+
+static bool deflate_to_stream(z_stream* z, const void* data, size_t len, int flush,
+                              uint8_t* buffer, size_t bufferSize, SkWStream* dst) {
+    z->next_in = (Bytef*)data;
+    z->avail_in = (uInt)len;
+    do {
+        z->next_out = buffer;
+        z->avail_out = (uInt)bufferSize;
+        if (Z_STREAM_ERROR == deflate(z, flush)) {
+            return false;
+        }
+        const size_t produced = bufferSize - z->avail_out;
+        if (produced > 0 && !dst->write(buffer, produced)) {
+            return false;
+        }
+    } while (0 == z->avail_out);
+    return true;
+}
+
+static bool deflate_png_strip(const SkStripEncoder::Strip& strip, const PngStripParams& params,
+                              SkDynamicMemoryWStream* dst, uLong* adler) {
+    const size_t rowLen = params.fWidth * params.fBpp;
+    const size_t kBufferSize = 16 * 1024;
+
+    // prev, cur, filtered (with a leading filter-type byte), candidate, zlib output.
+    SkAutoTMalloc<uint8_t> storage(4 * (rowLen + 1) + kBufferSize);
+    uint8_t* prev      = storage.get();
+    uint8_t* cur       = prev + (rowLen + 1);
+    uint8_t* filtered  = cur + (rowLen + 1);
+    uint8_t* candidate = filtered + (rowLen + 1);
+    uint8_t* buffer    = candidate + (rowLen + 1);
+
+    if (strip.fPrevRow) {
+        params.fProc(strip.fPrevRow, params.fWidth, (char*)prev);
+    } else {
+        memset(prev, 0, rowLen);
+    }
+
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (Z_OK != deflateInit2(&z, params.fZLevel, Z_DEFLATED, -MAX_WBITS, 8,
+                             Z_DEFAULT_STRATEGY)) {
+        return false;
+    }
+
+    uLong sum = adler32(0, nullptr, 0);
+    bool success = true;
+    const char* src = strip.fRows;
+    for (int y = 0; y < strip.fHeight && success; y++) {
+        params.fProc(src, params.fWidth, (char*)cur);
+        src += strip.fRowBytes;
+
+        if (params.fFilter >= 0) {
+            filtered[0] = params.fFilter;
+            filter_png_row(params.fFilter, cur, prev, params.fBpp, rowLen, filtered + 1);
+        } else {
+            filtered[0] = kNone_PngFilter;
+            filter_png_row(kNone_PngFilter, cur, prev, params.fBpp, rowLen, filtered + 1);
+            uint32_t bestCost = png_filter_cost(filtered + 1, rowLen);
+            for (int filter = kSub_PngFilter; filter < kPngFilterCount; filter++) {
+                candidate[0] = filter;
+                filter_png_row(filter, cur, prev, params.fBpp, rowLen, candidate + 1);
+                const uint32_t cost = png_filter_cost(candidate + 1, rowLen);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    SkTSwap(filtered, candidate);
+                }
+            }
+        }
+
+        sum = adler32(sum, filtered, (uInt)(rowLen + 1));
+        success = deflate_to_stream(&z, filtered, rowLen + 1, Z_NO_FLUSH,
+                                    buffer, kBufferSize, dst);
+        SkTSwap(prev, cur);
+    }
+
+    // Only the last strip may mark the end of the deflate stream.
+    success = success && deflate_to_stream(&z, nullptr, 0,
+                                           strip.fIsLast ? Z_FINISH : Z_SYNC_FLUSH,
+                                           buffer, kBufferSize, dst);
+    deflateEnd(&z);
+    *adler = sum;
+    return success;
+}
+
+static void write_be32(uint8_t* dst, uint32_t value) {
+    dst[0] = (uint8_t)(value >> 24);
+    dst[1] = (uint8_t)(value >> 16);
+    dst[2] = (uint8_t)(value >>  8);
+    dst[3] = (uint8_t)(value      );
+}
+
+// Writes a chunk whose payload is 'data' followed by 'tail'.
+static bool write_png_chunk(SkWStream* stream, const char type[4],
+                            const void* data, size_t length,
+                            const void* tail = nullptr, size_t tailLength = 0) {
+    uint8_t header[8];
+    write_be32(header, (uint32_t)(length + tailLength));
+    memcpy(header + 4, type, 4);
+
+    // crc32() with a null buffer returns the initial value, rather than crc.
+    uLong crc = crc32(0, header + 4, 4);
+    if (length) {
+        crc = crc32(crc, (const Bytef*)data, (uInt)length);
+    }
+    if (tailLength) {
+        crc = crc32(crc, (const Bytef*)tail, (uInt)tailLength);
+    }
+    uint8_t footer[4];
+    write_be32(footer, (uint32_t)crc);
+
+    return stream->write(header, sizeof(header)) &&
+           (0 == length || stream->write(data, length)) &&
+           (0 == tailLength || stream->write(tail, tailLength)) &&
+           stream->write(footer, sizeof(footer));
+}
+
+bool SkPNGImageEncoder::onEncodeStrips(SkWStream* stream, const SkImageInfo& info,
+                                       RowSource* src, int quality,
+                                       const StripOptions& options) {
+    const bool hasAlpha = !info.isOpaque();
+    png_color_8 sig_bit;
+    bool writeSigBit = true;
+    switch (info.colorType()) {
+        case kN32_SkColorType:
+            writeSigBit = false;
+            break;
+        case kARGB_4444_SkColorType:
+            sig_bit.red = sig_bit.green = sig_bit.blue = 4;
+            sig_bit.alpha = 4;
+            break;
+        case kRGB_565_SkColorType:
+            sig_bit.red = 5;
+            sig_bit.green = 6;
+            sig_bit.blue = 5;
+            break;
+        default:
+            // Let the default implementation convert, as onEncode() does.
+            return INHERITED::onEncodeStrips(stream, info, src, quality, options);
+    }
+
+    PngStripParams params;
+    params.fProc  = choose_proc(info.colorType(), hasAlpha);
+    params.fWidth = info.width();
+    params.fBpp   = hasAlpha ? 4 : 3;
+    switch (options.fPreset) {
+        case kFast_Preset:
+            params.fZLevel = Z_BEST_SPEED;
+            params.fFilter = kSub_PngFilter;
+            break;
+        case kSmall_Preset:
+            params.fZLevel = Z_BEST_COMPRESSION;
+            params.fFilter = -1;
+            break;
+        default:
+            params.fZLevel = Z_DEFAULT_COMPRESSION;
+            params.fFilter = -1;
+            break;
+    }
+
+    static const uint8_t kSignature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    uint8_t ihdr[13];
+    write_be32(ihdr + 0, info.width());
+    write_be32(ihdr + 4, info.height());
+    ihdr[8]  = 8;   // bit depth
+    ihdr[9]  = hasAlpha ? PNG_COLOR_TYPE_RGB_ALPHA : PNG_COLOR_TYPE_RGB;
+    ihdr[10] = PNG_COMPRESSION_TYPE_BASE;
+    ihdr[11] = PNG_FILTER_TYPE_BASE;
+    ihdr[12] = PNG_INTERLACE_NONE;
+    if (!stream->write(kSignature, sizeof(kSignature)) ||
+        !write_png_chunk(stream, "IHDR", ihdr, sizeof(ihdr))) {
+        return false;
+    }
+    if (writeSigBit) {
+        const uint8_t sbit[4] = { sig_bit.red, sig_bit.green, sig_bit.blue, sig_bit.alpha };
+        if (!write_png_chunk(stream, "sBIT", sbit, hasAlpha ? 4 : 3)) {
+            return false;
+        }
+    }
+
+    const int stripHeight = options.fStripHeight > 0 ? options.fStripHeight
+            : SkStripEncoder::DefaultStripHeight(info, options.fMaxConcurrentStrips);
+    SkStripEncoder encoder(info, src, stripHeight, options.fMaxConcurrentStrips);
+    SkAutoTMalloc<uLong> adlers(encoder.stripCount());
+    SkAutoTMalloc<size_t> lengths(encoder.stripCount());
+
+    // CMF: deflate with a 32K window. FLG: the level hint, plus check bits for CMF/FLG.
+    uint8_t zlibHeader[2] = { 0x78, 0x9C };
+    if (Z_BEST_SPEED == params.fZLevel) {
+        zlibHeader[1] = 0x01;
+    } else if (Z_BEST_COMPRESSION == params.fZLevel) {
+        zlibHeader[1] = 0xDA;
+    }
+    uLong adler = adler32(0, nullptr, 0);
+
+    auto compress = [&](const SkStripEncoder::Strip& strip, SkDynamicMemoryWStream* dst) {
+        if (0 == strip.fIndex && !dst->write(zlibHeader, sizeof(zlibHeader))) {
+            return false;
+        }
+        lengths[strip.fIndex] = strip.fHeight * (info.width() * params.fBpp + 1);
+        return deflate_png_strip(strip, params, dst, &adlers[strip.fIndex]);
+    };
+    auto emit = [&](int index, SkDynamicMemoryWStream* compressed) {
+        adler = adler32_combine(adler, adlers[index], (z_off_t)lengths[index]);
+        SkAutoTUnref<SkData> data(compressed->copyToData());
+        if (index < encoder.stripCount() - 1) {
+            return write_png_chunk(stream, "IDAT", data->data(), data->size());
+        }
+        uint8_t trailer[4];
+        write_be32(trailer, (uint32_t)adler);
+        return write_png_chunk(stream, "IDAT", data->data(), data->size(),
+                               trailer, sizeof(trailer));
+    };
+    if (!encoder.run(compress, emit)) {
+        return false;
+    }
+    return write_png_chunk(stream, "IEND", nullptr, 0);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 DEFINE_DECODER_CREATOR(PNGImageDecoder);
 DEFINE_ENCODER_CREATOR(PNGImageEncoder);
@@ -73,6 +73,77 @@ SkData* SkImageEncoder::EncodeData(const SkPixmap& pixmap,
     return SkImageEncoder::EncodeData(bm, t, quality);
 }
 
+bool SkImageEncoder::encodeStrips(SkWStream* stream, const SkImageInfo& info, RowSource* src,
+                                  int quality, const StripOptions& options) {
+    if (info.isEmpty() || kUnknown_SkColorType == info.colorType() ||
+        kIndex_8_SkColorType == info.colorType() || nullptr == src) {
+        return false;
+    }
+    if (options.fStripHeight < 0 || options.fMaxConcurrentStrips < 0) {
+        return false;
+    }
+    quality = SkMin32(100, SkMax32(0, quality));
+    return this->onEncodeStrips(stream, info, src, quality, options);
+}
+
+bool SkImageEncoder::onEncodeStrips(SkWStream* stream, const SkImageInfo& info, RowSource* src,
+                                    int quality, const StripOptions&) {
+    SkBitmap bm;
+    size_t rowBytes;
+    if (const void* pixels = src->peekPixels(&rowBytes)) {
+        if (!bm.installPixels(info, const_cast<void*>(pixels), rowBytes)) {
+            return false;
+        }
+    } else {
+        if (!bm.tryAllocPixels(info)) {
+            return false;
+        }
+        if (!src->getRows(0, info.height(), bm.getPixels(), bm.rowBytes())) {
+            return false;
+        }
+    }
+    bm.setImmutable();
+    return this->onEncode(stream, bm, quality);
+}
+
+bool SkImageEncoder::EncodeStrips(SkWStream* stream, const SkImageInfo& info, RowSource* src,
+                                  Type t, int quality, const StripOptions& options) {
+    SkAutoTDelete<SkImageEncoder> enc(SkImageEncoder::Create(t));
+    return enc.get() && enc.get()->encodeStrips(stream, info, src, quality, options);
+}
+
+namespace {
+class PixmapRowSource final : public SkImageEncoder::RowSource {
+public:
+    explicit PixmapRowSource(const SkPixmap& pmap) : fPixmap(pmap) {}
+
+    bool getRows(int y, int count, void* dst, size_t rowBytes) override {
+        const size_t bytes = fPixmap.info().minRowBytes();
+        for (int i = 0; i < count; i++) {
+            memcpy(SkTAddOffset<void>(dst, i * rowBytes), fPixmap.addr(0, y + i), bytes);
+        }
+        return true;
+    }
+
+    const void* peekPixels(size_t* rowBytes) override {
+        *rowBytes = fPixmap.rowBytes();
+        return fPixmap.addr();
+    }
+
+private:
+    const SkPixmap& fPixmap;
+};
+} // namespace
+
+bool SkImageEncoder::EncodeStrips(SkWStream* stream, const SkPixmap& pixmap,
+                                  Type t, int quality, const StripOptions& options) {
+    if (nullptr == pixmap.addr()) {
+        return false;
+    }
+    PixmapRowSource src(pixmap);
+    return SkImageEncoder::EncodeStrips(stream, pixmap.info(), &src, t, quality, options);
+}
+
 namespace {
 class ImageEncoderPixelSerializer final : public SkPixelSerializer {
 protected:
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStripEncoder.h"
+#include "SkTaskGroup.h"
+
+static int resolve_concurrency(int maxConcurrentStrips) {
+    return maxConcurrentStrips > 0 ? maxConcurrentStrips : SkTMax(1, sk_num_cores());
+}
+
+SkStripEncoder::SkStripEncoder(const SkImageInfo& info, SkImageEncoder::RowSource* src,
+                               int stripHeight, int maxConcurrentStrips)
+    : fInfo(info)
+    , fSrc(src)
+    , fStripHeight(SkTMin(stripHeight, info.height()))
+    , fStripCount((info.height() + fStripHeight - 1) / fStripHeight)
+    , fBatchSize(SkTMin(resolve_concurrency(maxConcurrentStrips), fStripCount))
+{
+    SkASSERT(stripHeight > 0);
+    SkASSERT(!info.isEmpty());
+}
+
+int SkStripEncoder::DefaultStripHeight(const SkImageInfo& info, int maxConcurrentStrips) {
+    // Below ~256K of pixels per strip, the fixed cost of each strip (and, for zlib, the lost
+    // history at each strip boundary) starts to show. Above ~4M we hold too much in memory.
+    static const size_t kMinStripBytes = 256 * 1024;
+    static const size_t kMaxStripBytes = 4 * 1024 * 1024;
+
+    const size_t rowBytes = SkTMax<size_t>(1, info.minRowBytes());
+    const int minRows = (int)SkTMax<size_t>(1, kMinStripBytes / rowBytes);
+    const int maxRows = (int)SkTMax<size_t>(minRows, kMaxStripBytes / rowBytes);
+
+    const int concurrency = resolve_concurrency(maxConcurrentStrips);
+    const int perStrip = (info.height() + concurrency - 1) / concurrency;
+    return SkTMin(SkTPin(perStrip, minRows, maxRows), info.height());
+}
+
+bool SkStripEncoder::run(const CompressProc& compress, const EmitProc& emit) {
+    const size_t minRowBytes = fInfo.minRowBytes();
+
+    size_t peekedRowBytes = 0;
+    const char* peeked = (const char*)fSrc->peekPixels(&peekedRowBytes);
+
+    // When we have to copy rows, each slot holds the last row of the previous strip, followed
+    // by the strip's own rows.
+    const size_t slotBytes = (fStripHeight + 1) * minRowBytes;
+    SkAutoTMalloc<char> storage;
+    if (!peeked) {
+        storage.reset(fBatchSize * slotBytes);
+    }
+
+    SkAutoTMalloc<Strip> strips(fBatchSize);
+    SkAutoTMalloc<bool> results(fBatchSize);
+    SkAutoTDeleteArray<SkDynamicMemoryWStream> outputs(new SkDynamicMemoryWStream[fBatchSize]);
+
+    const char* prevRow = nullptr;
+    for (int first = 0; first < fStripCount; first += fBatchSize) {
+        const int count = SkTMin(fBatchSize, fStripCount - first);
+
+        for (int i = 0; i < count; i++) {
+            Strip& strip = strips[i];
+            strip.fIndex  = first + i;
+            strip.fY      = strip.fIndex * fStripHeight;
+            strip.fHeight = SkTMin(fStripHeight, fInfo.height() - strip.fY);
+            strip.fIsLast = strip.fIndex == fStripCount - 1;
+
+            if (peeked) {
+                strip.fRowBytes = peekedRowBytes;
+                strip.fRows     = peeked + strip.fY * peekedRowBytes;
+                strip.fPrevRow  = strip.fY > 0 ? strip.fRows - peekedRowBytes : nullptr;
+                continue;
+            }
+
+            char* slot = storage.get() + i * slotBytes;
+            char* rows = slot + minRowBytes;
+            // Copy the previous row first: with a batch size of 1 it lives in this very slot.
+            if (prevRow) {
+                memcpy(slot, prevRow, minRowBytes);
+            }
+            if (!fSrc->getRows(strip.fY, strip.fHeight, rows, minRowBytes)) {
+                return false;
+            }
+            strip.fRowBytes = minRowBytes;
+            strip.fRows     = rows;
+            strip.fPrevRow  = prevRow ? slot : nullptr;
+            prevRow = rows + (strip.fHeight - 1) * minRowBytes;
+        }
+
+        if (1 == count) {
+            results[0] = compress(strips[0], &outputs[0]);
+        } else {
+            SkTaskGroup tg;
+            tg.batch(count, [&](int i) { results[i] = compress(strips[i], &outputs[i]); });
+            tg.wait();
+        }
+
+        for (int i = 0; i < count; i++) {
+            if (!results[i] || !emit(strips[i].fIndex, &outputs[i])) {
+                return false;
+            }
+            outputs[i].reset();
+        }
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStripEncoder_DEFINED
+#define SkStripEncoder_DEFINED
+
+#include "SkImageEncoder.h"
+#include "SkImageInfo.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+
+#include <functional>
+
+/**
+ *  Drives a strip encode for SkImageEncoder::onEncodeStrips().
+ *
+ *  Rows are pulled from the RowSource on the calling thread, a batch of strips at a time.
+ *  Each strip in the batch is then compressed on SkTaskGroup, and once the whole batch is
+ *  done the compressed strips are emitted to the caller, in order, on the calling thread.
+ */
+class SkStripEncoder : SkNoncopyable {
+public:
+    struct Strip {
+        int         fIndex;
+        int         fY;         // first row of the strip
+        int         fHeight;
+        const char* fRows;      // fHeight rows, fRowBytes apart
+        const char* fPrevRow;   // row fY - 1, or nullptr for the first strip
+        size_t      fRowBytes;
+        bool        fIsLast;
+    };
+
+    // Runs in parallel; returns false to fail the encode.
+    typedef std::function<bool(const Strip&, SkDynamicMemoryWStream* dst)> CompressProc;
+    // Runs serially, in strip order; returns false to fail the encode.
+    typedef std::function<bool(int index, SkDynamicMemoryWStream* compressed)> EmitProc;
+
+    /**
+     *  'stripHeight' must be positive. 'maxConcurrentStrips' of 0 means sk_num_cores().
+     */
+    SkStripEncoder(const SkImageInfo&, SkImageEncoder::RowSource*, int stripHeight,
+                   int maxConcurrentStrips);
+
+    int stripHeight() const { return fStripHeight; }
+    int stripCount() const { return fStripCount; }
+
+    bool run(const CompressProc&, const EmitProc&);
+
+    /**
+     *  Suggest a strip height for an image of this info: enough rows to keep per-strip setup
+     *  costs in the noise, but enough strips to keep every thread busy.
+     */
+    static int DefaultStripHeight(const SkImageInfo&, int maxConcurrentStrips);
+
+private:
+    const SkImageInfo               fInfo;
+    SkImageEncoder::RowSource*      fSrc;
+    const int                       fStripHeight;
+    const int                       fStripCount;
+    const int                       fBatchSize;
+};
+
+#endif
@@ -0,0 +1,393 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBitmapFilter_opts_DEFINED
+#define SkBitmapFilter_opts_DEFINED
+
+#include "SkConvolver.h"
+#include "SkNx.h"
+
+// These convolve B G R A pixels by SkConvolutionFilter1D's 14-bit fixed point filters, for
+// BGRAConvolve2D().  None of them read past the pixels or filter values they use, so they can
+// run right up to the last row and column of an image.
+
+namespace SK_OPTS_NS {
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+// With SSE we work in 16-bit, two taps at a time: _mm_madd_epi16 multiplies channels from two
+// pixels by their taps' coefficients and sums each channel's pair into 32 bits.
+
+// c0 c1 c0 c1 ..., to multiply pairs of pixels interleaved as by convolve_interleave().
+static inline __m128i convolve_coeffs(SkConvolutionFilter1D::ConvolutionFixed c0,
+                                      SkConvolutionFilter1D::ConvolutionFixed c1) {
+    return _mm_set1_epi32((uint16_t)c0 | ((uint32_t)(uint16_t)c1 << 16));
+}
+
+// The two pixels B G R A b g r a in the low 8 bytes -> 16-bit B b G g R r A a.
+static inline __m128i convolve_interleave(__m128i px) {
+    return _mm_unpacklo_epi8(_mm_unpacklo_epi8(px, _mm_srli_si128(px, 4)),
+                             _mm_setzero_si128());
+}
+
+// Shifts 32-bit sums back down by kShiftBits and packs them to bytes, clamping to [0,255].
+static inline __m128i convolve_pack(__m128i accum0, __m128i accum1,
+                                    __m128i accum2, __m128i accum3) {
+    const int shift = SkConvolutionFilter1D::kShiftBits;
+    return _mm_packus_epi16(_mm_packs_epi32(_mm_srai_epi32(accum0, shift),
+                                            _mm_srai_epi32(accum1, shift)),
+                            _mm_packs_epi32(_mm_srai_epi32(accum2, shift),
+                                            _mm_srai_epi32(accum3, shift)));
+}
+
+// Raises each packed pixel's alpha to at least its largest color channel.  The colors are
+// premultiplied, so only rounding can push one past alpha, but the resulting "impossible"
+// colors overflow when they are drawn.
+static inline __m128i convolve_fix_alpha(__m128i px) {
+    const __m128i maxColor = _mm_max_epu8(px, _mm_max_epu8(_mm_srli_epi32(px,  8),
+                                                           _mm_srli_epi32(px, 16)));
+    return _mm_max_epu8(px, _mm_slli_epi32(maxColor, 24));
+}
+
+static void convolve_horizontally(const unsigned char* srcData,
+                                  const SkConvolutionFilter1D& filter,
+                                  unsigned char* outRow,
+                                  bool /*hasAlpha*/) {
+    const __m128i zero = _mm_setzero_si128();
+    const int numValues = filter.numValues();
+    for (int outX = 0; outX < numValues; outX++) {
+        int filterOffset, filterLength;
+        const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
+            filter.FilterForValue(outX, &filterOffset, &filterLength);
+        const unsigned char* rowToFilter = srcData + filterOffset * 4;
+
+        __m128i accum = zero;
+        int filterX = 0;
+        for (; filterX + 2 <= filterLength; filterX += 2) {
+            const __m128i px = _mm_loadl_epi64((const __m128i*)(rowToFilter + filterX * 4));
+            accum = _mm_add_epi32(accum, _mm_madd_epi16(convolve_interleave(px),
+                    convolve_coeffs(filterValues[filterX], filterValues[filterX + 1])));
+        }
+        if (filterX < filterLength) {
+            // The missing second pixel reads as zero.
+            const __m128i px = _mm_cvtsi32_si128(*(const int*)(rowToFilter + filterX * 4));
+            accum = _mm_add_epi32(accum, _mm_madd_epi16(convolve_interleave(px),
+                    convolve_coeffs(filterValues[filterX], 0)));
+        }
+        *(int*)(outRow + outX * 4) = _mm_cvtsi128_si32(convolve_pack(accum, zero, zero, zero));
+    }
+}
+
+static void convolve_4_rows_horizontally(const unsigned char* srcData[4],
+                                         const SkConvolutionFilter1D& filter,
+                                         unsigned char* outRow[4],
+                                         size_t /*outRowBytes*/) {
+    const int numValues = filter.numValues();
+    for (int outX = 0; outX < numValues; outX++) {
+        int filterOffset, filterLength;
+        const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
+            filter.FilterForValue(outX, &filterOffset, &filterLength);
+        const int start = filterOffset * 4;
+
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        // Rows 0 and 1 share one register, and rows 2 and 3 the other.  AVX2 shifts and
+        // unpacks within 128-bit lanes, so each row is interleaved just as with SSE.
+        auto join = [](__m128i lo, __m128i hi) {
+            return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        };
+        auto interleave = [](__m256i px) {
+            return _mm256_unpacklo_epi8(_mm256_unpacklo_epi8(px, _mm256_srli_si256(px, 4)),
+                                        _mm256_setzero_si256());
+        };
+        __m256i accum01 = _mm256_setzero_si256(),
+                accum23 = _mm256_setzero_si256();
+        for (int filterX = 0; filterX < filterLength; filterX += 2) {
+            const int x = start + filterX * 4;
+            __m256i px01, px23, coeffs;
+            if (filterX + 2 <= filterLength) {
+                auto load2 = [x](const unsigned char* row) {
+                    return _mm_loadl_epi64((const __m128i*)(row + x));
+                };
+                px01 = join(load2(srcData[0]), load2(srcData[1]));
+                px23 = join(load2(srcData[2]), load2(srcData[3]));
+                coeffs = _mm256_broadcastsi128_si256(
+                        convolve_coeffs(filterValues[filterX], filterValues[filterX + 1]));
+            } else {
+                auto load1 = [x](const unsigned char* row) {
+                    return _mm_cvtsi32_si128(*(const int*)(row + x));
+                };
+                px01 = join(load1(srcData[0]), load1(srcData[1]));
+                px23 = join(load1(srcData[2]), load1(srcData[3]));
+                coeffs = _mm256_broadcastsi128_si256(convolve_coeffs(filterValues[filterX], 0));
+            }
+            accum01 = _mm256_add_epi32(accum01, _mm256_madd_epi16(interleave(px01), coeffs));
+            accum23 = _mm256_add_epi32(accum23, _mm256_madd_epi16(interleave(px23), coeffs));
+        }
+        const __m128i accum0 = _mm256_castsi256_si128(accum01),
+                      accum1 = _mm256_extracti128_si256(accum01, 1),
+                      accum2 = _mm256_castsi256_si128(accum23),
+                      accum3 = _mm256_extracti128_si256(accum23, 1);
+    #else
+        __m128i accum0 = _mm_setzero_si128(),
+                accum1 = _mm_setzero_si128(),
+                accum2 = _mm_setzero_si128(),
+                accum3 = _mm_setzero_si128();
+        for (int filterX = 0; filterX < filterLength; filterX += 2) {
+            const int x = start + filterX * 4;
+            const bool pair = filterX + 2 <= filterLength;
+            const __m128i coeffs = convolve_coeffs(filterValues[filterX],
+                                                   pair ? filterValues[filterX + 1] : 0);
+            auto tap = [x, pair, coeffs](const unsigned char* row) {
+                const __m128i px = pair ? _mm_loadl_epi64((const __m128i*)(row + x))
+                                        : _mm_cvtsi32_si128(*(const int*)(row + x));
+                return _mm_madd_epi16(convolve_interleave(px), coeffs);
+            };
+            accum0 = _mm_add_epi32(accum0, tap(srcData[0]));
+            accum1 = _mm_add_epi32(accum1, tap(srcData[1]));
+            accum2 = _mm_add_epi32(accum2, tap(srcData[2]));
+            accum3 = _mm_add_epi32(accum3, tap(srcData[3]));
+        }
+    #endif
+        const __m128i px = convolve_pack(accum0, accum1, accum2, accum3);
+        *(int*)(outRow[0] + outX * 4) = _mm_cvtsi128_si32(px);
+        *(int*)(outRow[1] + outX * 4) = _mm_cvtsi128_si32(_mm_srli_si128(px,  4));
+        *(int*)(outRow[2] + outX * 4) = _mm_cvtsi128_si32(_mm_srli_si128(px,  8));
+        *(int*)(outRow[3] + outX * 4) = _mm_cvtsi128_si32(_mm_srli_si128(px, 12));
+    }
+}
+
+static void convolve_vertically(const SkConvolutionFilter1D::ConvolutionFixed* filterValues,
+                                int filterLength,
+                                unsigned char* const* sourceDataRows,
+                                int pixelWidth,
+                                unsigned char* outRow,
+                                bool hasAlpha) {
+    // Pairs of rows are interleaved byte by byte, so each 32-bit lane of a madd sums one
+    // channel of one pixel from both rows.  An odd last row pairs with zeros.
+    const __m128i zero = _mm_setzero_si128(),
+                  opaque = _mm_set1_epi32(0xFF000000);
+    int outX = 0;
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    // AVX2 unpacks within 128-bit lanes, so accum0 holds pixels 0 and 4, accum1 pixels 1 and
+    // 5, and so on.  The packs work within lanes too, which puts them back in order.
+    for (; outX + 8 <= pixelWidth; outX += 8) {
+        const int x = outX * 4;
+        const __m256i zero8 = _mm256_setzero_si256();
+        __m256i accum0 = zero8, accum1 = zero8, accum2 = zero8, accum3 = zero8;
+        for (int filterY = 0; filterY < filterLength; filterY += 2) {
+            const bool pair = filterY + 1 < filterLength;
+            const __m256i coeffs = _mm256_broadcastsi128_si256(convolve_coeffs(
+                    filterValues[filterY], pair ? filterValues[filterY + 1] : 0));
+            const __m256i a = _mm256_loadu_si256((const __m256i*)(sourceDataRows[filterY] + x)),
+                          b = pair ? _mm256_loadu_si256(
+                                         (const __m256i*)(sourceDataRows[filterY + 1] + x))
+                                   : zero8;
+            const __m256i lo = _mm256_unpacklo_epi8(a, b),
+                          hi = _mm256_unpackhi_epi8(a, b);
+            accum0 = _mm256_add_epi32(accum0,
+                    _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero8), coeffs));
+            accum1 = _mm256_add_epi32(accum1,
+                    _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero8), coeffs));
+            accum2 = _mm256_add_epi32(accum2,
+                    _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero8), coeffs));
+            accum3 = _mm256_add_epi32(accum3,
+                    _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero8), coeffs));
+        }
+        const int shift = SkConvolutionFilter1D::kShiftBits;
+        __m256i px = _mm256_packus_epi16(
+                _mm256_packs_epi32(_mm256_srai_epi32(accum0, shift),
+                                   _mm256_srai_epi32(accum1, shift)),
+                _mm256_packs_epi32(_mm256_srai_epi32(accum2, shift),
+                                   _mm256_srai_epi32(accum3, shift)));
+        if (hasAlpha) {
+            const __m256i maxColor = _mm256_max_epu8(px,
+                    _mm256_max_epu8(_mm256_srli_epi32(px, 8), _mm256_srli_epi32(px, 16)));
+            px = _mm256_max_epu8(px, _mm256_slli_epi32(maxColor, 24));
+        } else {
+            px = _mm256_or_si256(px, _mm256_broadcastsi128_si256(opaque));
+        }
+        _mm256_storeu_si256((__m256i*)(outRow + x), px);
+    }
+#endif
+
+    for (; outX + 4 <= pixelWidth; outX += 4) {
+        const int x = outX * 4;
+        __m128i accum0 = zero, accum1 = zero, accum2 = zero, accum3 = zero;
+        for (int filterY = 0; filterY < filterLength; filterY += 2) {
+            const bool pair = filterY + 1 < filterLength;
+            const __m128i coeffs = convolve_coeffs(filterValues[filterY],
+                                                   pair ? filterValues[filterY + 1] : 0);
+            const __m128i a = _mm_loadu_si128((const __m128i*)(sourceDataRows[filterY] + x)),
+                          b = pair ? _mm_loadu_si128(
+                                         (const __m128i*)(sourceDataRows[filterY + 1] + x))
+                                   : zero;
+            const __m128i lo = _mm_unpacklo_epi8(a, b),
+                          hi = _mm_unpackhi_epi8(a, b);
+            accum0 = _mm_add_epi32(accum0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), coeffs));
+            accum1 = _mm_add_epi32(accum1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), coeffs));
+            accum2 = _mm_add_epi32(accum2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), coeffs));
+            accum3 = _mm_add_epi32(accum3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), coeffs));
+        }
+        const __m128i px = convolve_pack(accum0, accum1, accum2, accum3);
+        _mm_storeu_si128((__m128i*)(outRow + x),
+                         hasAlpha ? convolve_fix_alpha(px) : _mm_or_si128(px, opaque));
+    }
+
+    for (; outX < pixelWidth; outX++) {
+        const int x = outX * 4;
+        __m128i accum = zero;
+        for (int filterY = 0; filterY < filterLength; filterY += 2) {
+            const bool pair = filterY + 1 < filterLength;
+            const __m128i coeffs = convolve_coeffs(filterValues[filterY],
+                                                   pair ? filterValues[filterY + 1] : 0);
+            const __m128i a = _mm_cvtsi32_si128(*(const int*)(sourceDataRows[filterY] + x)),
+                          b = pair ? _mm_cvtsi32_si128(
+                                         *(const int*)(sourceDataRows[filterY + 1] + x))
+                                   : zero;
+            accum = _mm_add_epi32(accum,
+                    _mm_madd_epi16(_mm_unpacklo_epi8(_mm_unpacklo_epi8(a, b), zero), coeffs));
+        }
+        const __m128i px = convolve_pack(accum, zero, zero, zero);
+        *(int*)(outRow + x) = _mm_cvtsi128_si32(
+                hasAlpha ? convolve_fix_alpha(px) : _mm_or_si128(px, opaque));
+    }
+}
+
+#else
+
+// Elsewhere we accumulate in floats.  Every product of a 14-bit coefficient and a byte is an
+// integer under 2^23, and so is any running sum a normalized filter makes, so this is exact,
+// matching the integer math of the SSE code bit for bit.
+
+// B G R A bytes -> 4 floats.
+static inline Sk4f convolve_load(const unsigned char* px) {
+    return SkNx_cast<float>(Sk4b::Load(px));
+}
+
+// Shifts a sum back down by kShiftBits (rounding down, like >>) and clamps it to [0,255].
+static inline Sk4f convolve_unfix(const Sk4f& accum) {
+    const Sk4f v = SkNx_cast<float>(SkNx_cast<int>(accum) >> SkConvolutionFilter1D::kShiftBits);
+    return Sk4f::Min(Sk4f::Max(v, Sk4f(0)), Sk4f(255));
+}
+
+static inline void convolve_store(unsigned char* out, const Sk4f& accum) {
+    SkNx_cast<uint8_t>(convolve_unfix(accum)).store(out);
+}
+
+// Convolves one row horizontally, one output pixel (all four channels) at a time.
+static void convolve_horizontally(const unsigned char* srcData,
+                                  const SkConvolutionFilter1D& filter,
+                                  unsigned char* outRow,
+                                  bool /*hasAlpha*/) {
+    const int numValues = filter.numValues();
+    for (int outX = 0; outX < numValues; outX++) {
+        int filterOffset, filterLength;
+        const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
+            filter.FilterForValue(outX, &filterOffset, &filterLength);
+        const unsigned char* rowToFilter = srcData + filterOffset * 4;
+
+        // Two accumulators keep consecutive taps from waiting on each other.
+        Sk4f accum0(0), accum1(0);
+        int filterX = 0;
+        for (; filterX + 1 < filterLength; filterX += 2) {
+            const unsigned char* px = rowToFilter + filterX * 4;
+            accum0 = accum0 + convolve_load(px + 0) * Sk4f(filterValues[filterX + 0]);
+            accum1 = accum1 + convolve_load(px + 4) * Sk4f(filterValues[filterX + 1]);
+        }
+        if (filterX < filterLength) {
+            const Sk4f coeff(filterValues[filterX]);
+            accum0 = accum0 + convolve_load(rowToFilter + filterX * 4) * coeff;
+        }
+        convolve_store(outRow + outX * 4, accum0 + accum1);
+    }
+}
+
+// Convolves four rows horizontally at once, sharing the filter lookups and coefficients.
+static void convolve_4_rows_horizontally(const unsigned char* srcData[4],
+                                         const SkConvolutionFilter1D& filter,
+                                         unsigned char* outRow[4],
+                                         size_t /*outRowBytes*/) {
+    const int numValues = filter.numValues();
+    for (int outX = 0; outX < numValues; outX++) {
+        int filterOffset, filterLength;
+        const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
+            filter.FilterForValue(outX, &filterOffset, &filterLength);
+        const int start = filterOffset * 4;
+
+        Sk4f accum0(0), accum1(0), accum2(0), accum3(0);
+        for (int filterX = 0; filterX < filterLength; filterX++) {
+            const Sk4f coeff(filterValues[filterX]);
+            const int x = start + filterX * 4;
+            accum0 = accum0 + convolve_load(srcData[0] + x) * coeff;
+            accum1 = accum1 + convolve_load(srcData[1] + x) * coeff;
+            accum2 = accum2 + convolve_load(srcData[2] + x) * coeff;
+            accum3 = accum3 + convolve_load(srcData[3] + x) * coeff;
+        }
+        convolve_store(outRow[0] + outX * 4, accum0);
+        convolve_store(outRow[1] + outX * 4, accum1);
+        convolve_store(outRow[2] + outX * 4, accum2);
+        convolve_store(outRow[3] + outX * 4, accum3);
+    }
+}
+
+// Raises each packed pixel's alpha to at least its largest color channel, as above.
+static inline Sk4i convolve_fix_alpha(const Sk4i& px) {
+    const Sk4i byte(0xFF);
+    const Sk4f b = SkNx_cast<float>(px         & byte),
+               g = SkNx_cast<float>((px >>  8) & byte),
+               r = SkNx_cast<float>((px >> 16) & byte),
+               a = SkNx_cast<float>((px >> 24) & byte);
+    const Sk4i maxA = SkNx_cast<int>(Sk4f::Max(a, Sk4f::Max(b, Sk4f::Max(g, r))));
+    return (px & Sk4i(0x00FFFFFF)) | (maxA << 24);
+}
+
+// Convolves one output row vertically from filterLength rows, four pixels at a time.
+static void convolve_vertically(const SkConvolutionFilter1D::ConvolutionFixed* filterValues,
+                                int filterLength,
+                                unsigned char* const* sourceDataRows,
+                                int pixelWidth,
+                                unsigned char* outRow,
+                                bool hasAlpha) {
+    const Sk4i opaque((int)0xFF000000);
+    int outX = 0;
+    for (; outX + 4 <= pixelWidth; outX += 4) {
+        const int x = outX * 4;
+        Sk4f accum0(0), accum1(0), accum2(0), accum3(0);
+        for (int filterY = 0; filterY < filterLength; filterY++) {
+            const Sk4f coeff(filterValues[filterY]);
+            const unsigned char* src = sourceDataRows[filterY] + x;
+            accum0 = accum0 + convolve_load(src +  0) * coeff;
+            accum1 = accum1 + convolve_load(src +  4) * coeff;
+            accum2 = accum2 + convolve_load(src +  8) * coeff;
+            accum3 = accum3 + convolve_load(src + 12) * coeff;
+        }
+        uint8_t bytes[16];
+        Sk4f_ToBytes(bytes, convolve_unfix(accum0), convolve_unfix(accum1),
+                            convolve_unfix(accum2), convolve_unfix(accum3));
+        const Sk4i px = Sk4i::Load(bytes);
+        (hasAlpha ? convolve_fix_alpha(px) : px | opaque).store(outRow + x);
+    }
+    for (; outX < pixelWidth; outX++) {
+        const int x = outX * 4;
+        Sk4f accum(0);
+        for (int filterY = 0; filterY < filterLength; filterY++) {
+            const Sk4f coeff(filterValues[filterY]);
+            accum = accum + convolve_load(sourceDataRows[filterY] + x) * coeff;
+        }
+        int px;
+        convolve_store((unsigned char*)&px, accum);
+        px = (hasAlpha ? convolve_fix_alpha(Sk4i(px)) : Sk4i(px) | opaque)[0];
+        memcpy(outRow + x, &px, 4);
+    }
+}
+
+#endif
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkBitmapFilter_opts_DEFINED
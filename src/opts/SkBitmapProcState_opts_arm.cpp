@@ -6,7 +6,6 @@
  */
 
 
-#include "SkBitmapScaler.h"
 #include "SkBitmapProcState.h"
 #include "SkColorPriv.h"
 #include "SkPaint.h"
@@ -14,17 +13,4 @@
 #include "SkUtils.h"
 #include "SkUtilsArm.h"
 
-#include "SkConvolver.h"
-
 void SkBitmapProcState::platformProcs() { }
-
-///////////////////////////////////////////////////////////////////////////////
-
-extern void platformConvolutionProcs_arm_neon(SkConvolutionProcs* procs);
-
-void platformConvolutionProcs_arm(SkConvolutionProcs* procs) {
-}
-
-void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs* procs) {
-    SK_ARM_NEON_WRAP(platformConvolutionProcs_arm)(procs);
-}
@@ -7,7 +7,6 @@
 
 
 #include "SkBitmapProcState.h"
-#include "SkBitmapScaler.h"
 #include "SkColorPriv.h"
 #include "SkPaint.h"
 #include "SkUtils.h"
@@ -257,5 +256,3 @@ void SkBitmapProcState::platformProcs() {
             break;
     }
 }
-
-void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs*) {}
@@ -0,0 +1,18 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkOpts.h"
+
+#define SK_OPTS_NS sk_avx2
+#include "SkBitmapFilter_opts.h"
+
+namespace SkOpts {
+    void Init_avx2() {
+        convolve_4_rows_horizontally = sk_avx2::convolve_4_rows_horizontally;
+        convolve_vertically          = sk_avx2::convolve_vertically;
+    }
+}
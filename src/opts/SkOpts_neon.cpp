@@ -8,6 +8,7 @@
 #include "SkOpts.h"
 
 #define SK_OPTS_NS sk_neon
+#include "SkBitmapFilter_opts.h"
 #include "SkBlitMask_opts.h"
 #include "SkBlitRow_opts.h"
 #include "SkBlurImageFilter_opts.h"
@@ -17,6 +18,7 @@
 #include "SkSwizzler_opts.h"
 #include "SkTextureCompressor_opts.h"
 #include "SkXfermode_opts.h"
+#include "SkYUV_opts.h"
 
 namespace SkOpts {
     void Init_neon() {
@@ -54,5 +56,12 @@ namespace SkOpts {
         grayA_to_rgbA         = sk_neon::grayA_to_rgbA;
         inverted_CMYK_to_RGB1 = sk_neon::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = sk_neon::inverted_CMYK_to_BGR1;
+
+        YUV_to_RGB1 = sk_neon::YUV_to_RGB1;
+        YUV_to_BGR1 = sk_neon::YUV_to_BGR1;
+
+        convolve_horizontally        = sk_neon::convolve_horizontally;
+        convolve_4_rows_horizontally = sk_neon::convolve_4_rows_horizontally;
+        convolve_vertically          = sk_neon::convolve_vertically;
     }
 }
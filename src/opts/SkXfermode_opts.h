@@ -11,6 +11,7 @@
 #include "Sk4px.h"
 #include "SkMSAN.h"
 #include "SkNx.h"
+#include "SkXfermode_nonseparable.h"
 #include "SkXfermode_proccoeff.h"
 
 namespace {
@@ -311,6 +312,108 @@ private:
     typedef SkProcCoeffXfermode INHERITED;
 };
 
+// The non-separable modes blend four pixels at a time, with each channel in its own Sk4f.
+#define XFERMODE(Xfermode, blend) \
+    struct Xfermode { \
+        SkPlanes4f operator()(const SkPlanes4f& d, const SkPlanes4f& s) const { \
+            return blend(s, d); \
+        } \
+    }
+
+XFERMODE(Hue,        planes_hue);
+XFERMODE(Saturation, planes_saturation);
+XFERMODE(Color,      planes_color);
+XFERMODE(Luminosity, planes_luminosity);
+#undef XFERMODE
+
+template <typename Xfermode>
+class SkPlanesXfermode : public SkProcCoeffXfermode {
+public:
+    SkPlanesXfermode(const ProcCoeff& rec, SkXfermode::Mode mode)
+        : INHERITED(rec, mode) {}
+
+    void xfer32(SkPMColor dst[], const SkPMColor src[], int n, const SkAlpha aa[]) const override {
+        while (n > 0) {
+            const int count = SkTMin(n, 4);
+            Xfer32_4(dst, src, count, aa);
+            dst += 4;
+            src += 4;
+            aa  += aa ? 4 : 0;
+            n   -= 4;
+        }
+    }
+
+    void xfer16(uint16_t dst[], const SkPMColor src[], int n, const SkAlpha aa[]) const override {
+        SkPMColor dst32[4];
+        while (n > 0) {
+            const int count = SkTMin(n, 4);
+            for (int i = 0; i < count; i++) {
+                dst32[i] = SkPixel16ToPixel32(dst[i]);
+            }
+            Xfer32_4(dst32, src, count, aa);
+            for (int i = 0; i < count; i++) {
+                dst[i] = SkPixel32ToPixel16(dst32[i]);
+            }
+            dst += 4;
+            src += 4;
+            aa  += aa ? 4 : 0;
+            n   -= 4;
+        }
+    }
+
+private:
+    // Blends count <= 4 pixels.  Short spans repeat their last pixel to fill out the Sk4fs.
+    static void Xfer32_4(SkPMColor dst[], const SkPMColor src[], int count, const SkAlpha* aa) {
+        SkPMColor d[4], s[4];
+        SkAlpha a[4];
+        if (count < 4) {
+            for (int i = 0; i < 4; i++) {
+                d[i] = dst[SkTMin(i, count - 1)];
+                s[i] = src[SkTMin(i, count - 1)];
+                a[i] = aa ? aa[SkTMin(i, count - 1)] : 0;
+            }
+        }
+        const SkPlanes4f dp = Load(count < 4 ? d : dst),
+                         sp = Load(count < 4 ? s : src);
+        SkPlanes4f b = Xfermode()(dp, sp);
+        if (aa) {
+            const Sk4f cov = SkNx_cast<float>(Sk4b::Load(count < 4 ? a : aa)) * Sk4f(1.0f/255);
+            b.r = dp.r + (b.r - dp.r) * cov;
+            b.g = dp.g + (b.g - dp.g) * cov;
+            b.b = dp.b + (b.b - dp.b) * cov;
+            b.a = dp.a + (b.a - dp.a) * cov;
+        }
+
+        const Sk4i px = (Round(b.a) << SK_A32_SHIFT) | (Round(b.r) << SK_R32_SHIFT) |
+                        (Round(b.g) << SK_G32_SHIFT) | (Round(b.b) << SK_B32_SHIFT);
+        if (4 == count) {
+            px.store(dst);
+        } else {
+            SkPMColor tmp[4];
+            px.store(tmp);
+            memcpy(dst, tmp, count * sizeof(SkPMColor));
+        }
+    }
+
+    static SkPlanes4f Load(const SkPMColor c[4]) {
+        const Sk4i px = Sk4i::Load(c);
+        const Sk4f scale(1.0f/255);
+        return {
+            SkNx_cast<float>((px >> SK_R32_SHIFT) & 0xFF) * scale,
+            SkNx_cast<float>((px >> SK_G32_SHIFT) & 0xFF) * scale,
+            SkNx_cast<float>((px >> SK_B32_SHIFT) & 0xFF) * scale,
+            SkNx_cast<float>((px >> SK_A32_SHIFT) & 0xFF) * scale,
+        };
+    }
+
+    // The blends can stray a touch past 1, so pin before converting.
+    static Sk4i Round(const Sk4f& f) {
+        return SkNx_cast<int>(Sk4f::Min(f, Sk4f(1)) * Sk4f(255) + Sk4f(0.5f));
+    }
+
+    typedef SkProcCoeffXfermode INHERITED;
+};
+
 } // namespace
 
 namespace SK_OPTS_NS {
@@ -350,6 +453,14 @@ static SkXfermode* create_xfermode(const ProcCoeff& rec, SkXfermode::Mode mode)
         CASE(SoftLight);
     #undef CASE
 
+#define CASE(Xfermode) \
+    case SkXfermode::k##Xfermode##_Mode: return new SkPlanesXfermode<Xfermode>(rec, mode)
+        CASE(Hue);
+        CASE(Saturation);
+        CASE(Color);
+        CASE(Luminosity);
+    #undef CASE
+
         default: break;
     }
     return nullptr;
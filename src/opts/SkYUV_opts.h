@@ -0,0 +1,215 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkYUV_opts_DEFINED
+#define SkYUV_opts_DEFINED
+
+#include "SkImageInfo.h"
+#include "SkTypes.h"
+
+namespace SK_OPTS_NS {
+
+// The conversion is done in fixed point, the same way as libwebp's:
+//     R = clamp((hi(Y*kY) + hi(V*kRV) - kR) >> 6)
+//     G = clamp((hi(Y*kY) + kG - hi(U*kGU) - hi(V*kGV)) >> 6)
+//     B = clamp((hi(Y*kY) + hi(U*kBU) - kB) >> 6)
+// where hi(x) is x >> 8, the coefficients are scaled by 1<<14, and the constants fold in the
+// offsets of Y, U, and V, and rounding.  Every intermediate fits in 16 bits, as R's signed,
+// and G's and B's unsigned with saturation, so the portable and SIMD versions agree exactly.
+struct YUVCoeffs {
+    uint16_t fY, fRV, fGU, fGV, fBU;
+    uint16_t fR, fG, fB;
+};
+
+static const YUVCoeffs& yuv_coeffs(SkYUVColorSpace colorSpace) {
+    static const YUVCoeffs kCoeffs[] = {
+        // kJPEG_SkYUVColorSpace: BT.601, full range.
+        { 16384, 22970, 5638, 11700, 29032, 11453, 8701, 14484 },
+        // kRec601_SkYUVColorSpace: BT.601, studio range.
+        { 19077, 26149, 6419, 13320, 33050, 14234, 8708, 17685 },
+        // kRec709_SkYUVColorSpace: BT.709, studio range.
+        { 19077, 29372, 3494,  8731, 34610, 15846, 4952, 18465 },
+    };
+    static_assert(kLastEnum_SkYUVColorSpace == 2, "yuv coefficient array problem");
+    return kCoeffs[colorSpace];
+}
+
+static inline int yuv_hi(int x, int k) { return (x * k) >> 8; }
+
+template <bool kSwapRB>
+static void YUV_to_8888_portable(uint32_t* dst, const uint8_t* y, const uint8_t* u,
+                                 const uint8_t* v, int count, const YUVCoeffs& k,
+                                 bool halfChroma) {
+    for (int i = 0; i < count; i++) {
+        const int c = halfChroma ? i >> 1 : i;
+        const int y1 = yuv_hi(y[i], k.fY);
+        const int r = y1 + yuv_hi(v[c], k.fRV) - k.fR;
+        const int g = SkTMax(0, SkTMax(0, y1 + k.fG - yuv_hi(u[c], k.fGU))
+                                   - yuv_hi(v[c], k.fGV));
+        const int b = SkTMax(0, SkTMin(0xFFFF, y1 + yuv_hi(u[c], k.fBU)) - k.fB);
+
+        const uint32_t r8 = SkTPin(r >> 6, 0, 255),
+                       g8 = SkTMin(g >> 6, 255),
+                       b8 = SkTMin(b >> 6, 255);
+        dst[i] = (uint32_t)0xFF << 24
+               | (kSwapRB ? r8 : b8) << 16
+               | g8 << 8
+               | (kSwapRB ? b8 : r8) << 0;
+    }
+}
+
+#if defined(SK_ARM_HAS_NEON)
+
+// Returns (x*k) >> 8 for each lane.
+static uint16x8_t yuv_hi(uint16x8_t x, uint16_t k) {
+    uint32x4_t lo = vmull_n_u16(vget_low_u16(x), k),
+               hi = vmull_n_u16(vget_high_u16(x), k);
+    return vcombine_u16(vshrn_n_u32(lo, 8), vshrn_n_u32(hi, 8));
+}
+
+template <bool kSwapRB>
+static void YUV_to_8888(uint32_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                        int count, SkYUVColorSpace colorSpace, bool halfChroma) {
+    const YUVCoeffs& k = yuv_coeffs(colorSpace);
+    const int16x8_t kR = vdupq_n_s16(k.fR);
+    const uint16x8_t kG = vdupq_n_u16(k.fG),
+                     kB = vdupq_n_u16(k.fB);
+
+    while (count >= 8) {
+        uint8x8_t u8, v8;
+        if (halfChroma) {
+            // Load four samples of each, and double them up.
+            uint8x8_t u4 = vreinterpret_u8_u32(vld1_dup_u32((const uint32_t*) u)),
+                      v4 = vreinterpret_u8_u32(vld1_dup_u32((const uint32_t*) v));
+            u8 = vzip_u8(u4, u4).val[0];
+            v8 = vzip_u8(v4, v4).val[0];
+            u += 4;
+            v += 4;
+        } else {
+            u8 = vld1_u8(u);
+            v8 = vld1_u8(v);
+            u += 8;
+            v += 8;
+        }
+        uint16x8_t y16 = yuv_hi(vmovl_u8(vld1_u8(y)), k.fY),
+                   u16 = vmovl_u8(u8),
+                   v16 = vmovl_u8(v8);
+
+        int16x8_t r = vaddq_s16(vsubq_s16(vreinterpretq_s16_u16(y16), kR),
+                                vreinterpretq_s16_u16(yuv_hi(v16, k.fRV)));
+        uint16x8_t g = vqsubq_u16(vqsubq_u16(vaddq_u16(y16, kG), yuv_hi(u16, k.fGU)),
+                                  yuv_hi(v16, k.fGV));
+        uint16x8_t b = vqsubq_u16(vqaddq_u16(y16, yuv_hi(u16, k.fBU)), kB);
+
+        uint8x8x4_t rgba;
+        rgba.val[kSwapRB ? 2 : 0] = vqshrun_n_s16(r, 6);
+        rgba.val[1]               = vqshrn_n_u16(g, 6);
+        rgba.val[kSwapRB ? 0 : 2] = vqshrn_n_u16(b, 6);
+        rgba.val[3]               = vdup_n_u8(0xFF);
+        vst4_u8((uint8_t*) dst, rgba);
+
+        y += 8;
+        dst += 8;
+        count -= 8;
+    }
+
+    YUV_to_8888_portable<kSwapRB>(dst, y, u, v, count, k, halfChroma);
+}
+
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+template <bool kSwapRB>
+static void YUV_to_8888(uint32_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                        int count, SkYUVColorSpace colorSpace, bool halfChroma) {
+    const YUVCoeffs& k = yuv_coeffs(colorSpace);
+    const __m128i zeros = _mm_setzero_si128(),
+                  kY  = _mm_set1_epi16(k.fY),
+                  kRV = _mm_set1_epi16(k.fRV),
+                  kGU = _mm_set1_epi16(k.fGU),
+                  kGV = _mm_set1_epi16(k.fGV),
+                  kBU = _mm_set1_epi16(k.fBU),
+                  kR  = _mm_set1_epi16(k.fR),
+                  kG  = _mm_set1_epi16(k.fG),
+                  kB  = _mm_set1_epi16(k.fB);
+
+    while (count >= 8) {
+        __m128i u8, v8;
+        if (halfChroma) {
+            // Load four samples of each, and double them up.
+            int u4, v4;
+            memcpy(&u4, u, 4);
+            memcpy(&v4, v, 4);
+            u8 = _mm_cvtsi32_si128(u4);
+            v8 = _mm_cvtsi32_si128(v4);
+            u8 = _mm_unpacklo_epi8(u8, u8);
+            v8 = _mm_unpacklo_epi8(v8, v8);
+            u += 4;
+            v += 4;
+        } else {
+            u8 = _mm_loadl_epi64((const __m128i*) u);
+            v8 = _mm_loadl_epi64((const __m128i*) v);
+            u += 8;
+            v += 8;
+        }
+
+        // Unpacking into the high byte gives us x<<8, so mulhi gives us (x*k)>>8.
+        __m128i y16 = _mm_unpacklo_epi8(zeros, _mm_loadl_epi64((const __m128i*) y)),
+                u16 = _mm_unpacklo_epi8(zeros, u8),
+                v16 = _mm_unpacklo_epi8(zeros, v8);
+        y16 = _mm_mulhi_epu16(y16, kY);
+
+        __m128i r = _mm_add_epi16(_mm_sub_epi16(y16, kR), _mm_mulhi_epu16(v16, kRV)),
+                g = _mm_subs_epu16(_mm_subs_epu16(_mm_add_epi16(y16, kG),
+                                                  _mm_mulhi_epu16(u16, kGU)),
+                                   _mm_mulhi_epu16(v16, kGV)),
+                b = _mm_subs_epu16(_mm_adds_epu16(y16, _mm_mulhi_epu16(u16, kBU)), kB);
+
+        // r may be negative; g and b are unsigned, but no larger than 0xFFFF >> 6.
+        r = _mm_srai_epi16(r, 6);
+        g = _mm_srli_epi16(g, 6);
+        b = _mm_srli_epi16(b, 6);
+
+        // Repack into interlaced pixels.
+        __m128i rb = kSwapRB ? _mm_packus_epi16(b, r)
+                             : _mm_packus_epi16(r, b),                  // rrrrrrrr bbbbbbbb
+                ga = _mm_packus_epi16(g, _mm_set1_epi16(0xFF));         // gggggggg aaaaaaaa
+        __m128i rg = _mm_unpacklo_epi8(rb, ga),                          // rgrgrgrg rgrgrgrg
+                ba = _mm_unpackhi_epi8(rb, ga);                          // babababa babababa
+        _mm_storeu_si128((__m128i*) (dst + 0), _mm_unpacklo_epi16(rg, ba));
+        _mm_storeu_si128((__m128i*) (dst + 4), _mm_unpackhi_epi16(rg, ba));
+
+        y += 8;
+        dst += 8;
+        count -= 8;
+    }
+
+    YUV_to_8888_portable<kSwapRB>(dst, y, u, v, count, k, halfChroma);
+}
+
+#else
+
+template <bool kSwapRB>
+static void YUV_to_8888(uint32_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                        int count, SkYUVColorSpace colorSpace, bool halfChroma) {
+    YUV_to_8888_portable<kSwapRB>(dst, y, u, v, count, yuv_coeffs(colorSpace), halfChroma);
+}
+
+#endif
+
+static void YUV_to_RGB1(uint32_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                        int count, SkYUVColorSpace colorSpace, bool halfChroma) {
+    YUV_to_8888<false>(dst, y, u, v, count, colorSpace, halfChroma);
+}
+
+static void YUV_to_BGR1(uint32_t* dst, const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                        int count, SkYUVColorSpace colorSpace, bool halfChroma) {
+    YUV_to_8888<true>(dst, y, u, v, count, colorSpace, halfChroma);
+}
+
+}
+
+#endif // SkYUV_opts_DEFINED
@@ -5,10 +5,8 @@
  * found in the LICENSE file.
  */
 
-#include "SkBitmapFilter_opts_SSE2.h"
 #include "SkBitmapProcState_opts_SSE2.h"
 #include "SkBitmapProcState_opts_SSSE3.h"
-#include "SkBitmapScaler.h"
 #include "SkBlitMask.h"
 #include "SkBlitRow.h"
 #include "SkBlitRow_opts_SSE2.h"
@@ -119,18 +117,6 @@ static inline bool supports_simd(int minLevel) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs* procs) {
-    if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
-        procs->fExtraHorizontalReads = 3;
-        procs->fConvolveVertically = &convolveVertically_SSE2;
-        procs->fConvolve4RowsHorizontally = &convolve4RowsHorizontally_SSE2;
-        procs->fConvolveHorizontally = &convolveHorizontally_SSE2;
-        procs->fApplySIMDPadding = &applySIMDPadding_SSE2;
-    }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
 void SkBitmapProcState::platformProcs() {
     /* Every optimization in the function requires at least SSE2 */
     if (!supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
@@ -10,6 +10,8 @@
 #include "SkPathPriv.h"
 #include "SkPathOps.h"
 #include "SkPathOpsCommon.h"
+#include "SkTaskGroup.h"
+#include "SkTSort.h"
 
 static bool one_contour(const SkPath& path) {
     SkChunkAlloc allocator(256);
@@ -99,12 +101,153 @@ void SkOpBuilder::reset() {
     fOps.reset();
 }
 
+// Above this many paths, unions are divided: see resolve_unions().
+static const int kMinDivideCount = 16;
+
+static bool all_finite_unions(const SkTArray<SkPath>& paths, const SkTDArray<SkPathOp>& ops) {
+    for (int index = 0; index < ops.count(); ++index) {
+        if (kUnion_SkPathOp != ops[index] || paths[index].isInverseFillType()
+                || !paths[index].isFinite()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int find_group(int* parents, int index) {
+    while (parents[index] != index) {
+        parents[index] = parents[parents[index]];
+        index = parents[index];
+    }
+    return index;
+}
+
+/* Sorts the non-empty paths by their top edge, and sweeps down them to group the paths whose
+   bounds touch, directly or through other paths. Each group lists its paths in sorted order;
+   groups are ordered by their topmost path. */
+static void group_by_bounds(const SkTArray<SkPath>& paths, SkTArray<SkTDArray<int>>* groups) {
+    SkTDArray<int> sorted;
+    for (int index = 0; index < paths.count(); ++index) {
+        if (!paths[index].isEmpty()) {
+            *sorted.append() = index;
+        }
+    }
+    if (!sorted.count()) {
+        return;
+    }
+    SkTQSort(sorted.begin(), sorted.end() - 1, [&paths](int a, int b) {
+        const SkRect& boundsA = paths[a].getBounds();
+        const SkRect& boundsB = paths[b].getBounds();
+        return boundsA.fTop == boundsB.fTop ? a < b : boundsA.fTop < boundsB.fTop;
+    });
+
+    SkAutoTMalloc<int> parents(paths.count());
+    SkTDArray<int> active;
+    for (int s = 0; s < sorted.count(); ++s) {
+        const int index = sorted[s];
+        parents[index] = index;
+        const SkRect& bounds = paths[index].getBounds();
+        for (int a = 0; a < active.count(); ) {
+            const SkRect& test = paths[active[a]].getBounds();
+            if (test.fBottom < bounds.fTop) {
+                // Nothing further down the sweep can touch this path.
+                active.removeShuffle(a);
+                continue;
+            }
+            // Paths that merely share an edge still need to be unioned together.
+            if (test.fLeft <= bounds.fRight && bounds.fLeft <= test.fRight) {
+                int groupA = find_group(parents, active[a]);
+                int groupB = find_group(parents, index);
+                parents[SkTMax(groupA, groupB)] = SkTMin(groupA, groupB);
+            }
+            ++a;
+        }
+        *active.append() = index;
+    }
+
+    SkAutoTMalloc<int> groupIndex(paths.count());
+    for (int index = 0; index < paths.count(); ++index) {
+        groupIndex[index] = -1;
+    }
+    for (int s = 0; s < sorted.count(); ++s) {
+        const int index = sorted[s];
+        const int root = find_group(parents, index);
+        if (groupIndex[root] < 0) {
+            groupIndex[root] = groups->count();
+            groups->push_back();
+        }
+        *(*groups)[groupIndex[root]].append() = index;
+    }
+}
+
+/* Unions many paths by divide and conquer. Paths are first split into groups whose bounds do
+   not touch; each group can be resolved on its own, and the results of different groups are
+   disjoint, so they are simply appended. A group too large to resolve in one pass is cut
+   in two along the sweep order, and the halves are resolved separately, then unioned.
+   Groups and halves are independent, so they are resolved in parallel on SkTaskGroup; their
+   results are always combined in the same order, so the output does not depend on threading. */
+static bool resolve_unions(const SkTArray<SkPath>& paths, SkPath* result) {
+    SkTArray<SkTDArray<int>> groups;
+    group_by_bounds(paths, &groups);
+    if (1 == groups.count() && groups[0].count() == paths.count()) {
+        // Everything touches: halve the sweep, and union the halves.
+        const SkTDArray<int>& group = groups[0];
+        const int half = group.count() / 2;
+        SkPath halves[2];
+        bool success[2];
+        SkTaskGroup().batch(2, [&](int h) {
+            SkOpBuilder builder;
+            const int start = h ? half : 0;
+            const int end = h ? group.count() : half;
+            for (int index = start; index < end; ++index) {
+                builder.add(paths[group[index]], kUnion_SkPathOp);
+            }
+            success[h] = builder.resolve(&halves[h]);
+        });
+        return success[0] && success[1] && Op(halves[0], halves[1], kUnion_SkPathOp, result);
+    }
+
+    SkTArray<SkPath> groupResults(groups.count());
+    groupResults.push_back_n(groups.count());
+    SkAutoTMalloc<bool> success(groups.count());
+    SkTaskGroup().batch(groups.count(), [&](int g) {
+        if (1 == groups[g].count()) {
+            success[g] = Simplify(paths[groups[g][0]], &groupResults[g]);
+            return;
+        }
+        SkOpBuilder builder;
+        for (int index = 0; index < groups[g].count(); ++index) {
+            builder.add(paths[groups[g][index]], kUnion_SkPathOp);
+        }
+        success[g] = builder.resolve(&groupResults[g]);
+    });
+    SkPath sum;
+    sum.setFillType(SkPath::kEvenOdd_FillType);
+    for (int g = 0; g < groups.count(); ++g) {
+        if (!success[g]) {
+            return false;
+        }
+        SkASSERT(groupResults[g].getFillType() == SkPath::kEvenOdd_FillType);
+        sum.addPath(groupResults[g]);
+    }
+    *result = sum;
+    return true;
+}
+
 /* OPTIMIZATION: Union doesn't need to be all-or-nothing. A run of three or more convex
    paths with union ops could be locally resolved and still improve over doing the
    ops one at a time. */
 bool SkOpBuilder::resolve(SkPath* result) {
     SkPath original = *result;
     int count = fOps.count();
+    if (count > kMinDivideCount && all_finite_unions(fPathRefs, fOps)) {
+        bool success = resolve_unions(fPathRefs, result);
+        reset();
+        if (!success) {
+            *result = original;
+        }
+        return success;
+    }
     bool allUnion = true;
     SkPathPriv::FirstDirection firstDir = SkPathPriv::kUnknown_FirstDirection;
     for (int index = 0; index < count; ++index) {
@@ -139,10 +282,12 @@ bool SkOpBuilder::resolve(SkPath* result) {
             }
         }
     }
+    // The ops below run one after another, so they share one context's memory.
+    SkPathOpsContext context;
     if (!allUnion) {
         *result = fPathRefs[0];
         for (int index = 1; index < count; ++index) {
-            if (!Op(*result, fPathRefs[index], fOps[index], result)) {
+            if (!context.op(*result, fPathRefs[index], fOps[index], result)) {
                 reset();
                 *result = original;
                 return false;
@@ -153,7 +298,7 @@ bool SkOpBuilder::resolve(SkPath* result) {
     }
     SkPath sum;
     for (int index = 0; index < count; ++index) {
-        if (!Simplify(fPathRefs[index], &fPathRefs[index])) {
+        if (!context.simplify(fPathRefs[index], &fPathRefs[index])) {
             reset();
             *result = original;
             return false;
@@ -165,7 +310,7 @@ bool SkOpBuilder::resolve(SkPath* result) {
         }
     }
     reset();
-    bool success = Simplify(sum, result);
+    bool success = context.simplify(sum, result);
     if (!success) {
         *result = original;
     }
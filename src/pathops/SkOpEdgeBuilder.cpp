@@ -9,6 +9,9 @@
 #include "SkReduceOrder.h"
 
 void SkOpEdgeBuilder::init() {
+    fStorage->fPathPts.rewind();
+    fStorage->fWeights.rewind();
+    fStorage->fPathVerbs.rewind();
     fCurrentContour = fContoursHead;
     fOperand = false;
     fXorMask[0] = fXorMask[1] = (fPath->getFillType() & 1) ? kEvenOdd_PathOpsMask
@@ -18,8 +21,9 @@ void SkOpEdgeBuilder::init() {
 }
 
 void SkOpEdgeBuilder::addOperand(const SkPath& path) {
-    SkASSERT(fPathVerbs.count() > 0 && fPathVerbs.end()[-1] == SkPath::kDone_Verb);
-    fPathVerbs.pop();
+    SkASSERT(fStorage->fPathVerbs.count() > 0
+            && fStorage->fPathVerbs.end()[-1] == SkPath::kDone_Verb);
+    fStorage->fPathVerbs.pop();
     fPath = &path;
     fXorMask[1] = (fPath->getFillType() & 1) ? kEvenOdd_PathOpsMask
             : kWinding_PathOpsMask;
@@ -50,12 +54,12 @@ bool SkOpEdgeBuilder::finish(SkChunkAlloc* allocator) {
 
 void SkOpEdgeBuilder::closeContour(const SkPoint& curveEnd, const SkPoint& curveStart) {
     if (!SkDPoint::ApproximatelyEqual(curveEnd, curveStart)) {
-        *fPathVerbs.append() = SkPath::kLine_Verb;
-        *fPathPts.append() = curveStart;
+        *fStorage->fPathVerbs.append() = SkPath::kLine_Verb;
+        *fStorage->fPathPts.append() = curveStart;
     } else {
-        fPathPts[fPathPts.count() - 1] = curveStart;
+        fStorage->fPathPts[fStorage->fPathPts.count() - 1] = curveStart;
     }
-    *fPathVerbs.append() = SkPath::kClose_Verb;
+    *fStorage->fPathVerbs.append() = SkPath::kClose_Verb;
 }
 
 // very tiny points cause numerical instability : don't allow them
@@ -86,18 +90,18 @@ int SkOpEdgeBuilder::preFetch() {
                 if (!fAllowOpenContours && lastCurve) {
                     closeContour(curve[0], curveStart);
                 }
-                *fPathVerbs.append() = verb;
+                *fStorage->fPathVerbs.append() = verb;
                 force_small_to_zero(&pts[0]);
-                *fPathPts.append() = pts[0];
+                *fStorage->fPathPts.append() = pts[0];
                 curveStart = curve[0] = pts[0];
                 lastCurve = false;
                 continue;
             case SkPath::kLine_Verb:
                 force_small_to_zero(&pts[1]);
                 if (SkDPoint::ApproximatelyEqual(curve[0], pts[1])) {
-                    uint8_t lastVerb = fPathVerbs.top();
+                    uint8_t lastVerb = fStorage->fPathVerbs.top();
                     if (lastVerb != SkPath::kLine_Verb && lastVerb != SkPath::kMove_Verb) {
-                        fPathPts.top() = pts[1];
+                        fStorage->fPathPts.top() = pts[1];
                     }
                     continue;  // skip degenerate points
                 }
@@ -141,11 +145,11 @@ int SkOpEdgeBuilder::preFetch() {
             case SkPath::kDone_Verb:
                 continue;
         }
-        *fPathVerbs.append() = verb;
+        *fStorage->fPathVerbs.append() = verb;
         int ptCount = SkPathOpsVerbToPoints(verb);
-        fPathPts.append(ptCount, &pts[1]);
+        fStorage->fPathPts.append(ptCount, &pts[1]);
         if (verb == SkPath::kConic_Verb) {
-            *fWeights.append() = iter.conicWeight();
+            *fStorage->fWeights.append() = iter.conicWeight();
         }
         curve[0] = pts[ptCount];
         lastCurve = true;
@@ -153,8 +157,8 @@ int SkOpEdgeBuilder::preFetch() {
     if (!fAllowOpenContours && lastCurve) {
         closeContour(curve[0], curveStart);
     }
-    *fPathVerbs.append() = SkPath::kDone_Verb;
-    return fPathVerbs.count() - 1;
+    *fStorage->fPathVerbs.append() = SkPath::kDone_Verb;
+    return fStorage->fPathVerbs.count() - 1;
 }
 
 bool SkOpEdgeBuilder::close() {
@@ -163,10 +167,10 @@ bool SkOpEdgeBuilder::close() {
 }
 
 bool SkOpEdgeBuilder::walk(SkChunkAlloc* allocator) {
-    uint8_t* verbPtr = fPathVerbs.begin();
+    uint8_t* verbPtr = fStorage->fPathVerbs.begin();
     uint8_t* endOfFirstHalf = &verbPtr[fSecondHalf];
-    SkPoint* pointsPtr = fPathPts.begin() - 1;
-    SkScalar* weightPtr = fWeights.begin();
+    SkPoint* pointsPtr = fStorage->fPathPts.begin() - 1;
+    SkScalar* weightPtr = fStorage->fWeights.begin();
     SkPath::Verb verb;
     while ((verb = (SkPath::Verb) *verbPtr) != SkPath::kDone_Verb) {
         if (verbPtr == endOfFirstHalf) {
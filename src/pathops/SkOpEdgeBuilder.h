@@ -10,23 +10,33 @@
 #include "SkOpContour.h"
 #include "SkPathWriter.h"
 
+// The arrays an SkOpEdgeBuilder gathers a path's points, weights and verbs into. Builders that
+// run one after another can share one, so that the arrays keep their storage.
+struct SkOpEdgeBuilderStorage {
+    SkTDArray<SkPoint> fPathPts;
+    SkTDArray<SkScalar> fWeights;
+    SkTDArray<uint8_t> fPathVerbs;
+};
+
 class SkOpEdgeBuilder {
 public:
     SkOpEdgeBuilder(const SkPathWriter& path, SkOpContour* contours2, SkChunkAlloc* allocator,
-            SkOpGlobalState* globalState)
+            SkOpGlobalState* globalState, SkOpEdgeBuilderStorage* storage = nullptr)
         : fAllocator(allocator)  // FIXME: replace with const, tune this
         , fGlobalState(globalState)
         , fPath(path.nativePath())
+        , fStorage(storage ? storage : &fOwnStorage)
         , fContoursHead(contours2)
         , fAllowOpenContours(true) {
         init();
     }
 
     SkOpEdgeBuilder(const SkPath& path, SkOpContour* contours2, SkChunkAlloc* allocator,
-            SkOpGlobalState* globalState)
+            SkOpGlobalState* globalState, SkOpEdgeBuilderStorage* storage = nullptr)
         : fAllocator(allocator)
         , fGlobalState(globalState)
         , fPath(&path)
+        , fStorage(storage ? storage : &fOwnStorage)
         , fContoursHead(contours2)
         , fAllowOpenContours(false) {
         init();
@@ -61,9 +71,8 @@ private:
     SkChunkAlloc* fAllocator;
     SkOpGlobalState* fGlobalState;
     const SkPath* fPath;
-    SkTDArray<SkPoint> fPathPts;
-    SkTDArray<SkScalar> fWeights;
-    SkTDArray<uint8_t> fPathVerbs;
+    SkOpEdgeBuilderStorage fOwnStorage;
+    SkOpEdgeBuilderStorage* fStorage;
     SkOpContour* fCurrentContour;
     SkOpContour* fContoursHead;
     SkPathOpsMask fXorMask[2];
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkOpWorkingSet_DEFINED
+#define SkOpWorkingSet_DEFINED
+
+#include "SkChunkAlloc.h"
+#include "SkOpEdgeBuilder.h"
+
+// The memory a path op works in: the arena its contours, segments, spans and angles are
+// allocated from, and the arrays its edge builders gather paths into. Op() and Simplify() use
+// one for a single call; SkPathOpsContext keeps one from call to call.
+class SkOpWorkingSet {
+public:
+    SkOpWorkingSet()
+        : fAllocator(4096)  // FIXME: constant-ize, tune
+        , fRetainedBlocks(0)
+        , fLastAllocationCount(0) {
+    }
+
+    SkChunkAlloc* allocator() { return &fAllocator; }
+    SkOpEdgeBuilderStorage* builderStorage() { return &fBuilderStorage; }
+    SkOpEdgeBuilderStorage* assembleStorage() { return &fAssembleStorage; }
+
+    int lastAllocationCount() const { return fLastAllocationCount; }
+
+    // Discards everything the last op made, keeping the memory for the next one. If the op
+    // outgrew the arena, the arena is replaced by one block big enough for all of it, so that
+    // a stream of similar ops soon stops allocating.
+    void rewind() {
+        fLastAllocationCount = fAllocator.blockCount() - fRetainedBlocks;
+        if (fAllocator.blockCount() > 1) {
+            const size_t capacity = fAllocator.totalCapacity();
+            fAllocator.reset();
+            (void) fAllocator.allocThrow(SkAlign4(capacity));
+        }
+        fAllocator.rewind();
+        fRetainedBlocks = fAllocator.blockCount();
+    }
+
+private:
+    SkChunkAlloc fAllocator;
+    SkOpEdgeBuilderStorage fBuilderStorage;
+    SkOpEdgeBuilderStorage fAssembleStorage;
+    int fRetainedBlocks;
+    int fLastAllocationCount;
+};
+
+#endif
@@ -7,6 +7,7 @@
 #include "SkAddIntersections.h"
 #include "SkOpCoincidence.h"
 #include "SkOpEdgeBuilder.h"
+#include "SkOpWorkingSet.h"
 #include "SkPathOpsCommon.h"
 #include "SkPathWriter.h"
 #include "SkTSort.h"
@@ -195,8 +196,8 @@ public:
         connect closest
         reassemble contour pieces into new path
     */
-void Assemble(const SkPathWriter& path, SkPathWriter* simple) {
-    SkChunkAlloc allocator(4096);  // FIXME: constant-ize, tune
+void Assemble(const SkPathWriter& path, SkPathWriter* simple, SkOpWorkingSet* workingSet) {
+    SkChunkAlloc& allocator = *workingSet->allocator();
     SkOpContourHead contour;
     SkOpGlobalState globalState(nullptr, &contour  SkDEBUGPARAMS(nullptr));
 #if DEBUG_SHOW_TEST_NAME
@@ -205,7 +206,8 @@ void Assemble(const SkPathWriter& path, SkPathWriter* simple) {
 #if DEBUG_PATH_CONSTRUCTION
     SkDebugf("%s\n", __FUNCTION__);
 #endif
-    SkOpEdgeBuilder builder(path, &contour, &allocator, &globalState);
+    SkOpEdgeBuilder builder(path, &contour, &allocator, &globalState,
+                            workingSet->assembleStorage());
     builder.finish(&allocator);
     SkTDArray<const SkOpContour* > runs;  // indices of partial contours
     const SkOpContour* eContour = builder.head();
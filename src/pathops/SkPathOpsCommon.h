@@ -12,11 +12,12 @@
 
 class SkOpCoincidence;
 class SkOpContour;
+class SkOpWorkingSet;
 class SkPathWriter;
 
 const SkOpAngle* AngleWinding(SkOpSpanBase* start, SkOpSpanBase* end, int* windingPtr,
                               bool* sortable);
-void Assemble(const SkPathWriter& path, SkPathWriter* simple);
+void Assemble(const SkPathWriter& path, SkPathWriter* simple, SkOpWorkingSet* );
 SkOpSegment* FindChase(SkTDArray<SkOpSpanBase*>* chase, SkOpSpanBase** startPtr,
                        SkOpSpanBase** endPtr);
 SkOpSpan* FindSortableTop(SkOpContourHead* );
@@ -27,6 +28,9 @@ bool SortContourList(SkOpContourHead** , bool evenOdd, bool oppEvenOdd);
 bool HandleCoincidence(SkOpContourHead* , SkOpCoincidence* , SkChunkAlloc* );
 bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
              bool expectSuccess  SkDEBUGPARAMS(const char* testName));
+bool OpInWorkingSet(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+                    bool expectSuccess, SkOpWorkingSet*  SkDEBUGPARAMS(const char* testName));
+bool SimplifyInWorkingSet(const SkPath& path, SkPath* result, SkOpWorkingSet* );
 #if DEBUG_ACTIVE_SPANS
 void DebugShowActiveSpans(SkOpContourHead* );
 #endif
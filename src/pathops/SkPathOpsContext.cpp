@@ -0,0 +1,34 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkOpWorkingSet.h"
+#include "SkPathOps.h"
+#include "SkPathOpsCommon.h"
+
+SkPathOpsContext::SkPathOpsContext()
+    : fWorkingSet(new SkOpWorkingSet) {
+}
+
+SkPathOpsContext::~SkPathOpsContext() {
+    delete fWorkingSet;
+}
+
+bool SkPathOpsContext::op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
+    bool success = OpInWorkingSet(one, two, op, result, true, fWorkingSet
+                                  SkDEBUGPARAMS(nullptr));
+    fWorkingSet->rewind();
+    return success;
+}
+
+bool SkPathOpsContext::simplify(const SkPath& path, SkPath* result) {
+    bool success = SimplifyInWorkingSet(path, result, fWorkingSet);
+    fWorkingSet->rewind();
+    return success;
+}
+
+int SkPathOpsContext::lastAllocationCount() const {
+    return fWorkingSet->lastAllocationCount();
+}
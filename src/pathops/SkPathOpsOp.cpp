@@ -7,6 +7,7 @@
 #include "SkAddIntersections.h"
 #include "SkOpCoincidence.h"
 #include "SkOpEdgeBuilder.h"
+#include "SkOpWorkingSet.h"
 #include "SkPathOpsCommon.h"
 #include "SkPathWriter.h"
 
@@ -245,9 +246,9 @@ extern void (*gVerboseFinalize)();
 
 #endif
 
-bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
-        bool expectSuccess  SkDEBUGPARAMS(const char* testName)) {
-    SkChunkAlloc allocator(4096);  // FIXME: add a constant expression here, tune
+bool OpInWorkingSet(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+        bool expectSuccess, SkOpWorkingSet* workingSet  SkDEBUGPARAMS(const char* testName)) {
+    SkChunkAlloc& allocator = *workingSet->allocator();
     SkOpContour contour;
     SkOpContourHead* contourList = static_cast<SkOpContourHead*>(&contour);
     SkOpCoincidence coincidence;
@@ -276,7 +277,8 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
     SkPathOpsDebug::gSortCount = SkPathOpsDebug::gSortCountDefault;
 #endif
     // turn path into list of segments
-    SkOpEdgeBuilder builder(*minuend, &contour, &allocator, &globalState);
+    SkOpEdgeBuilder builder(*minuend, &contour, &allocator, &globalState,
+                            workingSet->builderStorage());
     if (builder.unparseable()) {
         return false;
     }
@@ -322,7 +324,7 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
         SkPath temp;
         temp.setFillType(fillType);
         SkPathWriter assembled(temp);
-        Assemble(wrapper, &assembled);
+        Assemble(wrapper, &assembled, workingSet);
         *result = *assembled.nativePath();
         result->setFillType(fillType);
     }
@@ -338,6 +340,13 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
     return true;
 }
 
+bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+        bool expectSuccess  SkDEBUGPARAMS(const char* testName)) {
+    SkOpWorkingSet workingSet;
+    return OpInWorkingSet(one, two, op, result, expectSuccess, &workingSet
+                          SkDEBUGPARAMS(testName));
+}
+
 #define DEBUG_VERIFY 0
 
 #if DEBUG_VERIFY
@@ -7,6 +7,7 @@
 #include "SkAddIntersections.h"
 #include "SkOpCoincidence.h"
 #include "SkOpEdgeBuilder.h"
+#include "SkOpWorkingSet.h"
 #include "SkPathOpsCommon.h"
 #include "SkPathWriter.h"
 
@@ -163,9 +164,8 @@ static bool bridgeXor(SkOpContourHead* contourList, SkPathWriter* simple,
     return true;
 }
 
-// FIXME : add this as a member of SkPath
-bool Simplify(const SkPath& path, SkPath* result) {
-    SkChunkAlloc allocator(4096);  // FIXME: constant-ize, tune
+bool SimplifyInWorkingSet(const SkPath& path, SkPath* result, SkOpWorkingSet* workingSet) {
+    SkChunkAlloc& allocator = *workingSet->allocator();
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
     SkPath::FillType fillType = path.isInverseFillType() ? SkPath::kInverseEvenOdd_FillType
             : SkPath::kEvenOdd_FillType;
@@ -184,7 +184,8 @@ bool Simplify(const SkPath& path, SkPath* result) {
 #if DEBUG_SORT
     SkPathOpsDebug::gSortCount = SkPathOpsDebug::gSortCountDefault;
 #endif
-    SkOpEdgeBuilder builder(path, &contour, &allocator, &globalState);
+    SkOpEdgeBuilder builder(path, &contour, &allocator, &globalState,
+                            workingSet->builderStorage());
     if (!builder.finish(&allocator)) {
         return false;
     }
@@ -227,10 +228,15 @@ bool Simplify(const SkPath& path, SkPath* result) {
         SkPath temp;
         temp.setFillType(fillType);
         SkPathWriter assembled(temp);
-        Assemble(wrapper, &assembled);
+        Assemble(wrapper, &assembled, workingSet);
         *result = *assembled.nativePath();
         result->setFillType(fillType);
     }
     return true;
 }
 
+// FIXME : add this as a member of SkPath
+bool Simplify(const SkPath& path, SkPath* result) {
+    SkOpWorkingSet workingSet;
+    return SimplifyInWorkingSet(path, result, &workingSet);
+}
@@ -7,7 +7,11 @@
 
 #include "SkData.h"
 #include "SkCodecImageGenerator.h"
+#include "SkCompressedImageGenerator.h"
 
 SkImageGenerator* SkImageGenerator::NewFromEncodedImpl(SkData* data) {
+    if (SkImageGenerator* generator = SkCompressedImageGenerator::NewFromEncodedCompressed(data)) {
+        return generator;
+    }
     return SkCodecImageGenerator::NewFromEncodedCodec(data);
 }
@@ -228,4 +228,38 @@ bool DecompressBufferFromFormat(uint8_t* dst, int dstRowBytes, const uint8_t* sr
     return false;
 }
 
+bool DecompressBlocksFromFormat(uint8_t* dst, int dstRowBytes, const uint8_t* src,
+                                int width, int height, Format format, const SkIRect& blocks) {
+    int dimX, dimY;
+    GetBlockDimensions(format, &dimX, &dimY, true);
+
+    if (width < 0 || ((width % dimX) != 0) || height < 0 || ((height % dimY) != 0)) {
+        return false;
+    }
+
+    const int blocksWide = width / dimX;
+    const int blocksTall = height / dimY;
+    if (blocks.isEmpty() || !SkIRect::MakeWH(blocksWide, blocksTall).contains(blocks)) {
+        return false;
+    }
+
+    const int blockSize = GetCompressedDataSize(format, dimX, dimY);
+
+    // ASTC stores its rows of blocks starting from the bottom of the image.
+    const bool isASTC = format >= kASTC_4x4_Format;
+
+    // Each row of blocks is contiguous, so we can hand the decompressor a one block tall image
+    // made of just the blocks we want from that row.
+    for (int y = blocks.fTop; y < blocks.fBottom; ++y) {
+        const int srcRow = isASTC ? blocksTall - 1 - y : y;
+        const uint8_t* rowSrc = src + (srcRow * blocksWide + blocks.fLeft) * blockSize;
+        if (!DecompressBufferFromFormat(dst, dstRowBytes, rowSrc,
+                                        blocks.width() * dimX, dimY, format)) {
+            return false;
+        }
+        dst += dimY * dstRowBytes;
+    }
+    return true;
+}
+
 }  // namespace SkTextureCompressor
@@ -80,6 +80,16 @@ namespace SkTextureCompressor {
     bool DecompressBufferFromFormat(uint8_t* dst, int dstRowBytes, const uint8_t* src,
                                     int width, int height, Format format);
 
+    // Like DecompressBufferFromFormat, but only decompresses the given rectangle of blocks
+    // (in units of blocks, as returned by GetBlockDimensions with matchSpec set) out of the
+    // width x height image in src. dst receives the pixels of those blocks, starting with
+    // the top-left pixel of the top-left block.
+    //
+    // Returns true if successfully decompresses the blocks.
+    bool DecompressBlocksFromFormat(uint8_t* dst, int dstRowBytes, const uint8_t* src,
+                                    int width, int height, Format format,
+                                    const SkIRect& blocks);
+
     // Returns true if there exists a blitter for the specified format.
     inline bool ExistsBlitterForFormat(Format format) {
         switch (format) {
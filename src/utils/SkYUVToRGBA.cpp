@@ -0,0 +1,52 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkOpts.h"
+#include "SkTemplates.h"
+#include "SkYUVToRGBA.h"
+
+bool SkYUVToRGBA(const SkISize sizes[3], const void* const planes[3], const size_t rowBytes[3],
+                 SkYUVColorSpace colorSpace, const SkPixmap& dst) {
+    SkOpts::YUV_8888 proc;
+    switch (dst.colorType()) {
+        case kRGBA_8888_SkColorType:
+            proc = SkOpts::YUV_to_RGB1;
+            break;
+        case kBGRA_8888_SkColorType:
+            proc = SkOpts::YUV_to_BGR1;
+            break;
+        default:
+            return false;
+    }
+
+    const SkISize& ySize = sizes[0];
+    const SkISize& uvSize = sizes[1];
+    if (ySize != dst.info().dimensions() || uvSize != sizes[2] || !dst.addr()) {
+        return false;
+    }
+    const bool halfWidth = uvSize.width() != ySize.width();
+    const bool halfHeight = uvSize.height() != ySize.height();
+    if ((halfWidth && uvSize.width() != (ySize.width() + 1) / 2) ||
+            (halfHeight && uvSize.height() != (ySize.height() + 1) / 2) ||
+            (halfHeight && !halfWidth)) {
+        return false;
+    }
+
+    size_t rb[3];
+    for (int i = 0; i < 3; ++i) {
+        rb[i] = rowBytes[i] ? rowBytes[i] : sizes[i].fWidth;
+    }
+    for (int y = 0; y < ySize.height(); y++) {
+        const int uvY = halfHeight ? y >> 1 : y;
+        proc(dst.writable_addr32(0, y),
+             SkTAddOffset<const uint8_t>(planes[0], y * rb[0]),
+             SkTAddOffset<const uint8_t>(planes[1], uvY * rb[1]),
+             SkTAddOffset<const uint8_t>(planes[2], uvY * rb[2]),
+             ySize.width(), colorSpace, halfWidth);
+    }
+    return true;
+}
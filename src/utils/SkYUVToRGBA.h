@@ -0,0 +1,22 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkYUVToRGBA_DEFINED
+#define SkYUVToRGBA_DEFINED
+
+#include "SkPixmap.h"
+#include "SkSize.h"
+
+// The inverse of SkRGBAToYUV, on the CPU.  The Y plane must be the size of dst, and the U and
+// V planes the same size as each other: either the size of Y (4:4:4), half its width (4:2:2),
+// or half each dimension (4:2:0), rounding up.  A rowBytes of 0 means the plane is tightly
+// packed.  dst must be kRGBA_8888 or kBGRA_8888, and is filled with opaque pixels.  Chroma is
+// not interpolated, so each sample covers a block of 1x1, 2x1, or 2x2 pixels.
+bool SkYUVToRGBA(const SkISize sizes[3], const void* const planes[3], const size_t rowBytes[3],
+                 SkYUVColorSpace, const SkPixmap& dst);
+
+#endif
@@ -10,8 +10,11 @@
 #include "SkBitmap.h"
 #include "SkCodec.h"
 #include "SkCodecImageGenerator.h"
+#include "SkCodecPool.h"
+#include "SkColorPriv.h"
 #include "SkData.h"
 #include "SkFrontBufferedStream.h"
+#include "SkImageEncoder.h"
 #include "SkMD5.h"
 #include "SkRandom.h"
 #include "SkStream.h"
@@ -1015,3 +1018,212 @@ DEF_TEST(Codec_InvalidRLEBmp, r) {
 
     test_info(r, codec.get(), codec->getInfo(), SkCodec::kIncompleteInput, nullptr);
 }
+
+// Decodes rows [y, y + count) of the image with the scanline decoder, skipping to them, and
+// compares them to the full decode.
+static void check_png_rows(skiatest::Reporter* r, SkCodec* codec, const SkBitmap& full, int y,
+                           int count) {
+    const SkImageInfo info = full.info().makeWH(full.width(), count);
+    SkBitmap rows;
+    rows.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startScanlineDecode(info.makeWH(full.width(),
+                                                                                   full.height())));
+    REPORTER_ASSERT(r, codec->skipScanlines(y));
+    REPORTER_ASSERT(r, count == codec->getScanlines(rows.getPixels(), count, rows.rowBytes()));
+    for (int i = 0; i < count; i++) {
+        if (memcmp(rows.getAddr(0, i), full.getAddr(0, y + i), full.width() * 4)) {
+            ERRORF(r, "Row %d differs after skipping %d rows", y + i, y);
+            return;
+        }
+    }
+}
+
+// Tall enough that the seek index records several checkpoints, with a mix of smooth and noisy
+// rows so that the encoder uses every filter type.
+static const int kSkipWidth = 512, kSkipHeight = 4096;
+
+static U8CPU skip_noise(SkRandom* rand, int y) {
+    return (y / 64) & 1 ? rand->nextU() & 0x3F : 0;
+}
+
+static SkData* make_png_skip_n32(bool opaque) {
+    SkBitmap src;
+    src.allocPixels(SkImageInfo::MakeN32(kSkipWidth, kSkipHeight,
+            opaque ? kOpaque_SkAlphaType : kUnpremul_SkAlphaType));
+    SkRandom rand;
+    for (int y = 0; y < kSkipHeight; y++) {
+        for (int x = 0; x < kSkipWidth; x++) {
+            const U8CPU noise = skip_noise(&rand, y);
+            const U8CPU a = opaque ? 0xFF : (x + y) & 0xFF;
+            *src.getAddr32(x, y) = SkPackARGB32NoCheck(a, (x + noise) & 0xFF, (y + noise) & 0xFF,
+                                                       (x ^ y) & 0xFF);
+        }
+    }
+    return SkImageEncoder::EncodeData(src, SkImageEncoder::kPNG_Type, 100);
+}
+
+// Writes an RGB or GRAY png with a tRNS chunk, which libpng expands to RGBA or GRAY_ALPHA,
+// so that the decoded rows are wider than the rows stored in the image data.
+static SkData* make_png_skip_trns(skiatest::Reporter* r, int colorType) {
+    const int channels = PNG_COLOR_TYPE_RGB == colorType ? 3 : 1;
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png ? png_create_info_struct(png) : nullptr;
+    if (!info) {
+        ERRORF(r, "failed creating png writer");
+        png_destroy_write_struct(&png, nullptr);
+        return nullptr;
+    }
+    SkAutoTMalloc<png_byte> row(kSkipWidth * channels);
+    if (setjmp(png_jmpbuf(png))) {
+        ERRORF(r, "failed writing png");
+        png_destroy_write_struct(&png, &info);
+        return nullptr;
+    }
+
+    SkDynamicMemoryWStream wStream;
+    png_set_write_fn(png, (void*) (&wStream), codex_test_write_fn, nullptr);
+    png_set_IHDR(png, info, kSkipWidth, kSkipHeight, 8, colorType, PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_color_16 trans;
+    trans.red = 0x10;
+    trans.green = 0x20;
+    trans.blue = 0x30;
+    trans.gray = 0x40;
+    png_set_tRNS(png, info, nullptr, 0, &trans);
+    png_write_info(png, info);
+
+    SkRandom rand;
+    for (int y = 0; y < kSkipHeight; y++) {
+        for (int x = 0; x < kSkipWidth; x++) {
+            const U8CPU noise = skip_noise(&rand, y);
+            png_byte* pixel = row.get() + x * channels;
+            if (3 == channels) {
+                pixel[0] = (x + noise) & 0xFF;
+                pixel[1] = (y + noise) & 0xFF;
+                pixel[2] = (x ^ y) & 0xFF;
+            } else {
+                pixel[0] = (x + y + noise) & 0xFF;
+            }
+        }
+        png_bytep rowPtr = row.get();
+        png_write_rows(png, &rowPtr, 1);
+    }
+    png_write_end(png, info);
+    png_destroy_write_struct(&png, &info);
+    return wStream.copyToData();
+}
+
+static void test_png_skip(skiatest::Reporter* r, SkData* data) {
+    const int width = kSkipWidth, height = kSkipHeight;
+    REPORTER_ASSERT(r, data);
+    if (!data) {
+        return;
+    }
+
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, full.getPixels(),
+                                                             full.rowBytes()));
+
+    // The first skip builds the index; later ones, in any order, may use it.
+    const int starts[] = { height - 16, height / 2 + 3, 0, 1, height - 16, height / 3 };
+    for (int y : starts) {
+        check_png_rows(r, codec, full, y, 16);
+    }
+
+    // Two skips in a row, and a skip after reading some rows.
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startScanlineDecode(info));
+    REPORTER_ASSERT(r, codec->skipScanlines(100));
+    REPORTER_ASSERT(r, codec->skipScanlines(2000));
+    SkBitmap row;
+    row.allocPixels(info.makeWH(width, 1));
+    REPORTER_ASSERT(r, 1 == codec->getScanlines(row.getPixels(), 1, row.rowBytes()));
+    REPORTER_ASSERT(r, !memcmp(row.getPixels(), full.getAddr(0, 2100), width * 4));
+    REPORTER_ASSERT(r, codec->skipScanlines(height - 2102));
+    REPORTER_ASSERT(r, 1 == codec->getScanlines(row.getPixels(), 1, row.rowBytes()));
+    REPORTER_ASSERT(r, !memcmp(row.getPixels(), full.getAddr(0, height - 1), width * 4));
+}
+
+DEF_TEST(Codec_png_skip, r) {
+    for (bool opaque : { true, false }) {
+        SkAutoTUnref<SkData> data(make_png_skip_n32(opaque));
+        test_png_skip(r, data);
+    }
+    for (int colorType : { PNG_COLOR_TYPE_RGB, PNG_COLOR_TYPE_GRAY }) {
+        SkAutoTUnref<SkData> data(make_png_skip_trns(r, colorType));
+        test_png_skip(r, data);
+    }
+}
+
+static bool decode_pooled(skiatest::Reporter* r, const char path[], bool pooled,
+                          SkMD5::Digest* digest) {
+    SkStream* stream = resource(path);
+    if (!stream) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return false;
+    }
+    SkAutoTDelete<SkCodec> codec(pooled ? SkCodec::NewFromStreamPooled(stream)
+                                        : SkCodec::NewFromStream(stream));
+    if (!codec) {
+        ERRORF(r, "Unable to create codec '%s'.", path);
+        return false;
+    }
+
+    SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    if (kUnpremul_SkAlphaType == info.alphaType()) {
+        info = info.makeAlphaType(kPremul_SkAlphaType);
+    }
+    SkBitmap bm;
+    bm.allocPixels(info);
+    SkCodec::Result result = codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes());
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+    if (pooled) {
+        // Decoding again makes the codec rewind, which has to hand back its old state.
+        result = codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes());
+        REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+    }
+    md5(bm, digest);
+    return true;
+}
+
+DEF_TEST(Codec_pooled, r) {
+    const char* paths[] = {
+        "mandrill_512_q075.jpg", "grayscale.jpg", "CMYK.jpg",
+        "yellow_rose.png", "index8.png", "plane_interlaced.png", "mandrill_16.png",
+    };
+    for (const char* path : paths) {
+        SkMD5::Digest expected;
+        if (!decode_pooled(r, path, false, &expected)) {
+            continue;
+        }
+        for (int i = 0; i < 3; i++) {
+            SkMD5::Digest digest;
+            const SkCodecPool::Stats before = SkCodecPool::GetStats();
+            if (!decode_pooled(r, path, true, &digest)) {
+                break;
+            }
+            const SkCodecPool::Stats after = SkCodecPool::GetStats();
+            REPORTER_ASSERT(r, digest == expected);
+            REPORTER_ASSERT(r, after.fAllocs > before.fAllocs);
+            if (i > 0) {
+                // Everything but the largest blocks should have come from the pool.
+                REPORTER_ASSERT(r, after.fHeapAllocs - before.fHeapAllocs <
+                                   after.fAllocs - before.fAllocs);
+            }
+        }
+    }
+
+    // Purging leaves nothing to reuse, but pooled codecs keep working.
+    SkCodecPool::Purge();
+    SkMD5::Digest expected, digest;
+    if (decode_pooled(r, "mandrill_512_q075.jpg", false, &expected) &&
+        decode_pooled(r, "mandrill_512_q075.jpg", true, &digest)) {
+        REPORTER_ASSERT(r, digest == expected);
+    }
+}
@@ -0,0 +1,336 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkColorPriv.h"
+#include "SkColorSpace.h"
+#include "SkColorSpaceXform.h"
+#include "SkData.h"
+#include "SkEndian.h"
+#include "SkImageEncoder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+#include <math.h>
+
+static void write_be32(uint8_t* p, uint32_t v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+static void write_s15Fixed16(uint8_t* p, float v) {
+    write_be32(p, (uint32_t)(int32_t)lrintf(v * 65536));
+}
+
+// Builds a matrix/TRC ICC profile, with a different kind of curve for each channel.
+static SkData* make_icc(const SkFloat3x3& toXYZ) {
+    const int kTagCount = 6;
+    const size_t kXYZSize = 20,
+                 kGammaCurvSize = 14,
+                 kParaSize = 16,
+                 kTableCurvSize = 12 + 2 * 3;
+    const size_t tagsStart = 132 + 12 * kTagCount;
+    const size_t size = tagsStart + 3 * kXYZSize + SkAlign4(kGammaCurvSize) + kParaSize +
+                        SkAlign4(kTableCurvSize);
+
+    SkAutoTMalloc<uint8_t> storage(size);
+    uint8_t* icc = storage.get();
+    sk_bzero(icc, size);
+    write_be32(icc, (uint32_t)size);
+    memcpy(icc + 16, "RGB ", 4);
+    memcpy(icc + 20, "XYZ ", 4);
+    memcpy(icc + 36, "acsp", 4);
+    write_be32(icc + 128, kTagCount);
+
+    uint8_t* entry = icc + 132;
+    size_t offset = tagsStart;
+    auto add_tag = [&](const char sig[4], size_t length) {
+        memcpy(entry, sig, 4);
+        write_be32(entry + 4, (uint32_t)offset);
+        write_be32(entry + 8, (uint32_t)length);
+        entry += 12;
+        uint8_t* data = icc + offset;
+        offset += SkAlign4(length);
+        return data;
+    };
+
+    static const char* kXYZTags[] = { "rXYZ", "gXYZ", "bXYZ" };
+    for (int i = 0; i < 3; ++i) {
+        uint8_t* xyz = add_tag(kXYZTags[i], kXYZSize);
+        memcpy(xyz, "XYZ ", 4);
+        for (int j = 0; j < 3; ++j) {
+            write_s15Fixed16(xyz + 8 + 4 * j, toXYZ.fMat[3 * i + j]);
+        }
+    }
+
+    // Red: a curve with a single u8Fixed8 exponent, 2.2.
+    uint8_t* curv = add_tag("rTRC", kGammaCurvSize);
+    memcpy(curv, "curv", 4);
+    write_be32(curv + 8, 1);
+    curv[12] = 2;
+    curv[13] = 0x33;
+
+    // Green: a parametric power function, 1.8.
+    uint8_t* para = add_tag("gTRC", kParaSize);
+    memcpy(para, "para", 4);
+    write_s15Fixed16(para + 12, 1.8f);
+
+    // Blue: a table whose middle entry is 0.25, which a gamma of 2 matches.
+    uint8_t* table = add_tag("bTRC", kTableCurvSize);
+    memcpy(table, "curv", 4);
+    write_be32(table + 8, 3);
+    const uint16_t entries[] = { 0, 16384, 65535 };
+    for (int i = 0; i < 3; ++i) {
+        table[12 + 2 * i] = entries[i] >> 8;
+        table[13 + 2 * i] = entries[i] & 0xFF;
+    }
+
+    SkASSERT(offset == size);
+    return SkData::NewFromMalloc(storage.detach(), size);
+}
+
+static const SkFloat3x3 gP3 {{
+    0.5151f, 0.2412f, -0.0011f,
+    0.2919f, 0.6922f,  0.0419f,
+    0.1571f, 0.0666f,  0.7841f,
+}};
+
+DEF_TEST(ColorSpace_ICC, r) {
+    SkAutoTUnref<SkData> icc(make_icc(gP3));
+    SkAutoTUnref<SkColorSpace> space(SkColorSpace::NewICC(icc->data(), icc->size()));
+    REPORTER_ASSERT(r, space);
+    if (!space) {
+        return;
+    }
+    for (int i = 0; i < 9; ++i) {
+        REPORTER_ASSERT(r, fabsf(space->xyz().fMat[i] - gP3.fMat[i]) < 1.0f / 32768);
+    }
+    const SkFloat3 gamma = space->gamma();
+    REPORTER_ASSERT(r, fabsf(gamma.fVec[0] - 2.2f) < 1.0f / 256);
+    REPORTER_ASSERT(r, fabsf(gamma.fVec[1] - 1.8f) < 1.0f / 32768);
+    REPORTER_ASSERT(r, fabsf(gamma.fVec[2] - 2.0f) < 1.0f / 256);
+
+    // Anything cut short is rejected.
+    for (size_t len : { (size_t)0, (size_t)100, icc->size() - 1 }) {
+        SkAutoTUnref<SkColorSpace> truncated(SkColorSpace::NewICC(icc->data(), len));
+        REPORTER_ASSERT(r, !truncated);
+    }
+
+    // So are profiles whose header claims a size too small for their tag table, or a tag table
+    // too big for their size, however much data follows.
+    SkAutoTMalloc<uint8_t> bad(icc->size());
+    const uint32_t kBadFields[][2] = {
+        {   0, 0 }, {   0, 100 }, {   0, 131 },  // declared size
+        { 128, 1000 }, { 128, 0xFFFFFFFF },     // tag count
+    };
+    for (const auto& field : kBadFields) {
+        memcpy(bad.get(), icc->data(), icc->size());
+        const uint32_t value = SkEndian_SwapBE32(field[1]);
+        memcpy(bad.get() + field[0], &value, 4);
+        SkAutoTUnref<SkColorSpace> malformed(SkColorSpace::NewICC(bad.get(), icc->size()));
+        REPORTER_ASSERT(r, !malformed);
+    }
+}
+
+DEF_TEST(ColorSpace_Concat, r) {
+    SkAutoTUnref<SkColorSpace> srgb(SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named));
+    SkAutoTUnref<SkColorSpace> p3(SkColorSpace::NewNamed(SkColorSpace::kDisplayP3_Named));
+
+    // sRGB's red is inside P3, so it needs a little green and blue there.
+    SkFloat3x3 m;
+    REPORTER_ASSERT(r, SkColorSpace::kNormal_Result == SkColorSpace::Concat(srgb, p3, &m));
+    REPORTER_ASSERT(r, fabsf(m.fMat[0] - 0.8220f) < 0.001f);
+    REPORTER_ASSERT(r, fabsf(m.fMat[1] - 0.0332f) < 0.001f);
+    REPORTER_ASSERT(r, fabsf(m.fMat[2] - 0.0171f) < 0.001f);
+
+    // Spaces without names are compared by their contents, not their (lack of) names.
+    SkAutoTUnref<SkColorSpace> a(SkColorSpace::NewRGB(gP3, srgb->gamma()));
+    SkAutoTUnref<SkColorSpace> b(SkColorSpace::NewRGB(srgb->xyz(), srgb->gamma()));
+    REPORTER_ASSERT(r, SkColorSpace::kNormal_Result == SkColorSpace::Concat(a, b, nullptr));
+}
+
+DEF_TEST(ColorSpaceXform_Cache, r) {
+    SkAutoTUnref<SkColorSpace> srgb(SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named));
+    SkAutoTUnref<SkColorSpace> srgb2(SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named));
+    SkAutoTUnref<SkColorSpace> p3(SkColorSpace::NewNamed(SkColorSpace::kDisplayP3_Named));
+    SkAutoTUnref<SkColorSpace> p3Copy(SkColorSpace::NewRGB(p3->xyz(), p3->gamma()));
+
+    SkAutoTUnref<SkColorSpaceXform> identity(SkColorSpaceXform::New(srgb, srgb2));
+    REPORTER_ASSERT(r, !identity);
+
+    // Equal spaces share one transform, however they were made.
+    SkAutoTUnref<SkColorSpaceXform> x1(SkColorSpaceXform::New(srgb, p3));
+    SkAutoTUnref<SkColorSpaceXform> x2(SkColorSpaceXform::New(srgb2, p3Copy));
+    REPORTER_ASSERT(r, x1 && x1.get() == x2.get());
+
+    SkAutoTUnref<SkColorSpaceXform> back(SkColorSpaceXform::New(p3, srgb));
+    REPORTER_ASSERT(r, back && back.get() != x1.get());
+}
+
+static unsigned reference_channel(const SkColorSpaceXform& xform, const uint8_t rgb[3], int c) {
+    const float* m = xform.matrix().fMat;
+    float linear[3];
+    for (int i = 0; i < 3; ++i) {
+        linear[i] = powf(rgb[i] / 255.0f, xform.srcGamma().fVec[i]);
+    }
+    const float v = linear[0] * m[c] + linear[1] * m[c + 3] + linear[2] * m[c + 6];
+    return (unsigned)(255 * powf(SkTPin(v, 0.0f, 1.0f), 1 / xform.dstGamma().fVec[c]) + 0.5f);
+}
+
+DEF_TEST(ColorSpaceXform_8888, r) {
+    SkAutoTUnref<SkColorSpace> srgb(SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named));
+    SkAutoTUnref<SkColorSpace> p3(SkColorSpace::NewNamed(SkColorSpace::kDisplayP3_Named));
+    SkAutoTUnref<SkColorSpaceXform> xform(SkColorSpaceXform::New(srgb, p3));
+
+    // An odd count, to cover the tail.
+    const int N = 255;
+    uint32_t rgba[N], bgra[N], opaque[N];
+    uint8_t channels[N][3];
+    SkRandom rand;
+    for (int i = 0; i < N; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            channels[i][c] = rand.nextU() & 0xFF;
+        }
+        opaque[i] = SkPackARGB_as_RGBA(0xFF, channels[i][0], channels[i][1], channels[i][2]);
+        bgra[i] = SkPackARGB_as_BGRA(0xFF, channels[i][0], channels[i][1], channels[i][2]);
+    }
+
+    xform->apply(rgba, opaque, N, kRGBA_8888_SkColorType, kOpaque_SkAlphaType);
+    xform->apply(bgra, bgra, N, kBGRA_8888_SkColorType, kOpaque_SkAlphaType);
+    for (int i = 0; i < N; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            const int expected = reference_channel(*xform, channels[i], c);
+            const int actual = (rgba[i] >> (8 * c)) & 0xFF;
+            if (SkTAbs(actual - expected) > 1) {
+                ERRORF(r, "pixel %d channel %d: %d, expected %d", i, c, actual, expected);
+                return;
+            }
+        }
+        REPORTER_ASSERT(r, SkSwizzle_RB(rgba[i]) == bgra[i]);
+    }
+
+    // Premul pixels convert like the unpremul pixels they came from.
+    uint32_t premul[N];
+    for (int i = 0; i < N; ++i) {
+        const U8CPU a = 0x80;
+        premul[i] = SkPackARGB_as_RGBA(a, SkMulDiv255Round(channels[i][0], a),
+                                       SkMulDiv255Round(channels[i][1], a),
+                                       SkMulDiv255Round(channels[i][2], a));
+    }
+    xform->apply(premul, premul, N, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+    for (int i = 0; i < N; ++i) {
+        REPORTER_ASSERT(r, premul[i] >> 24 == 0x80);
+        for (int c = 0; c < 3; ++c) {
+            const int expected = SkMulDiv255Round((rgba[i] >> (8 * c)) & 0xFF, 0x80);
+            const int actual = (premul[i] >> (8 * c)) & 0xFF;
+            REPORTER_ASSERT(r, SkTAbs(actual - expected) <= 2);
+        }
+    }
+}
+
+static void check_codec_xform(skiatest::Reporter* r, SkImageEncoder::Type type,
+                              const SkBitmap& bitmap) {
+    SkAutoTUnref<SkData> encoded(SkImageEncoder::EncodeData(bitmap, type, 100));
+    REPORTER_ASSERT(r, encoded);
+    if (!encoded) {
+        return;
+    }
+
+    SkAutoTUnref<SkColorSpace> p3(SkColorSpace::NewNamed(SkColorSpace::kDisplayP3_Named));
+    SkCodec::Options options;
+    options.fDstColorSpace = p3;
+
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(encoded));
+    REPORTER_ASSERT(r, codec && !codec->getColorSpace());
+    if (!codec) {
+        return;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                             .makeAlphaType(kPremul_SkAlphaType);
+    SkBitmap plain, converted;
+    plain.allocPixels(info);
+    converted.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess ==
+            codec->getPixels(info, plain.getPixels(), plain.rowBytes()));
+    REPORTER_ASSERT(r, SkCodec::kSuccess ==
+            codec->getPixels(info, converted.getPixels(), converted.rowBytes(), &options,
+                             nullptr, nullptr));
+
+    // Untagged images are treated as sRGB.
+    SkAutoTUnref<SkColorSpace> srgb(SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named));
+    SkAutoTUnref<SkColorSpaceXform> xform(SkColorSpaceXform::New(srgb, p3));
+    for (int y = 0; y < info.height(); ++y) {
+        uint32_t expected[64];
+        SkASSERT(info.width() <= 64);
+        xform->apply(expected, plain.getAddr32(0, y), info.width(), info.colorType(),
+                     info.alphaType());
+        REPORTER_ASSERT(r, 0 == memcmp(expected, converted.getAddr32(0, y),
+                                       info.width() * sizeof(uint32_t)));
+    }
+
+    // Scanline decodes convert too.
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startScanlineDecode(info, &options, nullptr,
+                                                                        nullptr));
+    SkBitmap row;
+    row.allocPixels(info.makeWH(info.width(), 1));
+    for (int y = 0; y < info.height(); ++y) {
+        REPORTER_ASSERT(r, 1 == codec->getScanlines(row.getPixels(), 1, row.rowBytes()));
+        REPORTER_ASSERT(r, 0 == memcmp(row.getPixels(), converted.getAddr32(0, y),
+                                       info.width() * sizeof(uint32_t)));
+    }
+
+    // Only 8888 can be converted.
+    const SkImageInfo info565 = info.makeColorType(kRGB_565_SkColorType)
+                                    .makeAlphaType(kOpaque_SkAlphaType);
+    SkBitmap bitmap565;
+    bitmap565.allocPixels(info565);
+    REPORTER_ASSERT(r, SkCodec::kInvalidConversion ==
+            codec->getPixels(info565, bitmap565.getPixels(), bitmap565.rowBytes(), &options,
+                             nullptr, nullptr));
+}
+
+DEF_TEST(ColorSpaceXform_Codec, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(37, 19, true);
+    SkRandom rand;
+    for (int y = 0; y < bitmap.height(); ++y) {
+        for (int x = 0; x < bitmap.width(); ++x) {
+            *bitmap.getAddr32(x, y) = rand.nextU() | 0xFF000000;
+        }
+    }
+
+    // PNG converts in its swizzler, JPEG after it decodes.
+    check_codec_xform(r, SkImageEncoder::kPNG_Type, bitmap);
+    check_codec_xform(r, SkImageEncoder::kJPEG_Type, bitmap);
+}
+
+DEF_TEST(ColorSpaceXform_ColorFilter, r) {
+    SkAutoTUnref<SkColorSpace> srgb(SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named));
+    SkAutoTUnref<SkColorSpace> p3(SkColorSpace::NewNamed(SkColorSpace::kDisplayP3_Named));
+    SkAutoTUnref<SkColorFilter> filter(SkColorSpaceXform::NewColorFilter(srgb, p3));
+    SkAutoTUnref<SkColorSpaceXform> xform(SkColorSpaceXform::New(srgb, p3));
+    REPORTER_ASSERT(r, filter && xform);
+
+    const SkPMColor src[] = {
+        SkPreMultiplyColor(SK_ColorRED),
+        SkPreMultiplyColor(0x80336699),
+        SkPreMultiplyColor(SK_ColorTRANSPARENT),
+    };
+    SkPMColor filtered[3], expected[3];
+    filter->filterSpan(src, 3, filtered);
+    xform->apply(expected, src, 3, kN32_SkColorType, kPremul_SkAlphaType);
+    REPORTER_ASSERT(r, 0 == memcmp(filtered, expected, sizeof(filtered)));
+    REPORTER_ASSERT(r, 0 == filtered[2]);
+
+    SkAutoTUnref<SkColorFilter> none(SkColorSpaceXform::NewColorFilter(srgb, srgb));
+    REPORTER_ASSERT(r, !none);
+}
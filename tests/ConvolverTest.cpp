@@ -0,0 +1,117 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkConvolver.h"
+#include "SkRandom.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// BGRAConvolve2D()'s SIMD passes should match plain integer math exactly, at any width, with
+// any filter length, and however its rows get split up.
+
+typedef SkConvolutionFilter1D::ConvolutionFixed Fixed;
+
+static uint8_t clamp_to_8(int x) {
+    return (uint8_t)SkTPin(x, 0, 255);
+}
+
+// Filters each output pixel with taps starting near its scaled position, some negative, summing
+// to one.  The last taps are clipped against the source's edge, as SkBitmapScaler's are.
+static void make_filter(SkRandom* rand, int srcSize, int dstSize, int taps,
+                        SkConvolutionFilter1D* filter) {
+    SkAutoTMalloc<Fixed> values(taps);
+    for (int i = 0; i < dstSize; ++i) {
+        const int offset = SkTMin(i * srcSize / dstSize, srcSize - 1);
+        const int length = SkTMin(taps, srcSize - offset);
+        int sum = 0;
+        for (int k = 0; k < length; ++k) {
+            values[k] = (Fixed)(rand->nextRangeU(0, 6000) - 1000);
+            sum += values[k];
+        }
+        values[length / 2] += SkConvolutionFilter1D::FloatToFixed(1) - sum;
+        filter->AddFilter(offset, values.get(), length);
+    }
+}
+
+static void reference_convolve(const uint8_t* src, int srcW, int srcH, bool hasAlpha,
+                               const SkConvolutionFilter1D& filterX,
+                               const SkConvolutionFilter1D& filterY, uint8_t* dst) {
+    const int dstW = filterX.numValues(),
+              dstH = filterY.numValues();
+    SkAutoTMalloc<uint8_t> tmp(dstW * srcH * 4);
+    for (int y = 0; y < srcH; ++y) {
+        for (int x = 0; x < dstW; ++x) {
+            int offset, length;
+            const Fixed* values = filterX.FilterForValue(x, &offset, &length);
+            for (int c = 0; c < 4; ++c) {
+                int sum = 0;
+                for (int k = 0; k < length; ++k) {
+                    sum += values[k] * src[(y * srcW + offset + k) * 4 + c];
+                }
+                tmp[(y * dstW + x) * 4 + c] = clamp_to_8(sum >> SkConvolutionFilter1D::kShiftBits);
+            }
+        }
+    }
+    for (int y = 0; y < dstH; ++y) {
+        int offset, length;
+        const Fixed* values = filterY.FilterForValue(y, &offset, &length);
+        for (int x = 0; x < dstW; ++x) {
+            uint8_t* px = &dst[(y * dstW + x) * 4];
+            for (int c = 0; c < 4; ++c) {
+                int sum = 0;
+                for (int k = 0; k < length; ++k) {
+                    sum += values[k] * tmp[((offset + k) * dstW + x) * 4 + c];
+                }
+                px[c] = clamp_to_8(sum >> SkConvolutionFilter1D::kShiftBits);
+            }
+            // Alpha is raised to keep the result premultiplied, or forced opaque.
+            px[3] = hasAlpha ? SkTMax(px[3], SkTMax(px[0], SkTMax(px[1], px[2]))) : 0xFF;
+        }
+    }
+}
+
+static void test_convolve(skiatest::Reporter* r, SkRandom* rand, int srcW, int srcH,
+                          int dstW, int dstH, int tapsX, int tapsY, bool hasAlpha) {
+    // Exactly as big as it needs to be, so reading past the end of a row shows up in ASAN.
+    SkAutoTMalloc<uint8_t> src(srcW * srcH * 4);
+    for (int i = 0; i < srcW * srcH * 4; ++i) {
+        src[i] = (uint8_t)rand->nextU();
+    }
+
+    SkConvolutionFilter1D filterX, filterY;
+    make_filter(rand, srcW, dstW, tapsX, &filterX);
+    make_filter(rand, srcH, dstH, tapsY, &filterY);
+
+    SkAutoTMalloc<uint8_t> expected(dstW * dstH * 4),
+                           actual(dstW * dstH * 4);
+    reference_convolve(src.get(), srcW, srcH, hasAlpha, filterX, filterY, expected.get());
+    REPORTER_ASSERT(r, BGRAConvolve2D(src.get(), srcW * 4, hasAlpha, filterX, filterY,
+                                      dstW * 4, actual.get()));
+
+    for (int i = 0; i < dstW * dstH * 4; ++i) {
+        if (expected[i] != actual[i]) {
+            ERRORF(r, "%dx%d -> %dx%d, %d x %d taps, alpha %d: pixel (%d, %d)[%d] is %d, "
+                   "expected %d", srcW, srcH, dstW, dstH, tapsX, tapsY, hasAlpha,
+                   i / 4 % dstW, i / 4 / dstW, i % 4, actual[i], expected[i]);
+            return;
+        }
+    }
+}
+
+DEF_TEST(Convolver_MatchesReference, r) {
+    SkRandom rand;
+    for (bool hasAlpha : { true, false }) {
+        // Odd sizes and tap counts exercise every tail of the SIMD loops.
+        for (int taps : { 1, 2, 3, 5, 8 }) {
+            test_convolve(r, &rand, 17, 13, 11, 9, taps, taps, hasAlpha);
+            test_convolve(r, &rand, 7, 5, 23, 19, taps, taps + 1, hasAlpha);
+            test_convolve(r, &rand, 1, 1, 3, 2, taps, taps, hasAlpha);
+        }
+        // Big enough to be split into bands of rows on machines with several cores.
+        test_convolve(r, &rand, 600, 500, 1100, 900, 4, 6, hasAlpha);
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorFilter.h"
+#include "SkImage.h"
+#include "SkPath.h"
+#include "SkRSXform.h"
+#include "SkShader.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static SkImage* make_atlas() {
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterN32Premul(32, 32));
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, 0x80FFFFFF };
+    for (int i = 0; i < 4; ++i) {
+        paint.setColor(colors[i]);
+        canvas->drawRect(SkRect::MakeXYWH((i & 1) * 16.f, (i >> 1) * 16.f, 16, 16), paint);
+    }
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawLine(0, 0, 32, 32, paint);
+    return surface->newImageSnapshot();
+}
+
+// What SkBaseDevice::drawAtlas() does: each sprite is a path, filled with its own image shader
+// and color filter.
+static void draw_atlas_as_paths(SkCanvas* canvas, const SkImage* atlas, const SkRSXform xform[],
+                                const SkRect tex[], const SkColor colors[], int count,
+                                SkXfermode::Mode mode, const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        SkPoint quad[4];
+        xform[i].toQuad(tex[i].width(), tex[i].height(), quad);
+
+        SkMatrix localM;
+        localM.setRSXform(xform[i]);
+        localM.preTranslate(-tex[i].left(), -tex[i].top());
+
+        SkPaint pnt(paint);
+        pnt.setShader(atlas->newShader(SkShader::kClamp_TileMode, SkShader::kClamp_TileMode,
+                                       &localM))->unref();
+        if (colors) {
+            pnt.setColorFilter(SkColorFilter::CreateModeFilter(colors[i], mode))->unref();
+        }
+
+        SkPath path;
+        path.addPoly(quad, 4, true);
+        canvas->drawPath(path, pnt);
+    }
+}
+
+static int max_component_diff(SkPMColor a, SkPMColor b) {
+    int diff = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        diff = SkTMax(diff, SkTAbs((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)));
+    }
+    return diff;
+}
+
+// The raster device draws all the sprites through one blitter; check that it matches drawing
+// them one at a time.
+DEF_TEST(DrawAtlas_MatchesPaths, reporter) {
+    SkAutoTUnref<SkImage> atlas(make_atlas());
+
+    const int kCount = 6;
+    SkRSXform xform[kCount];
+    SkRect tex[kCount];
+    SkColor colors[kCount];
+    for (int i = 0; i < kCount; ++i) {
+        // Alternate axis-aligned sprites (including a quarter turn) with rotated ones.
+        const SkScalar radians = (i & 1) ? 0.4f * i : (SK_ScalarPI / 2) * (i >> 1);
+        const SkScalar scale = 1 + 0.25f * i;
+        xform[i] = SkRSXform::Make(scale * SkScalarCos(radians), scale * SkScalarSin(radians),
+                                   20.f + 30 * i, 40.f + 5 * i);
+        tex[i] = SkRect::MakeXYWH((i & 1) * 8.f, (i % 3) * 4.f, 16, 20);
+        colors[i] = SkColorSetARGB(0xFF - 0x20 * i, 0x30 * i, 0xFF - 0x10 * i, 0x80);
+    }
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(220, 120);
+    for (int aa = 0; aa < 2; ++aa) {
+        for (int useColors = 0; useColors < 2; ++useColors) {
+            for (int matrix = 0; matrix < 2; ++matrix) {
+                SkPaint paint;
+                paint.setAntiAlias(SkToBool(aa));
+
+                SkBitmap batched, paths;
+                batched.allocPixels(info);
+                paths.allocPixels(info);
+                batched.eraseColor(SK_ColorWHITE);
+                paths.eraseColor(SK_ColorWHITE);
+
+                SkCanvas batchedCanvas(batched), pathsCanvas(paths);
+                if (matrix) {
+                    batchedCanvas.scale(0.75f, 0.9f);
+                    pathsCanvas.scale(0.75f, 0.9f);
+                }
+                const SkColor* c = useColors ? colors : nullptr;
+                batchedCanvas.drawAtlas(atlas, xform, tex, c, kCount, SkXfermode::kModulate_Mode,
+                                        nullptr, &paint);
+                draw_atlas_as_paths(&pathsCanvas, atlas, xform, tex, c, kCount,
+                                    SkXfermode::kModulate_Mode, paint);
+
+                // Colors are blended by a compose shader rather than a color filter, which can
+                // round differently, and axis-aligned AA sprites are filled as rects, whose
+                // edge coverage is exact rather than supersampled.
+                const int tolerance = aa ? 32 : 1;
+                int worst = 0;
+                for (int y = 0; y < info.height(); ++y) {
+                    for (int x = 0; x < info.width(); ++x) {
+                        worst = SkTMax(worst, max_component_diff(*batched.getAddr32(x, y),
+                                                                 *paths.getAddr32(x, y)));
+                    }
+                }
+                REPORTER_ASSERT_MESSAGE(reporter, worst <= tolerance,
+                                        SkStringPrintf("aa %d colors %d matrix %d: off by %d",
+                                                       aa, useColors, matrix, worst).c_str());
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDashPathEffect.h"
+#include "SkFillPathCache.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkResourceCache.h"
+#include "Test.h"
+
+static SkPath make_polyline(int count) {
+    SkPath path;
+    path.moveTo(0, 0);
+    for (int i = 1; i < count; ++i) {
+        path.lineTo(SkIntToScalar(i * 10), SkIntToScalar(i & 1 ? 10 : 0));
+    }
+    return path;
+}
+
+// Returns true if the fill path came out of the cache: a hit hands back the cached path itself,
+// which keeps the generation ID it had when it was added.
+static bool check_fill_path(skiatest::Reporter* reporter, SkResourceCache* cache,
+                            const SkPaint& paint, const SkPath& src, uint32_t* genID) {
+    SkPath expected, actual;
+    const bool expectedFill = paint.getFillPath(src, &expected);
+    const bool actualFill = SkFillPathCache::GetFillPath(paint, src, &actual, nullptr, 1, cache);
+    REPORTER_ASSERT(reporter, expectedFill == actualFill);
+    REPORTER_ASSERT(reporter, expected == actual);
+
+    const bool hit = actual.getGenerationID() == *genID;
+    *genID = actual.getGenerationID();
+    return hit;
+}
+
+DEF_TEST(FillPathCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    SkPath path = make_polyline(20);
+    uint32_t genID = 0;
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(4);
+    REPORTER_ASSERT(reporter, !check_fill_path(reporter, &cache, paint, path, &genID));
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() > 0);
+    REPORTER_ASSERT(reporter, check_fill_path(reporter, &cache, paint, path, &genID));
+
+    // Any stroke parameter is part of the key.
+    paint.setStrokeJoin(SkPaint::kRound_Join);
+    REPORTER_ASSERT(reporter, !check_fill_path(reporter, &cache, paint, path, &genID));
+    REPORTER_ASSERT(reporter, check_fill_path(reporter, &cache, paint, path, &genID));
+    paint.setStrokeWidth(5);
+    REPORTER_ASSERT(reporter, !check_fill_path(reporter, &cache, paint, path, &genID));
+
+    // So are the dash intervals and phase.
+    const SkScalar intervals[] = { 10, 5 };
+    paint.setPathEffect(SkDashPathEffect::Create(intervals, 2, 0))->unref();
+    REPORTER_ASSERT(reporter, !check_fill_path(reporter, &cache, paint, path, &genID));
+    REPORTER_ASSERT(reporter, check_fill_path(reporter, &cache, paint, path, &genID));
+    paint.setPathEffect(SkDashPathEffect::Create(intervals, 2, 3))->unref();
+    REPORTER_ASSERT(reporter, !check_fill_path(reporter, &cache, paint, path, &genID));
+    REPORTER_ASSERT(reporter, check_fill_path(reporter, &cache, paint, path, &genID));
+
+    // Editing the path misses.
+    path.lineTo(0, 50);
+    REPORTER_ASSERT(reporter, !check_fill_path(reporter, &cache, paint, path, &genID));
+    REPORTER_ASSERT(reporter, check_fill_path(reporter, &cache, paint, path, &genID));
+
+    // Volatile and short paths are never cached.
+    const size_t bytesUsed = cache.getTotalBytesUsed();
+    path.setIsVolatile(true);
+    REPORTER_ASSERT(reporter, !check_fill_path(reporter, &cache, paint, path, &genID));
+    REPORTER_ASSERT(reporter, !check_fill_path(reporter, &cache, paint, path, &genID));
+    SkPath shortPath = make_polyline(3);
+    REPORTER_ASSERT(reporter, !check_fill_path(reporter, &cache, paint, shortPath, &genID));
+    REPORTER_ASSERT(reporter, !check_fill_path(reporter, &cache, paint, shortPath, &genID));
+    REPORTER_ASSERT(reporter, bytesUsed == cache.getTotalBytesUsed());
+}
@@ -5,10 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkBlitter.h"
+#include "SkCanvas.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkScan.h"
+#include "SkScanPriv.h"
 #include "Test.h"
 
 struct FakeBlitter : public SkBlitter {
@@ -43,3 +47,140 @@ DEF_TEST(FillPathInverse, reporter) {
 
   REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+static const int kFillSize = 64;
+
+static void fill_path(const SkPath& path, bool aa, SkBitmap* bitmap) {
+    bitmap->allocPixels(SkImageInfo::MakeA8(kFillSize, kFillSize));
+    bitmap->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(*bitmap);
+    SkPaint paint;
+    paint.setAntiAlias(aa);
+    canvas.drawPath(path, paint);
+}
+
+// Returns the largest difference between the alphas of two A8 bitmaps of the same size.
+static int max_alpha_diff(const SkBitmap& a, const SkBitmap& b) {
+    int diff = 0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            diff = SkTMax(diff, SkAbs32(*a.getAddr8(x, y) - *b.getAddr8(x, y)));
+        }
+    }
+    return diff;
+}
+
+// Integer rects, each wound one way or the other.  Each rect adds two vertical edges (the
+// horizontal ones are dropped), and many of them tie on both fFirstY and fX.
+static void add_random_rects(SkRandom* rand, int count, SkPath* path, int8_t winding[]) {
+    for (int i = 0; i < count; i++) {
+        const int l = rand->nextULessThan(kFillSize - 1),
+                  t = rand->nextULessThan(kFillSize - 1);
+        const int r = l + 1 + rand->nextULessThan(kFillSize - l),
+                  b = t + 1 + rand->nextULessThan(kFillSize - t);
+        const bool cw = rand->nextBool();
+        path->addRect(SkRect::MakeLTRB(SkIntToScalar(l), SkIntToScalar(t),
+                                       SkIntToScalar(r), SkIntToScalar(b)),
+                      cw ? SkPath::kCW_Direction : SkPath::kCCW_Direction);
+        for (int y = t; y < b; y++) {
+            for (int x = l; x < r; x++) {
+                winding[y * kFillSize + x] += cw ? 1 : -1;
+            }
+        }
+    }
+}
+
+// Pixel centers never lie on the edges of integer rects, so both the aliased and the
+// anti-aliased fill must match the winding numbers exactly.
+DEF_TEST(FillPath_ManyRects, reporter) {
+    SkRandom rand;
+    for (int index = 0; index < 50; index++) {
+        SkPath path;
+        int8_t winding[kFillSize * kFillSize];
+        sk_bzero(winding, sizeof(winding));
+        add_random_rects(&rand, 40 + rand.nextULessThan(24), &path, winding);
+
+        for (int evenOdd = 0; evenOdd < 2; evenOdd++) {
+            path.setFillType(evenOdd ? SkPath::kEvenOdd_FillType : SkPath::kWinding_FillType);
+            for (int aa = 0; aa < 2; aa++) {
+                SkBitmap bitmap;
+                fill_path(path, SkToBool(aa), &bitmap);
+                bool matches = true;
+                for (int y = 0; y < kFillSize; y++) {
+                    for (int x = 0; x < kFillSize; x++) {
+                        const int w = winding[y * kFillSize + x];
+                        const bool inside = evenOdd ? SkToBool(w & 1) : 0 != w;
+                        matches &= (inside ? 0xFF : 0) == *bitmap.getAddr8(x, y);
+                    }
+                }
+                REPORTER_ASSERT(reporter, matches);
+            }
+        }
+    }
+}
+
+#ifdef SK_DEBUG
+// Fills with the radix sort and with SkTQSort.  Edges that tie on both fFirstY and fX can come
+// out of the two sorts in either order.  When their windings differ, one order ends a span at
+// their x and starts the next there, and the other carries one span across it.  Aliased, that
+// makes no difference.  Anti-aliased, the supersampler adds 63 rather than 64 for the last
+// sub-scanline of a pixel that one span covers, so that full coverage sums to 255, but it adds
+// the two halves of a split pixel up to 64.  So the pixel under the tie can differ by 1.
+static void test_sorts_match(skiatest::Reporter* reporter, const SkPath& path) {
+    for (int evenOdd = 0; evenOdd < 2; evenOdd++) {
+        SkPath filled(path);
+        filled.setFillType(evenOdd ? SkPath::kEvenOdd_FillType : SkPath::kWinding_FillType);
+        for (int aa = 0; aa < 2; aa++) {
+            SkBitmap radix, qsort;
+            gMinRadixSortEdges = 0;
+            fill_path(filled, SkToBool(aa), &radix);
+            gMinRadixSortEdges = SK_MaxS32;
+            fill_path(filled, SkToBool(aa), &qsort);
+            REPORTER_ASSERT(reporter, max_alpha_diff(radix, qsort) <= aa);
+        }
+    }
+}
+
+DEF_TEST(FillPath_RadixSortEdges, reporter) {
+    const int minRadixSortEdges = gMinRadixSortEdges;
+    SkRandom rand;
+
+    // Stars, some with more spikes than the threshold and some with fewer.
+    for (int spikes = 5; spikes <= 200; spikes += 15) {
+        SkPath path;
+        for (int i = 0; i < 2 * spikes; i++) {
+            const SkScalar radius = (i & 1) ? 8 : 30;
+            const SkScalar radians = SK_ScalarPI * i / spikes;
+            const SkPoint pt = SkPoint::Make(32 + radius * SkScalarCos(radians),
+                                             32 + radius * SkScalarSin(radians));
+            i ? path.lineTo(pt) : path.moveTo(pt);
+        }
+        test_sorts_match(reporter, path);
+    }
+
+    // Random polygons on a grid, so many edges share fFirstY and fX.
+    for (int index = 0; index < 100; index++) {
+        SkPath path;
+        const int count = 3 + rand.nextULessThan(150);
+        for (int i = 0; i < count; i++) {
+            const SkPoint pt = SkPoint::Make(SkIntToScalar(rand.nextULessThan(16) * 4),
+                                             SkIntToScalar(rand.nextULessThan(16) * 4)) +
+                               SkPoint::Make(0.5f, 0.25f);
+            i ? path.lineTo(pt) : path.moveTo(pt);
+        }
+        test_sorts_match(reporter, path);
+    }
+
+    // Rects, with their ties and vertical edges.
+    for (int index = 0; index < 20; index++) {
+        SkPath path;
+        int8_t winding[kFillSize * kFillSize];
+        sk_bzero(winding, sizeof(winding));
+        add_random_rects(&rand, 40 + rand.nextULessThan(24), &path, winding);
+        path.offset(0.375f, 0.5f);
+        test_sorts_match(reporter, path);
+    }
+
+    gMinRadixSortEdges = minRadixSortEdges;
+}
+#endif
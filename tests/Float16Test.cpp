@@ -113,3 +113,131 @@ DEF_TEST(FloatToHalf_01, r) {
         }
     }
 }
+
+#include "SkCanvas.h"
+#include "SkXfermode.h"
+
+static SkPM4f random_pm4f(SkRandom* rand) {
+    SkColor4f c4 = { rand->nextF(), rand->nextF(), rand->nextF(), rand->nextF() };
+    return c4.premul();
+}
+
+// F16 is stored RGBA, and SkPM4f is in SkPMColor order.
+static SkPM4f swap_rb(SkPM4f pm4) {
+    if (SkPM4f::R != 0) {
+        SkTSwap(pm4.fVec[0], pm4.fVec[2]);
+    }
+    return pm4;
+}
+
+static SkPM4f from_f16(uint64_t f16) {
+    return swap_rb(SkPM4f::FromF16((const uint16_t*)&f16));
+}
+
+static uint64_t to_f16(const SkPM4f& pm4) {
+    return swap_rb(pm4).toF16();
+}
+
+static SkPM4f pixel_at(const SkBitmap& bitmap, int x, int y) {
+    return from_f16(*(const uint64_t*)bitmap.getAddr(x, y));
+}
+
+static bool eq_within(const SkPM4f& a, const SkPM4f& b, float tolerance) {
+    for (int i = 0; i < 4; ++i) {
+        if (fabsf(a.fVec[i] - b.fVec[i]) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The F16 procs for every mode should match the mode's SkXfermodeProc4f.
+DEF_TEST(F16_xfermodes, reporter) {
+    const int N = 64;
+    SkRandom rand;
+    SkPM4f src[N], dst4f[N];
+    SkAlpha aa[N];
+    for (int i = 0; i < N; ++i) {
+        src[i] = random_pm4f(&rand);
+        // Round trip through F16, so the reference starts from the same dst as the procs.
+        dst4f[i] = from_f16(to_f16(random_pm4f(&rand)));
+        aa[i] = rand.nextU() & 0xFF;
+    }
+
+    for (int m = 0; m <= SkXfermode::kLastMode; ++m) {
+        const SkXfermode::Mode mode = (SkXfermode::Mode)m;
+        SkAutoTUnref<SkXfermode> xfer(SkXfermode::Create(mode));
+        const SkXfermodeProc4f proc4f = SkXfermode::GetProc4f(mode);
+
+        for (int single = 0; single <= 1; ++single) {
+            for (int coverage = 0; coverage <= 1; ++coverage) {
+                uint32_t flags = SkXfermode::kDstIsFloat16_D64Flag;
+                if (single) {
+                    flags |= SkXfermode::kSrcIsSingle_D64Flag;
+                }
+                SkXfermode::D64Proc proc = SkXfermode::GetD64Proc(xfer, flags);
+
+                uint64_t dst[N];
+                for (int i = 0; i < N; ++i) {
+                    dst[i] = to_f16(dst4f[i]);
+                }
+                proc(xfer, dst, src, N, coverage ? aa : nullptr);
+
+                for (int i = 0; i < N; ++i) {
+                    const SkPM4f& s = src[single ? 0 : i];
+                    const Sk4f d4 = Sk4f::Load(dst4f[i].fVec);
+                    Sk4f r4 = Sk4f::Load(proc4f(s, dst4f[i]).fVec);
+                    if (coverage) {
+                        r4 = d4 + (r4 - d4) * Sk4f(aa[i] * (1/255.0f));
+                    }
+                    SkPM4f expected;
+                    Sk4f::Min(Sk4f::Max(r4, Sk4f(0)), Sk4f(1)).store(expected.fVec);
+                    if (!eq_within(from_f16(dst[i]), expected, 1.0f / 512)) {
+                        ERRORF(reporter, "mode %s, single %d, coverage %d, pixel %d",
+                               SkXfermode::ModeName(mode), single, coverage, i);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(F16_canvas, reporter) {
+    const int w = 16, h = 16;
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::Make(w, h, kRGBA_F16_SkColorType, kPremul_SkAlphaType));
+    SkCanvas canvas(bitmap);
+    canvas.clear(SK_ColorBLUE);
+
+    // Half of the pixels in column 4 are covered.
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorRED);
+    canvas.drawRect(SkRect::MakeLTRB(4.5f, 0, 8, 8), paint);
+
+    SkPM4f edge = pixel_at(bitmap, 4, 0);
+    REPORTER_ASSERT(reporter, fabsf(edge.fVec[SkPM4f::R] - 0.5f) < 1.0f / 64);
+    REPORTER_ASSERT(reporter, fabsf(edge.fVec[SkPM4f::B] - 0.5f) < 1.0f / 64);
+    REPORTER_ASSERT(reporter, edge.fVec[SkPM4f::A] == 1.0f);
+
+    // Sprites from an F16 source keep their channels in order.
+    SkBitmap green;
+    green.allocPixels(SkImageInfo::Make(2, 2, kRGBA_F16_SkColorType, kPremul_SkAlphaType));
+    green.eraseColor(SK_ColorGREEN);
+    canvas.drawBitmap(green, 10, 10);
+    SkPM4f sprite = pixel_at(bitmap, 10, 10);
+    REPORTER_ASSERT(reporter, sprite.fVec[SkPM4f::R] == 0.0f);
+    REPORTER_ASSERT(reporter, sprite.fVec[SkPM4f::G] == 1.0f);
+    REPORTER_ASSERT(reporter, sprite.fVec[SkPM4f::B] == 0.0f);
+
+    // Non-separable modes blend with their own math.
+    paint.setAntiAlias(false);
+    paint.setColor(SK_ColorWHITE);
+    paint.setXfermodeMode(SkXfermode::kDifference_Mode);
+    canvas.drawRect(SkRect::MakeLTRB(0, 12, 4, 16), paint);
+    SkPM4f diff = pixel_at(bitmap, 0, 13);
+    REPORTER_ASSERT(reporter, diff.fVec[SkPM4f::R] == 1.0f);
+    REPORTER_ASSERT(reporter, diff.fVec[SkPM4f::G] == 1.0f);
+    REPORTER_ASSERT(reporter, diff.fVec[SkPM4f::B] == 0.0f);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkGradientShader.h"
+#include "SkShader.h"
+#include "SkXfermode.h"
+#include "Test.h"
+
+// The shader x xfermode x device combinations with fused blitters, checked against float math.
+
+enum SourceKind { kSolid, kBitmap, kGradient };
+
+static const int W = 32, H = 8;
+static const SkColor kSolidColor = 0xC0208040;
+static const SkColor kDstColor = 0xFF4080C0;
+
+static SkBitmap make_source_bitmap() {
+    SkBitmap bm;
+    bm.allocN32Pixels(4, 4);
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const U8CPU a = 0x40 + 0x30 * x;
+            *bm.getAddr32(x, y) = SkPreMultiplyARGB(a, 0x40 * y, 0xFF - 0x20 * x, 0x80);
+        }
+    }
+    return bm;
+}
+
+static SkShader* make_shader(SourceKind kind, const SkBitmap& bm) {
+    switch (kind) {
+        case kSolid:
+            return SkShader::CreateColorShader(kSolidColor);
+        case kBitmap: {
+            const SkMatrix m = SkMatrix::MakeTrans(2, 1);
+            return SkShader::CreateBitmapShader(bm, SkShader::kClamp_TileMode,
+                                                SkShader::kClamp_TileMode, &m);
+        }
+        case kGradient: {
+            const SkPoint pts[] = { { 4, 0 }, { 28, 0 } };
+            const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+            return SkGradientShader::CreateLinear(pts, colors, nullptr, 2,
+                                                  SkShader::kClamp_TileMode);
+        }
+    }
+    return nullptr;
+}
+
+static void unpack(SkPMColor c, float argb[4]) {
+    argb[0] = SkGetPackedA32(c) / 255.0f;
+    argb[1] = SkGetPackedR32(c) / 255.0f;
+    argb[2] = SkGetPackedG32(c) / 255.0f;
+    argb[3] = SkGetPackedB32(c) / 255.0f;
+}
+
+// Premul ARGB of the source at device pixel (x, y).
+static void source_at(SourceKind kind, const SkBitmap& bm, int x, int y, float argb[4]) {
+    switch (kind) {
+        case kSolid:
+            unpack(SkPreMultiplyColor(kSolidColor), argb);
+            break;
+        case kBitmap:
+            unpack(*bm.getAddr32(SkTPin(x - 2, 0, 3), SkTPin(y - 1, 0, 3)), argb);
+            break;
+        case kGradient: {
+            const float t = SkTPin((x + 0.5f - 4) / 24, 0.0f, 1.0f);
+            argb[0] = 1;
+            argb[1] = 1 - t;
+            argb[2] = 0;
+            argb[3] = t;
+            break;
+        }
+    }
+}
+
+static float blend(SkXfermode::Mode mode, const float s[4], const float d[4], int i) {
+    switch (mode) {
+        case SkXfermode::kSrc_Mode:
+            return s[i];
+        case SkXfermode::kSrcOver_Mode:
+            return s[i] + d[i] * (1 - s[0]);
+        case SkXfermode::kMultiply_Mode:
+            return s[i] * (1 - d[0]) + d[i] * (1 - s[0]) + s[i] * d[i];
+        default:
+            SkASSERT(false);
+            return 0;
+    }
+}
+
+static void check(skiatest::Reporter* r, SourceKind kind, SkXfermode::Mode mode, SkColorType ct) {
+    const SkBitmap srcBitmap = make_source_bitmap();
+    SkAutoTUnref<SkShader> shader(make_shader(kind, srcBitmap));
+
+    SkBitmap dst;
+    dst.allocPixels(SkImageInfo::Make(W, H, ct, kRGB_565_SkColorType == ct ? kOpaque_SkAlphaType
+                                                                          : kPremul_SkAlphaType));
+    dst.eraseColor(kDstColor);
+    SkCanvas canvas(dst);
+
+    SkPaint paint;
+    paint.setShader(shader);
+    paint.setXfermodeMode(mode);
+
+    // Rows 0-1 are covered fully, through blitRect().
+    canvas.drawRect(SkRect::MakeLTRB(0, 0, W, 2), paint);
+
+    // Rows 2-3 are each covered by half, through blitAntiH().
+    paint.setAntiAlias(true);
+    canvas.drawRect(SkRect::MakeLTRB(0, 2.5f, W, 3.5f), paint);
+    paint.setAntiAlias(false);
+
+    // Rows 4-7 go through blitMask(), with coverage increasing along x.
+    SkBitmap mask;
+    mask.allocPixels(SkImageInfo::MakeA8(W, 4));
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < W; ++x) {
+            *mask.getAddr8(x, y) = (uint8_t)(x * 8);
+        }
+    }
+    canvas.drawBitmap(mask, 0, 4, &paint);
+
+    const float tolerance = kRGB_565_SkColorType == ct ? 12 / 255.0f : 3 / 255.0f;
+    // 565 has no alpha to check.
+    const int firstChannel = kRGB_565_SkColorType == ct ? 1 : 0;
+    SkPMColor dstColor = SkPreMultiplyColor(kDstColor);
+    if (kRGB_565_SkColorType == ct) {
+        dstColor = SkPixel16ToPixel32(SkPixel32ToPixel16(dstColor));
+    }
+    float d[4];
+    unpack(dstColor, d);
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            float coverage = 1;
+            if (y >= 4) {
+                coverage = (x * 8) / 255.0f;
+            } else if (y >= 2) {
+                coverage = 0.5f;
+            }
+
+            // drawBitmap() shades the mask in the bitmap's space, which starts at row 4.
+            float s[4], actual[4];
+            source_at(kind, srcBitmap, x, y >= 4 ? y - 4 : y, s);
+            unpack(kRGB_565_SkColorType == ct ? SkPixel16ToPixel32(*dst.getAddr16(x, y))
+                                              : *dst.getAddr32(x, y), actual);
+            for (int i = firstChannel; i < 4; ++i) {
+                const float expected = d[i] + (blend(mode, s, d, i) - d[i]) * coverage;
+                if (fabsf(expected - actual[i]) > tolerance) {
+                    ERRORF(r, "source %d, %s, color type %d, (%d, %d)[%d]: %g, expected %g",
+                           kind, SkXfermode::ModeName(mode), ct, x, y, i, actual[i], expected);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(FusedBlitters, r) {
+    const SkXfermode::Mode modes[] = {
+        SkXfermode::kSrcOver_Mode, SkXfermode::kSrc_Mode, SkXfermode::kMultiply_Mode,
+    };
+    for (SourceKind kind : { kSolid, kBitmap, kGradient }) {
+        for (SkXfermode::Mode mode : modes) {
+            for (SkColorType ct : { kN32_SkColorType, kRGB_565_SkColorType }) {
+                check(r, kind, mode, ct);
+            }
+        }
+    }
+}
@@ -9,6 +9,7 @@
 #include "Resources.h"
 #include "SkAndroidCodec.h"
 #include "SkBitmap.h"
+#include "SkColorSpace.h"
 #include "SkData.h"
 #include "SkImage.h"
 #include "SkStream.h"
@@ -227,3 +228,156 @@ DEF_TEST(Gif_Sampled, r) {
             bm.rowBytes(), &options);
     REPORTER_ASSERT(r, result == SkCodec::kSuccess);
 }
+
+static bool decode_frame(SkCodec* codec, int index, int priorFrame, SkBitmap* bm,
+                         SkColorSpace* dstSpace = nullptr) {
+    SkCodec::Options options;
+    options.fFrameIndex = index;
+    options.fPriorFrame = priorFrame;
+    options.fDstColorSpace = dstSpace;
+    return SkCodec::kSuccess == codec->getPixels(bm->info(), bm->getPixels(), bm->rowBytes(),
+                                                 &options, nullptr, nullptr);
+}
+
+static bool bitmaps_equal(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < a.height(); y++) {
+        if (memcmp(a.getAddr(0, y), b.getAddr(0, y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(Gif_Frames, r) {
+    SkAutoTDelete<SkStreamAsset> stream(GetResourceAsStream("test640x479.gif"));
+    if (!stream) {
+        return;
+    }
+    SkAutoTUnref<SkData> data(SkData::NewFromStream(stream, stream->getLength()));
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+
+    // Four full size frames, each drawn on top of the last.
+    const int frameCount = codec->getFrameCount();
+    REPORTER_ASSERT(r, 4 == frameCount);
+    for (int i = 0; i < frameCount; i++) {
+        SkCodec::FrameInfo info;
+        REPORTER_ASSERT(r, codec->getFrameInfo(i, &info));
+        REPORTER_ASSERT(r, i - 1 == info.fRequiredFrame);
+        REPORTER_ASSERT(r, 200 == info.fDuration);
+        REPORTER_ASSERT(r, SkCodec::kKeep_DisposalMethod == info.fDisposalMethod);
+        REPORTER_ASSERT(r, SkIRect::MakeWH(640, 479) == info.fFrameRect);
+    }
+    SkCodec::FrameInfo info;
+    REPORTER_ASSERT(r, !codec->getFrameInfo(frameCount, &info));
+
+    // Play through the frames, then check that decoding each one from scratch, in
+    // reverse order and with a new codec, gets the same result.
+    const SkImageInfo dstInfo = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap played[4];
+    for (int i = 0; i < frameCount; i++) {
+        if (i > 0) {
+            played[i - 1].copyTo(&played[i]);
+        } else {
+            played[i].allocPixels(dstInfo);
+        }
+        REPORTER_ASSERT(r, decode_frame(codec, i, i - 1, &played[i]));
+    }
+    REPORTER_ASSERT(r, !bitmaps_equal(played[0], played[frameCount - 1]));
+
+    codec.reset(SkCodec::NewFromData(data));
+    for (int i = frameCount - 1; i >= 0; i--) {
+        SkBitmap bm;
+        bm.allocPixels(dstInfo);
+        REPORTER_ASSERT(r, decode_frame(codec, i, SkCodec::kNone, &bm));
+        REPORTER_ASSERT(r, bitmaps_equal(played[i], bm));
+    }
+
+    // The first frame decodes the same way it always has.
+    SkBitmap first;
+    first.allocPixels(dstInfo);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(dstInfo, first.getPixels(),
+                                                             first.rowBytes()));
+    REPORTER_ASSERT(r, bitmaps_equal(played[0], first));
+
+    // Later frames support neither scanline decoding nor kIndex8.
+    SkCodec::Options options;
+    options.fFrameIndex = 1;
+    REPORTER_ASSERT(r, SkCodec::kUnimplemented == codec->startScanlineDecode(dstInfo, &options,
+                                                                             nullptr, nullptr));
+    SkPMColor colors[256];
+    int colorCount = 256;
+    const SkImageInfo index8Info = dstInfo.makeColorType(kIndex_8_SkColorType);
+    SkAutoMalloc index8(index8Info.getSafeSize(index8Info.minRowBytes()));
+    REPORTER_ASSERT(r, SkCodec::kInvalidConversion == codec->getPixels(index8Info,
+            index8.get(), index8Info.minRowBytes(), &options, colors, &colorCount));
+
+    options.fFrameIndex = frameCount;
+    REPORTER_ASSERT(r, SkCodec::kInvalidParameters == codec->getPixels(dstInfo,
+            first.getPixels(), first.rowBytes(), &options, nullptr, nullptr));
+}
+
+// Frames drawn over a prior frame must convert only the pixels they draw, since the
+// prior frame's pixels are already in the destination color space.
+DEF_TEST(Gif_FramesColorSpace, r) {
+    SkAutoTDelete<SkStreamAsset> stream(GetResourceAsStream("test640x479.gif"));
+    if (!stream) {
+        return;
+    }
+    SkAutoTUnref<SkData> data(SkData::NewFromStream(stream, stream->getLength()));
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    SkAutoTUnref<SkColorSpace> p3(SkColorSpace::NewNamed(SkColorSpace::kDisplayP3_Named));
+
+    const int frameCount = codec->getFrameCount();
+    const SkImageInfo dstInfo = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap played[4];
+    REPORTER_ASSERT(r, frameCount <= 4);
+    for (int i = 0; i < frameCount; i++) {
+        if (i > 0) {
+            played[i - 1].copyTo(&played[i]);
+        } else {
+            played[i].allocPixels(dstInfo);
+        }
+        REPORTER_ASSERT(r, decode_frame(codec, i, i - 1, &played[i], p3));
+    }
+
+    codec.reset(SkCodec::NewFromData(data));
+    for (int i = frameCount - 1; i >= 0; i--) {
+        SkBitmap bm;
+        bm.allocPixels(dstInfo);
+        REPORTER_ASSERT(r, decode_frame(codec, i, SkCodec::kNone, &bm, p3));
+        REPORTER_ASSERT(r, bitmaps_equal(played[i], bm));
+
+        // The conversion did something.
+        SkBitmap unconverted;
+        unconverted.allocPixels(dstInfo);
+        REPORTER_ASSERT(r, decode_frame(codec, i, SkCodec::kNone, &unconverted));
+        REPORTER_ASSERT(r, !bitmaps_equal(unconverted, bm));
+    }
+}
+
+DEF_TEST(Gif_SingleFrame, r) {
+    SkAutoTUnref<SkData> data(SkData::NewWithoutCopy(gGIFData, sizeof(gGIFData)));
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    REPORTER_ASSERT(r, 1 == codec->getFrameCount());
+    SkCodec::FrameInfo info;
+    REPORTER_ASSERT(r, codec->getFrameInfo(0, &info));
+    REPORTER_ASSERT(r, SkCodec::kNone == info.fRequiredFrame);
+
+    // Counting the frames must not disturb a decode of the first frame.
+    SkBitmap bm;
+    bm.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType));
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(bm.info(), bm.getPixels(),
+                                                             bm.rowBytes()));
+}
@@ -217,3 +217,69 @@ DEF_TEST(PathMeasureConic, reporter) {
     REPORTER_ASSERT(reporter, 19.5f < stdP.fX && stdP.fX < 20.5f);
     REPORTER_ASSERT(reporter, 19.5f < hiP.fX && hiP.fX < 20.5f);
 }
+
+// Measures each contour of path, checking it against expected, and getPosTans() against
+// getPosTan().
+static void check_contours(skiatest::Reporter* reporter, const SkPath& path,
+                           const SkPath& expected) {
+    SkPathMeasure meas(path, false);
+    SkPathMeasure expectedMeas(expected, false);
+    do {
+        const SkScalar length = meas.getLength();
+        REPORTER_ASSERT(reporter, length == expectedMeas.getLength());
+        REPORTER_ASSERT(reporter, meas.isClosed() == expectedMeas.isClosed());
+
+        // Increasing distances, then some out of order and out of range.
+        SkScalar distances[40];
+        for (int i = 0; i < 32; ++i) {
+            distances[i] = length * i / 31;
+        }
+        const SkScalar unsorted[] = { length / 2, length / 3, -1, length + 1, 0, length / 4,
+                                      length / 4, length * 2 / 3 };
+        memcpy(&distances[32], unsorted, sizeof(unsorted));
+
+        SkPoint positions[40];
+        SkVector tangents[40];
+        REPORTER_ASSERT(reporter, meas.getPosTans(distances, 40, positions, tangents));
+        for (int i = 0; i < 40; ++i) {
+            SkPoint pos;
+            SkVector tan;
+            REPORTER_ASSERT(reporter, expectedMeas.getPosTan(distances[i], &pos, &tan));
+            REPORTER_ASSERT(reporter, pos == positions[i] && tan == tangents[i]);
+        }
+
+        SkPath segment, expectedSegment;
+        REPORTER_ASSERT(reporter, meas.getSegment(length / 5, length * 4 / 5, &segment, true));
+        REPORTER_ASSERT(reporter, expectedMeas.getSegment(length / 5, length * 4 / 5,
+                                                          &expectedSegment, true));
+        REPORTER_ASSERT(reporter, segment == expectedSegment);
+    } while (meas.nextContour() && expectedMeas.nextContour());
+    REPORTER_ASSERT(reporter, !meas.nextContour() && !expectedMeas.nextContour());
+}
+
+DEF_TEST(PathMeasureCache, reporter) {
+    SkPath path;
+    path.moveTo(0, 0);
+    for (int i = 0; i < 8; ++i) {
+        path.cubicTo(10 * i + 3, 20, 10 * i + 6, -20, 10 * i + 10, 0);
+    }
+    path.moveTo(0, 100);
+    path.lineTo(50, 100);
+    path.addCircle(50, 50, 40);
+    path.moveTo(200, 200);
+    path.quadTo(300, 400, 400, 200);
+    path.conicTo(300, 0, 200, 200, 0.5f);
+    path.close();
+
+    // The volatile copy is always measured; the second time through, path's contours should
+    // come from the cache, and must match.
+    SkPath uncached(path);
+    uncached.setIsVolatile(true);
+    check_contours(reporter, path, uncached);
+    check_contours(reporter, path, uncached);
+
+    // An edit changes the gen ID, so the old contours aren't used.
+    path.offset(10, 10);
+    uncached.offset(10, 10);
+    check_contours(reporter, path, uncached);
+}
@@ -301,3 +301,62 @@ DEF_TEST(Issue569540, reporter) {
     SkPath result;
     builder.resolve(&result);
 }
+
+// Enough paths to be divided: clusters of overlapping polygons (some not convex), clusters
+// that only share edges, and isolated polygons, compared with unioning them one at a time.
+DEF_TEST(BuilderManyUnions, reporter) {
+    SkOpBuilder builder;
+    SkPath expected;
+    for (int cell = 0; cell < 36; ++cell) {
+        const SkScalar x = SkIntToScalar(cell % 6 * 40);
+        const SkScalar y = SkIntToScalar(cell / 6 * 40);
+        SkPath paths[3];
+        int count;
+        switch (cell % 3) {
+            case 0:  // a rect, a triangle, and an L shape crossing them both
+                paths[0].addRect(x, y, x + 20, y + 20);
+                paths[1].moveTo(x + 10, y + 5);
+                paths[1].lineTo(x + 30, y + 10);
+                paths[1].lineTo(x + 15, y + 30);
+                paths[1].close();
+                paths[2].moveTo(x + 5, y + 15);
+                paths[2].lineTo(x + 25, y + 15);
+                paths[2].lineTo(x + 25, y + 18);
+                paths[2].lineTo(x + 8, y + 18);
+                paths[2].lineTo(x + 8, y + 33);
+                paths[2].lineTo(x + 5, y + 33);
+                paths[2].close();
+                count = 3;
+                break;
+            case 1:  // rects sharing edges
+                paths[0].addRect(x, y, x + 10, y + 30);
+                paths[1].addRect(x + 10, y, x + 20, y + 30);
+                paths[2].addRect(x + 20, y + 10, x + 30, y + 20);
+                count = 3;
+                break;
+            default:  // alone
+                paths[0].addCircle(x + 15, y + 15, 12);
+                count = 1;
+                break;
+        }
+        for (int index = 0; index < count; ++index) {
+            builder.add(paths[index], kUnion_SkPathOp);
+            REPORTER_ASSERT(reporter, Op(expected, paths[index], kUnion_SkPathOp, &expected));
+        }
+    }
+    SkPath result;
+    REPORTER_ASSERT(reporter, builder.resolve(&result));
+    int pixelDiff = comparePaths(reporter, __FUNCTION__, expected, result);
+    REPORTER_ASSERT(reporter, pixelDiff == 0);
+
+    // Edge-sharing rects merge into one contour, even when divided. The halves meet in the
+    // middle, which may leave a point there.
+    for (int index = 0; index < 40; ++index) {
+        SkPath rect;
+        rect.addRect(SkIntToScalar(index * 5), 0, SkIntToScalar(index * 5 + 5), 10);
+        builder.add(rect, kUnion_SkPathOp);
+    }
+    REPORTER_ASSERT(reporter, builder.resolve(&result));
+    REPORTER_ASSERT(reporter, result.countPoints() <= 6);
+    REPORTER_ASSERT(reporter, result.getBounds() == SkRect::MakeWH(200, 10));
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "Test.h"
+
+static void make_star(SkPath* path, SkScalar cx, SkScalar cy, SkScalar r, int points) {
+    path->reset();
+    path->moveTo(cx, cy - r);
+    for (int i = 1; i < points; ++i) {
+        // Skip every other vertex so that the edges cross.
+        const SkScalar radians = 2 * SK_ScalarPI * ((i * 2) % points) / points;
+        path->lineTo(cx + r * SkScalarSin(radians), cy - r * SkScalarCos(radians));
+    }
+    path->close();
+}
+
+// A context reuses its memory from one call to the next; its results must be the same as
+// those of Op() and Simplify(), which start afresh.
+DEF_TEST(PathOpsContext, reporter) {
+    SkPathOpsContext context;
+    for (int i = 0; i < 20; ++i) {
+        SkPath star, circle;
+        make_star(&star, 50, 50, 40, 5 + (i & 2));
+        circle.addCircle(40.f + i, 45, 20 + (i % 3) * 5.f);
+        const SkPathOp op = (SkPathOp) (i % (kReverseDifference_SkPathOp + 1));
+
+        SkPath expected, result;
+        REPORTER_ASSERT(reporter, Op(star, circle, op, &expected));
+        REPORTER_ASSERT(reporter, context.op(star, circle, op, &result));
+        REPORTER_ASSERT(reporter, expected == result);
+
+        REPORTER_ASSERT(reporter, Simplify(star, &expected));
+        REPORTER_ASSERT(reporter, context.simplify(star, &result));
+        REPORTER_ASSERT(reporter, expected == result);
+    }
+}
+
+// Once a context has grown to fit an op, repeating it allocates nothing, even after smaller
+// ops in between.
+DEF_TEST(PathOpsContext_Allocations, reporter) {
+    SkPath big, bigOther, small, smallOther;
+    for (int i = 0; i < 20; ++i) {
+        big.addCircle(10.f * i, 10, 8);
+        bigOther.addRect(10.f * i, 5, 10.f * i + 5, 30);
+    }
+    small.addRect(0, 0, 10, 10);
+    smallOther.addCircle(10, 10, 5);
+
+    SkPathOpsContext context;
+    SkPath result;
+    REPORTER_ASSERT(reporter, context.op(big, bigOther, kUnion_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, context.lastAllocationCount() > 0);
+    REPORTER_ASSERT(reporter, context.op(big, bigOther, kUnion_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, 0 == context.lastAllocationCount());
+    for (int i = 0; i < 3; ++i) {
+        REPORTER_ASSERT(reporter, context.op(small, smallOther, kXOR_SkPathOp, &result));
+        REPORTER_ASSERT(reporter, 0 == context.lastAllocationCount());
+        REPORTER_ASSERT(reporter, context.simplify(big, &result));
+        REPORTER_ASSERT(reporter, 0 == context.lastAllocationCount());
+    }
+    REPORTER_ASSERT(reporter, context.op(big, bigOther, kUnion_SkPathOp, &result));
+    REPORTER_ASSERT(reporter, 0 == context.lastAllocationCount());
+}
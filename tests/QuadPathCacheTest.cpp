@@ -0,0 +1,146 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkGeometry.h"
+#include "SkMatrix.h"
+#include "SkPath.h"
+#include "SkQuadPathCache.h"
+#include "SkResourceCache.h"
+#include "SkRRect.h"
+#include "SkSurfaceProps.h"
+#include "Test.h"
+
+static SkPath make_rounded_path() {
+    SkPath path;
+    path.addRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(10, 10, 90, 70), 20, 12));
+    path.addCircle(50, 40, 15);
+    path.moveTo(20, 80);
+    path.quadTo(50, 60, 80, 80);
+    path.cubicTo(70, 100, 30, 100, 20, 80);
+    return path;
+}
+
+// Returns true if the quad path came out of the cache, as for FillPathCache.
+static bool check_quad_path(skiatest::Reporter* reporter, SkResourceCache* cache,
+                            const SkPath& src, SkScalar scale, uint32_t* genID) {
+    SkPath dst;
+    REPORTER_ASSERT(reporter, SkQuadPathCache::GetQuadPath(
+            src, SkMatrix::MakeScale(scale, scale), &dst, cache));
+    REPORTER_ASSERT(reporter, !(dst.getSegmentMasks() & SkPath::kConic_SegmentMask));
+    REPORTER_ASSERT(reporter, src.getFillType() == dst.getFillType());
+
+    const bool hit = dst.getGenerationID() == *genID;
+    *genID = dst.getGenerationID();
+    return hit;
+}
+
+DEF_TEST(QuadPathCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    SkPath path = make_rounded_path();
+    uint32_t genID = 0;
+
+    REPORTER_ASSERT(reporter, !check_quad_path(reporter, &cache, path, 1, &genID));
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() > 0);
+    REPORTER_ASSERT(reporter, check_quad_path(reporter, &cache, path, 1, &genID));
+
+    // Nearby scales share quads cut for the larger of them; scales further apart don't.
+    REPORTER_ASSERT(reporter, !check_quad_path(reporter, &cache, path, 1.1f, &genID));
+    REPORTER_ASSERT(reporter, check_quad_path(reporter, &cache, path, 1.15f, &genID));
+    REPORTER_ASSERT(reporter, !check_quad_path(reporter, &cache, path, 4, &genID));
+
+    // The result takes the fill type of the path drawn.
+    path.setFillType(SkPath::kInverseEvenOdd_FillType);
+    check_quad_path(reporter, &cache, path, 4, &genID);
+
+    // Editing the path misses.
+    path.lineTo(0, 50);
+    REPORTER_ASSERT(reporter, !check_quad_path(reporter, &cache, path, 4, &genID));
+
+    // Volatile paths, paths without conics, and perspective are drawn as is.
+    const size_t bytesUsed = cache.getTotalBytesUsed();
+    SkPath dst;
+    SkPath volatilePath = make_rounded_path();
+    volatilePath.setIsVolatile(true);
+    REPORTER_ASSERT(reporter, !SkQuadPathCache::GetQuadPath(
+            volatilePath, SkMatrix::I(), &dst, &cache));
+    SkPath quadPath;
+    quadPath.moveTo(10, 10);
+    quadPath.quadTo(50, 0, 90, 10);
+    quadPath.cubicTo(100, 40, 100, 60, 90, 90);
+    quadPath.close();
+    REPORTER_ASSERT(reporter, !SkQuadPathCache::GetQuadPath(quadPath, SkMatrix::I(), &dst, &cache));
+    SkMatrix perspective;
+    perspective.setPerspX(0.001f);
+    REPORTER_ASSERT(reporter, !SkQuadPathCache::GetQuadPath(
+            make_rounded_path(), perspective, &dst, &cache));
+    REPORTER_ASSERT(reporter, bytesUsed == cache.getTotalBytesUsed());
+}
+
+DEF_TEST(QuadPathCache_Tolerance, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    const SkScalar kRadius = 40;
+    SkPath circle;
+    circle.addCircle(50, 50, kRadius);
+
+    // Each quad stays within tolerance of the circle at any scale in its bucket.
+    const SkScalar scales[] = { 0.3f, 1, 1.18f, 7, 40 };
+    for (SkScalar scale : scales) {
+        SkPath dst;
+        REPORTER_ASSERT(reporter, SkQuadPathCache::GetQuadPath(
+                circle, SkMatrix::MakeScale(scale, scale), &dst, &cache));
+        SkPath::RawIter iter(dst);
+        SkPoint pts[4];
+        SkPath::Verb verb;
+        while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+            if (SkPath::kQuad_Verb == verb) {
+                for (SkScalar t = 0.125f; t < 1; t += 0.125f) {
+                    SkPoint pt;
+                    SkEvalQuadAt(pts, t, &pt);
+                    const SkScalar error = SkPoint::Distance(SkPoint::Make(50, 50), pt) - kRadius;
+                    REPORTER_ASSERT(reporter,
+                                    SkScalarAbs(error) * scale <= SkQuadPathCache::kTolerance);
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(QuadPathCache_Draw, reporter) {
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(100, 100);
+    actual.allocN32Pixels(100, 100);
+    SkCanvas expectedCanvas(expected);
+    SkCanvas actualCanvas(actual, SkSurfaceProps(SkSurfaceProps::kCacheConicQuads_Flag,
+                                                 kUnknown_SkPixelGeometry));
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    const SkPath path = make_rounded_path();
+    for (SkScalar scale = 0.5f; scale < 1.25f; scale += 0.125f) {
+        for (SkCanvas* canvas : { &expectedCanvas, &actualCanvas }) {
+            canvas->clear(SK_ColorWHITE);
+            canvas->save();
+            canvas->scale(scale, scale);
+            canvas->drawPath(path, paint);
+            canvas->restore();
+        }
+
+        // Quads cut at least as finely as SkEdgeBuilder cuts them only nudge the coverage of
+        // the pixels along their edges.
+        int maxDiff = 0;
+        for (int y = 0; y < expected.height(); ++y) {
+            for (int x = 0; x < expected.width(); ++x) {
+                const int diff = SkAbs32((int)SkGetPackedG32(*expected.getAddr32(x, y)) -
+                                         (int)SkGetPackedG32(*actual.getAddr32(x, y)));
+                maxDiff = SkTMax(maxDiff, diff);
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 32);
+    }
+}
@@ -7,6 +7,7 @@
 
 #include "SkCanvas.h"
 #include "SkDrawLooper.h"
+#include "SkRandom.h"
 #include "SkTypes.h"
 #include "Test.h"
 
@@ -140,8 +141,46 @@ static void test_quick_reject(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, true == canvas.quickReject(r13));
 }
 
+// The batched quickReject() must agree with quickReject() on each rect, whatever the matrix.
+static void test_quick_reject_array(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    SkRect rects[100];
+    for (int i = 0; i < 100; ++i) {
+        const SkScalar x = rand.nextRangeF(-150, 150);
+        const SkScalar y = rand.nextRangeF(-150, 150);
+        rects[i] = SkRect::MakeXYWH(x, y, rand.nextRangeF(-20, 40), rand.nextRangeF(-20, 40));
+    }
+    rects[0].fLeft = SK_ScalarNaN;
+
+    SkMatrix rotate, perspective;
+    rotate.setRotate(37, 50, 50);
+    perspective.setAll(1, 0.2f, 10, 0.1f, 1, 5, 0.001f, 0.002f, 1);
+    const SkMatrix matrices[] = {
+        SkMatrix::I(),
+        SkMatrix::MakeTrans(20, -30),
+        SkMatrix::MakeScale(-2, 0.5f),
+        rotate,
+        perspective,
+    };
+
+    SkCanvas canvas(100, 100);
+    canvas.clipRect(SkRect::MakeLTRB(10, 20, 70, 90));
+    for (const SkMatrix& matrix : matrices) {
+        canvas.setMatrix(matrix);
+        bool rejected[100];
+        const int count = canvas.quickReject(rects, 100, rejected);
+        int expectedCount = 0;
+        for (int i = 0; i < 100; ++i) {
+            REPORTER_ASSERT(reporter, rejected[i] == canvas.quickReject(rects[i]));
+            expectedCount += canvas.quickReject(rects[i]);
+        }
+        REPORTER_ASSERT(reporter, count == expectedCount);
+    }
+}
+
 DEF_TEST(QuickReject, reporter) {
     test_drawBitmap(reporter);
     test_layers(reporter);
     test_quick_reject(reporter);
+    test_quick_reject_array(reporter);
 }
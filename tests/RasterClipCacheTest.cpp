@@ -0,0 +1,80 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkRasterClip.h"
+#include "SkRasterClipCache.h"
+#include "SkResourceCache.h"
+#include "Test.h"
+
+static bool clips_equal(const SkRasterClip& a, const SkRasterClip& b) {
+    if (a.isBW() != b.isBW()) {
+        return false;
+    }
+    return a.isBW() ? a.bwRgn() == b.bwRgn() : a.aaRgn() == b.aaRgn();
+}
+
+// Applies rrect to clip through the cache, and checks that it comes out as it would without the
+// cache.
+static void check_op(skiatest::Reporter* reporter, SkResourceCache* cache, SkRasterClip* clip,
+                     const SkRRect& rrect, SkRegion::Op op, bool doAA) {
+    const SkIRect bounds = SkIRect::MakeWH(200, 200);
+    SkRasterClip expected(*clip);
+    SkPath path;
+    path.addRRect(rrect);
+    const bool expectedNonEmpty = expected.op(path, bounds, op, doAA);
+
+    const bool nonEmpty = SkRasterClipCache::OpRRect(clip, rrect, bounds, op, doAA, cache);
+    REPORTER_ASSERT(reporter, expectedNonEmpty == nonEmpty);
+    REPORTER_ASSERT(reporter, clips_equal(expected, *clip));
+}
+
+DEF_TEST(RasterClipCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    const SkRRect outer = SkRRect::MakeRectXY(SkRect::MakeLTRB(10.5f, 10.5f, 150, 150), 10, 10);
+    const SkRRect inner = SkRRect::MakeRectXY(SkRect::MakeLTRB(40, 30.25f, 190, 120), 5, 8);
+
+    // Nested rrects, set up draw after draw. Each clip is added the second time its rrect is
+    // seen, and from then on comes out of the cache, sharing the runs that were added.
+    uint32_t ids[3][2];
+    for (int i = 0; i < 3; ++i) {
+        SkRasterClip clip(SkIRect::MakeWH(200, 200));
+        check_op(reporter, &cache, &clip, outer, SkRegion::kIntersect_Op, true);
+        REPORTER_ASSERT(reporter, clip.isAA());
+        ids[i][0] = clip.aaRgn().uniqueID();
+        check_op(reporter, &cache, &clip, inner, SkRegion::kIntersect_Op, true);
+        REPORTER_ASSERT(reporter, clip.isAA());
+        ids[i][1] = clip.aaRgn().uniqueID();
+    }
+    REPORTER_ASSERT(reporter, ids[0][0] != ids[1][0] && ids[0][1] != ids[1][1]);
+    REPORTER_ASSERT(reporter, ids[1][0] == ids[2][0] && ids[1][1] == ids[2][1]);
+
+    // The op and the clip the rrect is applied to are part of the key.
+    for (int i = 0; i < 2; ++i) {
+        SkRasterClip clip(SkIRect::MakeWH(200, 200));
+        check_op(reporter, &cache, &clip, inner, SkRegion::kIntersect_Op, true);
+        clip.setRect(SkIRect::MakeWH(200, 200));
+        check_op(reporter, &cache, &clip, outer, SkRegion::kDifference_Op, true);
+    }
+
+    // BW rrects and complex BW clips are never cached.
+    const size_t bytesUsed = cache.getTotalBytesUsed();
+    SkRegion rgn(SkIRect::MakeWH(100, 100));
+    rgn.op(SkIRect::MakeLTRB(50, 50, 200, 200), SkRegion::kUnion_Op);
+    for (int i = 0; i < 2; ++i) {
+        SkRasterClip clip(SkIRect::MakeWH(200, 200));
+        check_op(reporter, &cache, &clip, outer, SkRegion::kIntersect_Op, false);
+        REPORTER_ASSERT(reporter, clip.isBW());
+
+        clip.setRect(SkIRect::MakeWH(200, 200));
+        clip.op(rgn, SkRegion::kIntersect_Op);
+        REPORTER_ASSERT(reporter, clip.isBW() && clip.isComplex());
+        check_op(reporter, &cache, &clip, inner, SkRegion::kIntersect_Op, true);
+    }
+    REPORTER_ASSERT(reporter, bytesUsed == cache.getTotalBytesUsed());
+}
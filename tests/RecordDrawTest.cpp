@@ -11,6 +11,7 @@
 #include "SkDebugCanvas.h"
 #include "SkDropShadowImageFilter.h"
 #include "SkImagePriv.h"
+#include "SkRTree.h"
 #include "SkRecord.h"
 #include "SkRecordDraw.h"
 #include "SkRecordOpts.h"
@@ -147,6 +148,50 @@ DEF_TEST(RecordDraw_BasicBounds, r) {
     }
 }
 
+// Counts the rects drawn into it, and how many of those fell outside its clip.
+class RejectCountingCanvas : public SkCanvas {
+public:
+    RejectCountingCanvas() : INHERITED(W, H), fDraws(0), fRejectedDraws(0) {}
+
+    void onDrawRect(const SkRect& rect, const SkPaint&) override {
+        fDraws++;
+        fRejectedDraws += this->quickReject(rect);
+    }
+
+    int fDraws, fRejectedDraws;
+
+private:
+    typedef SkCanvas INHERITED;
+};
+
+// Rotating the canvas makes the BBH query the bounds of a rotated clip, which finds many ops
+// outside the clip itself.  Those should be culled before they reach the canvas.
+DEF_TEST(RecordDraw_RotatedBBHCulls, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+    for (int y = 0; y < H; y += 40) {
+        for (int x = 0; x < W; x += 40) {
+            recorder.drawRect(SkRect::MakeXYWH(SkIntToScalar(x), SkIntToScalar(y), 10, 10),
+                              SkPaint());
+        }
+    }
+
+    SkAutoTMalloc<SkRect> bounds(record.count());
+    SkRecordFillBounds(SkRect::MakeWH(SkIntToScalar(W), SkIntToScalar(H)), record, bounds);
+    SkRTree rtree;
+    rtree.insert(bounds, record.count());
+
+    RejectCountingCanvas canvas;
+    canvas.clipRect(SkRect::MakeXYWH(500, 300, 300, 300));
+    canvas.translate(650, 450);
+    canvas.rotate(45);
+    canvas.translate(-650, -450);
+    SkRecordDraw(record, &canvas, nullptr, nullptr, 0, &rtree, nullptr);
+
+    REPORTER_ASSERT(r, canvas.fDraws > 0);
+    REPORTER_ASSERT(r, 0 == canvas.fRejectedDraws);
+}
+
 // A regression test for crbug.com/409110.
 DEF_TEST(RecordDraw_TextBounds, r) {
     SkRecord record;
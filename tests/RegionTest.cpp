@@ -257,12 +257,57 @@ DEF_TEST(Region, reporter) {
         REPORTER_ASSERT(reporter, test_rects(rect, N));
     }
 
+    for (int i = 0; i < 20; i++) {
+        const int N = 200;
+        SkIRect rect[N];
+        for (int j = 0; j < N; j++) {
+            rand_rect(&rect[j], rand);
+        }
+        REPORTER_ASSERT(reporter, test_rects(rect, N));
+    }
+
     test_proc(reporter, contains_proc);
     test_proc(reporter, intersects_proc);
     test_empties(reporter);
     test_fromchrome(reporter);
 }
 
+// Ops that write back into one of their operands reuse its runs when they can. Check that
+// gives the same answers as writing into a fresh region, and leaves copies alone.
+DEF_TEST(Region_opInPlace, reporter) {
+    static const SkRegion::Op gOps[] = {
+        SkRegion::kUnion_Op, SkRegion::kXOR_Op, SkRegion::kDifference_Op,
+        SkRegion::kIntersect_Op, SkRegion::kReverseDifference_Op,
+    };
+
+    SkRandom rand;
+    for (int i = 0; i < 100; i++) {
+        SkRegion rgn, other;
+        randRgn(rand, &other, 8);
+        for (int j = 0; j < 40; j++) {
+            SkIRect rect;
+            rand_rect(&rect, rand);
+            const SkRegion::Op op = gOps[rand.nextULessThan(SK_ARRAY_COUNT(gOps))];
+
+            const SkRegion before(rgn);
+            SkRegion expected;
+            expected.op(before, rect, op);
+            rgn.op(rect, op);
+            REPORTER_ASSERT(reporter, rgn == expected);
+
+            expected.op(before, other, op);
+            SkRegion copy(rgn = before);
+            rgn.op(other, op);
+            REPORTER_ASSERT(reporter, rgn == expected);
+            REPORTER_ASSERT(reporter, copy == before);
+
+            if (rgn.isEmpty()) {
+                rgn.setRect(rect);
+            }
+        }
+    }
+}
+
 // Test that writeToMemory reports the same number of bytes whether there was a
 // buffer to write to or not.
 static void test_write(const SkRegion& region, skiatest::Reporter* r) {
@@ -290,3 +335,55 @@ DEF_TEST(Region_writeToMemory, r) {
     REPORTER_ASSERT(r, region.isComplex());
     test_write(region, r);
 }
+
+// Test that readFromMemory rejects regions whose runs disagree with their counts or bounds,
+// since ops size their scratch space from those counts.
+static bool read_corrupted(const SkRegion& region, int index, int32_t value) {
+    const size_t size = region.writeToMemory(nullptr);
+    SkAutoMalloc storage(size);
+    region.writeToMemory(storage.get());
+    static_cast<int32_t*>(storage.get())[index] = value;
+
+    SkRegion result;
+    return result.readFromMemory(storage.get(), size) != 0;
+}
+
+DEF_TEST(Region_readFromMemory, r) {
+    SkRegion region;
+    region.setRect(0, 0, 50, 50);
+    region.op(50, 50, 100, 100, SkRegion::kUnion_Op);
+    REPORTER_ASSERT(r, region.isComplex());
+
+    // Stored as count, bounds, ySpanCount, intervalCount, then the runs:
+    //  0, 50, 1, 0, 50, S, 100, 1, 50, 100, S, S
+    const size_t size = region.writeToMemory(nullptr);
+    SkAutoMalloc storage(size);
+    region.writeToMemory(storage.get());
+    const int32_t* ints = static_cast<const int32_t*>(storage.get());
+    REPORTER_ASSERT(r, 12 == ints[0] && 2 == ints[5] && 2 == ints[6]);
+
+    SkRegion copy;
+    REPORTER_ASSERT(r, copy.readFromMemory(storage.get(), size) == size);
+    REPORTER_ASSERT(r, copy == region);
+
+    // A truncated buffer.
+    REPORTER_ASSERT(r, 0 == copy.readFromMemory(storage.get(), size - 4));
+
+    REPORTER_ASSERT(r, !read_corrupted(region, 0, 10));        // run count
+    REPORTER_ASSERT(r, !read_corrupted(region, 0, 1 << 28));   // run count past the buffer
+    REPORTER_ASSERT(r, !read_corrupted(region, 3, 99));        // bounds
+    REPORTER_ASSERT(r, !read_corrupted(region, 5, 1));         // Y-span count
+    REPORTER_ASSERT(r, !read_corrupted(region, 6, 1));         // interval count
+    REPORTER_ASSERT(r, !read_corrupted(region, 9, 0));         // a span's interval count
+    REPORTER_ASSERT(r, !read_corrupted(region, 9, 2));
+    REPORTER_ASSERT(r, !read_corrupted(region, 9, -1));
+    REPORTER_ASSERT(r, !read_corrupted(region, 8, 0));         // an empty Y-span
+    REPORTER_ASSERT(r, !read_corrupted(region, 10, 60));       // an empty interval
+    REPORTER_ASSERT(r, !read_corrupted(region, 12, 60));       // a missing X-sentinel
+    REPORTER_ASSERT(r, !read_corrupted(region, 18, 60));       // a missing Y-sentinel
+
+    // An empty rect.
+    SkRegion rect;
+    rect.setRect(0, 0, 50, 50);
+    REPORTER_ASSERT(r, !read_corrupted(rect, 3, 0));
+}
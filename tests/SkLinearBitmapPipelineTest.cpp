@@ -36,7 +36,7 @@ DEF_TEST(SkBitmapFP, reporter) {
     SkPixmap srcPixmap{info, bitmap, static_cast<size_t>(4 * width)};
 
     SkLinearBitmapPipeline pipeline{invert, kNone_SkFilterQuality, SkShader::kClamp_TileMode,
-                                    SkShader::kClamp_TileMode, srcPixmap};
+                                    SkShader::kClamp_TileMode, SK_ColorBLACK, srcPixmap};
 
     int count = 10;
 
@@ -56,3 +56,198 @@ DEF_TEST(SkBitmapFP, reporter) {
     delete [] FPbuffer;
 }
 
+
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkColorTable.h"
+#include "SkHalf.h"
+#include "SkPM4fPriv.h"
+#include "SkShader.h"
+
+static void fill_bitmap(SkBitmap* bitmap, SkColorType colorType, int width, int height) {
+    const SkAlphaType alphaType =
+        kRGB_565_SkColorType == colorType || kGray_8_SkColorType == colorType
+            ? kOpaque_SkAlphaType : kPremul_SkAlphaType;
+    const SkImageInfo info = SkImageInfo::Make(width, height, colorType, alphaType);
+    SkAutoTUnref<SkColorTable> ctable;
+    if (kIndex_8_SkColorType == colorType) {
+        SkPMColor colors[256];
+        for (int i = 0; i < 256; i++) {
+            colors[i] = SkPreMultiplyARGB(255 - i, i, 3 * i, 7 * i);
+        }
+        ctable.reset(new SkColorTable(colors, 256));
+    }
+    bitmap->allocPixels(info, nullptr, ctable);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const int v = 37 * x + 61 * y;
+            switch (colorType) {
+                case kN32_SkColorType:
+                    *bitmap->getAddr32(x, y) = SkPreMultiplyARGB(255 - v, v, 3 * v, 5 * v);
+                    break;
+                case kRGB_565_SkColorType:
+                    *bitmap->getAddr16(x, y) = SkPackRGB16(v & 31, (3 * v) & 63, (5 * v) & 31);
+                    break;
+                default:
+                    *bitmap->getAddr8(x, y) = (uint8_t) v;
+                    break;
+            }
+        }
+    }
+}
+
+static bool close_enough(SkPMColor a, SkPMColor b, int tolerance) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        if (SkTAbs((int) ((a >> shift) & 0xFF) - (int) ((b >> shift) & 0xFF)) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Shades a span through the bitmap shader, once for SkPMColor clients, which get the
+// SkBitmapProcState procs, and once for SkPM4f clients, which get the pipeline.
+static void compare_to_legacy(skiatest::Reporter* reporter, const SkBitmap& bitmap,
+                              const SkMatrix& matrix, SkShader::TileMode xTile,
+                              SkShader::TileMode yTile) {
+    SkAutoTUnref<SkShader> shader(SkShader::CreateBitmapShader(bitmap, xTile, yTile));
+    SkPaint paint;
+    paint.setColor(0xFF3080C0);
+
+    const SkShader::ContextRec legacyRec(paint, matrix, nullptr,
+                                         SkShader::ContextRec::kPMColor_DstType);
+    const SkShader::ContextRec pm4fRec(paint, matrix, nullptr,
+                                       SkShader::ContextRec::kPM4f_DstType);
+    SkAutoMalloc legacyStorage(shader->contextSize(legacyRec));
+    SkAutoMalloc pm4fStorage(shader->contextSize(pm4fRec));
+    SkShader::Context* legacy = shader->createContext(legacyRec, legacyStorage.get());
+    SkShader::Context* pm4f = shader->createContext(pm4fRec, pm4fStorage.get());
+    REPORTER_ASSERT(reporter, legacy && pm4f);
+    if (!legacy || !pm4f) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, pm4f->getFlags() & SkShader::kPrefers4f_Flag);
+
+    const int count = 40;
+    SkPMColor expected[count];
+    SkPM4f actual[count];
+    bool matches = true;
+    for (int y = -6; y < 16 && matches; y += 3) {
+        legacy->shadeSpan(-8, y, expected, count);
+        pm4f->shadeSpan4f(-8, y, actual, count);
+        for (int i = 0; i < count && matches; i++) {
+            const SkPMColor color = Sk4f_toL32(Sk4f::Load(actual[i].fVec));
+            matches = close_enough(color, expected[i], 1);
+            if (!matches) {
+                ERRORF(reporter, "color type %d, tiles %d %d, matrix type %d, (%d, %d): "
+                       "expected %08x, got %08x", bitmap.colorType(), xTile, yTile,
+                       matrix.getType(), i - 8, y, expected[i], color);
+            }
+        }
+    }
+    legacy->~Context();
+    pm4f->~Context();
+}
+
+DEF_TEST(SkLinearBitmapPipeline_Legacy, reporter) {
+    const SkColorType colorTypes[] = {
+        kN32_SkColorType, kRGB_565_SkColorType, kIndex_8_SkColorType, kAlpha_8_SkColorType,
+        kGray_8_SkColorType,
+    };
+    const SkShader::TileMode tileModes[] = {
+        SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode, SkShader::kMirror_TileMode,
+    };
+
+    // The fractional translates keep the sample points off the pixel edges, where the
+    // pipeline and the fixed point procs could disagree.
+    SkMatrix translate = SkMatrix::MakeTrans(-3.25f, 2.25f);
+    SkMatrix scale = SkMatrix::MakeScale(2, 2);
+    scale.postTranslate(0.25f, -0.75f);
+    SkMatrix shrink = SkMatrix::MakeScale(0.75f, 0.5f);
+    shrink.postTranslate(0.125f, 0.125f);
+    const SkMatrix* matrices[] = { &SkMatrix::I(), &translate, &scale, &shrink };
+
+    for (SkColorType colorType : colorTypes) {
+        SkBitmap bitmap;
+        fill_bitmap(&bitmap, colorType, 7, 5);
+        for (SkShader::TileMode xTile : tileModes) {
+            for (SkShader::TileMode yTile : tileModes) {
+                for (const SkMatrix* matrix : matrices) {
+                    compare_to_legacy(reporter, bitmap, *matrix, xTile, yTile);
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(SkLinearBitmapPipeline_F16, reporter) {
+    const int width = 3, height = 2;
+    uint64_t pixels[width * height];
+    for (int i = 0; i < width * height; i++) {
+        const float v = i / 8.0f;
+        SkHalf channels[4] = {
+            SkFloatToHalf(v), SkFloatToHalf(v / 2), SkFloatToHalf(v / 4), SkFloatToHalf(0.75f)
+        };
+        memcpy(&pixels[i], channels, sizeof(pixels[i]));
+    }
+    const SkImageInfo info = SkImageInfo::Make(width, height, kRGBA_F16_SkColorType,
+                                               kPremul_SkAlphaType);
+    SkPixmap srcPixmap{info, pixels, sizeof(pixels[0]) * width};
+
+    SkLinearBitmapPipeline pipeline{SkMatrix::I(), kNone_SkFilterQuality,
+                                    SkShader::kRepeat_TileMode, SkShader::kRepeat_TileMode,
+                                    SK_ColorBLACK, srcPixmap};
+    SkPM4f dst[2 * width];
+    pipeline.shadeSpan4f(0, 1, dst, 2 * width);
+    for (int i = 0; i < 2 * width; i++) {
+        const float v = (width + i % width) / 8.0f;
+        REPORTER_ASSERT(reporter, dst[i].fVec[SkPM4f::R] == v);
+        REPORTER_ASSERT(reporter, dst[i].fVec[SkPM4f::G] == v / 2);
+        REPORTER_ASSERT(reporter, dst[i].fVec[SkPM4f::B] == v / 4);
+        REPORTER_ASSERT(reporter, dst[i].fVec[SkPM4f::A] == 0.75f);
+    }
+}
+
+DEF_TEST(SkLinearBitmapPipeline_Filters, reporter) {
+    // A flat image stays flat, however it is filtered and transformed.
+    const int width = 6, height = 6;
+    uint32_t pixels[width * height];
+    const SkPMColor flat = SkPreMultiplyARGB(0xC0, 0x40, 0x80, 0xFF);
+    for (int i = 0; i < width * height; i++) {
+        pixels[i] = flat;
+    }
+    SkPixmap srcPixmap{SkImageInfo::MakeN32Premul(width, height), pixels, 4 * width};
+
+    SkMatrix matrix;
+    matrix.setRotate(30, 3, 3);
+    matrix.postScale(1.7f, 0.6f);
+    const SkFilterQuality qualities[] = { kLow_SkFilterQuality, kHigh_SkFilterQuality };
+    const SkShader::TileMode tileModes[] = {
+        SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode, SkShader::kMirror_TileMode,
+    };
+    for (SkFilterQuality quality : qualities) {
+        for (SkShader::TileMode tile : tileModes) {
+            SkLinearBitmapPipeline pipeline{matrix, quality, tile, tile, SK_ColorBLACK, srcPixmap};
+            SkPM4f dst[20];
+            for (int y = -3; y < 10; y++) {
+                pipeline.shadeSpan4f(-5, y, dst, 20);
+                for (int i = 0; i < 20; i++) {
+                    REPORTER_ASSERT(reporter,
+                                    close_enough(Sk4f_toL32(Sk4f::Load(dst[i].fVec)), flat, 1));
+                }
+            }
+        }
+    }
+
+    // Half way between a black pixel and a white one is gray.
+    uint32_t blackWhite[2] = { SK_ColorBLACK, SK_ColorWHITE };
+    SkPixmap bwPixmap{SkImageInfo::MakeN32Premul(2, 1), blackWhite, sizeof(blackWhite)};
+    SkLinearBitmapPipeline pipeline{SkMatrix::MakeTrans(0.5f, 0), kLow_SkFilterQuality,
+                                    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode,
+                                    SK_ColorBLACK, bwPixmap};
+    SkPM4f gray;
+    pipeline.shadeSpan4f(0, 0, &gray, 1);
+    REPORTER_ASSERT(reporter, gray.fVec[SkPM4f::R] == 0.5f);
+    REPORTER_ASSERT(reporter, gray.fVec[SkPM4f::A] == 1.0f);
+}
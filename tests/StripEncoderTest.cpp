@@ -0,0 +1,202 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkCodec.h"
+#include "SkData.h"
+#include "SkImageEncoder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "Test.h"
+
+static void make_test_bitmap(SkBitmap* bm, int width, int height, bool opaque) {
+    bm->allocN32Pixels(width, height, opaque);
+    bm->eraseColor(opaque ? SK_ColorWHITE : SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(*bm);
+    SkRandom rand;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 64; i++) {
+        paint.setColor(rand.nextU() | (opaque ? 0xFF000000 : 0));
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(0, SkIntToScalar(width)),
+                                    rand.nextRangeScalar(0, SkIntToScalar(height)),
+                                    rand.nextRangeScalar(4, SkIntToScalar(width / 2)),
+                                    rand.nextRangeScalar(4, SkIntToScalar(height / 2)));
+        canvas.drawOval(r, paint);
+    }
+}
+
+static bool decode(SkData* data, SkBitmap* dst) {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+    if (!codec) {
+        return false;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    if (!dst->tryAllocPixels(info)) {
+        return false;
+    }
+    return SkCodec::kSuccess == codec->getPixels(info, dst->getPixels(), dst->rowBytes());
+}
+
+static bool pixels_equal(const SkBitmap& a, const SkBitmap& b) {
+    if (a.width() != b.width() || a.height() != b.height()) {
+        return false;
+    }
+    SkAutoLockPixels alpa(a), alpb(b);
+    for (int y = 0; y < a.height(); y++) {
+        if (memcmp(a.getAddr(0, y), b.getAddr(0, y), a.width() * a.bytesPerPixel())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Hides the pixels, so the encoder has to pull rows through getRows().
+class CopyingRowSource : public SkImageEncoder::RowSource {
+public:
+    explicit CopyingRowSource(const SkBitmap& bm) : fBitmap(bm), fNextY(0) {}
+
+    bool getRows(int y, int count, void* dst, size_t rowBytes) override {
+        if (y != fNextY) {
+            return false;
+        }
+        fNextY = y + count;
+        SkAutoLockPixels alp(fBitmap);
+        for (int i = 0; i < count; i++) {
+            memcpy((char*)dst + i * rowBytes, fBitmap.getAddr(0, y + i),
+                   fBitmap.width() * fBitmap.bytesPerPixel());
+        }
+        return true;
+    }
+
+private:
+    const SkBitmap& fBitmap;
+    int             fNextY;
+};
+
+static SkData* encode_strips(const SkBitmap& bm, SkImageEncoder::Type type, bool peek,
+                             const SkImageEncoder::StripOptions& options) {
+    SkDynamicMemoryWStream stream;
+    bool success;
+    if (peek) {
+        SkAutoLockPixels alp(bm);
+        SkPixmap pmap;
+        success = bm.peekPixels(&pmap) &&
+                  SkImageEncoder::EncodeStrips(&stream, pmap, type, 90, options);
+    } else {
+        CopyingRowSource src(bm);
+        success = SkImageEncoder::EncodeStrips(&stream, bm.info(), &src, type, 90, options);
+    }
+    return success ? stream.copyToData() : nullptr;
+}
+
+DEF_TEST(StripEncoder_PNG, r) {
+    for (bool opaque : { true, false }) {
+        SkBitmap src;
+        make_test_bitmap(&src, 123, 301, opaque);
+
+        // The PNG we decode is unpremultiplied and then premultiplied again, which is lossy,
+        // so compare against the regular encoder rather than the source pixels.
+        SkAutoTUnref<SkData> reference(SkImageEncoder::EncodeData(src,
+                                                                  SkImageEncoder::kPNG_Type, 100));
+        SkBitmap expected;
+        REPORTER_ASSERT(r, reference && decode(reference, &expected));
+
+        const SkImageEncoder::Preset presets[] = {
+            SkImageEncoder::kFast_Preset,
+            SkImageEncoder::kDefault_Preset,
+            SkImageEncoder::kSmall_Preset,
+        };
+        const int stripHeights[] = { 0, 1, 7, 300, 301, 1000 };
+        const int concurrency[] = { 0, 1, 3 };
+        for (auto preset : presets) {
+            for (int stripHeight : stripHeights) {
+                for (int maxConcurrent : concurrency) {
+                    for (bool peek : { true, false }) {
+                        SkImageEncoder::StripOptions options;
+                        options.fPreset = preset;
+                        options.fStripHeight = stripHeight;
+                        options.fMaxConcurrentStrips = maxConcurrent;
+                        SkAutoTUnref<SkData> data(encode_strips(src, SkImageEncoder::kPNG_Type,
+                                                                peek, options));
+                        SkBitmap actual;
+                        REPORTER_ASSERT(r, data && decode(data, &actual));
+                        REPORTER_ASSERT(r, pixels_equal(expected, actual));
+                    }
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(StripEncoder_JPEG, r) {
+    SkBitmap src;
+    make_test_bitmap(&src, 150, 207, true);
+
+    // With standard Huffman tables and the slow DCT, the stitched strips hold exactly the
+    // coefficients a single encode would, so they must decode to the same pixels.
+    SkImageEncoder::StripOptions serial;
+    serial.fStripHeight = src.height();
+    SkAutoTUnref<SkData> reference(encode_strips(src, SkImageEncoder::kJPEG_Type, true, serial));
+    SkBitmap expected;
+    REPORTER_ASSERT(r, reference && decode(reference, &expected));
+
+    const int stripHeights[] = { 0, 1, 16, 17, 64, 200 };
+    const int concurrency[] = { 0, 1, 2 };
+    for (int stripHeight : stripHeights) {
+        for (int maxConcurrent : concurrency) {
+            for (bool peek : { true, false }) {
+                SkImageEncoder::StripOptions options;
+                options.fStripHeight = stripHeight;
+                options.fMaxConcurrentStrips = maxConcurrent;
+                SkAutoTUnref<SkData> data(encode_strips(src, SkImageEncoder::kJPEG_Type,
+                                                        peek, options));
+                SkBitmap actual;
+                REPORTER_ASSERT(r, data && decode(data, &actual));
+                REPORTER_ASSERT(r, pixels_equal(expected, actual));
+            }
+        }
+    }
+
+    // The other presets only need to produce a valid image.
+    const SkImageEncoder::Preset presets[] = {
+        SkImageEncoder::kFast_Preset,
+        SkImageEncoder::kSmall_Preset,
+    };
+    for (auto preset : presets) {
+        SkImageEncoder::StripOptions options;
+        options.fPreset = preset;
+        options.fStripHeight = 32;
+        SkAutoTUnref<SkData> data(encode_strips(src, SkImageEncoder::kJPEG_Type, false, options));
+        SkBitmap actual;
+        REPORTER_ASSERT(r, data && decode(data, &actual));
+        REPORTER_ASSERT(r, actual.width() == src.width() && actual.height() == src.height());
+    }
+}
+
+DEF_TEST(StripEncoder_Invalid, r) {
+    SkBitmap src;
+    make_test_bitmap(&src, 16, 16, true);
+    CopyingRowSource rows(src);
+    SkDynamicMemoryWStream stream;
+
+    const SkImageInfo empty = SkImageInfo::MakeN32Premul(0, 16);
+    REPORTER_ASSERT(r, !SkImageEncoder::EncodeStrips(&stream, empty, &rows,
+                                                     SkImageEncoder::kPNG_Type, 100));
+
+    const SkImageInfo index8 = SkImageInfo::Make(16, 16, kIndex_8_SkColorType,
+                                                 kPremul_SkAlphaType);
+    REPORTER_ASSERT(r, !SkImageEncoder::EncodeStrips(&stream, index8, &rows,
+                                                     SkImageEncoder::kPNG_Type, 100));
+
+    SkImageEncoder::StripOptions options;
+    options.fStripHeight = -1;
+    REPORTER_ASSERT(r, !SkImageEncoder::EncodeStrips(&stream, src.info(), &rows,
+                                                     SkImageEncoder::kPNG_Type, 100, options));
+}
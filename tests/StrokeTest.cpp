@@ -7,6 +7,7 @@
 
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "SkStroke.h"
 #include "SkStrokeRec.h"
@@ -160,8 +161,55 @@ static void test_strokerec_equality(skiatest::Reporter* reporter) {
     }
 }
 
+// Paths of only lines are stroked by a faster route than other paths. Check that it comes up with
+// the same stroke, by comparing it to the stroke of the same path with its first line written as
+// a cubic, which the stroker turns back into that line.
+static void test_strokepolyline(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    for (int index = 0; index < 200; ++index) {
+        SkPath lines, linesAndCubic;
+        const int contours = 1 + rand.nextULessThan(3);
+        for (int contour = 0; contour < contours; ++contour) {
+            SkPoint pt = SkPoint::Make(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+            SkPoint next = pt + SkPoint::Make(rand.nextRangeF(1, 10), rand.nextRangeF(-5, 5));
+            lines.moveTo(pt);
+            lines.lineTo(next);
+            linesAndCubic.moveTo(pt);
+            linesAndCubic.cubicTo(pt, next, next);
+            const int count = 2 + rand.nextULessThan(30);
+            for (int i = 0; i < count; ++i) {
+                // repeat some points, and make some sharp turns and tiny steps
+                if (rand.nextULessThan(8)) {
+                    const SkScalar step = rand.nextULessThan(8) ? 10 : 0.001f;
+                    next.offset(rand.nextRangeF(-step, step), rand.nextRangeF(-step, step));
+                }
+                lines.lineTo(next);
+                linesAndCubic.lineTo(next);
+            }
+            if (rand.nextBool()) {
+                lines.close();
+                linesAndCubic.close();
+            }
+        }
+
+        SkPaint paint;
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(rand.nextRangeF(0.5f, 8));
+        paint.setStrokeCap((SkPaint::Cap) rand.nextULessThan(SkPaint::kCapCount));
+        paint.setStrokeJoin((SkPaint::Join) rand.nextULessThan(SkPaint::kJoinCount));
+        paint.setStrokeMiter(rand.nextRangeF(1, 6));
+        const SkScalar resScale = rand.nextBool() ? 1 : rand.nextRangeF(0.25f, 4);
+
+        SkPath fastStroke, stroke;
+        paint.getFillPath(lines, &fastStroke, nullptr, resScale);
+        paint.getFillPath(linesAndCubic, &stroke, nullptr, resScale);
+        REPORTER_ASSERT(reporter, fastStroke == stroke);
+    }
+}
+
 DEF_TEST(Stroke, reporter) {
     test_strokecubic(reporter);
     test_strokerect(reporter);
     test_strokerec_equality(reporter);
+    test_strokepolyline(reporter);
 }
@@ -7,6 +7,7 @@
 
 #include <functional>
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkData.h"
 #include "SkDevice.h"
 #include "SkImage_Base.h"
@@ -909,3 +910,50 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SurfaceClear_Gpu, reporter, context) {
     }
 }
 #endif
+
+// Gamma correct raster surfaces blend in linear light, but otherwise look like any N32 surface.
+DEF_TEST(SurfaceGammaCorrect, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(8, 8);
+    const SkSurfaceProps props(SkSurfaceProps::kGammaCorrect_Flag, kUnknown_SkPixelGeometry);
+
+    for (bool gammaCorrect : { false, true }) {
+        for (bool dither : { false, true }) {
+            SkAutoTUnref<SkSurface> surface(SkSurface::NewRaster(info, gammaCorrect ? &props
+                                                                                    : nullptr));
+            SkCanvas* canvas = surface->getCanvas();
+            canvas->clear(SK_ColorBLACK);
+
+            // Half-transparent white over black is 50% grey in linear light.
+            SkPaint paint;
+            paint.setColor(0x80FFFFFF);
+            paint.setDither(dither);
+            canvas->drawPaint(paint);
+
+            SkImageInfo peekInfo;
+            size_t rowBytes;
+            const void* pixels = canvas->peekPixels(&peekInfo, &rowBytes);
+            REPORTER_ASSERT(reporter, pixels && peekInfo == info);
+            const SkPixmap pixmap(peekInfo, pixels, rowBytes);
+
+            // 0x80/255 is 0.502, which encodes to 180.7 in sRGB, but only to 128 in linear 8888.
+            int lo = 255, hi = 0;
+            for (int y = 0; y < info.height(); ++y) {
+                for (int x = 0; x < info.width(); ++x) {
+                    const SkPMColor c = *pixmap.addr32(x, y);
+                    REPORTER_ASSERT(reporter, 0xFF == SkGetPackedA32(c));
+                    REPORTER_ASSERT(reporter, SkGetPackedR32(c) == SkGetPackedB32(c));
+                    lo = SkTMin(lo, (int)SkGetPackedR32(c));
+                    hi = SkTMax(hi, (int)SkGetPackedR32(c));
+                }
+            }
+            if (!gammaCorrect) {
+                REPORTER_ASSERT(reporter, 128 == lo && 128 == hi);
+            } else if (!dither) {
+                REPORTER_ASSERT(reporter, 181 == lo && 181 == hi);
+            } else {
+                // Ordered dither mixes the two nearest values.
+                REPORTER_ASSERT(reporter, 180 == lo && 181 == hi);
+            }
+        }
+    }
+}
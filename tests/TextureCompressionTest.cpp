@@ -6,13 +6,17 @@
  */
 
 #include "SkBitmap.h"
+#include "SkColorPriv.h"
 #include "SkData.h"
 #include "SkEndian.h"
+#include "SkImage.h"
 #include "SkImageInfo.h"
 #include "SkTemplates.h"
 #include "SkTextureCompressor.h"
 #include "Test.h"
 
+#include "etc1.h"
+
 // TODO: Create separate tests for RGB and RGBA data once
 // ASTC and ETC1 decompression is implemented.
 
@@ -274,3 +278,200 @@ DEF_TEST(CompressLATC, reporter) {
         }
     }
 }
+
+static int decompressed_bytes_per_pixel(SkTextureCompressor::Format fmt) {
+    if (decompresses_a8(fmt)) {
+        return 1;
+    }
+    return SkTextureCompressor::kETC1_Format == fmt ? 3 : 4;
+}
+
+static SkData* compress_test_pattern(SkTextureCompressor::Format fmt, int width, int height) {
+    SkAutoPixmapStorage pixmap;
+    if (SkTextureCompressor::kETC1_Format == fmt) {
+        pixmap.alloc(SkImageInfo::Make(width, height, kRGB_565_SkColorType,
+                                       kOpaque_SkAlphaType));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                *pixmap.writable_addr16(x, y) = SkPack888ToRGB16(x * 5, y * 3, (x ^ y) * 4);
+            }
+        }
+    } else {
+        pixmap.alloc(SkImageInfo::MakeA8(width, height));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                *pixmap.writable_addr8(x, y) = (x * 5 + y * 3) & 0xFF;
+            }
+        }
+    }
+    return SkTextureCompressor::CompressBitmapToFormat(pixmap, fmt);
+}
+
+/**
+ * Make sure that decompressing a rectangle of blocks gives the same pixels as
+ * decompressing the whole image.
+ */
+DEF_TEST(DecompressBlocks, reporter) {
+    static const int kWidth = 48;
+    static const int kHeight = 48;
+
+    const SkTextureCompressor::Format formats[] = {
+        SkTextureCompressor::kLATC_Format,
+        SkTextureCompressor::kR11_EAC_Format,
+#ifndef SK_IGNORE_ETC1_SUPPORT
+        SkTextureCompressor::kETC1_Format,
+#endif
+        SkTextureCompressor::kASTC_12x12_Format,
+    };
+    for (SkTextureCompressor::Format fmt : formats) {
+        SkAutoDataUnref data(compress_test_pattern(fmt, kWidth, kHeight));
+        REPORTER_ASSERT(reporter, data);
+        if (nullptr == data) {
+            continue;
+        }
+
+        const int bpp = decompressed_bytes_per_pixel(fmt);
+        SkAutoTMalloc<uint8_t> full(kWidth * kHeight * bpp);
+        REPORTER_ASSERT(reporter, SkTextureCompressor::DecompressBufferFromFormat(
+                full.get(), kWidth * bpp, data->bytes(), kWidth, kHeight, fmt));
+
+        int dimX, dimY;
+        SkTextureCompressor::GetBlockDimensions(fmt, &dimX, &dimY, true);
+        const SkIRect blocks = SkIRect::MakeLTRB(1, 1, kWidth / dimX, kHeight / dimY - 1);
+        const int rowBytes = blocks.width() * dimX * bpp;
+        SkAutoTMalloc<uint8_t> part(rowBytes * blocks.height() * dimY);
+        REPORTER_ASSERT(reporter, SkTextureCompressor::DecompressBlocksFromFormat(
+                part.get(), rowBytes, data->bytes(), kWidth, kHeight, fmt, blocks));
+
+        for (int y = 0; y < blocks.height() * dimY; ++y) {
+            const uint8_t* fullRow = full.get() + ((blocks.fTop * dimY + y) * kWidth +
+                                                   blocks.fLeft * dimX) * bpp;
+            REPORTER_ASSERT(reporter, 0 == memcmp(part.get() + y * rowBytes, fullRow, rowBytes));
+        }
+
+        // Blocks outside the image are rejected.
+        REPORTER_ASSERT(reporter, !SkTextureCompressor::DecompressBlocksFromFormat(
+                part.get(), rowBytes, data->bytes(), kWidth, kHeight, fmt,
+                SkIRect::MakeLTRB(1, 1, kWidth / dimX + 1, 2)));
+    }
+}
+
+static SkData* make_pkm(SkData* etc1, int width, int height) {
+    SkAutoTMalloc<uint8_t> pkm(ETC_PKM_HEADER_SIZE + etc1->size());
+    etc1_pkm_format_header(pkm.get(), width, height);
+    memcpy(pkm.get() + ETC_PKM_HEADER_SIZE, etc1->data(), etc1->size());
+    return SkData::NewWithCopy(pkm.get(), ETC_PKM_HEADER_SIZE + etc1->size());
+}
+
+static SkData* make_astc(SkData* astc, int dimX, int dimY, int width, int height) {
+    SkAutoTMalloc<uint8_t> file(16 + astc->size());
+    uint8_t* header = file.get();
+    const uint32_t magic = SkEndian_SwapLE32(0x5CA1AB13);
+    memcpy(header, &magic, 4);
+    const int fields[] = { dimX, dimY, 1 };
+    for (int i = 0; i < 3; ++i) {
+        header[4 + i] = fields[i];
+    }
+    const int sizes[] = { width, height, 1 };
+    for (int i = 0; i < 3; ++i) {
+        header[7 + 3*i + 0] = sizes[i] & 0xFF;
+        header[7 + 3*i + 1] = (sizes[i] >> 8) & 0xFF;
+        header[7 + 3*i + 2] = (sizes[i] >> 16) & 0xFF;
+    }
+    memcpy(file.get() + 16, astc->data(), astc->size());
+    return SkData::NewWithCopy(file.get(), 16 + astc->size());
+}
+
+static void check_image_pixels(skiatest::Reporter* reporter, SkImage* image,
+                               const SkBitmap& expected, const SkIRect& subset) {
+    REPORTER_ASSERT(reporter, image);
+    if (nullptr == image) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, image->isLazyGenerated());
+    REPORTER_ASSERT(reporter, image->width() == subset.width());
+    REPORTER_ASSERT(reporter, image->height() == subset.height());
+
+    SkBitmap actual;
+    actual.allocPixels(SkImageInfo::MakeN32Premul(subset.width(), subset.height()));
+    REPORTER_ASSERT(reporter, image->readPixels(actual.info(), actual.getPixels(),
+                                                actual.rowBytes(), 0, 0));
+    for (int y = 0; y < subset.height(); ++y) {
+        REPORTER_ASSERT(reporter, 0 == memcmp(actual.getAddr32(0, y),
+                                              expected.getAddr32(subset.fLeft, subset.fTop + y),
+                                              subset.width() * sizeof(SkPMColor)));
+    }
+}
+
+/**
+ * Make sure that SkImages of PKM and ASTC files, and of subsets of them, match decompressing
+ * the whole texture.
+ */
+DEF_TEST(CompressedImage, reporter) {
+    static const int kWidth = 48;
+    static const int kHeight = 48;
+    const SkIRect kSubsets[] = {
+        SkIRect::MakeWH(kWidth, kHeight),
+        SkIRect::MakeXYWH(5, 7, 20, 13),    // not block aligned
+        SkIRect::MakeXYWH(12, 24, 12, 12),  // block aligned
+    };
+
+    const SkTextureCompressor::Format formats[] = {
+#ifndef SK_IGNORE_ETC1_SUPPORT
+        SkTextureCompressor::kETC1_Format,
+#endif
+        SkTextureCompressor::kASTC_12x12_Format,
+    };
+    for (SkTextureCompressor::Format fmt : formats) {
+        SkAutoDataUnref blocks(compress_test_pattern(fmt, kWidth, kHeight));
+        REPORTER_ASSERT(reporter, blocks);
+        if (nullptr == blocks) {
+            continue;
+        }
+
+        const int bpp = decompressed_bytes_per_pixel(fmt);
+        SkAutoTMalloc<uint8_t> full(kWidth * kHeight * bpp);
+        REPORTER_ASSERT(reporter, SkTextureCompressor::DecompressBufferFromFormat(
+                full.get(), kWidth * bpp, blocks->bytes(), kWidth, kHeight, fmt));
+
+        SkBitmap expected;
+        expected.allocPixels(SkImageInfo::MakeN32Premul(kWidth, kHeight));
+        for (int y = 0; y < kHeight; ++y) {
+            for (int x = 0; x < kWidth; ++x) {
+                const uint8_t* p = full.get() + (y * kWidth + x) * bpp;
+                SkColor c;
+                if (3 == bpp) {
+                    c = SkColorSetRGB(p[0], p[1], p[2]);
+                } else {
+                    memcpy(&c, p, sizeof(c));
+                }
+                *expected.getAddr32(x, y) = SkPreMultiplyColor(c);
+            }
+        }
+
+        SkAutoDataUnref file;
+        if (SkTextureCompressor::kETC1_Format == fmt) {
+            file.reset(make_pkm(blocks, kWidth, kHeight));
+        } else {
+            file.reset(make_astc(blocks, 12, 12, kWidth, kHeight));
+        }
+
+        for (const SkIRect& subset : kSubsets) {
+            SkAutoTUnref<SkImage> image(SkImage::NewFromEncoded(file, &subset));
+            check_image_pixels(reporter, image, expected, subset);
+        }
+
+        // Reading part of an uncached image decompresses just that part.
+        SkAutoTUnref<SkImage> image(SkImage::NewFromEncoded(file));
+        SkBitmap part;
+        part.allocPixels(SkImageInfo::MakeN32Premul(10, 10));
+        REPORTER_ASSERT(reporter, image->readPixels(part.info(), part.getPixels(),
+                                                    part.rowBytes(), 30, 3,
+                                                    SkImage::kDisallow_CachingHint));
+        for (int y = 0; y < 10; ++y) {
+            REPORTER_ASSERT(reporter, 0 == memcmp(part.getAddr32(0, y),
+                                                  expected.getAddr32(30, 3 + y),
+                                                  10 * sizeof(SkPMColor)));
+        }
+    }
+}
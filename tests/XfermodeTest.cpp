@@ -6,6 +6,9 @@
  */
 
 #include "SkColor.h"
+#include "SkColorPriv.h"
+#include "SkPM4f.h"
+#include "SkRandom.h"
 #include "SkXfermode.h"
 #include "Test.h"
 
@@ -55,3 +58,106 @@ DEF_TEST(Xfermode, reporter) {
     test_asMode(reporter);
     test_IsMode(reporter);
 }
+
+// An odd count, so the vectorized procs have a tail to handle too.
+static const int kParityCount = 67;
+
+static void make_parity_colors(SkRandom* rand, SkPMColor colors[kParityCount]) {
+    for (int i = 0; i < kParityCount; ++i) {
+        // Mix in some opaque and transparent colors, which the modes often special-case.
+        U8CPU a = rand->nextU() & 0xFF;
+        if (0 == i % 5) {
+            a = 0xFF;
+        } else if (0 == i % 7) {
+            a = 0;
+        }
+        colors[i] = SkPreMultiplyARGB(a, rand->nextU() & 0xFF, rand->nextU() & 0xFF,
+                                      rand->nextU() & 0xFF);
+    }
+}
+
+static int max_channel_diff(SkPMColor a, SkPMColor b) {
+    int diff = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        diff = SkTMax(diff, SkAbs32((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)));
+    }
+    return diff;
+}
+
+// SkPM4f's channels are in SkPMColor's byte order.
+static SkPMColor round_to_pmcolor(const SkPM4f& c) {
+    SkPMColor pm = 0;
+    for (int i = 0; i < 4; ++i) {
+        pm |= (SkPMColor)(SkTPin(c.fVec[i], 0.0f, 1.0f) * 255 + 0.5f) << (8 * i);
+    }
+    return pm;
+}
+
+// Every mode's xfer32() and D32Proc should agree with its scalar SkXfermodeProc and
+// SkXfermodeProc4f, with and without coverage.
+DEF_TEST(Xfermode_VectorParity, reporter) {
+    SkRandom rand;
+    SkPMColor src[kParityCount], dst[kParityCount];
+    SkAlpha aa[kParityCount];
+    make_parity_colors(&rand, src);
+    make_parity_colors(&rand, dst);
+    for (int i = 0; i < kParityCount; ++i) {
+        aa[i] = rand.nextU() & 0xFF;
+    }
+
+    SkPM4f src4f[kParityCount];
+    for (int i = 0; i < kParityCount; ++i) {
+        src4f[i] = SkPM4f::FromPMColor(src[i]);
+    }
+
+    for (int m = 0; m <= SkXfermode::kLastMode; ++m) {
+        const SkXfermode::Mode mode = (SkXfermode::Mode)m;
+        SkAutoTUnref<SkXfermode> xfer(SkXfermode::Create(mode));
+        const SkXfermodeProc proc = SkXfermode::GetProc(mode);
+        const SkXfermodeProc4f proc4f = SkXfermode::GetProc4f(mode);
+        const SkXfermode::D32Proc d32 = SkXfermode::GetD32Proc(xfer, 0);
+
+        for (const SkAlpha* coverage : { (const SkAlpha*)nullptr, (const SkAlpha*)aa }) {
+            // SrcOver has no SkXfermode object; the blitters handle it themselves.
+            SkPMColor result[kParityCount];
+            memcpy(result, dst, sizeof(dst));
+            if (xfer) {
+                xfer->xfer32(result, src, kParityCount, coverage);
+            }
+
+            SkPMColor result4f[kParityCount];
+            memcpy(result4f, dst, sizeof(dst));
+            d32(xfer, result4f, src4f, kParityCount, coverage);
+
+            for (int i = 0; i < kParityCount; ++i) {
+                const SkAlpha a = coverage ? coverage[i] : 0xFF;
+
+                SkPMColor expected = SkFourByteInterp(proc(src[i], dst[i]), dst[i], a);
+                if (SkXfermode::kPlus_Mode == mode) {
+                    // Plus clamps after applying coverage.  skia:3852
+                    expected = proc(SkAlphaMulQ(src[i], SkAlpha255To256(a)), dst[i]);
+                }
+                if (xfer && max_channel_diff(expected, result[i]) > 3) {
+                    ERRORF(reporter, "%s%s xfer32 [%d]: 0x%08x, expected 0x%08x",
+                           SkXfermode::ModeName(mode), coverage ? " aa" : "", i, result[i],
+                           expected);
+                    break;
+                }
+
+                const SkPM4f d4f = SkPM4f::FromPMColor(dst[i]);
+                const SkPM4f r4f = proc4f(src4f[i], d4f);
+                SkPM4f lerped;
+                for (int c = 0; c < 4; ++c) {
+                    lerped.fVec[c] = d4f.fVec[c] + (r4f.fVec[c] - d4f.fVec[c]) * (a * (1/255.0f));
+                }
+                const SkPMColor expected4f = round_to_pmcolor(lerped);
+                if (max_channel_diff(expected4f, result4f[i]) > 2) {
+                    ERRORF(reporter, "%s%s D32Proc [%d]: 0x%08x, expected 0x%08x",
+                           SkXfermode::ModeName(mode), coverage ? " aa" : "", i, result4f[i],
+                           expected4f);
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -5,10 +5,17 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkCodec.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
 #include "Resources.h"
+#include "SkImageEncoder.h"
+#include "SkOpts.h"
+#include "SkRandom.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
+#include "SkYUVToRGBA.h"
 #include "Test.h"
 
 static SkStreamAsset* resource(const char path[]) {
@@ -119,3 +126,155 @@ DEF_TEST(Jpeg_YUV_Codec, r) {
     // A PNG should fail.
     codec_yuv(r, "arrow.png", nullptr);
 }
+
+// Returns the largest difference in any channel between the two.
+static int max_channel_diff(SkPMColor a, SkPMColor b) {
+    int diff = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        diff = SkTMax(diff, SkTAbs((int) ((a >> shift) & 0xFF) - (int) ((b >> shift) & 0xFF)));
+    }
+    return diff;
+}
+
+DEF_TEST(YUV_to_RGBA_Opts, r) {
+    // Y offset and scale, then the V->R, U->G, V->G, and U->B coefficients.
+    static const float kCoeffs[][6] = {
+        { 0, 1.0f,         1.402f,    0.344136f, 0.714136f, 1.772f    },   // kJPEG
+        { 16, 255 / 219.f, 1.596027f, 0.391762f, 0.812968f, 2.017232f },   // kRec601
+        { 16, 255 / 219.f, 1.792741f, 0.213249f, 0.532909f, 2.112402f },   // kRec709
+    };
+
+    SkRandom rand;
+    uint8_t y[64], u[64], v[64];
+    for (int i = 0; i < 64; i++) {
+        y[i] = rand.nextU();
+        u[i] = rand.nextU();
+        v[i] = rand.nextU();
+    }
+    // Include the extremes, which are the most likely to overflow.
+    y[0] = u[0] = v[0] = 0;
+    y[1] = u[1] = v[1] = 255;
+    y[2] = 255; u[2] = 0; v[2] = 255;
+    y[3] = 0; u[3] = 255; v[3] = 0;
+
+    for (int cs = 0; cs <= kLastEnum_SkYUVColorSpace; cs++) {
+        const float* k = kCoeffs[cs];
+        for (bool halfChroma : { false, true }) {
+            // Every count up to a few vectors, to cover the leftovers.
+            for (int count = 1; count <= 40; count++) {
+                uint32_t rgba[40], bgra[40];
+                SkOpts::YUV_to_RGB1(rgba, y, u, v, count, (SkYUVColorSpace) cs, halfChroma);
+                SkOpts::YUV_to_BGR1(bgra, y, u, v, count, (SkYUVColorSpace) cs, halfChroma);
+                for (int i = 0; i < count; i++) {
+                    const int c = halfChroma ? i / 2 : i;
+                    const float luma = (y[i] - k[0]) * k[1];
+                    const float cb = u[c] - 128.f, cr = v[c] - 128.f;
+                    const int red   = SkTPin(SkScalarRoundToInt(luma + k[2] * cr), 0, 255),
+                              green = SkTPin(SkScalarRoundToInt(luma - k[3] * cb - k[4] * cr),
+                                             0, 255),
+                              blue  = SkTPin(SkScalarRoundToInt(luma + k[5] * cb), 0, 255);
+                    const uint32_t expected = SkPackARGB_as_RGBA(0xFF, red, green, blue);
+                    if (max_channel_diff(rgba[i], expected) > 2) {
+                        ERRORF(r, "cs %d, pixel %d of %d: 0x%08x, expected 0x%08x", cs, i, count,
+                               rgba[i], expected);
+                        return;
+                    }
+                    REPORTER_ASSERT(r, bgra[i] == SkSwizzle_RB(rgba[i]));
+                }
+            }
+        }
+    }
+}
+
+// Converting the planes ourselves should give about the same answer as the codec's own
+// conversion to RGB.
+static void check_yuv_to_rgba(skiatest::Reporter* r, SkCodec* codec, int tolerance) {
+    SkCodec::YUVSizeInfo info;
+    SkYUVColorSpace colorSpace;
+    if (!codec->queryYUV8(&info, &colorSpace)) {
+        ERRORF(r, "Expected YUV support");
+        return;
+    }
+    SkAutoMalloc storage(info.fYWidthBytes * info.fYSize.height() +
+                         info.fUWidthBytes * info.fUSize.height() +
+                         info.fVWidthBytes * info.fVSize.height());
+    void* planes[3];
+    planes[0] = storage.get();
+    planes[1] = SkTAddOffset<void>(planes[0], info.fYWidthBytes * info.fYSize.height());
+    planes[2] = SkTAddOffset<void>(planes[1], info.fUWidthBytes * info.fUSize.height());
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getYUV8Planes(info, planes));
+
+    const SkImageInfo dstInfo = codec->getInfo().makeColorType(kRGBA_8888_SkColorType);
+    SkBitmap fromYUV, fromCodec;
+    fromYUV.allocPixels(dstInfo);
+    fromCodec.allocPixels(dstInfo);
+    SkPixmap pixmap;
+    REPORTER_ASSERT(r, fromYUV.peekPixels(&pixmap));
+    const SkISize sizes[3] = { info.fYSize, info.fUSize, info.fVSize };
+    const size_t rowBytes[3] = { info.fYWidthBytes, info.fUWidthBytes, info.fVWidthBytes };
+    REPORTER_ASSERT(r, SkYUVToRGBA(sizes, planes, rowBytes, colorSpace, pixmap));
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(dstInfo, fromCodec.getPixels(),
+                                                             fromCodec.rowBytes()));
+
+    int maxDiff = 0;
+    for (int y = 0; y < dstInfo.height(); y++) {
+        for (int x = 0; x < dstInfo.width(); x++) {
+            maxDiff = SkTMax(maxDiff, max_channel_diff(*fromYUV.getAddr32(x, y),
+                                                       *fromCodec.getAddr32(x, y)));
+        }
+    }
+    if (maxDiff > tolerance) {
+        ERRORF(r, "YUV converted to RGBA differs from RGBA decode by %d", maxDiff);
+    }
+}
+
+DEF_TEST(YUV_to_RGBA_Jpeg, r) {
+    // 4:4:4, so there is no upsampling to disagree about.  The codec decodes RGBA with the fast
+    // IDCT where libjpeg-turbo has one, and YUV with the accurate one, so allow for that.
+    SkAutoTDelete<SkStream> stream(resource("mandrill_h1v1.jpg"));
+    if (!stream) {
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        check_yuv_to_rgba(r, codec, 6);
+    }
+}
+
+DEF_TEST(Webp_YUV_Codec, r) {
+    // A smooth, opaque image, so that libwebp's interpolated chroma is close to ours.
+    SkBitmap src;
+    src.allocN32Pixels(99, 67, true);
+    for (int y = 0; y < src.height(); y++) {
+        for (int x = 0; x < src.width(); x++) {
+            *src.getAddr32(x, y) = SkPackARGB32(0xFF, x * 2, y * 3, (x + y) & 0xFF);
+        }
+    }
+    SkAutoTUnref<SkData> data(SkImageEncoder::EncodeData(src, SkImageEncoder::kWEBP_Type, 90));
+    if (!data) {
+        // Built without a WebP encoder.
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+
+    SkCodec::YUVSizeInfo info;
+    SkYUVColorSpace colorSpace;
+    REPORTER_ASSERT(r, codec->queryYUV8(&info, &colorSpace));
+    REPORTER_ASSERT(r, info.fYSize == SkISize::Make(99, 67));
+    REPORTER_ASSERT(r, info.fUSize == SkISize::Make(50, 34));
+    REPORTER_ASSERT(r, info.fVSize == SkISize::Make(50, 34));
+    REPORTER_ASSERT(r, kRec601_SkYUVColorSpace == colorSpace);
+    check_yuv_to_rgba(r, codec, 8);
+
+    // Lossless WebP is stored as RGB(A), so offers no planes.
+    SkAutoTDelete<SkStream> stream(resource("color_wheel.webp"));
+    if (stream) {
+        codec.reset(SkCodec::NewFromStream(stream.detach()));
+        REPORTER_ASSERT(r, codec && !codec->queryYUV8(&info, nullptr));
+    }
+}
@@ -22,7 +22,7 @@ static const char defaultConfigs[] =
     ;
 
 static const char configHelp[] =
-    "Options: 565 8888 debug gpu gpudebug gpudft gpunull "
+    "Options: 565 8888 debug f16 gpu gpudebug gpudft gpunull "
     "msaa16 msaa4 nonrendering null nullgpu nvprmsaa16 nvprmsaa4 "
     "pdf pdf_poppler skp svg xps"
 #if SK_ANGLE